@@ -0,0 +1,461 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <pstream.h>
+#include <csignal>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <array>
+#include <iomanip>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "DownloadManager.h"
+#include "ThreadPool.h"
+
+constexpr uint16 DownloadManager::MAX_ATTEMPTS;
+constexpr uint32 DownloadManager::READ_BUFFER;
+constexpr uint32 DownloadManager::RETRY_WAIT_SEC;
+constexpr int    DownloadManager::WGET_ERR_NETWORK;
+
+// Decompressor process compressed bytes are written to, with the
+// consumer thread reading its output (through a FIFO) when streaming
+struct DownloadManager::DecompressSink {
+    redi::opstream    process;
+    std::thread       consumer_thread;
+    std::string       fifo_path;
+    std::atomic<bool> consumer_stopped;     // Consumer finished before the end of the data
+    std::string       consumer_err;
+
+    DecompressSink() : consumer_stopped(false) {}
+};
+
+DownloadManager::DownloadManager(uint16 threads) {
+    mThreads = threads == 0 ? (uint16) 1 : threads;
+}
+
+uint64 DownloadManager::add_job(const DownloadJob &job) {
+    mJobs.push_back(job);
+    return mJobs.size() - 1;
+}
+
+const DownloadManager::DownloadJob &DownloadManager::get_job(uint64 index) const {
+    return mJobs.at(index);
+}
+
+std::string DownloadManager::get_error() const {
+    std::string err_msg;
+    for (const DownloadJob &job : mJobs) {
+        if (!job.success) err_msg += "\n" + job.url + ": " + job.err_msg;
+    }
+    return err_msg;
+}
+
+/**
+ * ======================================================================
+ * Function bool DownloadManager::run()
+ *
+ * Description          - Downloads every added job, up to the thread count
+ *                        at once
+ *
+ * Notes                - SIGPIPE is ignored so a decompressor exiting early
+ *                        is reported as a write error rather than killing
+ *                        the process
+ *
+ * @return              - True if every job succeeded
+ *
+ * =====================================================================
+ */
+bool DownloadManager::run() {
+    bool success = true;
+
+    std::signal(SIGPIPE, SIG_IGN);
+    {
+        ThreadPool threadPool((uint16) std::min((uint64) mThreads, (uint64) mJobs.size()));
+        for (DownloadJob &job : mJobs) {
+            DownloadJob *pJob = &job;
+            threadPool.enqueue([this, pJob] {
+                download(*pJob);
+            });
+        }
+        threadPool.wait_all();
+    }
+    for (const DownloadJob &job : mJobs) {
+        if (!job.success) success = false;
+    }
+    return success;
+}
+
+/**
+ * ======================================================================
+ * Function void DownloadManager::download(DownloadJob &job)
+ *
+ * Description          - Downloads a single job, retrying dropped transfers
+ *                        from the current offset
+ *                      - Data of a previous interrupted run (<out>.part) is
+ *                        replayed through the checksum and decompressor
+ *                        before resuming
+ *
+ * Notes                - Partial file is kept on transfer failure so a later
+ *                        run can resume, removed on corrupt data or data
+ *                        larger than the published size
+ *
+ * @param job           - Job to download, results are set in it
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void DownloadManager::download(DownloadJob &job) {
+    std::string part_path = job.out_path + PART_EXTENSION;
+    std::unique_ptr<DecompressSink> sink;
+    std::string command;
+    bool retry;
+    bool aborted = false;       // Consumer or decompressor stopped before the end of the data
+    bool decompressed = true;
+
+    FS_dprint("Downloading: " + job.url + " to: " + job.out_path);
+    job.success     = false;
+    job.transferred = false;
+    job.crc32       = 0;
+    job.bytes       = 0;
+    job.err_msg.clear();
+
+    // Some dropped connections end wget successfully, only the published size tells them apart
+    if (job.verify_size && job.size == 0) job.size = query_size(job.url);
+
+    // Start decompressor, compressed bytes are piped to it as they arrive
+    if (job.decompress != FileSystem::ENT_FILE_UNUSED) {
+        sink.reset(new DecompressSink());
+        if (job.decompress == FileSystem::ENT_FILE_TAR_GZ) {
+            command = "tar -xzf - -C " + quote_path(job.decompress_path);
+        } else if (job.decompress == FileSystem::ENT_FILE_GZ && job.consumer) {
+            sink->fifo_path = job.out_path + FIFO_EXTENSION;
+            std::remove(sink->fifo_path.c_str());
+            if (mkfifo(sink->fifo_path.c_str(), S_IRUSR | S_IWUSR) != 0) {
+                job.err_msg = "Unable to create FIFO at: " + sink->fifo_path;
+                return;
+            }
+            command = "gzip -dc > " + quote_path(sink->fifo_path);
+        } else if (job.decompress == FileSystem::ENT_FILE_GZ) {
+            command = "gzip -dc > " + quote_path(job.decompress_path);
+        } else {
+            job.err_msg = "Unsupported decompression type";
+            return;
+        }
+        sink->process.open(command, redi::pstreams::pstdin);
+        if (!sink->process.is_open()) {
+            job.err_msg = "Unable to start decompression: " + command;
+            if (!sink->fifo_path.empty()) std::remove(sink->fifo_path.c_str());
+            return;
+        }
+        if (!sink->fifo_path.empty()) {
+            DecompressSink *pSink = sink.get();
+            sink->consumer_thread = std::thread([&job, pSink] {
+                std::ifstream fifo(pSink->fifo_path, std::ios::binary);
+                try {
+                    if (!job.consumer(fifo)) pSink->consumer_stopped = true;
+                } catch (const std::exception &e) {
+                    pSink->consumer_err = e.what();
+                    pSink->consumer_stopped = true;
+                }
+                // Drain anything left so the decompressor never blocks on a full pipe
+                char buffer[READ_BUFFER];
+                fifo.clear();
+                while (fifo.read(buffer, READ_BUFFER) || fifo.gcount() > 0);
+            });
+        }
+    }
+
+    if (replay_partial(job, sink.get(), part_path)) {
+        std::ofstream part_file(part_path, std::ios::binary | std::ios::app);
+        for (uint16 attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
+            if ((job.verify_size && job.size > 0 && job.bytes == job.size) ||
+                transfer(job, sink.get(), part_file, retry)) {
+                job.transferred = true;
+                job.err_msg.clear();
+                break;
+            }
+            aborted = sink && (sink->consumer_stopped || !sink->process.good());
+            if (aborted || !retry) break;
+            if (attempt < MAX_ATTEMPTS) {
+                FS_dprint("Download of " + job.url + " interrupted at byte " + std::to_string(job.bytes) +
+                          ", resuming (attempt " + std::to_string(attempt + 1) + ")...");
+                std::this_thread::sleep_for(std::chrono::seconds(RETRY_WAIT_SEC * attempt));
+            }
+        }
+        part_file.close();
+    } else {
+        aborted = true;
+    }
+
+    // Finish decompression, consumer sees end of data once decompressor exits
+    if (sink) {
+        sink->process << std::flush;
+        sink->process.rdbuf()->peof();
+        if (sink->consumer_thread.joinable()) sink->consumer_thread.join();
+        sink->process.close();
+        decompressed = sink->process.rdbuf()->exited() && sink->process.rdbuf()->status() == 0;
+        if (!sink->fifo_path.empty()) std::remove(sink->fifo_path.c_str());
+    }
+
+    if (!job.transferred && !aborted) {
+        if (job.err_msg.empty()) job.err_msg = "Unable to download file, received " + std::to_string(job.bytes) + " bytes";
+        FS_dprint("ERROR downloading " + job.url + ": " + job.err_msg);
+        if (job.verify_size && job.size > 0 && job.bytes > job.size) {
+            std::remove(part_path.c_str());     // Not the published file, nothing to resume
+        }
+        return;     // Partial file kept for resume
+    } else if (sink && !sink->consumer_err.empty()) {
+        job.err_msg = "Unable to process downloaded data: " + sink->consumer_err;
+    } else if (sink && sink->consumer_stopped) {
+        job.err_msg = "Downloaded data was rejected";
+    } else if (!decompressed) {
+        job.err_msg = "Unable to decompress downloaded data";
+    } else if (job.verify_checksum && job.crc32 != job.checksum) {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0') << "Checksum mismatch, expected " << std::setw(8) << job.checksum
+           << " received " << std::setw(8) << job.crc32;
+        job.err_msg = ss.str();
+    } else {
+        job.success = true;
+    }
+
+    if (job.success && job.decompress == FileSystem::ENT_FILE_UNUSED) {
+        std::remove(job.out_path.c_str());
+        job.success = std::rename(part_path.c_str(), job.out_path.c_str()) == 0;
+        if (!job.success) job.err_msg = "Unable to move downloaded file to: " + job.out_path;
+    } else {
+        std::remove(part_path.c_str());   // Decompressed, or data is unusable for resume
+    }
+    if (job.success) {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0') << std::setw(8) << job.crc32;
+        FS_dprint("Success! Downloaded " + std::to_string(job.bytes) + " bytes from: " + job.url +
+                  " (CRC32 " + ss.str() + ")");
+    } else {
+        FS_dprint("ERROR downloading " + job.url + ": " + job.err_msg);
+    }
+}
+
+/**
+ * ======================================================================
+ * Function bool DownloadManager::transfer(DownloadJob &job, DecompressSink *sink,
+ *                                         std::ofstream &part_file, bool &retry)
+ *
+ * Description          - Single transfer attempt starting at the bytes
+ *                        already received
+ *                      - Data is checksummed, appended to the partial file
+ *                        and piped to the decompressor
+ *
+ * Notes                - Servers without range support are handled by wget
+ *                        skipping the leading bytes itself
+ *                      - A successful exit short of the published size is
+ *                        treated as a dropped connection
+ *
+ * @param job           - Job being downloaded
+ * @param sink          - Decompressor, nullptr if none
+ * @param part_file     - Partial file data is appended to
+ * @param retry         - Set if a failed transfer is worth resuming (network
+ *                        failure or data was received)
+ *
+ * @return              - True if transfer completed
+ *
+ * =====================================================================
+ */
+bool DownloadManager::transfer(DownloadJob &job, DecompressSink *sink, std::ofstream &part_file, bool &retry) {
+    std::string command;
+    char        buffer[READ_BUFFER];
+    std::streamsize count;
+    uint64      start_pos = job.bytes;
+    bool        aborted = false;
+
+    retry = false;
+    command = "wget -q --tries=1 -O -";
+    if (start_pos > 0) command += " --start-pos=" + std::to_string(start_pos);
+    command += " " + quote_path(job.url);
+
+    redi::ipstream child(command, redi::pstreams::pstdout);
+    if (!child.is_open()) {
+        job.err_msg = "Unable to execute: " + command;
+        return false;
+    }
+    while (child.read(buffer, READ_BUFFER) || child.gcount() > 0) {
+        count = child.gcount();
+        job.crc32  = crc32_update(job.crc32, buffer, (uint64) count);
+        job.bytes += (uint64) count;
+        part_file.write(buffer, count);
+        if (sink) {
+            sink->process.write(buffer, count);
+            if (sink->consumer_stopped || !sink->process.good()) {
+                aborted = true;
+                break;
+            }
+        }
+    }
+    part_file.flush();
+    if (aborted) {
+        child.rdbuf()->kill(SIGTERM);
+        child.close();
+        return false;
+    }
+    child.close();
+    if (child.rdbuf()->exited() && child.rdbuf()->status() == 0) {
+        if (!job.verify_size || job.size == 0 || job.bytes == job.size) return true;
+        retry = job.bytes < job.size;
+        job.err_msg = "Received " + std::to_string(job.bytes) + " bytes, server published " +
+                      std::to_string(job.size);
+        return false;
+    }
+
+    retry = job.bytes > start_pos || !child.rdbuf()->exited() ||
+            WEXITSTATUS(child.rdbuf()->status()) == WGET_ERR_NETWORK;
+    job.err_msg = "wget exited with status " + std::to_string(WEXITSTATUS(child.rdbuf()->status()));
+    return false;
+}
+
+// Feeds data of an earlier interrupted download through checksum and decompressor
+bool DownloadManager::replay_partial(DownloadJob &job, DecompressSink *sink, const std::string &part_path) {
+    char buffer[READ_BUFFER];
+    struct stat part_stat;
+    std::ifstream part_file(part_path, std::ios::binary);
+
+    if (!part_file.is_open()) return true;     // Nothing to resume
+    if (job.verify_size && job.size > 0 && stat(part_path.c_str(), &part_stat) == 0 &&
+        (uint64) part_stat.st_size > job.size) {
+        FS_dprint("Partial download of " + job.url + " is larger than the published size, starting over");
+        part_file.close();
+        std::remove(part_path.c_str());
+        return true;
+    }
+    while (part_file.read(buffer, READ_BUFFER) || part_file.gcount() > 0) {
+        job.crc32  = crc32_update(job.crc32, buffer, (uint64) part_file.gcount());
+        job.bytes += (uint64) part_file.gcount();
+        if (sink) {
+            sink->process.write(buffer, part_file.gcount());
+            if (sink->consumer_stopped || !sink->process.good()) return false;
+        }
+    }
+    if (job.bytes > 0) FS_dprint("Resuming " + job.url + " from byte " + std::to_string(job.bytes));
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function uint64 DownloadManager::query_size(const std::string &url)
+ *
+ * Description          - Asks the server for the size of a file without
+ *                        downloading it
+ *
+ * Notes                - HTTP Content-Length or FTP SIZE, as reported by
+ *                        wget. Last value is used so redirects are followed
+ *
+ * @param url           - File to query
+ *
+ * @return              - Published size in bytes, 0 if none was published
+ *
+ * =====================================================================
+ */
+uint64 DownloadManager::query_size(const std::string &url) {
+    std::string line;
+    std::string::size_type pos;
+    uint64 size = 0;
+
+    redi::ipstream child("wget --spider -S --tries=1 " + quote_path(url) + " 2>&1", redi::pstreams::pstdout);
+    if (!child.is_open()) return 0;
+    while (std::getline(child, line)) {
+        if ((pos = line.find("Length: ")) != std::string::npos) {
+            pos += 8;
+        } else if (line.find("==> SIZE ") != std::string::npos) {
+            pos = line.find_last_of(' ') + 1;
+        } else {
+            continue;
+        }
+        if (pos < line.size() && std::isdigit((unsigned char) line[pos])) {
+            size = std::strtoull(line.c_str() + pos, nullptr, 10);
+        }
+    }
+    child.close();
+    if (size > 0) {
+        FS_dprint("Server published " + std::to_string(size) + " bytes for: " + url);
+    } else {
+        FS_dprint("Server published no size for: " + url + ", size will not be verified");
+    }
+    return size;
+}
+
+/**
+ * ======================================================================
+ * Function uint32 DownloadManager::crc32_update(uint32 crc, const char *data, uint64 len)
+ *
+ * Description          - Continues a CRC32 (IEEE 802.3, same as gzip/zlib)
+ *                        over another block of data
+ *
+ * Notes                - Start with crc of 0
+ *
+ * @param crc           - CRC of data so far
+ * @param data          - Next block
+ * @param len           - Length of block
+ *
+ * @return              - Updated CRC
+ *
+ * =====================================================================
+ */
+uint32 DownloadManager::crc32_update(uint32 crc, const char *data, uint64 len) {
+    static const std::array<uint32, 256> table = [] {
+        std::array<uint32, 256> crc_table;
+        for (uint32 i = 0; i < 256; i++) {
+            uint32 value = i;
+            for (uint8 bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            crc_table[i] = value;
+        }
+        return crc_table;
+    }();
+
+    crc = ~crc;
+    for (uint64 i = 0; i < len; i++) {
+        crc = table[(crc ^ (uint8) data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// Single quotes path/URL for the shell
+std::string DownloadManager::quote_path(const std::string &path) {
+    std::string quoted = "'";
+    for (char c : path) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
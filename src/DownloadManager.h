@@ -0,0 +1,121 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ENTAP_DOWNLOADMANAGER_H
+#define ENTAP_DOWNLOADMANAGER_H
+
+#include <functional>
+#include <atomic>
+#include "common.h"
+#include "FileSystem.h"
+
+/**
+ * ======================================================================
+ * @class DownloadManager
+ *
+ * Description          - Fetches a set of files concurrently
+ *                      - Compressed bytes are checksummed (CRC32) and piped
+ *                        into the decompressor as they arrive, decompressed
+ *                        data can be streamed straight into a parser
+ *                      - Received size is checked against the size the
+ *                        server publishes, truncated transfers are resumed
+ *                        and oversized data fails the job. Corrupt gzip data
+ *                        fails its trailer CRC in the decompressor
+ *                      - Downloads resume from the partial file (<out>.part)
+ *                        after a dropped connection or an interrupted run
+ *
+ * Notes                - Transport is wget (--start-pos) and decompression
+ *                        is gzip/tar, both already required by configure
+ *                      - Sources publish no CRC32, an expected checksum is
+ *                        only verified if the caller sets one
+ *                      - URLs may point to any HTTP/FTP server, callers take
+ *                        them from FileSystem::get_download_url so a mirror
+ *                        (--data-mirror) can stand in for the sources
+ *
+ * ======================================================================
+ */
+class DownloadManager {
+
+public:
+    // Decompressed data is streamed to the consumer, returning false aborts the download
+    typedef std::function<bool(std::istream&)> stream_consumer_t;
+
+    struct DownloadJob {
+        std::string                url;
+        std::string                out_path;        // Compressed file, partial data kept at <out_path>.part
+        FileSystem::ENT_FILE_TYPES decompress;      // ENT_FILE_GZ, ENT_FILE_TAR_GZ or ENT_FILE_UNUSED (keep as is)
+        std::string                decompress_path; // Output file (GZ) or directory (TAR_GZ)
+        stream_consumer_t          consumer;        // GZ only, used instead of decompress_path if set
+        bool                       verify_checksum;
+        uint32                     checksum;        // Expected CRC32 of compressed file if verify_checksum
+        bool                       verify_size;
+        uint64                     size;            // Expected compressed bytes if verify_size, 0 queries the server
+
+        // Set by DownloadManager
+        bool                       success;
+        bool                       transferred;     // Every byte was received (failure was after download)
+        uint32                     crc32;           // CRC32 of compressed file
+        uint64                     bytes;           // Compressed bytes downloaded (including resumed)
+        std::string                err_msg;
+
+        DownloadJob() : decompress(FileSystem::ENT_FILE_UNUSED), verify_checksum(false),
+                        checksum(0), verify_size(true), size(0), success(false), transferred(false),
+                        crc32(0), bytes(0) {}
+    };
+
+    explicit DownloadManager(uint16 threads);
+    uint64 add_job(const DownloadJob &job);
+    bool run();
+    const DownloadJob &get_job(uint64 index) const;
+    std::string get_error() const;
+
+    static uint32 crc32_update(uint32 crc, const char *data, uint64 len);
+
+private:
+    struct DecompressSink;
+
+    void download(DownloadJob &job);
+    bool transfer(DownloadJob &job, DecompressSink *sink, std::ofstream &part_file, bool &retry);
+    bool replay_partial(DownloadJob &job, DecompressSink *sink, const std::string &part_path);
+    uint64 query_size(const std::string &url);
+    static std::string quote_path(const std::string &path);
+
+    static constexpr uint16 MAX_ATTEMPTS    = 5;            // Attempts per job, each resuming where the last stopped
+    static constexpr uint32 READ_BUFFER     = 1 << 16;
+    static constexpr uint32 RETRY_WAIT_SEC  = 5;            // Multiplied by attempt number
+    static constexpr int    WGET_ERR_NETWORK= 4;            // wget exit status of a network failure
+    const std::string       PART_EXTENSION  = ".part";
+    const std::string       FIFO_EXTENSION  = ".fifo";
+
+    std::vector<DownloadJob> mJobs;
+    uint16                   mThreads;
+};
+
+
+#endif //ENTAP_DOWNLOADMANAGER_H
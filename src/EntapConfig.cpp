@@ -27,10 +27,12 @@
 
 
 //*********************** Includes *****************************
+#include <future>
 #include "EntapConfig.h"
 #include "database/EggnogDatabase.h"
 #include "TerminalCommands.h"
 #include "database/BuscoDatabase.h"
+#include "similarity_search/SubjectIndex.h"
 //**************************************************************
 
 namespace entapConfig {
@@ -47,6 +49,7 @@ namespace entapConfig {
     // ***************** Local Prototype Functions******************
     void init_entap_database();
     void init_diamond_index(std::string &diamond_exe, uint16 threads, vect_str_t &compiled_databases);
+    bool init_subject_index(std::string &fasta_path, std::string &index_path);
     void init_eggnog(uint16 threads, std::string &diamond_exe);
     void init_busco();
     // *************************************************************
@@ -72,6 +75,8 @@ namespace entapConfig {
     void execute_main(UserInput *input, FileSystem *filesystem) {
 
         uint16                             threads;             // supported threads for execution
+        uint16                             eggnog_threads;      // threads for EggNOG, configured concurrently
+        std::string                        err_msg;             // Errors of both configuration branches
         ent_input_str_t                    diamond_exe;         // DIAMOND executable path
         ent_input_multi_str_t              compiled_databases;  // databases input from user
 
@@ -98,13 +103,38 @@ namespace entapConfig {
             compiled_databases = pUserInput->get_user_input<ent_input_multi_str_t>(INPUT_FLAG_DATABASE);
         }
 
-        try {
+        if (pUserInput->has_input(INPUT_FLAG_DATABASE_MIRROR)) {
+            pFileSystem->set_download_mirror(pUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_DATABASE_MIRROR));
+        }
 
-            init_entap_database();
+        // EggNOG indexing overlaps DIAMOND indexing of the user databases, split threads between them
+        eggnog_threads = threads > 1 ? (uint16) (threads / 2) : (uint16) 1;
+        if (threads > 1) threads = (uint16) (threads - eggnog_threads);
 
-            init_diamond_index(diamond_exe, threads, compiled_databases);
+        try {
+            // EggNOG databases do not depend on the EnTAP database, download them alongside
+            std::future<void> eggnog_config = std::async(std::launch::async, [eggnog_threads, &diamond_exe] {
+                init_eggnog(eggnog_threads, diamond_exe);
+            });
+
+            try {
+                init_entap_database();
+
+                init_diamond_index(diamond_exe, threads, compiled_databases);
+            } catch (ExceptionHandler &e) {
+                // Wait for EggNOG so it is not left running and its error is not lost
+                err_msg = e.what();
+                try {
+                    eggnog_config.get();
+                } catch (ExceptionHandler &eggnog_e) {
+                    err_msg += "\nEggNOG configuration also failed:\n" + std::string(eggnog_e.what());
+                } catch (const std::exception &eggnog_e) {
+                    err_msg += "\nEggNOG configuration also failed:\n" + std::string(eggnog_e.what());
+                }
+                throw ExceptionHandler(err_msg, e.getErr_code());
+            }
 
-            init_eggnog(threads, diamond_exe);
+            eggnog_config.get();
 
             init_busco();
 
@@ -140,6 +170,7 @@ namespace entapConfig {
         std::string indexed_path;       // Absolute path to final, DMND indexed database
         std::string std_out;            // Standard output (out, err) from execution
         std::string index_command;      // DMND indexing command
+        std::string subject_index_path; // Absolute path to subject metadata index
         std::stringstream log_msg;      // Message to print to EnTAP log file
 
         if (compiled_databases.empty()) {
@@ -187,12 +218,72 @@ namespace entapConfig {
                 FS_dprint("Database successfully indexed to: " + indexed_path + FileSystem::EXT_DMND);
                 log_msg << "DIAMOND database generated to: " << indexed_path << FileSystem::EXT_DMND << std::endl;
             }
+
+            // Subject metadata index, DIAMOND execution will only need to output sseqid
+            subject_index_path = indexed_path + FileSystem::EXT_SUBJ;
+            if (pFileSystem->file_exists(subject_index_path)) {
+                FS_dprint("Subject index found at " + subject_index_path + ", skipping...");
+                log_msg << "Subject index skipped, exists at: " << subject_index_path << std::endl;
+            } else if (init_subject_index(fasta_path, subject_index_path)) {
+                log_msg << "Subject index generated to: " << subject_index_path << std::endl;
+            } else {
+                log_msg << "WARNING: Subject index not generated for: " << fasta_path <<
+                        "\n\tSubject titles will be pulled from DIAMOND output" << std::endl;
+            }
         } // END FOR
 
+        SAFE_DELETE(pEntapDatabase);
         std::string temp = log_msg.str();
         pFileSystem->print_stats(temp);
     }
 
+    /**
+     * ======================================================================
+     * Function bool init_subject_index(std::string &fasta_path, std::string &index_path)
+     *
+     * Description          - Generates subject metadata index (species, lineage,
+     *                        UniProt accession, contaminant/informative status)
+     *                        for a FASTA database being configured for DIAMOND
+     *
+     * Notes                - Not fatal, DIAMOND parsing falls back to resolving
+     *                        subjects from titles if the index is missing
+     *
+     * @param fasta_path    - Path to FASTA database
+     * @param index_path    - Path to output subject index
+     *
+     * @return              - TRUE if index was generated
+     *
+     * =====================================================================
+     */
+    bool init_subject_index(std::string &fasta_path, std::string &index_path) {
+        SubjectIndex subjectIndex(pFileSystem);
+        vect_str_t   contaminants;
+        vect_str_t   uninformative;
+
+        if (pFileSystem->get_file_extension(fasta_path, false) == ".gz") {
+            FS_dprint("WARNING compressed FASTA database, subject index not generated: " + fasta_path);
+            return false;
+        }
+
+        // EnTAP database is needed to resolve species lineages
+        if (pEntapDatabase == nullptr) {
+            pEntapDatabase = new EntapDatabase(pFileSystem, pUserInput);
+            ent_input_multi_int_t database_types =
+                    pUserInput->get_user_input<ent_input_multi_int_t>(INPUT_FLAG_DATABASE_TYPE);
+            if (database_types.empty() ||
+                !pEntapDatabase->set_database(static_cast<EntapDatabase::DATABASE_TYPE>(database_types[0]))) {
+                FS_dprint("WARNING unable to open EnTAP database, subject index not generated" +
+                          pEntapDatabase->print_error_log());
+                SAFE_DELETE(pEntapDatabase);
+                return false;
+            }
+        }
+
+        contaminants  = pUserInput->get_contaminants();
+        uninformative = pUserInput->get_uninformative_vect();
+        return subjectIndex.generate_index(fasta_path, index_path, pEntapDatabase, contaminants, uninformative);
+    }
+
 
     /**
      * ======================================================================
@@ -217,17 +308,23 @@ namespace entapConfig {
         std::string dmnd_outpath;               // Absolute path to converted FASTA -> DMND
         std::string user_egg_dmnd;              // User input EggNOG DMND database
         std::string user_egg_sql;               // User input EggNOG SQL database
+        std::string sql_path;                   // EggNOG SQL database used for runs
         std::string err_msg;                    // Error mMessage from execution
         std::string index_cmd;                  // DMND indexing command
         std::string std_out;                    // Standard output (err, out) from execution
         std::stringstream log_msg;              // Message to print to EnTAP log file
+        bool need_sql;                          // EggNOG SQL database must be downloaded
+        bool need_dmnd;                         // EggNOG DIAMOND database must be generated
+        std::vector<EggnogDatabase::EGGNOG_DB_TYPES> download_types;
+        vect_str_t download_paths;
 
         FS_dprint("Ensuring EggNOG databases exist...");
 
         pFileSystem->format_stat_stream(log_msg, "EggNOG Database Configuration");
 
         // Generate database to allow downloading
-        EggnogDatabase eggnogDatabase = EggnogDatabase(pFileSystem, pEntapDatabase, nullptr);
+        //  EnTAP database is not needed to configure and is being rebuilt concurrently (do not touch it)
+        EggnogDatabase eggnogDatabase(pFileSystem, nullptr, nullptr);
 
 #if EGGNOG_MAPPER
         std::string eggnog_cmd;
@@ -248,44 +345,62 @@ namespace entapConfig {
 #endif
         // setup outpath
         sql_outpath   = PATHS(dataDir, pUserInput->getEGG_SQL_DB_FILENAME());
-        fasta_outpath = PATHS(pFileSystem->get_temp_outdir(), "eggnog_fasta_temp.fa");
+        fasta_outpath = PATHS(eggnogDatabase.get_temp_directory(), "eggnog_fasta_temp.fa");
         dmnd_outpath  = PATHS(binDir, pUserInput->getEGG_DMND_FILENAME());
         user_egg_dmnd = pUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_EGG_DMND_DB);
         user_egg_sql  = pUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_EGG_SQL_DB);
 
+        need_sql  = !pFileSystem->file_exists(user_egg_sql) && !pFileSystem->file_exists(sql_outpath);
+        need_dmnd = !pFileSystem->file_exists(user_egg_dmnd) && !pFileSystem->file_exists(dmnd_outpath);
+
+        // Missing databases are downloaded together
+        if (need_sql) {
+            download_types.push_back(EggnogDatabase::EGGNOG_SQL);
+            download_paths.push_back(sql_outpath);
+        }
+        if (need_dmnd) {
+            // DIAMOND database is generated from FASTA
+            download_types.push_back(EggnogDatabase::EGGNOG_FASTA);
+            download_paths.push_back(fasta_outpath);
+        }
+        if (!download_types.empty() &&
+            eggnogDatabase.download(download_types, download_paths) != EggnogDatabase::ERR_EGG_OK) {
+            // Error in download
+            err_msg = "Unable to download EggNOG databases from FTP to:\n";
+            for (std::string &path : download_paths) err_msg += path + "\n";
+            err_msg += "Error: " + eggnogDatabase.print_err();
+            throw ExceptionHandler(err_msg,ERR_ENTAP_INIT_EGGNOG);
+        }
+
         // Check if SQL database already exists
-        if (!pFileSystem->file_exists(user_egg_sql) && !pFileSystem->file_exists(sql_outpath)) {
-            // No, path does not. Download it
-            if (eggnogDatabase.download(EggnogDatabase::EGGNOG_SQL, sql_outpath) != EggnogDatabase::ERR_EGG_OK) {
-                // Error in download
-                err_msg = "Unable to download EggNOG sql database from FTP to: " +
-                        sql_outpath + "\nError: " + eggnogDatabase.print_err();
-                throw ExceptionHandler(err_msg,ERR_ENTAP_INIT_EGGNOG);
-            } else {
-                // Downloaded successfully
-                FS_dprint("Success! EggNOG SQL database downloaded to: " + sql_outpath);
-                log_msg << "EggNOG SQL database written to: " + sql_outpath << std::endl;
-            }
+        if (need_sql) {
+            // Downloaded successfully
+            FS_dprint("Success! EggNOG SQL database downloaded to: " + sql_outpath);
+            log_msg << "EggNOG SQL database written to: " + sql_outpath << std::endl;
+            sql_path = sql_outpath;
         } else {
             // Already exists, skip
-            std::string path;
-            if (pFileSystem->file_exists(user_egg_sql)) path = user_egg_sql;
-            if (pFileSystem->file_exists(sql_outpath)) path = sql_outpath;
-            FS_dprint("EggNOG SQL database already exists at: " + path +
+            if (pFileSystem->file_exists(user_egg_sql)) sql_path = user_egg_sql;
+            if (pFileSystem->file_exists(sql_outpath)) sql_path = sql_outpath;
+            FS_dprint("EggNOG SQL database already exists at: " + sql_path +
                 " skipping");
-            log_msg << "EggNOG SQL Database skipped, exists at: " << path << std::endl;
+            log_msg << "EggNOG SQL Database skipped, exists at: " << sql_path << std::endl;
         }
 
-        // Check if DIAMOND EggNOG database exists
-        if (!pFileSystem->file_exists(user_egg_dmnd) && !pFileSystem->file_exists(dmnd_outpath)) {
-            // No, does not exist, need to generate from FASTA
-            if (eggnogDatabase.download(EggnogDatabase::EGGNOG_FASTA, fasta_outpath) != EggnogDatabase::ERR_EGG_OK) {
-                // Error in download
-                err_msg = "Unable to get EggNOG FASTA from FTP to: " +
-                          fasta_outpath + "\nError: " + eggnogDatabase.print_err();
-                throw ExceptionHandler(err_msg,ERR_ENTAP_INIT_EGGNOG);
-            }
+        // Precompile annotations of every seed ortholog, runs fall back to SQL if this fails
+        if (EggnogDatabase::index_current(sql_path)) {
+            FS_dprint("EggNOG index already exists at: " + EggnogDatabase::get_index_path(sql_path));
+            log_msg << "EggNOG index skipped, exists at: " << EggnogDatabase::get_index_path(sql_path) << std::endl;
+        } else if (eggnogDatabase.open_sql(sql_path) != EggnogDatabase::ERR_EGG_OK ||
+                   eggnogDatabase.build_index(threads) != EggnogDatabase::ERR_EGG_OK) {
+            FS_dprint("WARNING unable to generate EggNOG index" + eggnogDatabase.print_err());
+            log_msg << "EggNOG index could not be generated, SQL database will be used" << std::endl;
+        } else {
+            log_msg << "EggNOG index written to: " << EggnogDatabase::get_index_path(sql_path) << std::endl;
+        }
 
+        // Check if DIAMOND EggNOG database exists
+        if (need_dmnd) {
             // Now, index for DIAMOND
             FS_dprint("Success! EggNOG FASTA downloaded, indexing for DIAMOND...");
             log_msg << "EggNOG FASTA database written to: " + fasta_outpath << std::endl;
@@ -342,6 +457,7 @@ namespace entapConfig {
      */
     void init_entap_database() {
         bool              generate_databases;    // Whether user would like to generate rather than download
+        ent_input_multi_str_t deltas;            // Delta files to apply to existing databases
         vect_uint16_t     databases;             // User defined types of databases to configure (SQL or Bin)
         std::string       config_outpath;        // Path to check against (from config file)
         std::string       database_outpath;      // Path to print to (also acts as default path)
@@ -359,6 +475,9 @@ namespace entapConfig {
 
         // If user would like to generate databases rather than download them from ftp(default)
         generate_databases = pUserInput->has_input(INPUT_FLAG_DATABASE_GENERATE);
+        if (pUserInput->has_input(INPUT_FLAG_DATABASE_DELTA)) {
+            deltas = pUserInput->get_user_input<ent_input_multi_str_t>(INPUT_FLAG_DATABASE_DELTA);
+        }
 
         // Check which databases they want (will always have this input, default = 0)
         databases = pUserInput->get_user_input<ent_input_multi_int_t>(INPUT_FLAG_DATABASE_TYPE);
@@ -383,6 +502,12 @@ namespace entapConfig {
                     database_outpath = PATHS(rootDir, pUserInput->getENTAP_DATABASE_SQL_DEFAULT());
                     break;
 
+                case EntapDatabase::ENTAP_MAPPED:
+                    FS_dprint("Generating/downloading Memory Mapped database");
+                    config_outpath   = pUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_ENTAP_DB_MAPPED);
+                    database_outpath = PATHS(rootDir, pUserInput->getENTAP_DATABASE_MAPPED_DEFAULT());
+                    break;
+
                 default:
                     FS_dprint("WARNING Unrecognized database code: " + std::to_string(data));
                     continue;
@@ -394,8 +519,26 @@ namespace entapConfig {
                 if (pFileSystem->file_exists(config_outpath)) path = config_outpath;
                 if (pFileSystem->file_exists(database_outpath)) path = database_outpath;
                 FS_dprint("File already exists at: " + path);
-                log_msg << "Database skipped, already exists at: " << path << std::endl;
-                continue; // Don't redownload
+                if (deltas.empty()) {
+                    log_msg << "Database skipped, already exists at: " << path << std::endl;
+                    continue; // Don't redownload
+                }
+                if (database_type != EntapDatabase::ENTAP_SERIALIZED) {
+                    FS_dprint("WARNING deltas can only be applied to the serialized database, skipping");
+                    log_msg << "Database skipped, deltas are only supported by the serialized database: " <<
+                            path << std::endl;
+                    continue;
+                }
+                // Refresh existing database rather than generating it again
+                for (std::string &delta : deltas) {
+                    database_err = pEntapDatabase->apply_delta(database_type, path, delta);
+                    if (database_err != EntapDatabase::ERR_DATA_OK) {
+                        throw ExceptionHandler(pEntapDatabase->print_error_log(), ERR_ENTAP_INIT_DATA_GENERIC);
+                    }
+                    log_msg << "Delta " << delta << " applied to: " << path << std::endl;
+                }
+                log_msg << "Database revision: " << pEntapDatabase->get_revision() << std::endl;
+                continue;
             }
 
             // Need to generate/download file!
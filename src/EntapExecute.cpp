@@ -43,6 +43,7 @@ namespace entapExecute {
     void verify_state(std::queue<char> &queue, bool test);
     bool valid_state(enum ExecuteStates current_state);
     void exit_error(ExecuteStates exiting_state);
+    void track_database_revision(EntapDatabase *entap_database, bool reannotate);
     //**************************************************************
 
 /**
@@ -134,6 +135,8 @@ namespace entapExecute {
                                        pEntap_Database->print_error_log(), ERR_ENTAP_READ_ENTAP_DATA_GENERIC);
             }
 
+            track_database_revision(pEntap_Database, pUserInput->has_input(INPUT_FLAG_REANNOTATE));
+
             // Compile all data pointers needed during execution
             entap_data_ptrs.mpEntapDatabase = pEntap_Database;
             entap_data_ptrs.mpFileSystem   = filesystem;
@@ -300,6 +303,57 @@ namespace entapExecute {
         }
     }
 
+    /**
+     * ======================================================================
+     * Function track_database_revision(EntapDatabase *entap_database, bool reannotate)
+     *
+     * Description          - Records the EnTAP database revision used by this
+     *                        run in the output directory
+     *                      - When re-annotating, reports the database records
+     *                        changed (by deltas) since the previous run
+     *
+     * Notes                - A previous run without a recorded revision is
+     *                        treated as revision 0
+     *
+     * @param entap_database - EnTAP database in use
+     * @param reannotate    - True if re-annotating a previous run
+     * @return              - None
+     * ======================================================================
+     */
+    void track_database_revision(EntapDatabase *entap_database, bool reannotate) {
+        std::string       revision_path;
+        std::stringstream log_msg;
+        uint32            previous_revision=0;
+        uint32            revision;
+
+        revision_path = PATHS(pFileSystem->get_root_path(), DATABASE_REVISION_FILE);
+        revision      = entap_database->get_revision();
+
+        if (reannotate) {
+            std::ifstream in_file(revision_path);
+            if (!(in_file >> previous_revision)) previous_revision = 0;
+            in_file.close();
+
+            pFileSystem->format_stat_stream(log_msg, "Re-annotation");
+            log_msg <<
+                    "Previous EnTAP database revision: " << previous_revision <<
+                    "\nCurrent EnTAP database revision: " << revision <<
+                    "\nTaxonomy records changed: " <<
+                    entap_database->get_changed_count(EntapDatabase::ENTAP_TAXONOMY, previous_revision) <<
+                    "\nGene Ontology records changed: " <<
+                    entap_database->get_changed_count(EntapDatabase::ENTAP_GENE_ONTOLOGY, previous_revision) <<
+                    "\nUniProt records changed: " <<
+                    entap_database->get_changed_count(EntapDatabase::ENTAP_UNIPROT, previous_revision) <<
+                    "\nPrevious similarity search and ontology results are reused" << std::endl;
+            std::string out_msg = log_msg.str();
+            pFileSystem->print_stats(out_msg);
+        }
+
+        std::ofstream out_file(revision_path, std::ios::trunc);
+        out_file << revision << std::endl;
+        out_file.close();
+    }
+
     /**
      * ======================================================================
      * Function verify_state(std::queue<char> &queue, bool &test)
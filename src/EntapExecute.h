@@ -49,6 +49,7 @@ namespace entapExecute {
     const std::string TRANSCRIPTOME_FINAL_TAG = "_final.fasta";
     const std::string TRANSCRIPTOME_FRAME_TAG = "_frame_selected.fasta";
     const std::string TRANSCRIPTOME_FILTERED_TAG = "_expression_filtered.fasta";
+    const std::string DATABASE_REVISION_FILE = "entap_database_revision.txt";  // Revision used by last run (re-annotation)
     //**************************************************************
 
 
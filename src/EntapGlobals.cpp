@@ -31,19 +31,17 @@
 //**************************************************************
 
 // For C++11 use std::to_string(arg)
+// Formatted without a stream, called for every output row
 std::string float_to_string(fp64 val) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << val;
-    return ss.str();
+    char buffer[320];   // Fits any fp64 in fixed notation
+    int len = snprintf(buffer, sizeof(buffer), "%.2f", val);
+    return std::string(buffer, (size_t) std::min(len, (int) sizeof(buffer) - 1));
 }
 
 std::string float_to_sci(fp64 val, int precision) {
-    std::stringstream ss;
-    ss << std::fixed <<
-          std::setprecision(precision) <<
-          std::scientific              <<
-          val;
-    return ss.str();
+    char buffer[64];
+    int len = snprintf(buffer, sizeof(buffer), "%.*e", precision, val);
+    return std::string(buffer, (size_t) std::min(len, (int) sizeof(buffer) - 1));
 }
 
 vect_str_t split_string(std::string sequences, char delim) {
@@ -63,11 +61,15 @@ vect_str_t split_string(std::string sequences, char delim) {
 std::string get_cur_time() {
     std::chrono::time_point<std::chrono::system_clock> current;
     std::time_t time;
+    std::tm local_tm{};
+    char out_time[32];
 
     current = std::chrono::system_clock::now();
     time = std::chrono::system_clock::to_time_t(current);
-    std::string out_time(std::ctime(&time));
-    return out_time.substr(0,out_time.length()-1);
+    // localtime_r rather than ctime, called from several threads during configuration
+    localtime_r(&time, &local_tm);
+    std::strftime(out_time, sizeof(out_time), "%a %b %e %H:%M:%S %Y", &local_tm);
+    return std::string(out_time);
 }
 
 std::string &ltrim(std::string &s) {
@@ -97,21 +97,9 @@ EntapModule::EntapModule(std::string &execution_stage_path, std::string &in_hits
 }
 
 
-go_format_t EntapModule::EM_parse_go_list(std::string list, EntapDatabase* database,char delim) {
-
-    go_format_t output;
-    std::string temp;
-    std::vector<std::vector<std::string>>results;
-
-    if (list.empty()) return output;
-    std::istringstream ss(list);
-    while (std::getline(ss,temp,delim)) {
-        GoEntry term_info =
-                database->get_go_entry(temp);
-        output[term_info.category].push_back(temp + "-" + term_info.term +
-                                             "(L=" + term_info.level + ")");
-    }
-    return output;
+GoTermTable::GoTermSet EntapModule::EM_parse_go_list(std::string list, EntapDatabase* database,char delim) {
+    // Terms not found in the database are kept (uncategorized) so they still count as GO hits
+    return database->intern_go_terms(list, delim, true);
 }
 
 void EntapModule::enable_headers() {
@@ -29,6 +29,7 @@
 #include "ExceptionHandler.h"
 #include <sys/stat.h>
 #include "config.h"
+#include <mutex>
 
 #ifdef USE_BOOST
 #include <boost/date_time/posix_time/ptime.hpp>
@@ -39,6 +40,9 @@
 #include <zconf.h>
 #endif
 
+// Debug and log files may be written from configuration threads
+static std::mutex fs_print_mutex;
+
 const std::string FileSystem::EXT_TXT  = ".txt";
 const std::string FileSystem::EXT_ERR  = ".err";
 const std::string FileSystem::EXT_OUT  = ".out";
@@ -48,6 +52,7 @@ const std::string FileSystem::EXT_FAA  = ".faa";
 const std::string FileSystem::EXT_FNN  = ".fnn";
 const std::string FileSystem::EXT_XML  = ".xml";
 const std::string FileSystem::EXT_DMND = ".dmnd";
+const std::string FileSystem::EXT_SUBJ = ".subj";
 const std::string FileSystem::EXT_STD  = "_std";
 const std::string FileSystem::EXT_TSV  = ".tsv";
 const std::string FileSystem::EXT_CSV  = ".csv";
@@ -84,6 +89,7 @@ FileSystem::FileSystem() {
     mFinalOutpath = "";
     mTrancriptomeDir = "";
     mTempOutpath = "";
+    mDownloadMirror = "";
 
     FS_dprint("Spawn Object - FileSystem");
     set_executable_dir();
@@ -130,6 +136,7 @@ void FileSystem::close_file(std::ofstream &ofstream) {
  * =====================================================================
  */
 void FS_dprint(const std::string &msg) {
+    std::lock_guard<std::mutex> lock(fs_print_mutex);
     std::ofstream debug_file(DEBUG_FILE_PATH, std::ios::out | std::ios::app);
 
     debug_file << get_cur_time() << ": " + msg << std::endl;
@@ -151,6 +158,7 @@ void FS_dprint(const std::string &msg) {
  * =====================================================================
  */
 void FileSystem::print_stats(std::string &msg) {
+    std::lock_guard<std::mutex> lock(fs_print_mutex);
     std::ofstream log_file(mLogFilePath, std::ios::out | std::ios::app);
     log_file << msg << std::endl;
     close_file(log_file);
@@ -774,6 +782,7 @@ bool FileSystem::download_ftp_file(std::string ftp_path, std::string& out_path)
     terminalData.base_std_path = "";
 
 
+    ftp_path = get_download_url(ftp_path);
     FS_dprint("Downloading FTP file at: " + ftp_path);
 
 #ifdef USE_CURL
@@ -822,6 +831,40 @@ bool FileSystem::download_ftp_file(std::string ftp_path, std::string& out_path)
 #endif
 }
 
+void FileSystem::set_download_mirror(const std::string &mirror) {
+    mDownloadMirror = mirror;
+    while (!mDownloadMirror.empty() && mDownloadMirror.back() == '/') mDownloadMirror.pop_back();
+    FS_dprint("Downloads will be fetched from mirror: " + mDownloadMirror);
+}
+
+/**
+ * ======================================================================
+ * Function std::string FileSystem::get_download_url(const std::string &url)
+ *
+ * Description          - Returns the URL a file should be downloaded from,
+ *                        moved under the download mirror if one was set
+ *                      - Host is kept as the first directory, the same
+ *                        layout a recursive wget mirror creates
+ *                        (ftp://host/path -> <mirror>/host/path)
+ *
+ * Notes                - Mirror may be a local server standing in for the
+ *                        public sources
+ *
+ * @param url           - Published URL of the file
+ *
+ * @return              - URL to download from
+ *
+ * =====================================================================
+ */
+std::string FileSystem::get_download_url(const std::string &url) const {
+    std::string::size_type host_start;
+
+    if (mDownloadMirror.empty()) return url;
+    host_start = url.find("://");
+    host_start = host_start == std::string::npos ? 0 : host_start + 3;
+    return mDownloadMirror + "/" + url.substr(host_start);
+}
+
 bool FileSystem::decompress_file(std::string &in_path, std::string &out_dir, ENT_FILE_TYPES type) {
     TerminalData terminalData;
     clear_error();
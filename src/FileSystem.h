@@ -130,6 +130,8 @@ public:
     std::string get_trancriptome_dir();
 
     bool download_ftp_file(std::string,std::string&);
+    void set_download_mirror(const std::string &mirror);
+    std::string get_download_url(const std::string &url) const;
     bool decompress_file(std::string &in_path, std::string &out_dir, ENT_FILE_TYPES);
     bool is_url(std::string &url);
 
@@ -144,6 +146,7 @@ public:
     static const std::string EXT_FAA ;
     static const std::string EXT_FNN ;
     static const std::string EXT_DMND;
+    static const std::string EXT_SUBJ;
     static const std::string EXT_XML;
     static const std::string EXT_STD;
     static const std::string EXT_TSV;
@@ -187,6 +190,7 @@ private:
     std::string mExeDirectory;    // Directory of the EnTAP executable
     std::string mOriginalWorkingDir;     // Original working directory;
     std::string mCurrentWorkingDir;      // Current working directory
+    std::string mDownloadMirror;         // Base URL replacing the host of every download, empty if none
     //**********************************************************
 };
 
@@ -0,0 +1,235 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "KeywordMatcher.h"
+
+constexpr int32  KeywordMatcher::NO_MATCH;
+constexpr uint32 KeywordMatcher::ROOT_STATE;
+
+KeywordMatcher::KeywordMatcher() {
+    set_keywords(vect_str_t());
+}
+
+KeywordMatcher::KeywordMatcher(const vect_str_t &keywords) {
+    set_keywords(keywords);
+}
+
+/**
+ * ======================================================================
+ * Function void KeywordMatcher::set_keywords(const vect_str_t &keywords)
+ *
+ * Description          - Compiles keywords into the automaton, replacing
+ *                        any previous keywords
+ *
+ * Notes                - Trie is built first, failure links are then
+ *                        resolved breadth first into full transitions
+ *
+ * @param keywords      - Keywords to match
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void KeywordMatcher::set_keywords(const vect_str_t &keywords) {
+    std::vector<uint32> fail_links;
+    std::queue<uint32>  state_queue;
+    uint32              state;
+    uint32              next;
+    uint32              fail;
+    uint64              ind;
+
+    mKeywords = keywords;
+
+    // Each distinct (case folded) character of the keywords gets a class
+    std::fill(mCharClass, mCharClass + 256, (uint16) 0);
+    mAlphabetSize = 1;
+    for (const std::string &keyword : mKeywords) {
+        for (char c : keyword) {
+            uint8 lower = (uint8) std::tolower((uint8) c);
+            if (mCharClass[lower] == 0) {
+                mCharClass[lower] = mAlphabetSize++;
+                mCharClass[(uint8) std::toupper(lower)] = mCharClass[lower];
+            }
+        }
+    }
+
+    // Trie, 0 transition means none yet (root can never be a child)
+    mTransitions.assign(mAlphabetSize, ROOT_STATE);
+    mStateKeywords.assign(1, std::vector<uint32>());
+    for (uint32 i = 0; i < mKeywords.size(); i++) {
+        state = ROOT_STATE;
+        for (char c : mKeywords[i]) {
+            ind = (uint64) state * mAlphabetSize + mCharClass[(uint8) c];
+            if (mTransitions[ind] == ROOT_STATE) {
+                mTransitions[ind] = (uint32) mStateKeywords.size();
+                mStateKeywords.emplace_back();
+                mTransitions.resize(mTransitions.size() + mAlphabetSize, ROOT_STATE);
+            }
+            state = mTransitions[ind];
+        }
+        mStateKeywords[state].push_back(i);
+    }
+
+    fail_links.assign(mStateKeywords.size(), ROOT_STATE);
+    mOutputLinks.assign(mStateKeywords.size(), ROOT_STATE);
+    mFirstKeyword.assign(mStateKeywords.size(), NO_MATCH);
+    if (!mStateKeywords[ROOT_STATE].empty()) mFirstKeyword[ROOT_STATE] = (int32) mStateKeywords[ROOT_STATE][0];
+
+    // Depth one states fail to root
+    for (uint16 c = 0; c < mAlphabetSize; c++) {
+        next = mTransitions[c];
+        if (next != ROOT_STATE) state_queue.push(next);
+    }
+
+    // Breadth first, every state's failure link is resolved before its children
+    while (!state_queue.empty()) {
+        state = state_queue.front();
+        state_queue.pop();
+
+        fail = fail_links[state];
+        mOutputLinks[state] = mStateKeywords[fail].empty() ? mOutputLinks[fail] : fail;
+        mFirstKeyword[state] = mFirstKeyword[fail];
+        if (!mStateKeywords[state].empty() &&
+            (mFirstKeyword[state] == NO_MATCH || (int32) mStateKeywords[state][0] < mFirstKeyword[state])) {
+            mFirstKeyword[state] = (int32) mStateKeywords[state][0];
+        }
+
+        for (uint16 c = 0; c < mAlphabetSize; c++) {
+            ind = (uint64) state * mAlphabetSize + c;
+            next = mTransitions[ind];
+            if (next != ROOT_STATE) {
+                fail_links[next] = mTransitions[(uint64) fail * mAlphabetSize + c];
+                state_queue.push(next);
+            } else {
+                mTransitions[ind] = mTransitions[(uint64) fail * mAlphabetSize + c];
+            }
+        }
+    }
+}
+
+/**
+ * ======================================================================
+ * Function bool KeywordMatcher::contains_any(const std::string &text)
+ *
+ * Description          - Returns whether any keyword is found within text
+ *
+ * Notes                - Stops at first match
+ *
+ * @param text          - Text to search
+ *
+ * @return              - TRUE if a keyword was found
+ *
+ * =====================================================================
+ */
+bool KeywordMatcher::contains_any(const std::string &text) const {
+    uint32 state = ROOT_STATE;
+
+    if (mFirstKeyword[ROOT_STATE] != NO_MATCH) return true;
+    for (char c : text) {
+        state = get_next_state(state, c);
+        if (mFirstKeyword[state] != NO_MATCH) return true;
+    }
+    return false;
+}
+
+/**
+ * ======================================================================
+ * Function int32 KeywordMatcher::find_first_keyword(const std::string &text)
+ *
+ * Description          - Returns the lowest index (input order) of the
+ *                        keywords found within text
+ *
+ * Notes                - Same result as checking each keyword in order with
+ *                        std::string::find
+ *
+ * @param text          - Text to search
+ *
+ * @return              - Keyword index, NO_MATCH if none found
+ *
+ * =====================================================================
+ */
+int32 KeywordMatcher::find_first_keyword(const std::string &text) const {
+    uint32 state = ROOT_STATE;
+    int32  first = mFirstKeyword[ROOT_STATE];
+
+    for (char c : text) {
+        if (first == 0) break;      // Can't do any better
+        state = get_next_state(state, c);
+        if (mFirstKeyword[state] != NO_MATCH && (first == NO_MATCH || mFirstKeyword[state] < first)) {
+            first = mFirstKeyword[state];
+        }
+    }
+    return first;
+}
+
+/**
+ * ======================================================================
+ * Function void KeywordMatcher::find_keywords(const std::string &text,
+ *                                             std::vector<uint32> &keyword_indices)
+ *
+ * Description          - Returns indices of every keyword found within text
+ *
+ * Notes                - Indices are unique and sorted
+ *
+ * @param text            - Text to search
+ * @param keyword_indices - Found keyword indices (cleared first)
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void KeywordMatcher::find_keywords(const std::string &text, std::vector<uint32> &keyword_indices) const {
+    uint32 state = ROOT_STATE;
+    uint32 output;
+
+    keyword_indices.clear();
+    keyword_indices.insert(keyword_indices.end(), mStateKeywords[ROOT_STATE].begin(),
+                           mStateKeywords[ROOT_STATE].end());
+    for (char c : text) {
+        state = get_next_state(state, c);
+        if (mFirstKeyword[state] == NO_MATCH) continue;
+        for (output = state; output != ROOT_STATE; output = mOutputLinks[output]) {
+            keyword_indices.insert(keyword_indices.end(), mStateKeywords[output].begin(),
+                                   mStateKeywords[output].end());
+        }
+    }
+    std::sort(keyword_indices.begin(), keyword_indices.end());
+    keyword_indices.erase(std::unique(keyword_indices.begin(), keyword_indices.end()), keyword_indices.end());
+}
+
+const std::string &KeywordMatcher::get_keyword(uint32 index) const {
+    return mKeywords.at(index);
+}
+
+const vect_str_t &KeywordMatcher::get_keywords() const {
+    return mKeywords;
+}
+
+uint32 KeywordMatcher::get_keyword_count() const {
+    return (uint32) mKeywords.size();
+}
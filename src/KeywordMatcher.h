@@ -0,0 +1,83 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_KEYWORDMATCHER_H
+#define ENTAP_KEYWORDMATCHER_H
+
+#include "common.h"
+
+/**
+ * ======================================================================
+ * @class KeywordMatcher
+ *
+ * Description          - Case insensitive (ASCII) matching of a list of
+ *                        keywords against free text
+ *                      - Keywords are compiled once into an Aho-Corasick
+ *                        automaton with a dense transition table, text is
+ *                        scanned in a single pass without copies
+ *                      - Keyword indices follow the order of the input list
+ *
+ * Notes                - Empty keywords match any text (same as std::string::find)
+ *
+ * ======================================================================
+ */
+class KeywordMatcher {
+
+public:
+    static constexpr int32 NO_MATCH = -1;
+
+    KeywordMatcher();
+    explicit KeywordMatcher(const vect_str_t &keywords);
+    ~KeywordMatcher() = default;
+
+    void set_keywords(const vect_str_t &keywords);
+    bool contains_any(const std::string &text) const;
+    int32 find_first_keyword(const std::string &text) const;
+    void find_keywords(const std::string &text, std::vector<uint32> &keyword_indices) const;
+    const std::string &get_keyword(uint32 index) const;
+    const vect_str_t &get_keywords() const;
+    uint32 get_keyword_count() const;
+
+private:
+    static constexpr uint32 ROOT_STATE = 0;
+
+    uint32 get_next_state(uint32 state, char c) const {
+        return mTransitions[(uint64) state * mAlphabetSize + mCharClass[(uint8) c]];
+    }
+
+    vect_str_t                          mKeywords;
+    uint16                              mAlphabetSize;      // Character classes, 0 = not in any keyword
+    uint16                              mCharClass[256];    // Byte to character class (case folded)
+    std::vector<uint32>                 mTransitions;       // state * mAlphabetSize + class
+    std::vector<int32>                  mFirstKeyword;      // Lowest keyword ending at state or its suffixes
+    std::vector<std::vector<uint32>>    mStateKeywords;     // Keywords ending exactly at state
+    std::vector<uint32>                 mOutputLinks;       // Nearest suffix state with keywords (ROOT_STATE if none)
+};
+
+
+#endif //ENTAP_KEYWORDMATCHER_H
@@ -112,7 +112,13 @@ void Ontology::execute() {
         for (uint16 software : mSoftwareFlags) {
             ptr = spawn_object(software);
             verify_data = ptr->verify_files();
-            if (!verify_data.files_exist) ptr->execute();
+            if (!verify_data.files_exist) {
+                if (mpUserInput->has_input(INPUT_FLAG_REANNOTATE)) {
+                    throw ExceptionHandler("Unable to re-annotate, previous ontology results not found in: " +
+                                           mOntologyDir, ERR_ENTAP_INPUT_PARSE);
+                }
+                ptr->execute();
+            }
             ptr->parse();
             ptr->set_success_flags();
             ptr.reset();
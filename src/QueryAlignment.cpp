@@ -34,10 +34,10 @@
 //**********************************************************************
 //**********************************************************************
 
-QueryAlignment::QueryAlignment(ExecuteStates state, uint16 software, std::string &database_path, QuerySequence* parent) {
+QueryAlignment::QueryAlignment(ExecuteStates state, uint16 software, StringInterner::handle_t database, QuerySequence* parent) {
     mExecutionState = state;
     mSoftwareModule = software;
-    mDatabasePath   = database_path;
+    mDatabaseHandle = database;
     mpParentSequence= parent;
     mCompareOverallAlignment = false;
 
@@ -56,12 +56,8 @@ void QueryAlignment::get_all_header_data(std::string *headers) {
 }
 
 void QueryAlignment::get_header_data(ENTAP_HEADERS header, std::string &val, uint8 lvl) {
-    std::vector<std::string> go_list;
-
     if (ALIGN_OUTPUT_MAP.find(header) != ALIGN_OUTPUT_MAP.end()) {
-        if (is_go_header(header, go_list)) {
-            val = mpParentSequence->format_go_info(go_list, lvl);
-        } else {
+        if (!format_go_header(header, lvl, val)) {
             val = *ALIGN_OUTPUT_MAP[header];
         }
     } else {
@@ -79,8 +75,12 @@ ExecuteStates QueryAlignment::getMExecutionState() const {
     return mExecutionState;
 }
 
-std::string &QueryAlignment::getMDatabasePath() {
-    return mDatabasePath;
+const std::string &QueryAlignment::getMDatabasePath() const {
+    return StringInterner::get(mDatabaseHandle);
+}
+
+StringInterner::handle_t QueryAlignment::getMDatabaseHandle() const {
+    return mDatabaseHandle;
 }
 
 
@@ -91,116 +91,242 @@ std::string &QueryAlignment::getMDatabasePath() {
 //**********************************************************************
 
 
+const std::vector<ENTAP_HEADERS> SimSearchAlignment::SIM_SEARCH_HEADERS = {
+        ENTAP_HEADER_QUERY,
+        ENTAP_HEADER_SIM_SUBJECT,
+        ENTAP_HEADER_SIM_PERCENT,
+        ENTAP_HEADER_SIM_ALIGN_LEN,
+        ENTAP_HEADER_SIM_MISMATCH,
+        ENTAP_HEADER_SIM_GAP_OPEN,
+        ENTAP_HEADER_SIM_QUERY_E,
+        ENTAP_HEADER_SIM_QUERY_S,
+        ENTAP_HEADER_SIM_SUBJ_S,
+        ENTAP_HEADER_SIM_SUBJ_E,
+        ENTAP_HEADER_SIM_E_VAL,
+        ENTAP_HEADER_SIM_COVERAGE,
+        ENTAP_HEADER_SIM_TITLE,
+        ENTAP_HEADER_SIM_SPECIES,
+        ENTAP_HEADER_SIM_TAXONOMIC_LINEAGE,
+        ENTAP_HEADER_SIM_DATABASE,
+        ENTAP_HEADER_SIM_CONTAM,
+        ENTAP_HEADER_SIM_INFORM,
+        ENTAP_HEADER_SIM_UNI_DATA_XREF,
+        ENTAP_HEADER_SIM_UNI_COMMENTS
+};
+
+const std::string SimSearchAlignment::YES_FLAG = "Yes";
+const std::string SimSearchAlignment::NO_FLAG  = "No";
+
 /**
  * ======================================================================
- * Function void QuerySequence::set_tax_score(std::string input_lineage)
+ * Function fp32 SimSearchAlignment::calculate_tax_score(const tax_path_t &lineage_path,
+ *                                      const tax_path_t &input_lineage_path, bool is_informative)
  *
- * Description          - Sets tax score based on informativeness and
+ * Description          - Calculates tax score based on informativeness and
  *                        lineage
+ *                      - Lineage score is the depth of the lowest common
+ *                        ancestor of the hit and input species (root excluded)
  *
- * Notes                - None
+ * Notes                - Calculated once per hit as it is added to the hit store
+ *                      - Paths share a prefix up to the common ancestor, so
+ *                        its depth is found with a binary search
  *
- * @param lineage       - Lineage input from  user
+ * @param lineage_path       - Lineage path of the hit
+ * @param input_lineage_path - Lineage path of species input from user
+ * @param is_informative     - Whether the hit is informative
  *
- * @return              - None
+ * @return              - Tax score
  *
  * =====================================================================
  */
-void SimSearchAlignment::set_tax_score(std::string &input_lineage) {
-    float tax_score = 0;
-    std::string lineage = this->_sim_search_results.lineage;
-    std::remove_if(lineage.begin(),lineage.end(), ::isspace);
-    std::remove_if(input_lineage.begin(),input_lineage.end(), ::isspace);
-
-    std::string temp;
-    size_t p = 0;std::string del = ";";
-    while ((p = lineage.find(';'))!=std::string::npos) {
-        temp = lineage.substr(0,p);
-        if (input_lineage.find(temp)!=std::string::npos) tax_score++;
-        lineage.erase(0,p+del.length());
+fp32 SimSearchAlignment::calculate_tax_score(const tax_path_t &lineage_path, const tax_path_t &input_lineage_path,
+                                             bool is_informative) {
+    float  tax_score = 0;
+    uint64 shared;      // Number of ancestors shared (including root)
+    uint64 upper;
+    uint64 mid;
+
+    shared = 0;
+    upper  = std::min(lineage_path.size(), input_lineage_path.size());
+    while (shared < upper) {
+        mid = (shared + upper + 1) / 2;
+        if (lineage_path[mid - 1] == input_lineage_path[mid - 1]) {
+            shared = mid;
+        } else {
+            upper = mid - 1;
+        }
     }
+    if (shared > 1) tax_score = (float) (shared - 1);
+
     if (tax_score == 0) {
-        if(this->_sim_search_results.is_informative) tax_score += INFORM_ADD;
+        if(is_informative) tax_score += INFORM_ADD;
     } else {
-        if (this->_sim_search_results.is_informative) tax_score *= INFORM_FACTOR;
+        if (is_informative) tax_score *= INFORM_FACTOR;
     }
-    this->_sim_search_results.tax_score = tax_score;
+    return tax_score;
 }
 
 
-SimSearchAlignment::SimSearchAlignment(ExecuteStates state, uint16 software, std::string &database_path, QuerySequence* parent,
-                                       QuerySequence::SimSearchResults d, std::string &lineage)
-    : QueryAlignment(state, software, database_path, parent){
-    _sim_search_results = d;
-    set_tax_score(lineage);
+SimSearchAlignment::SimSearchAlignment(ExecuteStates state, uint16 software, QuerySequence* parent,
+                                       SimSearchHitStore *store, uint32 row)
+    : QueryAlignment(state, software, store->get_database_handle(), parent){
+    mpHitStore = store;
+    mRow       = row;
+}
 
-    ALIGN_OUTPUT_MAP = {
-            {ENTAP_HEADER_QUERY               , &_sim_search_results.qseqid},
-            {ENTAP_HEADER_SIM_SUBJECT         , &_sim_search_results.sseqid},
-            {ENTAP_HEADER_SIM_PERCENT         , &_sim_search_results.pident},
-            {ENTAP_HEADER_SIM_ALIGN_LEN       , &_sim_search_results.length},
-            {ENTAP_HEADER_SIM_MISMATCH        , &_sim_search_results.mismatch},
-            {ENTAP_HEADER_SIM_GAP_OPEN        , &_sim_search_results.gapopen},
-            {ENTAP_HEADER_SIM_QUERY_E         , &_sim_search_results.qend},
-            {ENTAP_HEADER_SIM_QUERY_S         , &_sim_search_results.qstart},
-            {ENTAP_HEADER_SIM_SUBJ_S          , &_sim_search_results.sstart},
-            {ENTAP_HEADER_SIM_SUBJ_E          , &_sim_search_results.send},
-            {ENTAP_HEADER_SIM_E_VAL           , &_sim_search_results.e_val},
-            {ENTAP_HEADER_SIM_COVERAGE        , &_sim_search_results.coverage},
-            {ENTAP_HEADER_SIM_TITLE           , &_sim_search_results.stitle},
-            {ENTAP_HEADER_SIM_SPECIES         , &_sim_search_results.species},
-            {ENTAP_HEADER_SIM_TAXONOMIC_LINEAGE, &_sim_search_results.lineage},
-            {ENTAP_HEADER_SIM_DATABASE        , &_sim_search_results.database_path},
-            {ENTAP_HEADER_SIM_CONTAM          , &_sim_search_results.yes_no_contam},
-            {ENTAP_HEADER_SIM_INFORM          , &_sim_search_results.yes_no_inform},
-            {ENTAP_HEADER_SIM_UNI_DATA_XREF   , &_sim_search_results.uniprot_info.database_x_refs},
-            {ENTAP_HEADER_SIM_UNI_COMMENTS    , &_sim_search_results.uniprot_info.comments},
-            {ENTAP_HEADER_SIM_UNI_GO_CELL     , nullptr},
-            {ENTAP_HEADER_SIM_UNI_GO_BIO      , nullptr},
-            {ENTAP_HEADER_SIM_UNI_GO_MOLE     , nullptr}
-    };
+bool SimSearchAlignment::is_contaminant() const {
+    return mpHitStore->is_contaminant(mRow);
+}
+
+bool SimSearchAlignment::is_informative() const {
+    return mpHitStore->is_informative(mRow);
+}
+
+const std::string &SimSearchAlignment::get_species() const {
+    return mpHitStore->get_species(mRow);
+}
+
+const std::string &SimSearchAlignment::get_contam_type() const {
+    return mpHitStore->get_contam_type(mRow);
 }
 
-QuerySequence::SimSearchResults* SimSearchAlignment::get_results() {
-    return &_sim_search_results;
+const UniprotEntry *SimSearchAlignment::get_uniprot_entry() const {
+    return mpHitStore->get_uniprot_entry(mRow);
+}
+
+/**
+ * ======================================================================
+ * Function bool SimSearchAlignment::format_header(ENTAP_HEADERS header, std::string &val)
+ *
+ * Description          - Formats typed hit store data for output
+ *
+ * Notes                - Only called by writers, hit data is never stored
+ *                        as text
+ *
+ * @param header        - Header to format
+ * @param val           - Output formatted value
+ *
+ * @return              - True if header applies to Similarity Search
+ *
+ * =====================================================================
+ */
+bool SimSearchAlignment::format_header(ENTAP_HEADERS header, std::string &val) {
+    const UniprotEntry *uniprot_entry;
+
+    switch (header) {
+        case ENTAP_HEADER_QUERY:
+            val = mpParentSequence->getMSequenceID();
+            break;
+        case ENTAP_HEADER_SIM_SUBJECT:
+            val = mpHitStore->get_sseqid(mRow);
+            break;
+        case ENTAP_HEADER_SIM_PERCENT:
+            val = float_to_string(mpHitStore->get_pident(mRow));
+            break;
+        case ENTAP_HEADER_SIM_ALIGN_LEN:
+            val = std::to_string(mpHitStore->get_length(mRow));
+            break;
+        case ENTAP_HEADER_SIM_MISMATCH:
+            val = std::to_string(mpHitStore->get_mismatch(mRow));
+            break;
+        case ENTAP_HEADER_SIM_GAP_OPEN:
+            val = std::to_string(mpHitStore->get_gapopen(mRow));
+            break;
+        case ENTAP_HEADER_SIM_QUERY_E:
+            val = std::to_string(mpHitStore->get_qend(mRow));
+            break;
+        case ENTAP_HEADER_SIM_QUERY_S:
+            val = std::to_string(mpHitStore->get_qstart(mRow));
+            break;
+        case ENTAP_HEADER_SIM_SUBJ_S:
+            val = std::to_string(mpHitStore->get_sstart(mRow));
+            break;
+        case ENTAP_HEADER_SIM_SUBJ_E:
+            val = std::to_string(mpHitStore->get_send(mRow));
+            break;
+        case ENTAP_HEADER_SIM_E_VAL:
+            val = float_to_sci(mpHitStore->get_e_value(mRow), 2);
+            break;
+        case ENTAP_HEADER_SIM_COVERAGE:
+            val = float_to_string(mpHitStore->get_coverage(mRow));
+            break;
+        case ENTAP_HEADER_SIM_TITLE:
+            val = mpHitStore->get_stitle(mRow);
+            break;
+        case ENTAP_HEADER_SIM_SPECIES:
+            val = mpHitStore->get_species(mRow);
+            break;
+        case ENTAP_HEADER_SIM_TAXONOMIC_LINEAGE:
+            val = mpHitStore->get_lineage(mRow);
+            break;
+        case ENTAP_HEADER_SIM_DATABASE:
+            val = mpHitStore->get_database_path();
+            break;
+        case ENTAP_HEADER_SIM_CONTAM:
+            val = mpHitStore->is_contaminant(mRow) ? YES_FLAG : NO_FLAG;
+            break;
+        case ENTAP_HEADER_SIM_INFORM:
+            val = mpHitStore->is_informative(mRow) ? YES_FLAG : NO_FLAG;
+            break;
+        case ENTAP_HEADER_SIM_UNI_DATA_XREF:
+            uniprot_entry = mpHitStore->get_uniprot_entry(mRow);
+            val = uniprot_entry != nullptr ? uniprot_entry->database_x_refs : "";
+            break;
+        case ENTAP_HEADER_SIM_UNI_COMMENTS:
+            uniprot_entry = mpHitStore->get_uniprot_entry(mRow);
+            val = uniprot_entry != nullptr ? uniprot_entry->comments : "";
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void SimSearchAlignment::get_all_header_data(std::string *headers) {
+    for (ENTAP_HEADERS header : SIM_SEARCH_HEADERS) {
+        format_header(header, headers[header]);
+    }
+}
+
+void SimSearchAlignment::get_header_data(ENTAP_HEADERS header, std::string &val, uint8 lvl) {
+    if (!format_go_header(header, lvl, val) && !format_header(header, val)) {
+        // Header does NOT apply to this alignment, get info from parent
+        mpParentSequence->get_header_data(val, header, lvl);
+    }
 }
 
 bool SimSearchAlignment::operator>(const QueryAlignment &alignment) {
 
-    // Don't need to check typeid
-    const SimSearchAlignment alignment_cast = dynamic_cast<const SimSearchAlignment&>(alignment);
+    // Don't need to check typeid, alignments are only compared within the same software
+    const SimSearchAlignment &alignment_cast = static_cast<const SimSearchAlignment&>(alignment);
+    const SimSearchHitStore *store1 = this->mpHitStore;
+    const SimSearchHitStore *store2 = alignment_cast.mpHitStore;
+    uint32 row1 = this->mRow;
+    uint32 row2 = alignment_cast.mRow;
 
-    fp64 eval1 = this->_sim_search_results.e_val_raw;
-    fp64 eval2 = alignment_cast._sim_search_results.e_val_raw;
+    fp64 eval1 = store1->get_e_value(row1);
+    fp64 eval2 = store2->get_e_value(row2);
     // Avoid error on taking log
-    if (eval1 == 0) eval1 = 1E-300;
-    if (eval2 == 0) eval2 = 1E-300;
-    fp64 cov1 = this->_sim_search_results.coverage_raw;
-    fp64 cov2 = alignment_cast._sim_search_results.coverage_raw;
+    if (eval1 == 0) eval1 = SimSearchHitStore::E_VAL_FLOOR;
+    if (eval2 == 0) eval2 = SimSearchHitStore::E_VAL_FLOOR;
+    fp64 cov1 = store1->get_coverage(row1);
+    fp64 cov2 = store2->get_coverage(row2);
     fp64 coverage_dif = fabs(cov1 - cov2);
+    bool contam1 = store1->is_contaminant(row1);
+    bool contam2 = store2->is_contaminant(row2);
+    fp32 tax_score1 = store1->get_tax_score(row1);
+    fp32 tax_score2 = store2->get_tax_score(row2);
     if (!this->mCompareOverallAlignment) {
         // For hits of the same database "better hit"
-
-        fp64 log1 = 0.0;
-        fp64 log2 = 0.0;
-
-        if (eval1 != 0.0) {
-            log1 = log10(eval1);
-        }
-
-        if (eval2 != 0.0) {
-            log2 = log10(eval2);
-        }
-
-        if (fabs(log1 - log2) < E_VAL_DIF) {
+        if (fabs(store1->get_log_e_value(row1) - store2->get_log_e_value(row2)) < E_VAL_DIF) {
             if (coverage_dif > COV_DIF) {
                 return cov1 > cov2;
             }
-            if (this->_sim_search_results.contaminant && !alignment_cast._sim_search_results.contaminant) return false;
-            if (!this->_sim_search_results.contaminant && alignment_cast._sim_search_results.contaminant) return true;
-            if (this->_sim_search_results.tax_score == alignment_cast._sim_search_results.tax_score)
+            if (contam1 && !contam2) return false;
+            if (!contam1 && contam2) return true;
+            if (tax_score1 == tax_score2)
                 return eval1 < eval2;
-            return this->_sim_search_results.tax_score > alignment_cast._sim_search_results.tax_score;
+            return tax_score1 > tax_score2;
         } else {
             return eval1 < eval2;
         }
@@ -209,39 +335,45 @@ bool SimSearchAlignment::operator>(const QueryAlignment &alignment) {
         if (coverage_dif > COV_DIF) {
             return cov1 > cov2;
         }
-        if (this->_sim_search_results.contaminant && !alignment_cast._sim_search_results.contaminant) return false;
-        if (!this->_sim_search_results.contaminant && alignment_cast._sim_search_results.contaminant) return true;
-        if (this->_sim_search_results.tax_score == alignment_cast._sim_search_results.tax_score) {
+        if (contam1 && !contam2) return false;
+        if (!contam1 && contam2) return true;
+        if (tax_score1 == tax_score2) {
 			return cov1 > cov2;
 		} else {
-			return this->_sim_search_results.tax_score > alignment_cast._sim_search_results.tax_score;
+			return tax_score1 > tax_score2;
 		}
     }
 }
 
-bool SimSearchAlignment::is_go_header(ENTAP_HEADERS header, std::vector<std::string> &go_list) {
+bool SimSearchAlignment::format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) {
 
-    bool out_flag;
+    const UniprotEntry *uniprot_entry;
+    go_format_t::const_iterator it;
+    std::string go_flag;
 
     switch (header) {
 
         case ENTAP_HEADER_SIM_UNI_GO_CELL:
-            go_list = _sim_search_results.uniprot_info.go_terms[GO_CELLULAR_FLAG];
-            out_flag = true;
+            go_flag = GO_CELLULAR_FLAG;
             break;
         case ENTAP_HEADER_SIM_UNI_GO_MOLE:
-            go_list = _sim_search_results.uniprot_info.go_terms[GO_MOLECULAR_FLAG];
-            out_flag = true;
+            go_flag = GO_MOLECULAR_FLAG;
             break;
         case ENTAP_HEADER_SIM_UNI_GO_BIO:
-            go_list = _sim_search_results.uniprot_info.go_terms[GO_BIOLOGICAL_FLAG];
-            out_flag = true;
+            go_flag = GO_BIOLOGICAL_FLAG;
             break;
 
         default:
-            out_flag = false;
+            return false;
+    }
+    // UniProt terms are stored pre-rendered in the EnTAP database
+    val.clear();
+    uniprot_entry = mpHitStore->get_uniprot_entry(mRow);
+    if (uniprot_entry != nullptr) {
+        it = uniprot_entry->go_terms.find(go_flag);
+        if (it != uniprot_entry->go_terms.end()) val = mpParentSequence->format_go_info(it->second, lvl);
     }
-    return out_flag;
+    return true;
 }
 
 
@@ -255,7 +387,7 @@ bool SimSearchAlignment::is_go_header(ENTAP_HEADERS header, std::vector<std::str
 
 EggnogDmndAlignment::EggnogDmndAlignment(ExecuteStates state, uint16 software, std::string &database_path, QuerySequence* parent,
                                          QuerySequence::EggnogResults eggnogResults)
-    : QueryAlignment (state, software, database_path, parent) {
+    : QueryAlignment (state, software, StringInterner::intern(database_path), parent) {
     mEggnogResults = eggnogResults;
     refresh_headers();
 }
@@ -266,33 +398,31 @@ QuerySequence::EggnogResults *EggnogDmndAlignment::get_results() {
 }
 
 bool EggnogDmndAlignment::operator>(const QueryAlignment & alignment) {
-    const EggnogDmndAlignment alignment_cast = dynamic_cast<const EggnogDmndAlignment&>(alignment);
+    const EggnogDmndAlignment &alignment_cast = static_cast<const EggnogDmndAlignment&>(alignment);
 
     return this->mEggnogResults.seed_eval_raw < alignment_cast.mEggnogResults.seed_eval_raw;
 }
 
-bool EggnogDmndAlignment::is_go_header(ENTAP_HEADERS header, std::vector<std::string> &go_list) {
-    bool out_flag;
+bool EggnogDmndAlignment::format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) {
+    GoTermTable::GO_CATEGORY category;
 
     switch (header) {
 
         case ENTAP_HEADER_ONT_EGG_GO_CELL:
-            go_list = mEggnogResults.parsed_go[GO_CELLULAR_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_CELLULAR;
             break;
         case ENTAP_HEADER_ONT_EGG_GO_MOLE:
-            go_list = mEggnogResults.parsed_go[GO_MOLECULAR_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_MOLECULAR;
             break;
         case ENTAP_HEADER_ONT_EGG_GO_BIO:
-            go_list = mEggnogResults.parsed_go[GO_BIOLOGICAL_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_BIOLOGICAL;
             break;
 
         default:
-            out_flag = false;
+            return false;
     }
-    return out_flag;
+    val = GoTermTable::format_terms(mEggnogResults.parsed_go.get(category), lvl);
+    return true;
 }
 
 void EggnogDmndAlignment::refresh_headers() {
@@ -302,8 +432,8 @@ void EggnogDmndAlignment::refresh_headers() {
             {ENTAP_HEADER_ONT_EGG_SEED_EVAL,  &mEggnogResults.seed_evalue},
             {ENTAP_HEADER_ONT_EGG_SEED_SCORE, &mEggnogResults.seed_score},
             {ENTAP_HEADER_ONT_EGG_PRED_GENE,  &mEggnogResults.predicted_gene},
-            {ENTAP_HEADER_ONT_EGG_TAX_SCOPE_READABLE,  &mEggnogResults.tax_scope_readable},
-            {ENTAP_HEADER_ONT_EGG_TAX_SCOPE_MAX, &mEggnogResults.tax_scope_lvl_max},
+            {ENTAP_HEADER_ONT_EGG_TAX_SCOPE_READABLE,  &StringInterner::get(mEggnogResults.tax_scope_readable)},
+            {ENTAP_HEADER_ONT_EGG_TAX_SCOPE_MAX, &StringInterner::get(mEggnogResults.tax_scope_lvl_max)},
             {ENTAP_HEADER_ONT_EGG_MEMBER_OGS,&mEggnogResults.member_ogs},
             {ENTAP_HEADER_ONT_EGG_DESC,       &mEggnogResults.description},
             {ENTAP_HEADER_ONT_EGG_BIGG,       &mEggnogResults.bigg},
@@ -325,7 +455,7 @@ void EggnogDmndAlignment::refresh_headers() {
 
 InterproAlignment::InterproAlignment(ExecuteStates state, uint16 software, std::string &database_path, QuerySequence* parent,
                                      QuerySequence::InterProResults results)
-    : QueryAlignment(state, software, database_path, parent){
+    : QueryAlignment(state, software, StringInterner::intern(database_path), parent){
 
     mInterproResults = results;
 
@@ -346,31 +476,29 @@ QuerySequence::InterProResults *InterproAlignment::get_results() {
 }
 
 bool InterproAlignment::operator>(const QueryAlignment &alignment) {
-    const InterproAlignment alignment_cast = dynamic_cast<const InterproAlignment&>(alignment);
+    const InterproAlignment &alignment_cast = static_cast<const InterproAlignment&>(alignment);
 
     return this->mInterproResults.e_value_raw < alignment_cast.mInterproResults.e_value_raw;
 }
 
-bool InterproAlignment::is_go_header(ENTAP_HEADERS header, std::vector<std::string> &go_list) {
-    bool out_flag;
+bool InterproAlignment::format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) {
+    GoTermTable::GO_CATEGORY category;
 
     switch (header) {
 
         case ENTAP_HEADER_ONT_INTER_GO_CELL:
-            go_list = mInterproResults.parsed_go[GO_CELLULAR_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_CELLULAR;
             break;
         case ENTAP_HEADER_ONT_INTER_GO_MOLE:
-            go_list = mInterproResults.parsed_go[GO_MOLECULAR_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_MOLECULAR;
             break;
         case ENTAP_HEADER_ONT_INTER_GO_BIO:
-            go_list = mInterproResults.parsed_go[GO_BIOLOGICAL_FLAG];
-            out_flag = true;
+            category = GoTermTable::GO_CATEGORY_BIOLOGICAL;
             break;
 
         default:
-            out_flag = false;
+            return false;
     }
-    return out_flag;
+    val = GoTermTable::format_terms(mInterproResults.parsed_go.get(category), lvl);
+    return true;
 }
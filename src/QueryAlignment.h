@@ -29,6 +29,7 @@
 #define ENTAP_QUERYALIGNMENT_H
 
 #include "QuerySequence.h"
+#include "SimSearchHitStore.h"
 //**********************************************************************
 //**********************************************************************
 //                 QueryAlignment Nested Class
@@ -38,27 +39,28 @@
 class QueryAlignment {
 
 public:
-    QueryAlignment(ExecuteStates state, uint16 software, std::string& database_path, QuerySequence* parent);
+    QueryAlignment(ExecuteStates state, uint16 software, StringInterner::handle_t database, QuerySequence* parent);
     bool operator<(const QueryAlignment&query) {return !(*this > query);};
     void set_compare_overall_alignment(bool val);
     virtual ~QueryAlignment() = default;;
     virtual bool operator>(const QueryAlignment&)=0;
-    void get_all_header_data(std::string[]);
-    void get_header_data(ENTAP_HEADERS header, std::string &val, uint8 lvl);
+    virtual void get_all_header_data(std::string[]);
+    virtual void get_header_data(ENTAP_HEADERS header, std::string &val, uint8 lvl);
 
     uint16 getMSoftwareModule() const;
     ExecuteStates getMExecutionState() const;
-    std::string &getMDatabasePath();
+    const std::string &getMDatabasePath() const;
+    StringInterner::handle_t getMDatabaseHandle() const;
 
 protected:
-    virtual bool is_go_header(ENTAP_HEADERS header, std::vector<std::string>& go_list)=0;
+    virtual bool format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val)=0;
 
-    std::unordered_map<ENTAP_HEADERS , std::string*> ALIGN_OUTPUT_MAP;
+    std::unordered_map<ENTAP_HEADERS , const std::string*> ALIGN_OUTPUT_MAP;
     bool mCompareOverallAlignment; // May want to compare separate parameters for overall alignment across databases
     QuerySequence* mpParentSequence;
     uint16 mSoftwareModule;
     ExecuteStates mExecutionState;
-    std::string mDatabasePath;
+    StringInterner::handle_t mDatabaseHandle;   // Interned path to database
 };
 
 //**********************************************************************
@@ -70,24 +72,37 @@ protected:
 class SimSearchAlignment : public QueryAlignment{
 
 public:
-    SimSearchAlignment(ExecuteStates state, uint16 software, std::string &database_path, QuerySequence* parent,
-                       QuerySequence::SimSearchResults d, std::string &lineage);
+    SimSearchAlignment(ExecuteStates state, uint16 software, QuerySequence* parent,
+                       SimSearchHitStore *store, uint32 row);
     ~SimSearchAlignment() override = default;
-    QuerySequence::SimSearchResults* get_results();
     bool operator>(const QueryAlignment&) override;
+    void get_all_header_data(std::string[]) override;
+    void get_header_data(ENTAP_HEADERS header, std::string &val, uint8 lvl) override;
+    static fp32 calculate_tax_score(const tax_path_t &lineage_path, const tax_path_t &input_lineage_path,
+                                    bool is_informative);
+
+    bool is_contaminant() const;
+    bool is_informative() const;
+    const std::string &get_species() const;
+    const std::string &get_contam_type() const;
+    const UniprotEntry *get_uniprot_entry() const;
 
 private:
-    void set_tax_score(std::string&);
+    bool format_header(ENTAP_HEADERS header, std::string &val);
 
-    QuerySequence::SimSearchResults    _sim_search_results;
+    SimSearchHitStore *mpHitStore;      // Columnar store of all hits against this database
+    uint32             mRow;            // Row of this hit within mpHitStore
 
 protected:
-    bool is_go_header(ENTAP_HEADERS header, std::vector<std::string>& go_list) override;
+    bool format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) override;
 
     static constexpr uint8 E_VAL_DIF     = 8;
     static constexpr uint8 COV_DIF       = 5;
     static constexpr uint8 INFORM_ADD    = 3;
     static constexpr fp32 INFORM_FACTOR  = 1.2;
+    static const std::vector<ENTAP_HEADERS> SIM_SEARCH_HEADERS;
+    static const std::string YES_FLAG;
+    static const std::string NO_FLAG;
 };
 
 //**********************************************************************
@@ -110,7 +125,7 @@ private:
     QuerySequence::EggnogResults mEggnogResults;
 
 protected:
-    bool is_go_header(ENTAP_HEADERS header, std::vector<std::string>& go_list) override;
+    bool format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) override;
 
 };
 
@@ -134,7 +149,7 @@ private:
     QuerySequence::InterProResults mInterproResults;
 
 protected:
-    bool is_go_header(ENTAP_HEADERS header, std::vector<std::string>& go_list) override;
+    bool format_go_header(ENTAP_HEADERS header, uint8 lvl, std::string &val) override;
 
 };
 
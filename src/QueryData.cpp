@@ -573,6 +573,11 @@ QueryData::~QueryData() {
     FS_dprint("QuerySequence data freed");
     delete mpSequences;
 
+    // Alignments reference hit stores, free once sequences are gone
+    for (auto &pair : mHitStores) {
+        delete pair.second;
+    }
+
     // Cleanup files in case it was interrupted
     for (auto &pair : mAlignmentFiles) {
         path = pair.first;
@@ -706,6 +711,53 @@ bool QueryData::add_alignment_data(std::string &base_path, QuerySequence *queryS
     return ret;
 }
 
+/**
+ * ======================================================================
+ * Function void QueryData::finalize_alignments(ExecuteStates state, uint16 software)
+ *
+ * Description          - Selects the overall best hit for every sequence that
+ *                        aligned during this software execution
+ *
+ * Notes                - Called by modules once parsing has completed
+ *
+ * @param state         - Execution state of the alignments
+ * @param software      - Software module of the alignments
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void QueryData::finalize_alignments(ExecuteStates state, uint16 software) {
+    for (auto &pair : *mpSequences) {
+        pair.second->finalize_alignments(state, software);
+    }
+}
+
+/**
+ * ======================================================================
+ * Function SimSearchHitStore* QueryData::get_hit_store(std::string &database_path)
+ *
+ * Description          - Returns columnar hit store for a Similarity Search
+ *                        database, creating it if it does not exist yet
+ *
+ * Notes                - Hit stores are owned by QueryData and freed with
+ *                        the sequences
+ *
+ * @param database_path - Path associated with the database hits
+ *
+ * @return              - Pointer to hit store
+ *
+ * =====================================================================
+ */
+SimSearchHitStore* QueryData::get_hit_store(std::string &database_path) {
+    std::unordered_map<std::string, SimSearchHitStore*>::iterator it = mHitStores.find(database_path);
+    if (it != mHitStores.end()) return it->second;
+
+    SimSearchHitStore *store = new SimSearchHitStore(database_path);
+    mHitStores.emplace(database_path, store);
+    return store;
+}
+
 bool QueryData::is_protein_data() {
     return DATA_FLAG_GET(IS_PROTEIN);
 }
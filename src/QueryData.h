@@ -75,6 +75,8 @@ public:
     bool end_alignment_files(std::string &base_path);
     bool add_alignment_data(std::string &base_path, QuerySequence *querySequence, QueryAlignment *alignment);
     QuerySequence* get_sequence(std::string&);
+    void finalize_alignments(ExecuteStates state, uint16 software);
+    SimSearchHitStore* get_hit_store(std::string &database_path);
     bool print_transcriptome(uint32 flags, std::string &outpath, SEQUENCE_TYPES sequence_type);
 
     QUERY_MAP_T get_specific_sequences(uint32 flags);
@@ -150,6 +152,7 @@ private:
     UserInput   *mpUserInput;
     std::string mTranscriptTypeStr;
     std::unordered_map<std::string, OutputFileData> mAlignmentFiles;
+    std::unordered_map<std::string, SimSearchHitStore*> mHitStores;   // Similarity Search hits keyed to database
     static EntapHeader ENTAP_HEADER_INFO[];
 
 };
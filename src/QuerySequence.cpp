@@ -438,19 +438,19 @@ void QuerySequence::set_header_data() {
     mHeaderInfo[ENTAP_HEADER_EXP_TPM] = float_to_string(this->mTPM);
 
     // Similarity Search data
-    align_ptr = this->mAlignmentData->get_best_align_ptr(SIMILARITY_SEARCH, SIM_DIAMOND, "");
+    align_ptr = this->mAlignmentData->get_best_align_ptr(SIMILARITY_SEARCH, SIM_DIAMOND, StringInterner::EMPTY_HANDLE);
     if (align_ptr != nullptr) {
         align_ptr->get_all_header_data(mHeaderInfo);
     }
 
     // Ontology EggNOG data
-    align_ptr = this->mAlignmentData->get_best_align_ptr(GENE_ONTOLOGY, ONT_EGGNOG_DMND, "");
+    align_ptr = this->mAlignmentData->get_best_align_ptr(GENE_ONTOLOGY, ONT_EGGNOG_DMND, StringInterner::EMPTY_HANDLE);
     if (align_ptr != nullptr) {
         align_ptr->get_all_header_data(mHeaderInfo);
     }
 
     // Ontology InterProScan data
-    align_ptr = this->mAlignmentData->get_best_align_ptr(GENE_ONTOLOGY, ONT_INTERPRO_SCAN, "");
+    align_ptr = this->mAlignmentData->get_best_align_ptr(GENE_ONTOLOGY, ONT_INTERPRO_SCAN, StringInterner::EMPTY_HANDLE);
     if (align_ptr != nullptr) {
         align_ptr->get_all_header_data(mHeaderInfo);
     }
@@ -562,25 +562,25 @@ void QuerySequence::add_alignment(ExecuteStates state, uint16 software, EggnogRe
 /**
  * ======================================================================
  * Function void QuerySequence::add_alignment(ExecuteStates state, uint16 software,
- *                                      SimSearchResults &results, std::string& database)
+ *                                      SimSearchHitStore *store, uint32 row)
  *
  * Description          - Adds Similarity Search alignment to AlignmentData and updates
  *                        pertinent data/best hits (flags, EggnogResults...)
  *
- * Notes                - None
+ * Notes                - Alignment is a view into a row of the database hit store
  *
  * @param state         - State that alignment was created in
  * @param software      - Software that alignment was created using (DIAMOND, EggNOG...)
- * @param results       - Similarity Search data
- * @param database      - Absolute path to database associated with alignment
+ * @param store         - Hit store of the database associated with alignment
+ * @param row           - Row of the hit within the store
  *
  * @return              - None
  *
  * =====================================================================
  */
-void QuerySequence::add_alignment(ExecuteStates state, uint16 software, SimSearchResults &results, std::string& database,std::string lineage) {
+void QuerySequence::add_alignment(ExecuteStates state, uint16 software, SimSearchHitStore *store, uint32 row) {
     QUERY_FLAG_SET(QUERY_BLAST_HIT);
-    QueryAlignment *new_alignment = new SimSearchAlignment(state, software, database, this, results, lineage);
+    QueryAlignment *new_alignment = new SimSearchAlignment(state, software, this, store, row);
     mAlignmentData->update_best_hit(new_alignment);
 }
 
@@ -674,17 +674,18 @@ QuerySequence::AlignmentData::~AlignmentData() {
 
 /**
  * ======================================================================
- * Function void QuerySequence::AlignmentData::update_best_hit(ExecuteStates state,
- *          uint16 software, std::string &database, QueryAlignment* new_alignment)
- *
- * Description          - Updates all alignment data including best hit for
- *                        each database, overall software best hit across
- *                        every database, calls Query flag update
+ * Function void QuerySequence::AlignmentData::update_best_hit(QueryAlignment* new_alignment)
  *
- * Notes                - None
+ * Description          - Adds alignment to the database it was hit against
+ *                        and updates the running best hit for that database
+ *                        (index 0 of the database vector)
  *
- * @param state         - Execution state the algnment belongs to
+ * Notes                - Remaining hits are NOT sorted here, they are sorted
+ *                        lazily when the database hits are accessed
+ *                      - Overall best hit and query flags are updated once
+ *                        parsing is complete through finalize_best_hits
  *
+ * @param new_alignment - Alignment to add
  *
  * @return              - None
  *
@@ -696,41 +697,92 @@ void QuerySequence::AlignmentData::update_best_hit(QueryAlignment* new_alignment
 
     // Did we hit against this database yet
     if (!hit_database(new_alignment->getMExecutionState(), new_alignment->getMSoftwareModule(),
-                      new_alignment->getMDatabasePath())) {
+                      new_alignment->getMDatabaseHandle())) {
         // No, create new vector for that database and add as best hit for database
         align_database_hits_t vect = {new_alignment};
-        alignment_arr->emplace(new_alignment->getMDatabasePath(), vect);
-    } else {
-        // Yes, add alignment to list then update
-        alignment_arr->at(new_alignment->getMDatabasePath()).push_back(new_alignment);
+        alignment_arr->emplace(new_alignment->getMDatabaseHandle(), vect);
+        return;
     }
 
-    // Always will have hit this database, get alignments
-    align_database_hits_t *database_data = &alignment_arr->at(new_alignment->getMDatabasePath());
+    // Yes, add alignment to list then update
+    align_database_hits_t *database_data = &alignment_arr->at(new_alignment->getMDatabaseHandle());
+    database_data->push_back(new_alignment);
 
-    // Sort alignments for that database (0 index is best hit)
-    std::sort(database_data->begin(), database_data->end(), sort_descending_database());
+    // Compare against running best for that database (0 index is best hit)
+    new_alignment->set_compare_overall_alignment(false);
+    database_data->front()->set_compare_overall_alignment(false);
+    if (*new_alignment > *database_data->front()) {
+        std::swap(database_data->front(), database_data->back());
+    }
+    unsorted_tails.insert(database_data);
+}
 
-    // See if this alignment is better than the overall alignment
-    new_alignment->set_compare_overall_alignment(true);
-    QueryAlignment* best_alignment = get_best_align_ptr(new_alignment->getMExecutionState(), new_alignment->getMSoftwareModule(), "");
+/**
+ * ======================================================================
+ * Function void QuerySequence::AlignmentData::sort_database_tail(align_database_hits_t *database_data)
+ *
+ * Description          - Sorts every hit after the best hit for a database
+ *
+ * Notes                - Does nothing if the database has already been sorted
+ *
+ * @param database_data - Alignments for a single database
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void QuerySequence::AlignmentData::sort_database_tail(align_database_hits_t *database_data) {
+    if (database_data == nullptr) return;
+    if (unsorted_tails.erase(database_data) == 0) return;
+    std::sort(database_data->begin() + 1, database_data->end(), sort_descending_database());
+}
 
-    if (best_alignment == nullptr) {
-        set_best_alignment(new_alignment);
-    } else {
-        best_alignment->set_compare_overall_alignment(true);
-        if (*new_alignment > *best_alignment) {
-            set_best_alignment(new_alignment);
+/**
+ * ======================================================================
+ * Function void QuerySequence::AlignmentData::finalize_best_hits(ExecuteStates state, uint16 software)
+ *
+ * Description          - Selects the overall best hit across every database
+ *                        in a single pass over the database best hits and
+ *                        sorts any remaining database hits
+ *
+ * Notes                - Called once all alignments have been added for
+ *                        this software
+ *
+ * @param state         - Execution state of the alignments
+ * @param software      - Software module of the alignments
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void QuerySequence::AlignmentData::finalize_best_hits(ExecuteStates state, uint16 software) {
+    ALIGNMENT_DATA_T* alignment_arr = get_software_ptr(state, software);
+    QueryAlignment* best_alignment = nullptr;
+
+    if (alignment_arr == nullptr || alignment_arr->empty()) return;
+
+    for (auto &pair : *alignment_arr) {
+        sort_database_tail(&pair.second);
+        QueryAlignment* database_best = pair.second.front();
+        if (best_alignment == nullptr) {
+            best_alignment = database_best;
+        } else {
+            database_best->set_compare_overall_alignment(true);
+            best_alignment->set_compare_overall_alignment(true);
+            if (*database_best > *best_alignment) {
+                best_alignment = database_best;
+            }
         }
     }
+    set_best_alignment(best_alignment);
 
     // Update any overall flags that may have changed with best hit changes
-    querySequence->update_query_flags(new_alignment->getMExecutionState(), new_alignment->getMSoftwareModule());
+    querySequence->update_query_flags(state, software);
 }
 
-bool QuerySequence::AlignmentData::hit_database(ExecuteStates state, uint16 software, std::string &database) {
+bool QuerySequence::AlignmentData::hit_database(ExecuteStates state, uint16 software, StringInterner::handle_t database) {
     // If we want overall best alignment
-    if (database.empty()) {
+    if (database == StringInterner::EMPTY_HANDLE) {
         return get_best_align_ptr(state, software, database) != nullptr;
     } else {
         // If we hit a specific database
@@ -742,9 +794,8 @@ void QuerySequence::update_query_flags(ExecuteStates state, uint16 software) {
     switch (state) {
         case SIMILARITY_SEARCH: {
             SimSearchAlignment *best_align = get_best_hit_alignment<SimSearchAlignment>(state, software, "");
-            SimSearchResults *results = best_align->get_results();
-            QUERY_FLAG_CHANGE(QUERY_INFORMATIVE, results->is_informative);
-            QUERY_FLAG_CHANGE(QUERY_CONTAMINANT, results->contaminant);
+            QUERY_FLAG_CHANGE(QUERY_INFORMATIVE, best_align->is_informative());
+            QUERY_FLAG_CHANGE(QUERY_CONTAMINANT, best_align->is_contaminant());
             break;
         }
 
@@ -791,22 +842,50 @@ void QuerySequence::update_query_flags(ExecuteStates state, uint16 software) {
 
 QuerySequence::align_database_hits_t *
 QuerySequence::get_database_hits(std::string &database, ExecuteStates state, uint16 software) {
-    return this->mAlignmentData->get_database_ptr(state, software, database);
+    align_database_hits_t *database_data =
+            this->mAlignmentData->get_database_ptr(state, software, StringInterner::find(database));
+    this->mAlignmentData->sort_database_tail(database_data);
+    return database_data;
+}
+
+/**
+ * ======================================================================
+ * Function void QuerySequence::finalize_alignments(ExecuteStates state, uint16 software)
+ *
+ * Description          - Selects overall best hit and updates query flags
+ *                        once all alignments from a software have been added
+ *
+ * Notes                - Modules must call this after parsing, before
+ *                        accessing the overall best hit
+ *
+ * @param state         - Execution state of the alignments
+ * @param software      - Software module of the alignments
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void QuerySequence::finalize_alignments(ExecuteStates state, uint16 software) {
+    mAlignmentData->finalize_best_hits(state, software);
 }
 
-std::string QuerySequence::format_go_info(std::vector<std::string> &go_list, uint8 lvl) {
-    std::stringstream out;
+// Only used for UniProt terms, which are stored pre-rendered (GO:0000001-term(L=3)) in the EnTAP database
+std::string QuerySequence::format_go_info(const std::vector<std::string> &go_list, uint8 lvl) {
+    std::string out;
+    std::string level_tag = "(L=" + std::to_string(lvl) + ")";
 
-    for (std::string &val : go_list)  {
-        if (val.find("(L=" + std::to_string(lvl))!=std::string::npos || lvl == 0) {
-            out<<val<<",";
+    for (const std::string &val : go_list)  {
+        if (lvl == 0 || (val.size() >= level_tag.size() &&
+                         val.compare(val.size() - level_tag.size(), level_tag.size(), level_tag) == 0)) {
+            out += val;
+            out += ',';
         }
     }
-    return out.str();
+    return out;
 }
 
 bool QuerySequence::hit_database(ExecuteStates state, uint16 software, std::string database) {
-    return mAlignmentData->hit_database(state, software, database);
+    return mAlignmentData->hit_database(state, software, StringInterner::find(database));
 }
 
 void QuerySequence::set_blasted() {
@@ -841,8 +920,8 @@ bool QuerySequence::is_nucleotide() {
     return QUERY_FLAG_GET(QUERY_IS_NUCLEOTIDE);
 }
 
-QuerySequence::align_database_hits_t* QuerySequence::AlignmentData::get_database_ptr(ExecuteStates state, uint16 software, std::string& database) {
-    if (database.empty()) return nullptr;
+QuerySequence::align_database_hits_t* QuerySequence::AlignmentData::get_database_ptr(ExecuteStates state, uint16 software, StringInterner::handle_t database) {
+    if (database == StringInterner::EMPTY_HANDLE || database == StringInterner::HANDLE_NOT_FOUND) return nullptr;
 
     switch (state) {
         case SIMILARITY_SEARCH:
@@ -873,11 +952,12 @@ QuerySequence::AlignmentData::ALIGNMENT_DATA_T* QuerySequence::AlignmentData::ge
     }
 }
 
-QueryAlignment* QuerySequence::AlignmentData::get_best_align_ptr(ExecuteStates state, uint16 software, std::string database) {
-    if (database.empty()) {
+QueryAlignment* QuerySequence::AlignmentData::get_best_align_ptr(ExecuteStates state, uint16 software, StringInterner::handle_t database) {
+    if (database == StringInterner::EMPTY_HANDLE) {
         return overall_alignment[state][software];
     } else {
-        return get_database_ptr(state, software, database)->at(0);
+        align_database_hits_t *database_data = get_database_ptr(state, software, database);
+        return database_data != nullptr ? database_data->at(0) : nullptr;
     }
 }
 
@@ -31,8 +31,10 @@
 
 #include "common.h"
 #include "database/EntapDatabase.h"
+#include "StringInterner.h"
 
 class QueryAlignment;
+class SimSearchHitStore;
 
 /**
  * ======================================================================
@@ -88,9 +90,9 @@ public:
         std::string              seed_score;        // Pulled from DIAMOND run
         std::string              seed_coverage;     // Pulled from DIAMOND run
         std::string              predicted_gene;    // Most common predicted gene (pname)
-        std::string              tax_scope_lvl_max; // virNOG[6]
-        std::string              tax_scope;         // virNOG
-        std::string              tax_scope_readable;// Ascomycota
+        StringInterner::handle_t tax_scope_lvl_max; // virNOG[6] (interned)
+        StringInterner::handle_t tax_scope;         // virNOG (interned)
+        StringInterner::handle_t tax_scope_readable;// Ascomycota (interned)
         std::string              pname;             // All predicted gene names
         std::string              name;
         std::string              bigg;
@@ -99,7 +101,7 @@ public:
         std::string              description;       // Used for older version
         std::string              protein_domains;
         fp64                     seed_eval_raw;     // Used for finding best hit
-        go_format_t              parsed_go;         // All go terms found
+        GoTermTable::GoTermSet   parsed_go;         // All go terms found (interned)
     };
 
     struct InterProResults {
@@ -109,36 +111,30 @@ public:
         std::string             interpro_desc_id;
         std::string             pathways;
         fp64                    e_value_raw;
-        go_format_t             parsed_go;
+        GoTermTable::GoTermSet  parsed_go;
     };
 
+    // Parsed Similarity Search hit, typed data is copied into a SimSearchHitStore row
     struct SimSearchResults {
-        std::string                       length;
-        std::string                       mismatch;
-        std::string                       gapopen;
-        std::string                       qstart;
-        std::string                       qend;
-        std::string                       sstart;
-        std::string                       send;
-        std::string                       pident;
-        std::string                       bit_score;
-        std::string                       e_val;
-        std::string                       coverage;
-        std::string                       database_path;
-        std::string                       qseqid;
+        uint32                            length;
+        uint32                            mismatch;
+        uint32                            gapopen;
+        uint32                            qstart;
+        uint32                            qend;
+        uint32                            sstart;
+        uint32                            send;
+        fp64                              pident_raw;
+        fp32                              bit_score;
         std::string                       sseqid;
         std::string                       stitle;
         std::string                       species;
         std::string                       contam_type;
         std::string                       lineage;
-        std::string                       yes_no_contam; // just for convenience
-        std::string                       yes_no_inform;
-        fp32                              tax_score;     // taxonomic score, may be based on parent
         fp64                              e_val_raw;
         fp64                              coverage_raw;
         bool                              contaminant;
         bool                              is_informative;
-        UniprotEntry                      uniprot_info;
+        const UniprotEntry               *uniprot_info;     // Points into EntapDatabase, nullptr if none
     };
 
     /**
@@ -151,22 +147,26 @@ public:
      *                      - Data is organized into maps of vectors (QueryAligments)
      *                        keyed to the database associated with the alignment
      *                      - First element in an alignment vector is the best hit
-     *                        for that database
+     *                        for that database, maintained as a running best on
+     *                        insert. Remaining hits (tail) are only sorted when
+     *                        accessed
      *                      - All statuses in parent QuerySequence are based upon
-     *                        the 'overall' best hit across all databases
+     *                        the 'overall' best hit across all databases, chosen
+     *                        in a single pass once parsing has completed
      *                      - Best hit algorithm is implemented by the QueryAlignment
      *                        class
      *
      * ======================================================================
      */
     struct AlignmentData {
-        typedef std::unordered_map<std::string,align_database_hits_t> ALIGNMENT_DATA_T;
+        typedef std::unordered_map<StringInterner::handle_t,align_database_hits_t> ALIGNMENT_DATA_T;
 
         ALIGNMENT_DATA_T sim_search_data[SIM_SOFTWARE_COUNT];
         ALIGNMENT_DATA_T ontology_data[ONT_SOFTWARE_COUNT];
         QuerySequence* querySequence;
 
         QueryAlignment* overall_alignment[EXECUTION_MAX][ONT_SOFTWARE_COUNT]{};
+        std::set<align_database_hits_t*> unsorted_tails;    // Databases with hits past index 0 not yet sorted
 
         struct sort_descending_database {
             bool operator () (QueryAlignment* first, QueryAlignment* second);
@@ -177,9 +177,11 @@ public:
 
         void set_best_alignment(QueryAlignment *new_alignment);
         void update_best_hit(QueryAlignment* new_alignment);
-        bool hit_database(ExecuteStates state, uint16 software, std::string &database);
-        align_database_hits_t* get_database_ptr(ExecuteStates, uint16, std::string&);
-        QueryAlignment* get_best_align_ptr(ExecuteStates, uint16 software, std::string database);
+        void finalize_best_hits(ExecuteStates state, uint16 software);
+        void sort_database_tail(align_database_hits_t *database_data);
+        bool hit_database(ExecuteStates state, uint16 software, StringInterner::handle_t database);
+        align_database_hits_t* get_database_ptr(ExecuteStates, uint16, StringInterner::handle_t);
+        QueryAlignment* get_best_align_ptr(ExecuteStates, uint16 software, StringInterner::handle_t database);
         ALIGNMENT_DATA_T* get_software_ptr(ExecuteStates state, uint16 software);
     };
 
@@ -218,16 +220,17 @@ public:
 #endif
     // Alignemnt accession routines
     void add_alignment(ExecuteStates state, uint16 software, EggnogResults &results, std::string& database);
-    void add_alignment(ExecuteStates state, uint16 software, SimSearchResults &results, std::string& database,std::string lineage);
+    void add_alignment(ExecuteStates state, uint16 software, SimSearchHitStore *store, uint32 row);
     void add_alignment(ExecuteStates state, uint16 software, InterProResults &results, std::string& database);
     QuerySequence::align_database_hits_t* get_database_hits(std::string& database,ExecuteStates state, uint16 software);
+    void finalize_alignments(ExecuteStates state, uint16 software);
 
-    std::string format_go_info(std::vector<std::string> &go_list, uint8 lvl);
+    std::string format_go_info(const std::vector<std::string> &go_list, uint8 lvl);
 
     // Returns recast alignment pointer
     template<class T>
     T *get_best_hit_alignment(ExecuteStates state, uint16 software, std::string database) {
-        return static_cast<T*>(mAlignmentData->get_best_align_ptr(state, software, database));
+        return static_cast<T*>(mAlignmentData->get_best_align_ptr(state, software, StringInterner::find(database)));
     }
 
     // Checks whether an alignment was found against specific atabase
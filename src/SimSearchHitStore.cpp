@@ -0,0 +1,144 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <cmath>
+#include <cstring>
+#include "SimSearchHitStore.h"
+
+constexpr fp64   SimSearchHitStore::E_VAL_FLOOR;
+
+/**
+ * ======================================================================
+ * Function SimSearchHitStore::SimSearchHitStore(const std::string &database_path)
+ *
+ * Description          - Initializes an empty hit store for a database
+ *
+ * Notes                - Constructor
+ *
+ * @param database_path - Path to DIAMOND output for this database
+ *
+ * @return              - SimSearchHitStore object
+ *
+ * =====================================================================
+ */
+SimSearchHitStore::SimSearchHitStore(const std::string &database_path) {
+    mDatabaseHandle = StringInterner::intern(database_path);
+}
+
+/**
+ * ======================================================================
+ * Function row_t SimSearchHitStore::add_hit(const QuerySequence::SimSearchResults &results,
+ *                                           fp32 tax_score)
+ *
+ * Description          - Appends a hit to every column of the store
+ *
+ * Notes                - Rows are never removed, row indices are stable
+ *                        for the lifetime of the store
+ *
+ * @param results       - Parsed Similarity Search hit
+ * @param tax_score     - Taxonomic score calculated for this hit
+ *
+ * @return              - Row index of the new hit
+ *
+ * =====================================================================
+ */
+SimSearchHitStore::row_t SimSearchHitStore::add_hit(const QuerySequence::SimSearchResults &results, fp32 tax_score) {
+    row_t row = (row_t) mEValue.size();
+    fp64 e_val_floor = results.e_val_raw == 0 ? E_VAL_FLOOR : results.e_val_raw;
+    uint8 flags = 0;
+
+    mBitScore.push_back(results.bit_score);
+    mCoverage.push_back(results.coverage_raw);
+    mPident.push_back(results.pident_raw);
+    mTaxScore.push_back(tax_score);
+    mEValue.push_back(results.e_val_raw);
+    mLogEValue.push_back(log10(e_val_floor));
+    mLength.push_back(results.length);
+    mMismatch.push_back(results.mismatch);
+    mGapOpen.push_back(results.gapopen);
+    mQStart.push_back(results.qstart);
+    mQEnd.push_back(results.qend);
+    mSStart.push_back(results.sstart);
+    mSEnd.push_back(results.send);
+
+    if (results.contaminant) flags |= HIT_CONTAMINANT;
+    if (results.is_informative) flags |= HIT_INFORMATIVE;
+    mFlags.push_back(flags);
+
+    mSpeciesID.push_back(StringInterner::intern(results.species));
+    mLineageID.push_back(StringInterner::intern(results.lineage));
+    mContamTypeID.push_back(StringInterner::intern(results.contam_type));
+
+    mUniprotEntry.push_back(results.uniprot_info);
+
+    // Subject ID and title are stored back to back, null terminated
+    mTextOffset.push_back(mTextPool.size());
+    mTextPool.insert(mTextPool.end(), results.sseqid.begin(), results.sseqid.end());
+    mTextPool.push_back('\0');
+    mTextPool.insert(mTextPool.end(), results.stitle.begin(), results.stitle.end());
+    mTextPool.push_back('\0');
+
+    return row;
+}
+
+uint64 SimSearchHitStore::size() const {
+    return mEValue.size();
+}
+
+const std::string &SimSearchHitStore::get_database_path() const {
+    return StringInterner::get(mDatabaseHandle);
+}
+
+StringInterner::handle_t SimSearchHitStore::get_database_handle() const {
+    return mDatabaseHandle;
+}
+
+const char *SimSearchHitStore::get_sseqid(row_t row) const {
+    return &mTextPool[mTextOffset[row]];
+}
+
+const char *SimSearchHitStore::get_stitle(row_t row) const {
+    const char *sseqid = get_sseqid(row);
+    return sseqid + strlen(sseqid) + 1;
+}
+
+const std::string &SimSearchHitStore::get_species(row_t row) const {
+    return StringInterner::get(mSpeciesID[row]);
+}
+
+const std::string &SimSearchHitStore::get_lineage(row_t row) const {
+    return StringInterner::get(mLineageID[row]);
+}
+
+const std::string &SimSearchHitStore::get_contam_type(row_t row) const {
+    return StringInterner::get(mContamTypeID[row]);
+}
+
+const UniprotEntry *SimSearchHitStore::get_uniprot_entry(row_t row) const {
+    return mUniprotEntry[row];
+}
@@ -0,0 +1,129 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_SIMSEARCHHITSTORE_H
+#define ENTAP_SIMSEARCHHITSTORE_H
+
+#include "common.h"
+#include "QuerySequence.h"
+#include "StringInterner.h"
+
+/**
+ * ======================================================================
+ * @class SimSearchHitStore
+ *
+ * Description          - Columnar (struct of arrays) storage for every
+ *                        Similarity Search hit against a single database
+ *                      - Numeric DIAMOND fields are stored typed, repeated
+ *                        strings (species, lineage, contaminant type) are
+ *                        interned and referenced by handle, subject ID and
+ *                        title are stored in a shared text pool
+ *                      - Percent identity and coverage are kept at double
+ *                        precision so output and best hit selection match
+ *                        parsing to text
+ *                      - UniProt entries are referenced in place within
+ *                        EntapDatabase, which must outlive the store
+ *                      - SimSearchAlignment objects are lightweight views
+ *                        into a row of this store, text is only formatted
+ *                        when written to output
+ *
+ * ======================================================================
+ */
+class SimSearchHitStore {
+
+public:
+    typedef uint32 row_t;
+
+    static constexpr fp64   E_VAL_FLOOR = 1E-300;       // Avoid error on taking log of 0
+
+    SimSearchHitStore(const std::string &database_path);
+    ~SimSearchHitStore() = default;
+
+    row_t add_hit(const QuerySequence::SimSearchResults &results, fp32 tax_score);
+    uint64 size() const;
+    const std::string &get_database_path() const;
+    StringInterner::handle_t get_database_handle() const;
+
+    // Typed column accessors
+    fp32   get_bit_score(row_t row) const     {return mBitScore[row];}
+    fp64   get_coverage(row_t row) const      {return mCoverage[row];}
+    fp64   get_pident(row_t row) const        {return mPident[row];}
+    fp32   get_tax_score(row_t row) const     {return mTaxScore[row];}
+    fp64   get_e_value(row_t row) const       {return mEValue[row];}
+    fp64   get_log_e_value(row_t row) const   {return mLogEValue[row];}
+    uint32 get_length(row_t row) const        {return mLength[row];}
+    uint32 get_mismatch(row_t row) const      {return mMismatch[row];}
+    uint32 get_gapopen(row_t row) const       {return mGapOpen[row];}
+    uint32 get_qstart(row_t row) const        {return mQStart[row];}
+    uint32 get_qend(row_t row) const          {return mQEnd[row];}
+    uint32 get_sstart(row_t row) const        {return mSStart[row];}
+    uint32 get_send(row_t row) const          {return mSEnd[row];}
+    bool   is_contaminant(row_t row) const    {return (mFlags[row] & HIT_CONTAMINANT) != 0;}
+    bool   is_informative(row_t row) const    {return (mFlags[row] & HIT_INFORMATIVE) != 0;}
+
+    const char* get_sseqid(row_t row) const;
+    const char* get_stitle(row_t row) const;
+    const std::string &get_species(row_t row) const;
+    const std::string &get_lineage(row_t row) const;
+    const std::string &get_contam_type(row_t row) const;
+    const UniprotEntry *get_uniprot_entry(row_t row) const;
+
+private:
+    typedef enum {
+        HIT_CONTAMINANT = (1 << 0),
+        HIT_INFORMATIVE = (1 << 1)
+    } HIT_FLAGS;
+
+    StringInterner::handle_t    mDatabaseHandle;
+    // Numeric columns
+    std::vector<fp32>           mBitScore;
+    std::vector<fp64>           mCoverage;
+    std::vector<fp64>           mPident;
+    std::vector<fp32>           mTaxScore;
+    std::vector<fp64>           mEValue;            // Raw e-value
+    std::vector<fp64>           mLogEValue;         // log10 of e-value (floored), used for best hit
+    std::vector<uint32>         mLength;
+    std::vector<uint32>         mMismatch;
+    std::vector<uint32>         mGapOpen;
+    std::vector<uint32>         mQStart;
+    std::vector<uint32>         mQEnd;
+    std::vector<uint32>         mSStart;
+    std::vector<uint32>         mSEnd;
+    std::vector<uint8>          mFlags;
+    // Interned string columns
+    std::vector<StringInterner::handle_t> mSpeciesID;
+    std::vector<StringInterner::handle_t> mLineageID;
+    std::vector<StringInterner::handle_t> mContamTypeID;
+    std::vector<const UniprotEntry*> mUniprotEntry; // EntapDatabase entry or nullptr, never copied
+    std::vector<uint64>         mTextOffset;        // Offset of "sseqid\0stitle\0" in mTextPool
+    // Shared storage
+    std::vector<char>           mTextPool;
+};
+
+
+#endif //ENTAP_SIMSEARCHHITSTORE_H
@@ -82,6 +82,10 @@ void SimilaritySearch::execute() {
         ptr = spawn_object();
         verifyData = ptr->verify_files();
         if (!verifyData.files_exist) {
+            if (mpUserInput->has_input(INPUT_FLAG_REANNOTATE)) {
+                throw ExceptionHandler("Unable to re-annotate, previous DIAMOND results not found in: " +
+                                       mSimSearchDir, ERR_ENTAP_INPUT_PARSE);
+            }
             ptr->execute();
         }
         ptr->parse();
@@ -0,0 +1,121 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "StringInterner.h"
+#include "ExceptionHandler.h"
+
+constexpr StringInterner::handle_t StringInterner::EMPTY_HANDLE;
+constexpr StringInterner::handle_t StringInterner::HANDLE_NOT_FOUND;
+constexpr uint32 StringInterner::CHUNK_SIZE;
+
+StringInterner::StringInterner() {
+    mCount = 0;
+    std::fill(mChunks, mChunks + CHUNK_MAX, nullptr);
+}
+
+StringInterner::~StringInterner() {
+    for (std::string *chunk : mChunks) {
+        delete[] chunk;
+    }
+}
+
+StringInterner &StringInterner::instance() {
+    static StringInterner interner;
+    return interner;
+}
+
+/**
+ * ======================================================================
+ * Function handle_t StringInterner::intern(const std::string &val)
+ *
+ * Description          - Returns handle of a string, storing it if it has
+ *                        not been interned yet
+ *
+ * Notes                - Thread safe
+ *
+ * @param val           - String to intern
+ *
+ * @return              - Stable handle of the string
+ *
+ * =====================================================================
+ */
+StringInterner::handle_t StringInterner::intern(const std::string &val) {
+    StringInterner &interner = instance();
+    std::lock_guard<std::mutex> lock(interner.mMutex);
+
+    // Empty string is always reserved as the first handle
+    if (interner.mCount == 0) {
+        interner.mChunks[0] = new std::string[CHUNK_SIZE];
+        interner.mHandles.emplace(&interner.mChunks[0][0], EMPTY_HANDLE);
+        interner.mCount = 1;
+    }
+
+    handle_map_t::iterator it = interner.mHandles.find(&val);
+    if (it != interner.mHandles.end()) return it->second;
+
+    if (interner.mCount == HANDLE_NOT_FOUND) {
+        throw ExceptionHandler("Maximum number of interned strings reached", ERR_ENTAP_MEM_ALLOC);
+    }
+
+    handle_t handle = interner.mCount++;
+    std::string *&chunk = interner.mChunks[handle >> CHUNK_BITS];
+    if (chunk == nullptr) chunk = new std::string[CHUNK_SIZE];
+    std::string &stored = chunk[handle & (CHUNK_SIZE - 1)];
+    stored = val;
+    interner.mHandles.emplace(&stored, handle);
+    return handle;
+}
+
+/**
+ * ======================================================================
+ * Function handle_t StringInterner::find(const std::string &val)
+ *
+ * Description          - Returns handle of a string without interning it
+ *
+ * Notes                - Thread safe
+ *
+ * @param val           - String to find
+ *
+ * @return              - Handle of the string or HANDLE_NOT_FOUND
+ *
+ * =====================================================================
+ */
+StringInterner::handle_t StringInterner::find(const std::string &val) {
+    if (val.empty()) return EMPTY_HANDLE;
+
+    StringInterner &interner = instance();
+    std::lock_guard<std::mutex> lock(interner.mMutex);
+    handle_map_t::iterator it = interner.mHandles.find(&val);
+    return it != interner.mHandles.end() ? it->second : HANDLE_NOT_FOUND;
+}
+
+const std::string &StringInterner::get(handle_t handle) {
+    static const std::string EMPTY_STRING;
+    if (handle == EMPTY_HANDLE) return EMPTY_STRING;
+    return instance().mChunks[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)];
+}
@@ -0,0 +1,91 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_STRINGINTERNER_H
+#define ENTAP_STRINGINTERNER_H
+
+#include <mutex>
+#include <unordered_map>
+#include "common.h"
+
+/**
+ * ======================================================================
+ * @class StringInterner
+ *
+ * Description          - Process wide storage of repeated strings (database
+ *                        paths, species, lineages, tax scopes...)
+ *                      - Each unique string is stored once and referenced by
+ *                        a stable 32bit handle, equality checks between
+ *                        interned strings become integer compares
+ *                      - Strings are never removed, references returned by
+ *                        get() are valid for the lifetime of the process
+ *
+ * Notes                - intern/find are thread safe. get() does not lock,
+ *                        handle must have been obtained by the calling thread
+ *                        or passed to it through a synchronized path
+ *
+ * ======================================================================
+ */
+class StringInterner {
+
+public:
+    typedef uint32 handle_t;
+
+    static constexpr handle_t EMPTY_HANDLE     = 0;            // Always the empty string
+    static constexpr handle_t HANDLE_NOT_FOUND = UINT32_MAX;
+
+    static handle_t intern(const std::string &val);
+    static handle_t find(const std::string &val);
+    static const std::string &get(handle_t handle);
+
+private:
+    struct ptr_hash {
+        size_t operator()(const std::string *val) const {return std::hash<std::string>()(*val);}
+    };
+    struct ptr_equal {
+        bool operator()(const std::string *a, const std::string *b) const {return *a == *b;}
+    };
+    // Keys point into chunk storage so string bytes are never duplicated
+    typedef std::unordered_map<const std::string*, handle_t, ptr_hash, ptr_equal> handle_map_t;
+
+    StringInterner();
+    ~StringInterner();
+    static StringInterner &instance();
+
+    static constexpr uint32 CHUNK_BITS = 16;
+    static constexpr uint32 CHUNK_SIZE = (1 << CHUNK_BITS);
+    static constexpr uint32 CHUNK_MAX  = (1 << (32 - CHUNK_BITS));
+
+    std::mutex    mMutex;
+    handle_map_t  mHandles;
+    uint32        mCount;
+    std::string  *mChunks[CHUNK_MAX];   // Fixed table of chunks, never reallocated
+};
+
+
+#endif //ENTAP_STRINGINTERNER_H
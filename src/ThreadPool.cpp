@@ -0,0 +1,123 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ThreadPool.h"
+#include "FileSystem.h"
+
+ThreadPool::ThreadPool(uint16 threads) {
+    mPendingTasks = 0;
+    mStopping     = false;
+    if (threads == 0) threads = 1;
+    for (uint16 i = 0; i < threads; i++) {
+        mWorkers.emplace_back(&ThreadPool::worker, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait_all();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mTaskCondition.notify_all();
+    for (std::thread &thread : mWorkers) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void ThreadPool::enqueue(std::function<void()> task)
+ *
+ * Description          - Queues task to be executed by the next free worker
+ *
+ * Notes                - None
+ *
+ * @param task          - Task to execute
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTasks.push(std::move(task));
+        mPendingTasks++;
+    }
+    mTaskCondition.notify_one();
+}
+
+/**
+ * ======================================================================
+ * Function void ThreadPool::wait_all()
+ *
+ * Description          - Blocks until every queued task has completed
+ *
+ * Notes                - None
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ThreadPool::wait_all() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdleCondition.wait(lock, [this]{return mPendingTasks == 0;});
+}
+
+uint16 ThreadPool::get_thread_count() const {
+    return (uint16) mWorkers.size();
+}
+
+void ThreadPool::worker() {
+    std::function<void()> task;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mTaskCondition.wait(lock, [this]{return mStopping || !mTasks.empty();});
+            if (mTasks.empty()) return;     // Stopping and nothing left to run
+            task = std::move(mTasks.front());
+            mTasks.pop();
+        }
+
+        try {
+            task();
+        } catch (const std::exception &e) {
+            FS_dprint("ERROR uncaught exception in thread pool task: " + std::string(e.what()));
+        } catch (...) {
+            FS_dprint("ERROR uncaught exception in thread pool task");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPendingTasks--;
+        }
+        mIdleCondition.notify_all();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_THREADPOOL_H
+#define ENTAP_THREADPOOL_H
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include "common.h"
+
+/**
+ * ======================================================================
+ * @class ThreadPool
+ *
+ * Description          - Fixed number of worker threads executing queued
+ *                        tasks in FIFO order
+ *                      - Destructor waits for queued tasks to finish and
+ *                        joins workers
+ *
+ * Notes                - Tasks are responsible for their own error handling,
+ *                        exceptions escaping a task are logged and dropped
+ *
+ * ======================================================================
+ */
+class ThreadPool {
+
+public:
+    explicit ThreadPool(uint16 threads);
+    ~ThreadPool();
+    void enqueue(std::function<void()> task);
+    void wait_all();
+    uint16 get_thread_count() const;
+
+private:
+    void worker();
+
+    std::vector<std::thread>          mWorkers;
+    std::queue<std::function<void()>> mTasks;
+    std::mutex                        mMutex;
+    std::condition_variable           mTaskCondition;   // Signaled when a task is queued or pool stops
+    std::condition_variable           mIdleCondition;   // Signaled when a task completes
+    uint64                            mPendingTasks;    // Queued + running tasks
+    bool                              mStopping;
+};
+
+
+#endif //ENTAP_THREADPOOL_H
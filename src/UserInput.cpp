@@ -89,6 +89,16 @@
                             "files\n"                                                   \
                             "Note: do NOT use this if you would like to pickup from "    \
                             "a previous run!"
+#define CMD_REANNOTATE      "reannotate"
+#define DESC_REANNOTATE     "Re-annotate a previous run against an updated EnTAP database "\
+                            "without running DIAMOND again.\n"                           \
+                            "This resumes the run as it would without --overwrite: "     \
+                            "previous similarity search and ontology results in the "    \
+                            "output directory are reused and final outputs are written " \
+                            "again. In addition, records changed since the previous run "\
+                            "are reported and the run fails if previous DIAMOND results "\
+                            "are missing.\n"                                             \
+                            "Cannot be used with --overwrite"
 #define CMD_INI_FILE        "ini"
 #define DESC_INI_FILE      "Specify path to the entap_config.ini file that will "       \
                             "be used to find all of the configuration data!"
@@ -131,6 +141,11 @@
 #define DESC_ENTAP_DB_BIN   "Path to the EnTAP binary database"
 #define CMD_ENTAP_DB_SQL    "entap-db-sql"
 #define DESC_ENTAP_DB_SQL   "Path to the EnTAP SQL database (not needed if you are using the binary database)"
+#define CMD_ENTAP_DB_MAPPED "entap-db-mapped"
+#define DESC_ENTAP_DB_MAPPED "Path to the EnTAP memory mapped database (not needed if you are using the binary database)"
+#define CMD_ENTAP_DB_SHARED "entap-db-shared"
+#define DESC_ENTAP_DB_SHARED "Share the EnTAP binary database between EnTAP runs on the same node. The first run "\
+                             "publishes the database to shared memory and the rest attach to it read only"
 #define CMD_ENTAP_GRAPH_PATH "entap-graph"
 #define DESC_ENTAP_GRAPH_PATH "Path to the EnTAP graphing script (entap_graphing.py)"
 
@@ -145,10 +160,36 @@
                             "generate.\n"                                               \
                             "    0. Serialized Database (default)\n"                    \
                             "    1. SQLITE Database\n"                                  \
-                            "Either or both can be selected with an additional flag. "  \
+                            "    2. Memory Mapped Database\n"                           \
+                            "Multiple can be selected with an additional flag. "        \
                             "The serialized database will be faster although requires " \
                             "more memory usage. The SQLITE database may be slightly "   \
-                            "slower."
+                            "slower. The memory mapped database opens instantly and "   \
+                            "only loads the data that is used."
+#define CMD_DATABASE_PLAIN  "data-plain"
+#define DESC_DATABASE_PLAIN "Write the serialized EnTAP database as a plain archive instead "\
+                            "of compressed blocks. Plain archives load slower although can " \
+                            "be read by older versions of EnTAP"
+#define CMD_DATABASE_DELTA  "data-delta"
+#define DESC_DATABASE_DELTA "Apply a delta file (records added, changed, or removed by "  \
+                            "accession) to an existing serialized EnTAP database instead " \
+                            "of generating it again. Multiple deltas are applied in order,"\
+                            " deltas already applied are skipped.\n"                    \
+                            "Lines are tab delimited:\n"                                 \
+                            "    RELEASE    source  release\n"                          \
+                            "    ADD/CHANGE TAXONOMY name tax_id lineage\n"              \
+                            "    ADD/CHANGE GO go_id term category level parents\n"      \
+                            "    ADD/CHANGE UNIPROT uniprot_id xrefs comments kegg go_ids\n"\
+                            "    REMOVE     TAXONOMY/GO/UNIPROT key\n"                   \
+                            "GO parents are comma separated is_a/part_of parent IDs used " \
+                            "by --go-propagate. They are required to ADD a term, CHANGE " \
+                            "without them keeps the current parents. Only the serialized " \
+                            "database can be updated"
+#define CMD_DATABASE_MIRROR "data-mirror"
+#define DESC_DATABASE_MIRROR "Base URL to download database files from instead of their "  \
+                            "public servers. Each file is fetched from <url>/<host>/<path> "\
+                            "of its published address, the layout of a recursive wget "    \
+                            "mirror, so a local server may stand in for the sources"
 
 
 /* ---------------- Expression Analysis Commands -------------*/
@@ -292,6 +333,10 @@
                             "It is possible to specify multiple flags as well with\n"   \
                             "multiple --level flags\n"                                  \
                             "Example: --level 0 --level 3 --level 1"
+#define CMD_GO_PROPAGATE   "go-propagate"
+#define DESC_GO_PROPAGATE   "Propagate Gene Ontology terms assigned by EggNOG and InterProScan to all of their\n"\
+                            "ancestor terms (is_a/part_of) before they are printed and filtered by level.\n"  \
+                            "Requires an EnTAP database configured with the Gene Ontology graph"
 
 /* BUSCO */
 #define CMD_BUSCO_EXE      "busco-exe"
@@ -356,7 +401,9 @@ const std::string UserInput::BIN_PATH_DEFAULT                 = "/bin";
 const std::string UserInput::DATABASE_DIR_DEFAULT             = "/databases";
 const std::string UserInput::ENTAP_DATABASE_SQL_FILENAME      = "entap_database.db";
 const std::string UserInput::ENTAP_DATABASE_SERIAL_FILENAME   = "entap_database.bin";
+const std::string UserInput::ENTAP_DATABASE_MAPPED_FILENAME   = "entap_database.mmap";
 const std::string UserInput::ENTAP_DATABASE_BIN_DEFAULT       = PATHS(BIN_PATH_DEFAULT, ENTAP_DATABASE_SERIAL_FILENAME);
+const std::string UserInput::ENTAP_DATABASE_MAPPED_DEFAULT    = PATHS(BIN_PATH_DEFAULT, ENTAP_DATABASE_MAPPED_FILENAME);
 const std::string UserInput::ENTAP_DATABASE_SQL_DEFAULT       = PATHS(DATABASE_DIR_DEFAULT, ENTAP_DATABASE_SQL_FILENAME);
 const std::string UserInput::EGG_SQL_DB_DEFAULT               = PATHS(DATABASE_DIR_DEFAULT, EGG_SQL_DB_FILENAME);
 const std::string UserInput::EGG_DMND_DEFAULT                 = PATHS(BIN_PATH_DEFAULT, EGG_DMND_FILENAME);
@@ -377,6 +424,7 @@ const std::string UserInput::DEFAULT_OUT_DIR             = PATHS(FileSystem::get
 const std::string UserInput::DEFAULT_INI_PATH            = PATHS(FileSystem::get_cur_dir(), ENTAP_INI_FILENAME);
 const std::string UserInput::DEFAULT_ENTAP_DB_BIN_INI    = PATHS(FileSystem::get_exe_dir(), ENTAP_DATABASE_BIN_DEFAULT);
 const std::string UserInput::DEFAULT_ENTAP_DB_SQL_INI    = PATHS(FileSystem::get_exe_dir(), ENTAP_DATABASE_SQL_DEFAULT);
+const std::string UserInput::DEFAULT_ENTAP_DB_MAPPED_INI = PATHS(FileSystem::get_exe_dir(), ENTAP_DATABASE_MAPPED_DEFAULT);
 const std::string UserInput::DEFAULT_EGG_SQL_DB_INI      = PATHS(FileSystem::get_exe_dir(), EGG_SQL_DB_DEFAULT);
 const std::string UserInput::DEFAULT_EGG_DMND_DB_INI     = PATHS(FileSystem::get_exe_dir(), EGG_DMND_DEFAULT);
 const std::string UserInput::DEFAULT_ENTAP_GRAPH_INI     = PATHS(FileSystem::get_exe_dir(), GRAPH_SCRIPT_DEF);
@@ -394,6 +442,7 @@ UserInput::EntapINIEntry UserInput::mUserInputs[] = {
         {INI_GENERAL   ,CMD_RUN_PROTEIN          ,ENTAP_INI_NULL  ,DESC_RUN_PROTEIN           ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
         {INI_GENERAL   ,CMD_RUN_NUCLEO           ,ENTAP_INI_NULL  ,DESC_RUN_NUCLEO            ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
         {INI_GENERAL   ,CMD_OVERWRITE            ,ENTAP_INI_NULL  ,DESC_OVERWRITE             ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
+        {INI_GENERAL   ,CMD_REANNOTATE           ,ENTAP_INI_NULL  ,DESC_REANNOTATE            ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
         {INI_GENERAL   ,CMD_INI_FILE             ,ENTAP_INI_NULL  ,DESC_INI_FILE              ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_INI_PATH       ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
 //        {INI_GENERAL   ,CMD_HELP                 ,CMD_SHORT_HELP       ,DESC_HELP             ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL   ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
 //        {INI_GENERAL   ,CMD_VERSION              ,CMD_SHORT_VERSION    ,DESC_VERSION          ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL   ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
@@ -409,12 +458,17 @@ UserInput::EntapINIEntry UserInput::mUserInputs[] = {
 /* EnTAP Commands */
         {INI_ENTAP     ,CMD_ENTAP_DB_BIN         ,ENTAP_INI_NULL  ,DESC_ENTAP_DB_BIN          ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_ENTAP_DB_BIN_INI, ENT_INI_FILE        ,ENTAP_INI_NULL_VAL},
         {INI_ENTAP     ,CMD_ENTAP_DB_SQL         ,ENTAP_INI_NULL  ,DESC_ENTAP_DB_SQL          ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_ENTAP_DB_SQL_INI, ENT_INI_FILE        ,ENTAP_INI_NULL_VAL},
+        {INI_ENTAP     ,CMD_ENTAP_DB_MAPPED      ,ENTAP_INI_NULL  ,DESC_ENTAP_DB_MAPPED       ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_ENTAP_DB_MAPPED_INI, ENT_INI_FILE     ,ENTAP_INI_NULL_VAL},
+        {INI_ENTAP     ,CMD_ENTAP_DB_SHARED      ,ENTAP_INI_NULL  ,DESC_ENTAP_DB_SHARED       ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_INI_FILE          ,ENTAP_INI_NULL_VAL},
         {INI_ENTAP     ,CMD_ENTAP_GRAPH_PATH     ,ENTAP_INI_NULL  ,DESC_ENTAP_GRAPH_PATH      ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_ENTAP_GRAPH_INI , ENT_INI_FILE        ,ENTAP_INI_NULL_VAL},
         {INI_ENTAP     ,ENTAP_INI_NULL           ,ENTAP_INI_NULL  ,ENTAP_INI_NULL             ,ENTAP_INI_NULL   ,ENT_INI_VAR_MULTI_INT,ENTAP_INI_NULL_VAL      , ENT_INPUT_FUTURE    ,ENTAP_INI_NULL_VAL},
 
 /* Configuration Commands */
         {INI_CONFIG    ,CMD_DATA_GENERATE        ,ENTAP_INI_NULL  ,DESC_DATA_GENERATE         ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
         {INI_CONFIG    ,CMD_DATABASE_TYPE        ,ENTAP_INI_NULL  ,DESC_DATABASE_TYPE         ,ENTAP_INI_NULL   ,ENT_INI_VAR_MULTI_INT   ,DEFAULT_DATA_TYPE      ,ENT_INI_FILE          ,ENTAP_INI_NULL_VAL},
+        {INI_CONFIG    ,CMD_DATABASE_PLAIN       ,ENTAP_INI_NULL  ,DESC_DATABASE_PLAIN        ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
+        {INI_CONFIG    ,CMD_DATABASE_DELTA       ,ENTAP_INI_NULL  ,DESC_DATABASE_DELTA        ,ENTAP_INI_NULL   ,ENT_INI_VAR_MULTI_STRING,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
+        {INI_CONFIG    ,CMD_DATABASE_MIRROR      ,ENTAP_INI_NULL  ,DESC_DATABASE_MIRROR       ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,ENTAP_INI_NULL_VAL     ,ENT_COMMAND_LINE      ,ENTAP_INI_NULL_VAL},
 
 /* Expression Analysis Commands */
         {INI_EXPRESSION,CMD_FPKM                 ,ENTAP_INI_NULL  ,DESC_FPKM                  ,ENTAP_INI_NULL   ,ENT_INI_VAR_FLOAT       ,RSEM_FPKM_DEFAULT      ,ENT_INI_FILE          ,ENTAP_INI_NULL_VAL},
@@ -452,6 +506,7 @@ UserInput::EntapINIEntry UserInput::mUserInputs[] = {
 /* Ontology Commands */
         {INI_ONTOLOGY  ,CMD_ONTOLOGY_FLAG        ,ENTAP_INI_NULL  ,DESC_ONTOLOGY_FLAG         ,ENTAP_INI_NULL   ,ENT_INI_VAR_MULTI_INT   ,DEFAULT_ONTOLOGY       ,ENT_INI_FILE, ENTAP_INI_NULL_VAL},
         {INI_ONTOLOGY  ,CMD_GO_LEVELS            ,ENTAP_INI_NULL  ,DESC_ONT_LEVELS            ,ENTAP_INI_NULL   ,ENT_INI_VAR_MULTI_INT   ,DEFAULT_ONT_LEVELS     ,ENT_INI_FILE, ENTAP_INI_NULL_VAL},
+        {INI_ONTOLOGY  ,CMD_GO_PROPAGATE         ,ENTAP_INI_NULL  ,DESC_GO_PROPAGATE          ,ENTAP_INI_NULL   ,ENT_INI_VAR_BOOL        ,ENTAP_INI_NULL_VAL     ,ENT_INI_FILE, ENTAP_INI_NULL_VAL},
 
 /* Ontology - EggNOG Commands */
         {INI_ONT_EGGNOG,CMD_EGGNOG_SQL           ,ENTAP_INI_NULL  ,DESC_EGGNOG_SQL            ,ENTAP_INI_NULL   ,ENT_INI_VAR_STRING      ,DEFAULT_EGG_SQL_DB_INI ,ENT_INI_FILE, ENTAP_INI_NULL_VAL},
@@ -1108,6 +1163,13 @@ bool UserInput::verify_user_input() {
         // Handle EnTAP execution commands
         if (is_run) {
 
+            // Re-annotation reuses previous results, overwriting would remove them
+            if (has_input(INPUT_FLAG_REANNOTATE) && has_input(INPUT_FLAG_OVERWRITE)) {
+                throw ExceptionHandler("Cannot re-annotate a previous run (" + mUserInputs[INPUT_FLAG_REANNOTATE].input +
+                                       ") while overwriting it (" + mUserInputs[INPUT_FLAG_OVERWRITE].input + ")",
+                                       ERR_ENTAP_INPUT_PARSE);
+            }
+
             // Verify EnTAP database can be generated
             FS_dprint("Verifying EnTAP database...");
             pEntap_database = new EntapDatabase(mpFileSystem, this);
@@ -1261,6 +1323,17 @@ bool UserInput::verify_user_input() {
         } else {
             // Must be config
 
+            // Verify database deltas exist
+            if (has_input(INPUT_FLAG_DATABASE_DELTA)) {
+                FS_dprint("Verifying input flag " + mUserInputs[INPUT_FLAG_DATABASE_DELTA].input);
+                ent_input_multi_str_t deltas = get_user_input<ent_input_multi_str_t>(INPUT_FLAG_DATABASE_DELTA);
+                for (std::string &delta : deltas) {
+                    if (!mpFileSystem->file_exists(delta)) {
+                        throw ExceptionHandler("EnTAP database delta not found at: " + delta, ERR_ENTAP_INPUT_PARSE);
+                    }
+                }
+            }
+
             // Verify BUSCO database if the user has input it
             if (has_input(INPUT_FLAG_BUSCO_DATABASE)) {
                 FS_dprint("Verifying input flag " + mUserInputs[INPUT_FLAG_BUSCO_DATABASE].input);
@@ -1494,7 +1567,7 @@ void UserInput::verify_species(SPECIES_FLAGS flag, EntapDatabase *database) {
     if (species.empty()) return;
 
     for (std::string &s : species) {
-        if (database->get_tax_entry(s).is_empty()) {
+        if (database->get_tax_entry(s)->is_empty()) {
             throw ExceptionHandler("Error in one of your inputted taxons: " + s + " it is not located"
                                    " within the taxonomic database. You may remove it or select another",
                                     ERR_ENTAP_INPUT_PARSE);
@@ -1864,6 +1937,10 @@ const std::string &UserInput::getENTAP_DATABASE_SQL_DEFAULT() {
     return ENTAP_DATABASE_SQL_DEFAULT;
 }
 
+const std::string &UserInput::getENTAP_DATABASE_MAPPED_DEFAULT() {
+    return ENTAP_DATABASE_MAPPED_DEFAULT;
+}
+
 // Returns false if unable to determine whether we want to run frame selection
 bool UserInput::run_frame_selection(QueryData *queryData, bool &run_frame_selection) {
     FS_dprint("Determining if we want to run frame selection...");
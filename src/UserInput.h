@@ -61,6 +61,7 @@ typedef enum {
     INPUT_FLAG_RUNPROTEIN,
     INPUT_FLAG_RUNNUCLEOTIDE,
     INPUT_FLAG_OVERWRITE,
+    INPUT_FLAG_REANNOTATE,
     INPUT_FLAG_INI_FILE,
 //    INPUT_FLAG_HELP,      // Native to TCLAP
 //    INPUT_FLAG_VERSION,   // Native to TCLAP
@@ -76,12 +77,17 @@ typedef enum {
     /* EnTAP Commands */
     INPUT_FLAG_ENTAP_DB_BIN,
     INPUT_FLAG_ENTAP_DB_SQL,
+    INPUT_FLAG_ENTAP_DB_MAPPED,
+    INPUT_FLAG_ENTAP_DB_SHARED,
     INPUT_FLAG_ENTAP_GRAPH,
     INPUT_FLAG_ENTAP_HEADERS,
 
     /* Configuration Commands */
     INPUT_FLAG_DATABASE_GENERATE,
     INPUT_FLAG_DATABASE_TYPE,
+    INPUT_FLAG_DATABASE_PLAIN,
+    INPUT_FLAG_DATABASE_DELTA,
+    INPUT_FLAG_DATABASE_MIRROR,
 
     /* Expression Analysis Commands */
     INPUT_FLAG_FPKM,
@@ -119,6 +125,7 @@ typedef enum {
     /* Ontology Commands */
     INPUT_FLAG_ONTOLOGY,
     INPUT_FLAG_GO_LEVELS,
+    INPUT_FLAG_GO_PROPAGATE,
 
     /* Ontology Commands - EggNOG */
     INPUT_FLAG_EGG_SQL_DB,
@@ -148,6 +155,7 @@ public:
     static std::string getBIN_PATH_DEFAULT();
     static const std::string &getENTAP_DATABASE_BIN_DEFAULT();
     static const std::string &getENTAP_DATABASE_SQL_DEFAULT();
+    static const std::string &getENTAP_DATABASE_MAPPED_DEFAULT();
     static const std::string &getEGG_SQL_DB_FILENAME();
     static const std::string &getEGG_DMND_FILENAME();
     static const std::string &getEGG_SQL_DB_DEFAULT();
@@ -283,12 +291,15 @@ private:
     static const std::string DATABASE_DIR_DEFAULT              ;
     static const std::string ENTAP_DATABASE_SQL_FILENAME       ;
     static const std::string ENTAP_DATABASE_SERIAL_FILENAME    ;
+    static const std::string ENTAP_DATABASE_MAPPED_FILENAME    ;
     static const std::string ENTAP_DATABASE_BIN_DEFAULT        ;
     static const std::string ENTAP_DATABASE_SQL_DEFAULT        ;
+    static const std::string ENTAP_DATABASE_MAPPED_DEFAULT     ;
     static const std::string EGG_SQL_DB_DEFAULT                ;
     static const std::string EGG_DMND_DEFAULT                  ;
     static const std::string DEFAULT_ENTAP_DB_BIN_INI;
     static const std::string DEFAULT_ENTAP_DB_SQL_INI;
+    static const std::string DEFAULT_ENTAP_DB_MAPPED_INI;
     static const std::string DEFAULT_EGG_SQL_DB_INI;
     static const std::string DEFAULT_EGG_DMND_DB_INI;
     static const std::string DEFAULT_ENTAP_GRAPH_INI;
@@ -0,0 +1,376 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+//*********************** Includes *****************************
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include "BlockCompressor.h"
+#include "../ThreadPool.h"
+//**************************************************************
+
+const char BlockCompressor::MAGIC[8] = {'E','N','T','A','P','B','L','K'};
+
+/**
+ * ======================================================================
+ * Function bool BlockCompressor::is_compressed(const std::string &path)
+ *
+ * Description          - Checks whether file was written by BlockCompressor
+ *
+ * Notes                - Serialized databases generated by older versions
+ *                        are plain archives
+ *
+ * @param path          - Path to file
+ *
+ * @return              - True if file begins with block compressed magic
+ *
+ * =====================================================================
+ */
+bool BlockCompressor::is_compressed(const std::string &path) {
+    char magic[sizeof(MAGIC)];
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.read(magic, sizeof(magic))) return false;
+    return memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * ======================================================================
+ * Function bool BlockCompressor::write(const std::string &path, const std::string &data,
+ *                                      uint16 threads, std::string &err_msg)
+ *
+ * Description          - Compresses data in fixed size blocks (in parallel)
+ *                        and writes header, block index, and blocks to file
+ *
+ * Notes                - None
+ *
+ * @param path          - Output path
+ * @param data          - Buffer to compress
+ * @param threads       - Threads to compress with
+ * @param err_msg       - Set on error
+ *
+ * @return              - True if successful
+ *
+ * =====================================================================
+ */
+bool BlockCompressor::write(const std::string &path, const std::string &data, uint16 threads,
+                            std::string &err_msg) {
+    FileHeader               header;
+    std::vector<BlockEntry>  index;
+    std::vector<std::string> blocks;
+    uint64                   offset;
+
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.block_size     = BLOCK_SIZE;
+    header.raw_size       = data.size();
+    header.block_count    = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    index.resize(header.block_count);
+    blocks.resize(header.block_count);
+    {
+        ThreadPool threadPool(threads == 0 ? (uint16) 1 : threads);
+        for (uint64 i = 0; i < header.block_count; i++) {
+            threadPool.enqueue([&data, &blocks, &index, i] {
+                uint32 raw_size = (uint32) std::min((uint64) BLOCK_SIZE, data.size() - i * BLOCK_SIZE);
+                compress_block(data.data() + i * BLOCK_SIZE, raw_size, blocks[i]);
+                if (blocks[i].size() >= raw_size) {
+                    // Incompressible, store as is
+                    blocks[i].assign(data.data() + i * BLOCK_SIZE, raw_size);
+                }
+                index[i].raw_size        = raw_size;
+                index[i].compressed_size = (uint32) blocks[i].size();
+            });
+        }
+        threadPool.wait_all();
+    }
+
+    offset = sizeof(FileHeader) + index.size() * sizeof(BlockEntry);
+    for (BlockEntry &entry : index) {
+        entry.offset = offset;
+        offset += entry.compressed_size;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        err_msg = "Unable to open compressed EnTAP database for writing at: " + path;
+        return false;
+    }
+    file.write((const char*) &header, sizeof(FileHeader));
+    file.write((const char*) index.data(), index.size() * sizeof(BlockEntry));
+    for (const std::string &block : blocks) {
+        file.write(block.data(), block.size());
+    }
+    file.close();
+    if (!file) {
+        err_msg = "Error writing compressed EnTAP database to: " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool BlockCompressor::read(const std::string &path, std::string &data,
+ *                                     uint16 threads, std::string &err_msg)
+ *
+ * Description          - Reads block compressed file and decompresses each
+ *                        block (in parallel) directly into its position in
+ *                        the output buffer
+ *
+ * Notes                - Block index and sizes are validated, corrupt
+ *                        blocks are reported rather than read out of bounds
+ *
+ * @param path          - Path to block compressed file
+ * @param data          - Decompressed contents
+ * @param threads       - Threads to decompress with
+ * @param err_msg       - Set on error
+ *
+ * @return              - True if successful
+ *
+ * =====================================================================
+ */
+bool BlockCompressor::read(const std::string &path, std::string &data, uint16 threads,
+                           std::string &err_msg) {
+    FileHeader          header;
+    std::string         compressed;
+    std::atomic<bool>   failed(false);
+    const BlockEntry   *index;
+    uint64              file_size;
+    uint64              raw_offset;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        err_msg = "Unable to open compressed EnTAP database at: " + path;
+        return false;
+    }
+    file_size = (uint64) file.tellg();
+    file.seekg(0);
+    compressed.resize(file_size);
+    if (!file.read(&compressed[0], file_size)) {
+        err_msg = "Unable to read compressed EnTAP database at: " + path;
+        return false;
+    }
+    file.close();
+
+    if (file_size < sizeof(FileHeader)) {
+        err_msg = "Compressed EnTAP database is truncated: " + path;
+        return false;
+    }
+    memcpy(&header, compressed.data(), sizeof(FileHeader));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.format_version != FORMAT_VERSION) {
+        err_msg = "Unrecognized compressed EnTAP database format: " + path;
+        return false;
+    }
+    if (header.block_count > (file_size - sizeof(FileHeader)) / sizeof(BlockEntry)) {
+        err_msg = "Compressed EnTAP database block index is truncated: " + path;
+        return false;
+    }
+    index = (const BlockEntry*) (compressed.data() + sizeof(FileHeader));
+
+    // Validate index before any block is decompressed
+    raw_offset = 0;
+    for (uint64 i = 0; i < header.block_count; i++) {
+        if (index[i].offset > file_size || index[i].compressed_size > file_size - index[i].offset ||
+            index[i].raw_size > header.block_size || index[i].compressed_size > index[i].raw_size) {
+            err_msg = "Compressed EnTAP database block index is corrupt: " + path;
+            return false;
+        }
+        raw_offset += index[i].raw_size;
+    }
+    if (raw_offset != header.raw_size) {
+        err_msg = "Compressed EnTAP database block index is corrupt: " + path;
+        return false;
+    }
+
+    data.resize(header.raw_size);
+    {
+        ThreadPool threadPool(threads == 0 ? (uint16) 1 : threads);
+        raw_offset = 0;
+        for (uint64 i = 0; i < header.block_count; i++) {
+            const BlockEntry *entry = &index[i];
+            char *dst = &data[0] + raw_offset;
+            threadPool.enqueue([&compressed, &failed, entry, dst] {
+                const char *src = compressed.data() + entry->offset;
+                if (entry->compressed_size == entry->raw_size) {
+                    memcpy(dst, src, entry->raw_size);
+                } else if (!decompress_block(src, entry->compressed_size, dst, entry->raw_size)) {
+                    failed = true;
+                }
+            });
+            raw_offset += entry->raw_size;
+        }
+        threadPool.wait_all();
+    }
+    if (failed) {
+        data.clear();
+        err_msg = "Compressed EnTAP database contains a corrupt block: " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function void BlockCompressor::compress_block(const char *src, uint32 size,
+ *                                               std::string &out)
+ *
+ * Description          - Greedy LZ4 block compression, a hash of every four
+ *                        bytes points to their last position
+ *
+ * Notes                - Follows LZ4 end of block rules so output can be
+ *                        read by standard LZ4 block decoders
+ *
+ * @param src           - Block to compress
+ * @param size          - Block size
+ * @param out           - Compressed block
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void BlockCompressor::compress_block(const char *src, uint32 size, std::string &out) {
+    std::vector<uint32> table(1u << HASH_LOG, UINT32_MAX);
+    const uint8 *in = (const uint8*) src;
+    uint32 pos = 0;
+    uint32 anchor = 0;
+    uint32 sequence;
+    uint32 ref;
+    uint32 hash;
+    uint32 length;
+
+    auto write_length = [&out](uint32 len) {
+        while (len >= 255) {
+            out.push_back((char) 255);
+            len -= 255;
+        }
+        out.push_back((char) len);
+    };
+    // Literals from anchor, then match (if any) as one LZ4 sequence
+    auto write_sequence = [&](uint32 literal_end, uint32 offset, uint32 match_length) {
+        uint32 literals = literal_end - anchor;
+        uint8  token = (uint8) (std::min(literals, (uint32) 15) << 4);
+        if (offset != 0) token |= (uint8) std::min(match_length - MIN_MATCH, (uint32) 15);
+        out.push_back((char) token);
+        if (literals >= 15) write_length(literals - 15);
+        out.append(src + anchor, literals);
+        if (offset == 0) return;
+        out.push_back((char) (offset & 0xFF));
+        out.push_back((char) (offset >> 8));
+        if (match_length - MIN_MATCH >= 15) write_length(match_length - MIN_MATCH - 15);
+    };
+
+    out.clear();
+    out.reserve(size / 2);
+    if (size > MATCH_LIMIT) {
+        while (pos < size - MATCH_LIMIT) {
+            memcpy(&sequence, in + pos, sizeof(sequence));
+            hash = (sequence * 2654435761u) >> (32 - HASH_LOG);
+            ref = table[hash];
+            table[hash] = pos;
+            if (ref == UINT32_MAX || pos - ref > MAX_OFFSET || memcmp(in + ref, in + pos, MIN_MATCH) != 0) {
+                pos++;
+                continue;
+            }
+            length = MIN_MATCH;
+            while (pos + length < size - LAST_LITERALS && in[ref + length] == in[pos + length]) length++;
+            write_sequence(pos, pos - ref, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    write_sequence(size, 0, 0);
+}
+
+/**
+ * ======================================================================
+ * Function bool BlockCompressor::decompress_block(const char *src, uint32 size,
+ *                                                 char *dst, uint32 raw_size)
+ *
+ * Description          - LZ4 block decompression with bounds checking
+ *
+ * Notes                - None
+ *
+ * @param src           - Compressed block
+ * @param size          - Compressed block size
+ * @param dst           - Output, raw_size bytes
+ * @param raw_size      - Decompressed block size
+ *
+ * @return              - False if block is corrupt
+ *
+ * =====================================================================
+ */
+bool BlockCompressor::decompress_block(const char *src, uint32 size, char *dst, uint32 raw_size) {
+    const uint8 *in = (const uint8*) src;
+    const uint8 *in_end = in + size;
+    uint8       *out = (uint8*) dst;
+    uint8       *out_end = out + raw_size;
+    uint64       length;
+    uint32       offset;
+    uint8        token;
+    uint8        extra;
+
+    while (in < in_end) {
+        token = *in++;
+
+        // Literals
+        length = token >> 4;
+        if (length == 15) {
+            do {
+                if (in == in_end) return false;
+                extra = *in++;
+                length += extra;
+            } while (extra == 255);
+        }
+        if (length > (uint64) (in_end - in) || length > (uint64) (out_end - out)) return false;
+        memcpy(out, in, length);
+        in  += length;
+        out += length;
+        if (in == in_end) break;    // Last sequence has no match
+
+        // Match
+        if (in_end - in < 2) return false;
+        offset = (uint32) in[0] | ((uint32) in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (uint64) (out - (uint8*) dst)) return false;
+        length = token & 0x0F;
+        if (length == 15) {
+            do {
+                if (in == in_end) return false;
+                extra = *in++;
+                length += extra;
+            } while (extra == 255);
+        }
+        length += MIN_MATCH;
+        if (length > (uint64) (out_end - out)) return false;
+        // Byte copy, match may overlap output
+        for (const uint8 *match = out - offset; length > 0; length--) *out++ = *match++;
+    }
+    return out == out_end;
+}
@@ -0,0 +1,100 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ENTAP_BLOCKCOMPRESSOR_H
+#define ENTAP_BLOCKCOMPRESSOR_H
+
+#include <streambuf>
+#include "../common.h"
+
+/**
+ * ======================================================================
+ * @class BlockCompressor
+ *
+ * Description          - Stores a buffer (serialized EnTAP database) as
+ *                        independently compressed blocks with a block index
+ *                      - Blocks use the LZ4 block format, compressed and
+ *                        decompressed in parallel straight to/from memory so
+ *                        the uncompressed database never lands on disk
+ *
+ * Notes                - Codec is self contained, no compression library
+ *                        is required
+ *                      - Blocks that do not compress are stored as is
+ *
+ * ======================================================================
+ */
+class BlockCompressor {
+
+public:
+    static bool is_compressed(const std::string &path);
+    static bool write(const std::string &path, const std::string &data, uint16 threads,
+                      std::string &err_msg);
+    static bool read(const std::string &path, std::string &data, uint16 threads,
+                     std::string &err_msg);
+
+    // Read only stream buffer over memory, avoids copying decompressed data into a stringstream
+    class MemoryBuffer : public std::streambuf {
+    public:
+        MemoryBuffer(const char *data, uint64 size) {
+            char *begin = const_cast<char*>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+
+private:
+    static constexpr uint32 FORMAT_VERSION = 1;
+    static constexpr uint32 BLOCK_SIZE     = 4 * 1024 * 1024;
+    static constexpr uint32 HASH_LOG       = 16;
+    static constexpr uint32 MIN_MATCH      = 4;
+    static constexpr uint32 MAX_OFFSET     = 65535;
+    static constexpr uint32 LAST_LITERALS  = 5;     // LZ4 format, sequences end with literals
+    static constexpr uint32 MATCH_LIMIT    = 12;    // LZ4 format, no match starts this close to the end
+    static const char       MAGIC[8];
+
+    // On disk layout, block data follows the index
+    struct FileHeader {
+        char         magic[8];
+        uint32       format_version;
+        uint32       block_size;
+        uint64       raw_size;
+        uint64       block_count;
+    };
+
+    struct BlockEntry {
+        uint64 offset;              // From start of file
+        uint32 compressed_size;     // Equal to raw_size if block is stored uncompressed
+        uint32 raw_size;
+    };
+
+    static void compress_block(const char *src, uint32 size, std::string &out);
+    static bool decompress_block(const char *src, uint32 size, char *dst, uint32 raw_size);
+};
+
+
+#endif //ENTAP_BLOCKCOMPRESSOR_H
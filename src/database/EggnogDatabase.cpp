@@ -27,6 +27,11 @@
 
 #include "EggnogDatabase.h"
 #include "../QueryData.h"
+#include "../DownloadManager.h"
+#include "../ThreadPool.h"
+#include <sys/stat.h>
+#include <cstdio>
+#include <unordered_set>
 
 const std::unordered_map<std::string,std::string> EggnogDatabase::EGGNOG_LEVELS = {
         {"acoNOG", "Aconoidasida"},
@@ -233,94 +238,103 @@ const vect_str_t EggnogDatabase::TAXONOMIC_RESOLUTION = {"apiNOG", "virNOG", "ne
                                          "fuNOG", "opiNOG", "euNOG", "arNOG", "bactNOG",
                                          "NOG"};
 
+const std::string EggnogDatabase::EGGNOG_INDEX_EXT = ".index";
+
 
 EggnogDatabase::EggnogDatabase(FileSystem* filesystem, EntapDatabase* entap_data, QueryData* queryData) {
     mpFileSystem = filesystem;
     mpSQLDatabase = nullptr;
+    mpIndex = nullptr;
     mpEntapDatabase = entap_data;
     mpQueryData = queryData;
     mErrMsg = "";
     mErrCode = ERR_EGG_OK;
+    mTempDirectory = PATHS(filesystem->get_temp_outdir(), TEMP_DIRECTORY);
     mVersionMajor = 0;
     mVersionMinor = 0;
     mVersionRev   = 0;
     mSQLVersion = EGGNOG_VERSION_UNKONWN;
+    mMemoLookups = 0;
+    mMemoHits = 0;
 }
 
 EggnogDatabase::~EggnogDatabase() {
     FS_dprint("Killing object - EggNOG Database");
     delete mpSQLDatabase;   // closes on SQLDatabaseHelper destructor
+    delete mpIndex;
 }
 
 EggnogDatabase::ERR_EGGNOG_DB EggnogDatabase::download(EggnogDatabase::EGGNOG_DB_TYPES type, std::string out_path) {
-    std::string temp_path;
-
-
-    switch (type) {
-        case EGGNOG_SQL:
-            FS_dprint("Downloading EggNOG SQL database...");
-            temp_path = PATHS(mpFileSystem->get_temp_outdir(), TEMP_SQL_GZ);
-            if (!mpFileSystem->download_ftp_file(FTP_EGGNOG_SQL, temp_path)) {
-                set_error("Unable to download from FTP address at: " + FTP_EGGNOG_SQL +
-                          mpFileSystem->get_error(), ERR_EGG_SQL_FTP);
-                return ERR_EGG_SQL_FTP;
-            }
-
-            FS_dprint("Success! Decompressing...");
-
-            if (!mpFileSystem->decompress_file(temp_path, out_path, FileSystem::ENT_FILE_GZ)) {
-                set_error("Unable to decompress file at: " + temp_path + mpFileSystem->get_error(),
-                          ERR_EGG_SQL_DECOMP);
-                return ERR_EGG_SQL_DECOMP;
-            }
-            FS_dprint("Success! EggNOG SQL database sent to: " + out_path);
-            break;
-
-        case EGGNOG_DIAMOND:
-            FS_dprint("Downloading EggNOG DIAMOND database...");
-            temp_path = PATHS(mpFileSystem->get_temp_outdir(), TEMP_DMND_GZ);
-            if (!mpFileSystem->download_ftp_file(FTP_EGGNOG_DMND, temp_path)) {
-                set_error("Unable to download from FTP address at: " + FTP_EGGNOG_DMND + mpFileSystem->get_error(),
-                        ERR_EGG_DMND_FTP);
-                mpFileSystem->delete_file(temp_path);
-                return ERR_EGG_DMND_FTP;
-            }
-
-            FS_dprint("Success! Decompressing...");
-
-            if (!mpFileSystem->decompress_file(temp_path, out_path, FileSystem::ENT_FILE_GZ)) {
-                set_error("Unable to decompress file at: " + temp_path +mpFileSystem->get_error(),
-                        ERR_EGG_DMND_DECOMP);
-                mpFileSystem->delete_file(out_path);
-                return ERR_EGG_DMND_DECOMP;
-            }
-            FS_dprint("Success! EggNOG DIAMOND database sent to: " + out_path);
-            break;
-
-        case EGGNOG_FASTA:
-            FS_dprint("Downloading EggNOG DIAMOND database...");
-            temp_path = PATHS(mpFileSystem->get_temp_outdir(), TEMP_FAST_GZ);
-            if (!mpFileSystem->download_ftp_file(FTP_EGGNOG_FASTA, temp_path)) {
-                set_error("Unable to download from FTP address at: " + FTP_EGGNOG_FASTA + mpFileSystem->get_error(),
-                        ERR_EGG_FASTA_FTP);
-                mpFileSystem->delete_file(temp_path);
-                return ERR_EGG_FASTA_FTP;
-            }
-
-            FS_dprint("Success! Decompressing...");
-
-            if (!mpFileSystem->decompress_file(temp_path, out_path, FileSystem::ENT_FILE_GZ)) {
-                set_error("Unable to decompress file at: " + temp_path + mpFileSystem->get_error(),
-                        ERR_EGG_FASTA_DECOMP);
-                mpFileSystem->delete_file(out_path);
-                return ERR_EGG_FASTA_DECOMP;
-            }
-            FS_dprint("Success! EggNOG FASTA sent to: " + out_path);
-            break;
-
-        default:
-            break;
+    return download(std::vector<EGGNOG_DB_TYPES>{type}, vect_str_t{out_path});
+}
 
+/**
+ * ======================================================================
+ * Function ERR_EGGNOG_DB EggnogDatabase::download(const std::vector<EGGNOG_DB_TYPES> &types,
+ *                                                 const vect_str_t &out_paths)
+ *
+ * Description          - Downloads EggNOG databases concurrently
+ *                      - Each file is decompressed to its out path as it
+ *                        downloads
+ *
+ * Notes                - Partial downloads are resumed on the next attempt
+ *                      - Compressed files are written to the EggNOG temp
+ *                        directory
+ *
+ * @param types         - Databases to download
+ * @param out_paths     - Decompressed out path of each database
+ *
+ * @return              - Error code of the first failed download
+ *
+ * =====================================================================
+ */
+EggnogDatabase::ERR_EGGNOG_DB EggnogDatabase::download(const std::vector<EGGNOG_DB_TYPES> &types,
+                                                       const vect_str_t &out_paths) {
+    std::vector<ERR_EGGNOG_DB> err_codes;   // Download error of each type
+
+    mpFileSystem->create_dir(mTempDirectory);
+    DownloadManager downloadManager((uint16) types.size());
+    for (uint16 i = 0; i < types.size(); i++) {
+        DownloadManager::DownloadJob job;
+        job.decompress      = FileSystem::ENT_FILE_GZ;
+        job.decompress_path = out_paths[i];
+        switch (types[i]) {
+            case EGGNOG_SQL:
+                FS_dprint("Downloading EggNOG SQL database...");
+                job.url      = mpFileSystem->get_download_url(FTP_EGGNOG_SQL);
+                job.out_path = PATHS(mTempDirectory, TEMP_SQL_GZ);
+                err_codes.push_back(ERR_EGG_SQL_FTP);
+                break;
+
+            case EGGNOG_DIAMOND:
+                FS_dprint("Downloading EggNOG DIAMOND database...");
+                job.url      = mpFileSystem->get_download_url(FTP_EGGNOG_DMND);
+                job.out_path = PATHS(mTempDirectory, TEMP_DMND_GZ);
+                err_codes.push_back(ERR_EGG_DMND_FTP);
+                break;
+
+            case EGGNOG_FASTA:
+                FS_dprint("Downloading EggNOG FASTA database...");
+                job.url      = mpFileSystem->get_download_url(FTP_EGGNOG_FASTA);
+                job.out_path = PATHS(mTempDirectory, TEMP_FAST_GZ);
+                err_codes.push_back(ERR_EGG_FASTA_FTP);
+                break;
+
+            default:
+                return ERR_EGG_OK;
+        }
+        downloadManager.add_job(job);
+    }
+    downloadManager.run();
+
+    for (uint16 i = 0; i < types.size(); i++) {
+        const DownloadManager::DownloadJob &job = downloadManager.get_job(i);
+        if (!job.success) {
+            set_error("Unable to download from FTP address at: " + job.url + "\n" + job.err_msg, err_codes[i]);
+            mpFileSystem->delete_file(out_paths[i]);
+            return err_codes[i];
+        }
+        FS_dprint("Success! EggNOG database sent to: " + out_paths[i]);
     }
     return ERR_EGG_OK;
 }
@@ -337,13 +351,25 @@ EggnogDatabase::ERR_EGGNOG_DB EggnogDatabase::open_sql(std::string& sql_path) {
         return ERR_EGG_OK;
     }
 
+    mSQLPath = sql_path;
     mpSQLDatabase = new SQLDatabaseHelper();
-    if (!mpSQLDatabase->open(sql_path)) {
+    if (!mpSQLDatabase->open_read_only(sql_path)) {
         FS_dprint("Unable to open SQL database");
         return ERR_EGG_SQL_OPEN;
     }
 
     set_database_version();
+
+    // Precompiled annotation index is optional, hits are resolved through SQL without it
+    if (index_current(sql_path)) {
+        mpIndex = new MappedDatabase();
+        if (mpIndex->open(get_index_path(sql_path))) {
+            FS_dprint("Using EggNOG index at: " + get_index_path(sql_path));
+        } else {
+            FS_dprint("WARNING unable to use EggNOG index, using SQL database: " + mpIndex->get_error());
+            SAFE_DELETE(mpIndex);
+        }
+    }
     return ERR_EGG_OK;
 }
 
@@ -351,12 +377,23 @@ std::string EggnogDatabase::print_err() {
     return "\nEggNOG Database Error: " + mErrMsg;
 }
 
+// EggNOG files in progress are kept here so EnTAP database configuration never removes them
+std::string EggnogDatabase::get_temp_directory() {
+    return mTempDirectory;
+}
+
 void EggnogDatabase::get_eggnog_entry(QuerySequence::EggnogResults *eggnog_data) {
-    std::set<std::string> unique_groups;    // Unique member orthologous groups
-    std::string           temp;
     member_orthologs_t    member_orthologs;
-    std::set<std::string> level_set;
+    const TaxLevels      *target_lvls;      // nullptr when no level matched
     set_str_t             orthologs;        // Selected from member orthologs
+    std::string           key;              // Memo key, empty when no target levels
+    EggnogIndexEntry      annotations;
+
+    // Precompiled index resolves the seed with a single lookup
+    if (mpIndex != nullptr && mpIndex->find_eggnog_entry(eggnog_data->seed_ortholog, annotations)) {
+        apply_annotations(annotations, eggnog_data);
+        return;
+    }
 
     // Get member orthologous groups (0A01R@biNOG,0V8CP@meNOG) from best hit query
     get_member_ogs(eggnog_data);
@@ -366,31 +403,15 @@ void EggnogDatabase::get_eggnog_entry(QuerySequence::EggnogResults *eggnog_data)
 //    get_og_query(eggnog_data);      // populated og_key to be used as index into SQL
 //    get_sql_data(eggnog_data);
 
-
-    // Get unique tax groups (split "0V8CP@meNOG" to meNOG) and max level
-    std::istringstream iss(eggnog_data->member_ogs);
-    while(std::getline(iss, temp, ',')) {
-        unique_groups.insert(temp.substr(temp.find("@")+1));    // add meNOG
-    }
-    // For default taxonomic scope (may want to allow user to change later)
-    for (const std::string &level : EggnogDatabase::TAXONOMIC_RESOLUTION) {
-        if (unique_groups.find(level) != unique_groups.end()) {
-            _it_vect_str = LEVEL_CONTENT.find(level);
-            if (_it_vect_str != LEVEL_CONTENT.end()) {
-                std::copy(_it_vect_str->second.begin(),
-                      _it_vect_str->second.end(),
-                      std::inserter(level_set,level_set.end()));
-            }
-            level_set.insert(level);
-            eggnog_data->tax_scope_lvl_max = level + "[" + std::to_string(level_set.size()) + "]";
-            // Get tax scope readable
-            get_tax_scope(eggnog_data);
-            break;
-        }
+    target_lvls = set_tax_levels(eggnog_data);
+    if (target_lvls != nullptr) {
+        key = memo_key(eggnog_data->seed_ortholog, *target_lvls);
+        if (memo_find(key, eggnog_data)) return;
     }
 
     // Get all member orthologs
-    member_orthologs = get_member_orthologs(member_orthologs, eggnog_data->seed_ortholog, level_set);
+    member_orthologs = get_member_orthologs(member_orthologs, eggnog_data->seed_ortholog,
+                                            target_lvls != nullptr ? target_lvls->names : std::set<std::string>());
     orthologs = member_orthologs["all"];        // default, can change
 
     if (!orthologs.empty()) {
@@ -402,10 +423,726 @@ void EggnogDatabase::get_eggnog_entry(QuerySequence::EggnogResults *eggnog_data)
               // be needed by the user
         }
     }
+    if (!key.empty()) memo_store(key, eggnog_data);
 }
 
 
 
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::get_eggnog_entries(std::vector<QuerySequence::EggnogResults*> &eggnog_results,
+ *                                                   uint16 threads)
+ *
+ * Description          - Batched get_eggnog_entry over many best hits
+ *                      - Hits are split into batches (at most
+ *                        EGGNOG_BATCH_SEQUENCES), each batch resolving member
+ *                        OGs, events, annotations and OG data with a few bulk
+ *                        queries instead of several queries per hit
+ *                      - Seeds in the precompiled index (build_index) skip
+ *                        SQL with a single lookup
+ *                      - Batches are spread over worker threads, each with
+ *                        its own read only connection to the database
+ *
+ * Notes                - Results match get_eggnog_entry. Each batch only
+ *                        writes its own results, so output order is up to
+ *                        the caller and independent of thread count
+ *                      - First error of a worker is rethrown once all
+ *                        workers finish
+ *
+ * @param eggnog_results- EggNOG results of each best hit, seed_ortholog set
+ * @param threads       - Worker threads (and connections)
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::get_eggnog_entries(std::vector<QuerySequence::EggnogResults*> &eggnog_results,
+                                        uint16 threads) {
+    uint64 batch_size;
+    uint64 batch_count;
+    std::atomic<uint64> resolved(0);
+
+    if (eggnog_results.empty()) return;
+    if (threads == 0) threads = 1;
+
+    // Smaller batches when there are too few hits to keep every thread busy
+    batch_size  = std::min(EGGNOG_BATCH_SEQUENCES, (uint64) (eggnog_results.size() + threads - 1) / threads);
+    batch_count = (eggnog_results.size() + batch_size - 1) / batch_size;
+    threads     = (uint16) std::min((uint64) threads, batch_count);
+    FS_dprint("Resolving " + std::to_string(eggnog_results.size()) + " EggNOG entries in " +
+              std::to_string(batch_count) + " batches with " + std::to_string(threads) + " threads...");
+
+    run_workers(threads, [&, batch_size, batch_count](SQLDatabaseHelper *database, uint16 worker, uint16 workers) {
+        std::vector<QuerySequence::EggnogResults*> batch;
+        uint64 start;
+        uint64 end;
+        for (uint64 i = worker; i < batch_count; i += workers) {
+            start = i * batch_size;
+            end   = std::min(start + batch_size, (uint64) eggnog_results.size());
+            batch.assign(eggnog_results.begin() + start, eggnog_results.begin() + end);
+            get_eggnog_batch(database, batch);
+            FS_dprint("EggNOG entries resolved: " + std::to_string(resolved += end - start) + " of " +
+                      std::to_string(eggnog_results.size()));
+        }
+    });
+}
+
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::run_workers(uint16 threads, const worker_t &work)
+ *
+ * Description          - Runs work on worker threads, each with its own read
+ *                        only connection to the SQL database
+ *
+ * Notes                - A single worker runs on the calling thread with the
+ *                        shared connection
+ *                      - First error of a worker is rethrown once all
+ *                        workers finish
+ *
+ * @param threads       - Worker threads (and connections)
+ * @param work          - Called once per worker with its connection
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::run_workers(uint16 threads, const worker_t &work) {
+    std::exception_ptr  worker_error;
+    std::mutex          error_mutex;
+
+    if (threads <= 1) {
+        work(mpSQLDatabase, 0, 1);
+        return;
+    }
+
+    {
+        ThreadPool threadPool(threads);
+        for (uint16 worker = 0; worker < threads; worker++) {
+            threadPool.enqueue([&, worker, threads] {
+                try {
+                    // Connection is only used by this worker, no sqlite mutex needed
+                    SQLDatabaseHelper database;
+                    if (!database.open_read_only(mSQLPath, SQLDatabaseHelper::DEFAULT_MMAP_SIZE,
+                                                 SQLDatabaseHelper::DEFAULT_CACHE_SIZE, true)) {
+                        throw ExceptionHandler("Unable to open EggNOG SQL database at: " + mSQLPath,
+                                               ERR_ENTAP_DATABASE_QUERY);
+                    }
+                    work(&database, worker, threads);
+                    database.close();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!worker_error) worker_error = std::current_exception();
+                }
+            });
+        }
+        threadPool.wait_all();
+    }
+    if (worker_error) std::rethrow_exception(worker_error);
+}
+
+void EggnogDatabase::get_eggnog_batch(SQLDatabaseHelper *database,
+                                      std::vector<QuerySequence::EggnogResults*> &batch) {
+    std::unordered_map<std::string, SeedData>  seeds;       // Keyed to seed ortholog
+    std::vector<std::pair<QuerySequence::EggnogResults*, QuerySequence::EggnogResults*>> repeats; // (hit, first hit)
+
+    for (QuerySequence::EggnogResults *eggnog_data : batch) {
+        if (!eggnog_data->seed_ortholog.empty()) seeds[eggnog_data->seed_ortholog];
+    }
+    if (seeds.empty()) return;
+
+    // Seeds in the precompiled index are resolved by a single lookup, the rest through SQL
+    if (mpIndex != nullptr) {
+        for (auto &pair : seeds) {
+            SeedData &seed = pair.second;
+            if (!mpIndex->find_eggnog_entry(pair.first, seed.annotations)) continue;
+            seed.indexed    = true;
+            seed.found_ogs  = true;
+            seed.member_ogs = seed.annotations.member_ogs;
+        }
+    }
+    query_member_ogs(database, seeds);
+
+    // Tax scope of every hit and target levels of every seed. Seeds already resolved at
+    // their levels (memo) or by an earlier hit of the batch are copied instead
+    for (QuerySequence::EggnogResults *eggnog_data : batch) {
+        if (eggnog_data->seed_ortholog.empty()) continue;
+        SeedData &seed = seeds[eggnog_data->seed_ortholog];
+        if (seed.found_ogs) eggnog_data->member_ogs = seed.member_ogs;
+        if (eggnog_data->member_ogs.empty()) continue;
+        const TaxLevels *target_lvls = set_tax_levels(eggnog_data);
+        if (target_lvls == nullptr) continue;
+        if (seed.first_hit != nullptr) {
+            mMemoLookups++;
+            mMemoHits++;
+            repeats.emplace_back(eggnog_data, seed.first_hit);
+            continue;
+        }
+        seed.memo_key = memo_key(eggnog_data->seed_ortholog, *target_lvls);
+        if (memo_find(seed.memo_key, eggnog_data)) continue;    // Later hits of the seed find it as well
+        seed.first_hit = eggnog_data;
+        if (seed.indexed) continue;
+        seed.resolve     = true;
+        seed.target_lvls = target_lvls;
+        seed.annotations.member_ogs        = eggnog_data->member_ogs;
+        seed.annotations.tax_scope_lvl_max = StringInterner::get(eggnog_data->tax_scope_lvl_max);
+    }
+
+    resolve_seeds(database, seeds);
+
+    // Resolved seeds go to their first hit and the memo, repeated seeds of the batch copy their first hit
+    for (auto &pair : seeds) {
+        if (pair.second.first_hit == nullptr) continue;
+        apply_annotations(pair.second.annotations, pair.second.first_hit);
+        memo_store(pair.second.memo_key, pair.second.first_hit);
+    }
+    for (auto &pair : repeats) copy_annotations(*pair.second, pair.first);
+}
+
+// Member OGs of every seed not found in the index, first row is used as with single lookups
+void EggnogDatabase::query_member_ogs(SQLDatabaseHelper *database, std::unordered_map<std::string, SeedData> &seeds) {
+    vect_str_t  keys;
+    std::string groups_table;
+
+    for (auto &pair : seeds) {
+        if (!pair.second.indexed) keys.push_back(pair.first);
+    }
+    groups_table = mSQLVersion == EGGNOG_VERSION_4_5_1 ? SQL_EGGNOG_TABLE : mSQLMemberTable;
+    sql_bulk_query(database, "SELECT " + SQL_MEMBER_NAME + ", " + SQL_MEMBER_GROUP + " FROM " + groups_table +
+                   " WHERE " + SQL_MEMBER_NAME, keys, [&seeds](SQLDatabaseHelper::Statement &statement) {
+        SeedData &seed = seeds[statement.get_text(0)];
+        if (!seed.found_ogs) seed.member_ogs = statement.get_text(1);
+        seed.found_ogs = true;
+    });
+}
+
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::resolve_seeds(SQLDatabaseHelper *database,
+ *                                            std::unordered_map<std::string, SeedData> &seeds)
+ *
+ * Description          - Resolves annotations of many seed orthologs with a
+ *                        few bulk queries: event indexes, events, orthologs
+ *                        at the target levels, ortholog annotations and OG
+ *                        data
+ *
+ * Notes                - Only seeds marked resolve, with target levels, member
+ *                        OGs and tax level of their annotations set
+ *                      - GO terms are left as IDs, they are interned when
+ *                        annotations are applied to a hit
+ *
+ * @param database      - Connection to query
+ * @param seeds         - Seeds keyed to seed ortholog, annotations are set
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::resolve_seeds(SQLDatabaseHelper *database, std::unordered_map<std::string, SeedData> &seeds) {
+    std::unordered_map<int64, std::vector<std::pair<uint16, vect_str_t>>> events; // Event index to level_id, (level, side1, side2)
+    std::unordered_map<std::string, SQLDatabaseHelper::query_struct> annotations; // Ortholog to annotation rows
+    std::unordered_map<std::string, vect_str_t> og_data;   // OG to (description, KEGG, SMART)
+    std::set<int64>  event_keys;
+    set_str_t        ortholog_keys;
+    set_str_t        og_keys;
+    vect_str_t       keys;
+    std::string      annotation_query;
+
+    // Event indexes of every seed left to resolve
+    for (auto &pair : seeds) {
+        if (pair.second.resolve) keys.push_back(pair.first);
+    }
+    if (keys.empty()) return;
+    sql_bulk_query(database, "SELECT " + SQL_MEMBER_NAME + ", " + SQL_MEMBER_ORTHOINDEX + " FROM " + mSQLMemberTable +
+                   " WHERE " + SQL_MEMBER_NAME, keys, [&seeds](SQLDatabaseHelper::Statement &statement) {
+        SeedData &seed = seeds[statement.get_text(0)];
+        if (!seed.found_index) seed.event_indexes = statement.get_text(1);
+        seed.found_index = true;
+    });
+    for (auto &pair : seeds) {
+        SeedData &seed = pair.second;
+        if (!seed.resolve) continue;
+        for (std::string &index : split_string(seed.event_indexes, ',')) {
+            char *index_end;
+            int64 event = std::strtoll(index.c_str(), &index_end, 10);
+            if (index.empty() || *index_end != '\0') continue;   // Never matches the integer index
+            seed.events.insert(event);
+            event_keys.insert(event);
+        }
+    }
+
+    keys.clear();
+    for (int64 event : event_keys) keys.push_back(std::to_string(event));
+    sql_bulk_query(database, "SELECT " + SQL_EVENT_I + ", " + SQL_EVENT_LEVEL + ", " + SQL_EVENT_SIDE1 + ", " +
+                   SQL_EVENT_SIDE2 + " FROM " + SQL_EVENT_TABLE + " WHERE " + SQL_EVENT_I, keys,
+                   [&events](SQLDatabaseHelper::Statement &statement) {
+        std::string level = statement.get_text(1);
+        events[statement.get_int(0)].emplace_back(level_id(level),
+                vect_str_t{level, statement.get_text(2), statement.get_text(3)});
+    });
+
+    // Orthologs of every seed from its events at the target levels
+    for (auto &pair : seeds) {
+        SeedData &seed = pair.second;
+        std::vector<const vect_str_t*> seed_events;
+        for (int64 event : seed.events) {
+            auto it = events.find(event);
+            if (it == events.end()) continue;
+            for (auto &row : it->second) {
+                if (seed.target_lvls->contains(row.first)) seed_events.push_back(&row.second);
+            }
+        }
+        if (seed_events.empty()) continue;
+        seed.orthologs = compute_member_orthologs(seed_events)["all"];
+        ortholog_keys.insert(seed.orthologs.begin(), seed.orthologs.end());
+    }
+    events.clear();
+
+    // Annotations of every ortholog
+    if (mSQLVersion == EGGNOG_VERSION_4_5_1) {
+        annotation_query = "SELECT " + SQL_EGGNOG_NAME + ", " + SQL_EGGNOG_PNAME + ", " + SQL_EGGNOG_GOS + ", " +
+                SQL_EGGNOG_KEGG + ", " + SQL_EGGNOG_BIGG + " FROM " + SQL_EGGNOG_TABLE +
+                " LEFT JOIN seq on " + SQL_EGGNOG_SEQ_NAME + " = " + SQL_EGGNOG_NAME +
+                " LEFT JOIN gene_ontology on " + SQL_EGGNOG_GO_NAME + " = " + SQL_EGGNOG_NAME +
+                " LEFT JOIN kegg on " + SQL_EGGNOG_KEGG_NAME + " = " + SQL_EGGNOG_NAME +
+                " LEFT JOIN bigg on " + SQL_EGGNOG_BIGG_NAME + " = " + SQL_EGGNOG_NAME +
+                " WHERE " + SQL_EGGNOG_NAME;
+    } else {
+        annotation_query = "SELECT " + SQL_MEMBER_NAME + ", " + SQL_MEMBER_PNAME + ", " + SQL_MEMBER_GO + ", " +
+                SQL_MEMBER_KEGG + " FROM " + mSQLMemberTable + " WHERE " + SQL_MEMBER_NAME;
+    }
+    keys.assign(ortholog_keys.begin(), ortholog_keys.end());
+    sql_bulk_query(database, annotation_query, keys, [&annotations](SQLDatabaseHelper::Statement &statement) {
+        vect_str_t row;
+        for (int i = 0; i < statement.get_column_count(); i++) row.push_back(statement.get_text(i));
+        annotations[row[0]].push_back(std::move(row));
+    });
+
+    for (auto &pair : seeds) {
+        SeedData &seed = pair.second;
+        if (!seed.resolve || seed.orthologs.empty()) continue;
+        SQLDatabaseHelper::query_struct rows;
+        for (const std::string &ortholog : seed.orthologs) {
+            std::unordered_map<std::string, SQLDatabaseHelper::query_struct>::iterator it = annotations.find(ortholog);
+            if (it != annotations.end()) rows.insert(rows.end(), it->second.begin(), it->second.end());
+        }
+        merge_annotations(rows, seed.annotations);
+        if (mSQLVersion == EGGNOG_VERSION_EARLIER) {
+            seed.annotations.og_key = select_og_key(seed.annotations);
+            if (!seed.annotations.og_key.empty()) og_keys.insert(seed.annotations.og_key);
+        }
+    }
+
+    // Additional OG data (only supported for earlier versions of SQL database currently)
+    if (og_keys.empty()) return;
+    try {
+        keys.assign(og_keys.begin(), og_keys.end());
+        sql_bulk_query(database, "SELECT og, description, SMART_freq FROM og WHERE og", keys,
+                       [&og_data](SQLDatabaseHelper::Statement &statement) {
+            og_data.emplace(statement.get_text(0), vect_str_t{statement.get_text(1), statement.get_text(2)});
+        });
+        for (auto &pair : seeds) {
+            SeedData &seed = pair.second;
+            if (!seed.resolve || seed.annotations.og_key.empty() || seed.orthologs.empty()) continue;
+            std::unordered_map<std::string, vect_str_t>::iterator it = og_data.find(seed.annotations.og_key);
+            if (it != og_data.end()) set_og_data(seed.annotations, it->second[0], it->second[1]);
+        }
+    } catch (std::exception &e) {
+        // Do not fatal error
+        FS_dprint(e.what());
+    }
+}
+
+// OG of the seed at its tax scope, as get_og_query
+std::string EggnogDatabase::select_og_key(const EggnogIndexEntry &annotations) {
+    QuerySequence::EggnogResults eggnog_data;
+
+    eggnog_data.member_ogs        = annotations.member_ogs;
+    eggnog_data.tax_scope_lvl_max = StringInterner::intern(annotations.tax_scope_lvl_max);
+    get_tax_scope(&eggnog_data);
+    get_og_query(&eggnog_data);
+    return eggnog_data.og_key;
+}
+
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::apply_annotations(const EggnogIndexEntry &annotations,
+ *                                                 QuerySequence::EggnogResults *eggnog_data)
+ *
+ * Description          - Sets resolved seed ortholog annotations (from SQL or
+ *                        the index) on a hit, interning tax scope and GO terms
+ *
+ * Notes                - None
+ *
+ * @param annotations   - Resolved annotations of the hit's seed ortholog
+ * @param eggnog_data   - Current query sequence Eggnog struc
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::apply_annotations(const EggnogIndexEntry &annotations, QuerySequence::EggnogResults *eggnog_data) {
+    eggnog_data->member_ogs = annotations.member_ogs;
+    if (!annotations.tax_scope_lvl_max.empty()) {
+        eggnog_data->tax_scope_lvl_max = StringInterner::intern(annotations.tax_scope_lvl_max);
+        get_tax_scope(eggnog_data);
+    }
+    eggnog_data->pname = annotations.pname;
+    if (!annotations.predicted_gene.empty()) eggnog_data->predicted_gene = annotations.predicted_gene;
+    eggnog_data->parsed_go       = mpEntapDatabase->intern_go_terms(annotations.go, ',', false);
+    eggnog_data->kegg            = annotations.kegg;
+    eggnog_data->bigg            = annotations.bigg;
+    eggnog_data->og_key          = annotations.og_key;
+    eggnog_data->description     = annotations.description;
+    eggnog_data->protein_domains = annotations.protein_domains;
+}
+
+/**
+ * ======================================================================
+ * Function EggnogDatabase::ERR_EGGNOG_DB EggnogDatabase::build_index(uint16 threads)
+ *
+ * Description          - Precompiles annotations of every seed ortholog in the
+ *                        SQL database into a memory mapped index next to it
+ *                        (get_index_path)
+ *                      - Seeds are resolved in batches across worker threads
+ *                        with the same rules as get_eggnog_entries, runs then
+ *                        need a single lookup per hit
+ *
+ * Notes                - open_sql must be called first
+ *                      - Distinct values are stored once in the index
+ *                      - Index is written to a temporary file and renamed
+ *                        into place
+ *
+ * @param threads       - Worker threads (and connections)
+ *
+ * @return              - ERR_EGG_OK if index was written
+ * ======================================================================
+ */
+EggnogDatabase::ERR_EGGNOG_DB EggnogDatabase::build_index(uint16 threads) {
+    vect_str_t                      seed_names;
+    uint64                          batch_count;
+    std::atomic<uint64>             resolved(0);
+    std::mutex                      records_mutex;
+    std::unordered_set<std::string> values;     // Distinct field values, records point into it
+    MappedDatabase::section_data_t  records;
+    std::string                     groups_table;
+    std::string                     index_path;
+    std::string                     temp_path;
+    std::string                     err_msg;
+
+    if (mpSQLDatabase == nullptr) {
+        set_error("EggNOG SQL database must be opened before building its index", ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+    index_path = get_index_path(mSQLPath);
+    temp_path  = index_path + ".tmp";
+    FS_dprint("Building EggNOG index from: " + mSQLPath);
+
+    try {
+        groups_table = mSQLVersion == EGGNOG_VERSION_4_5_1 ? SQL_EGGNOG_TABLE : mSQLMemberTable;
+        SQLDatabaseHelper::Statement statement(mpSQLDatabase, "SELECT " + SQL_MEMBER_NAME + " FROM " + groups_table);
+        while (statement.step()) seed_names.push_back(statement.get_text(0));
+    } catch (std::exception &e) {
+        set_error("Unable to read EggNOG seed orthologs: " + std::string(e.what()), ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+    std::sort(seed_names.begin(), seed_names.end());
+    seed_names.erase(std::unique(seed_names.begin(), seed_names.end()), seed_names.end());
+    if (seed_names.empty()) {
+        set_error("No seed orthologs found in EggNOG SQL database", ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+
+    batch_count = (seed_names.size() + EGGNOG_BATCH_SEQUENCES - 1) / EGGNOG_BATCH_SEQUENCES;
+    threads     = (uint16) std::max((uint64) 1, std::min((uint64) threads, batch_count));
+    records.reserve(seed_names.size());
+
+    try {
+        run_workers(threads, [&](SQLDatabaseHelper *database, uint16 worker, uint16 workers) {
+            for (uint64 i = worker; i < batch_count; i += workers) {
+                std::unordered_map<std::string, SeedData> seeds;
+                uint64 start = i * EGGNOG_BATCH_SEQUENCES;
+                uint64 end   = std::min(start + EGGNOG_BATCH_SEQUENCES, (uint64) seed_names.size());
+
+                for (uint64 j = start; j < end; j++) seeds[seed_names[j]];
+                query_member_ogs(database, seeds);
+                for (auto &pair : seeds) {
+                    SeedData &seed = pair.second;
+                    if (seed.member_ogs.empty()) continue;
+                    seed.annotations.member_ogs        = seed.member_ogs;
+                    seed.target_lvls = select_tax_levels(seed.member_ogs);
+                    if (seed.target_lvls == nullptr) continue;
+                    seed.annotations.tax_scope_lvl_max = seed.target_lvls->lvl_max;
+                    seed.resolve = true;
+                }
+                resolve_seeds(database, seeds);
+
+                // Seeds without member OGs are left out, hits fall back to SQL and find nothing either
+                std::lock_guard<std::mutex> lock(records_mutex);
+                auto value = [&values](const std::string &str) {return &*values.insert(str).first;};
+                for (uint64 j = start; j < end; j++) {
+                    const EggnogIndexEntry &entry = seeds[seed_names[j]].annotations;
+                    if (entry.member_ogs.empty()) continue;
+                    records.push_back({&seed_names[j], value(entry.member_ogs), value(entry.tax_scope_lvl_max),
+                                       value(entry.pname), value(entry.predicted_gene), value(entry.go),
+                                       value(entry.kegg), value(entry.bigg), value(entry.og_key),
+                                       value(entry.description), value(entry.protein_domains)});
+                }
+                FS_dprint("EggNOG seed orthologs indexed: " + std::to_string(resolved += end - start) + " of " +
+                          std::to_string(seed_names.size()));
+            }
+        });
+    } catch (std::exception &e) {
+        set_error("Unable to resolve EggNOG seed orthologs: " + std::string(e.what()), ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+
+    if (!MappedDatabase::write_eggnog_index(temp_path, records, err_msg)) {
+        std::remove(temp_path.c_str());
+        set_error(err_msg, ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+    if (std::rename(temp_path.c_str(), index_path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        set_error("Unable to move EggNOG index to: " + index_path, ERR_EGG_INDEX);
+        return ERR_EGG_INDEX;
+    }
+    FS_dprint("Success! EggNOG index of " + std::to_string(records.size()) + " seed orthologs written to: " +
+              index_path);
+    return ERR_EGG_OK;
+}
+
+std::string EggnogDatabase::get_index_path(const std::string &sql_path) {
+    return sql_path + EGGNOG_INDEX_EXT;
+}
+
+// Index is only used if generated after the SQL database was last changed
+bool EggnogDatabase::index_current(const std::string &sql_path) {
+    struct stat sql_stat;
+    struct stat index_stat;
+
+    if (stat(sql_path.c_str(), &sql_stat) != 0 || stat(get_index_path(sql_path).c_str(), &index_stat) != 0) {
+        return false;
+    }
+    return index_stat.st_mtime >= sql_stat.st_mtime;
+}
+
+/**
+ * ======================================================================
+ * Function std::string EggnogDatabase::memo_key(const std::string &seed_ortholog,
+ *                                              const TaxLevels &target_lvls)
+ *
+ * Description          - Key of the annotation memo, seed ortholog with the
+ *                        target levels orthologs were searched at
+ *
+ * Notes                - Target levels are identified by their max level, each
+ *                        TAXONOMIC_RESOLUTION level has its own level set
+ *
+ * @param seed_ortholog - Seed ortholog of the hit (34740.HMEL017225-PA)
+ * @param target_lvls   - Target levels from set_tax_levels
+ *
+ * @return              - Memo key
+ * ======================================================================
+ */
+std::string EggnogDatabase::memo_key(const std::string &seed_ortholog, const TaxLevels &target_lvls) {
+    return seed_ortholog + "\t" + target_lvls.lvl_max;
+}
+
+/**
+ * ======================================================================
+ * Function bool EggnogDatabase::memo_find(const std::string &key,
+ *                                        QuerySequence::EggnogResults *eggnog_data)
+ *
+ * Description          - Copies memoized annotations of a seed ortholog to a
+ *                        hit and counts the lookup
+ *
+ * Notes                - Thread safe
+ *
+ * @param key           - Memo key from memo_key
+ * @param eggnog_data   - Current query sequence Eggnog struc
+ *
+ * @return              - True if the seed was memoized
+ * ======================================================================
+ */
+bool EggnogDatabase::memo_find(const std::string &key, QuerySequence::EggnogResults *eggnog_data) {
+    std::lock_guard<std::mutex> lock(mMemoMutex);
+    std::unordered_map<std::string, QuerySequence::EggnogResults>::const_iterator it = mAnnotationMemo.find(key);
+
+    mMemoLookups++;
+    if (it == mAnnotationMemo.end()) return false;
+    mMemoHits++;
+    copy_annotations(it->second, eggnog_data);
+    return true;
+}
+
+// Memoizes the resolved annotations of a hit, first entry of a key is kept (thread safe)
+void EggnogDatabase::memo_store(const std::string &key, const QuerySequence::EggnogResults *eggnog_data) {
+    QuerySequence::EggnogResults annotations;
+
+    copy_annotations(*eggnog_data, &annotations);
+    std::lock_guard<std::mutex> lock(mMemoMutex);
+    mAnnotationMemo.emplace(key, std::move(annotations));
+}
+
+// Copies everything resolved from the seed ortholog, DIAMOND values of the hit are kept
+void EggnogDatabase::copy_annotations(const QuerySequence::EggnogResults &from, QuerySequence::EggnogResults *to) {
+    to->member_ogs         = from.member_ogs;
+    to->predicted_gene     = from.predicted_gene;
+    to->tax_scope_lvl_max  = from.tax_scope_lvl_max;
+    to->tax_scope          = from.tax_scope;
+    to->tax_scope_readable = from.tax_scope_readable;
+    to->pname              = from.pname;
+    to->bigg               = from.bigg;
+    to->kegg               = from.kegg;
+    to->og_key             = from.og_key;
+    to->description        = from.description;
+    to->protein_domains    = from.protein_domains;
+    to->parsed_go          = from.parsed_go;
+}
+
+// Hits that needed a memo lookup (seed with target levels) and hits served from it
+uint64 EggnogDatabase::get_memo_lookups() const {
+    return mMemoLookups;
+}
+
+uint64 EggnogDatabase::get_memo_hits() const {
+    return mMemoHits;
+}
+
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::sql_bulk_query(SQLDatabaseHelper *database, const std::string &sql_prefix,
+ *                          const vect_str_t &keys,
+ *                          const std::function<void(SQLDatabaseHelper::Statement&)> &on_row)
+ *
+ * Description          - Looks up many keys, binding SQL_BULK_KEYS keys per
+ *                        query as "key IN (?,...)"
+ *
+ * Notes                - Database is opened read only, so keys are bound
+ *                        rather than loaded into a temporary table
+ *                      - on_row must not query the database itself
+ *
+ * @param database      - Connection to query
+ * @param sql_prefix    - SELECT ending in the key column
+ * @param keys          - Keys to look up
+ * @param on_row        - Called for every row found
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::sql_bulk_query(SQLDatabaseHelper *database, const std::string &sql_prefix,
+                                    const vect_str_t &keys,
+                                    const std::function<void(SQLDatabaseHelper::Statement&)> &on_row) {
+    std::string sql;
+    uint64      end;
+
+    if (keys.empty()) return;
+
+    sql = sql_prefix + " IN (?";
+    for (uint16 i = 1; i < SQL_BULK_KEYS; i++) sql += ",?";
+    sql += ")";
+
+    for (uint64 start = 0; start < keys.size(); start += SQL_BULK_KEYS) {
+        SQLDatabaseHelper::Statement statement(database, sql);
+        end = std::min(start + SQL_BULK_KEYS, (uint64)keys.size());
+        for (uint64 i = start; i < end; i++) {
+            statement.bind((int)(i - start + 1), keys[i]);
+        }
+        while (statement.step()) {
+            on_row(statement);
+        }
+    }
+}
+
+/**
+ * ======================================================================
+ * Function const TaxLevels *EggnogDatabase::set_tax_levels(QuerySequence::EggnogResults *eggnog_data)
+ *
+ * Description          - Selects the taxonomic scope of the member OGs by
+ *                        TAXONOMIC_RESOLUTION and the levels orthologs are
+ *                        searched at
+ *                      - Sets tax scope (max level and readable)
+ *
+ * Notes                - member_ogs must be set
+ *
+ * @param eggnog_data   - Current query sequence Eggnog struc
+ *
+ * @return              - Target levels, nullptr if no level matched
+ * ======================================================================
+ */
+const EggnogDatabase::TaxLevels *EggnogDatabase::set_tax_levels(QuerySequence::EggnogResults *eggnog_data) {
+    const TaxLevels *target_lvls = select_tax_levels(eggnog_data->member_ogs);
+
+    if (target_lvls != nullptr) {
+        eggnog_data->tax_scope_lvl_max = StringInterner::intern(target_lvls->lvl_max);
+        // Get tax scope readable
+        get_tax_scope(eggnog_data);
+    }
+    return target_lvls;
+}
+
+// Target levels of member OGs by TAXONOMIC_RESOLUTION, nullptr if none matched
+const EggnogDatabase::TaxLevels *EggnogDatabase::select_tax_levels(const std::string &member_ogs) {
+    std::bitset<EGGNOG_LEVEL_BITS> unique_groups;   // Levels of the member orthologous groups
+    std::string                     temp;
+
+    // Get tax groups (split "0V8CP@meNOG" to meNOG)
+    std::istringstream iss(member_ogs);
+    while(std::getline(iss, temp, ',')) {
+        uint16 level = level_id(temp.substr(temp.find("@")+1));    // meNOG
+        if (level != EGGNOG_LEVEL_NONE) unique_groups.set(level);
+    }
+    // For default taxonomic scope (may want to allow user to change later)
+    const std::vector<TaxLevels> &resolution = resolution_levels();
+    for (uint16 i = 0; i < TAXONOMIC_RESOLUTION.size(); i++) {
+        if (unique_groups.test(level_id(TAXONOMIC_RESOLUTION[i]))) return &resolution[i];
+    }
+    return nullptr;
+}
+
+// Target levels of each TAXONOMIC_RESOLUTION level (same order), built once and shared by annotation workers
+const std::vector<EggnogDatabase::TaxLevels> &EggnogDatabase::resolution_levels() {
+    static const std::vector<TaxLevels> resolution = [] {
+        std::vector<TaxLevels> levels;
+
+        for (const std::string &level : TAXONOMIC_RESOLUTION) {
+            TaxLevels target_lvls;
+            std::unordered_map<std::string, vect_str_t>::const_iterator it_content = LEVEL_CONTENT.find(level);
+            if (it_content != LEVEL_CONTENT.end()) {
+                target_lvls.names.insert(it_content->second.begin(), it_content->second.end());
+            }
+            target_lvls.names.insert(level);
+            for (const std::string &name : target_lvls.names) target_lvls.levels.set(level_id(name));
+            target_lvls.lvl_max = level + "[" + std::to_string(target_lvls.names.size()) + "]";
+            levels.push_back(target_lvls);
+        }
+        return levels;
+    }();
+    return resolution;
+}
+
+// Bit of every level in EGGNOG_LEVELS and LEVEL_CONTENT
+const std::unordered_map<std::string, uint16> &EggnogDatabase::level_ids() {
+    static const std::unordered_map<std::string, uint16> ids = [] {
+        std::unordered_map<std::string, uint16> level_ids;
+        auto add = [&level_ids](const std::string &level) {
+            level_ids.emplace(level, (uint16) level_ids.size());
+        };
+
+        for (auto &pair : EGGNOG_LEVELS) add(pair.first);
+        for (auto &pair : LEVEL_CONTENT) {
+            add(pair.first);
+            for (const std::string &level : pair.second) add(level);
+        }
+        for (const std::string &level : TAXONOMIC_RESOLUTION) add(level);
+        return level_ids;
+    }();
+    return ids;
+}
+
+uint16 EggnogDatabase::level_id(const std::string &level) {
+    const std::unordered_map<std::string, uint16> &ids = level_ids();
+    std::unordered_map<std::string, uint16>::const_iterator it = ids.find(level);
+    if (it == ids.end()) return EGGNOG_LEVEL_NONE;
+    return it->second;
+}
+
+
 /**
  * ======================================================================
  * Function void EggnogDatabase::get_tax_scope(std::string &raw_scope,
@@ -425,14 +1162,17 @@ void EggnogDatabase::get_eggnog_entry(QuerySequence::EggnogResults *eggnog_data)
 void EggnogDatabase::get_tax_scope(QuerySequence::EggnogResults *eggnogResults) {
     // Lookup/Assign Tax Scope
 
-    eggnogResults->tax_scope_readable = "";
+    const std::string &tax_scope_lvl_max = StringInterner::get(eggnogResults->tax_scope_lvl_max);
+
+    eggnogResults->tax_scope_readable = StringInterner::EMPTY_HANDLE;
     eggnogResults->tax_scope  = eggnogResults->tax_scope_lvl_max;
 
-    if (!eggnogResults->tax_scope_lvl_max.empty()) {
-        uint16 p = (uint16) (eggnogResults->tax_scope_lvl_max.find("NOG"));
+    if (!tax_scope_lvl_max.empty()) {
+        uint16 p = (uint16) (tax_scope_lvl_max.find("NOG"));
         if (p != std::string::npos) {
-            eggnogResults->tax_scope = eggnogResults->tax_scope_lvl_max.substr(0,p+3);
-            eggnogResults->tax_scope_readable = EGGNOG_LEVELS.at(eggnogResults->tax_scope);
+            std::string tax_scope = tax_scope_lvl_max.substr(0,p+3);
+            eggnogResults->tax_scope = StringInterner::intern(tax_scope);
+            eggnogResults->tax_scope_readable = StringInterner::intern(EGGNOG_LEVELS.at(tax_scope));
             return;
         }
     }
@@ -462,28 +1202,22 @@ void EggnogDatabase::get_additional_sql_data(QuerySequence::EggnogResults *eggno
     get_og_query(eggnogResults);    // Will lookup og_key
 
     if (!eggnogResults->og_key.empty()) {
-        std::vector<std::vector<std::string>>results;
-        std::string sql_kegg;
         std::string sql_desc;
         std::string sql_protein;
+        EggnogIndexEntry annotations;
 
-        char *query = sqlite3_mprintf(
-                "SELECT description, KEGG_freq, SMART_freq FROM og WHERE og=%Q",
-                eggnogResults->og_key.c_str());
         try {
-            results = mpSQLDatabase->query(query);
-            sql_desc = results[0][0];
-            sql_kegg = results[0][1];
-            sql_protein = results[0][2];
-            if (!sql_desc.empty() && sql_desc.find("[]") != 0) eggnogResults->description = sql_desc;
-#if 0
-            if (!sql_kegg.empty() && sql_kegg.find("[]") != 0) {
-                eggnogResults->kegg = format_sql_data(sql_kegg);
-            }
-#endif
-            if (!sql_protein.empty() && sql_protein.find("{}") != 0){
-                eggnogResults->protein_domains = format_sql_data(sql_protein);
+            {
+                SQLDatabaseHelper::Statement statement(mpSQLDatabase,
+                    "SELECT description, SMART_freq FROM og WHERE og=?");
+                statement.bind(1, eggnogResults->og_key);
+                if (!statement.step()) return;
+                sql_desc = statement.get_text(0);
+                sql_protein = statement.get_text(1);
             }
+            set_og_data(annotations, sql_desc, sql_protein);
+            if (!annotations.description.empty()) eggnogResults->description = annotations.description;
+            if (!annotations.protein_domains.empty()) eggnogResults->protein_domains = annotations.protein_domains;
         } catch (std::exception &e) {
             // Do not fatal error
             FS_dprint(e.what());
@@ -491,6 +1225,14 @@ void EggnogDatabase::get_additional_sql_data(QuerySequence::EggnogResults *eggno
     }
 }
 
+// Sets description and protein domains from the og table entry of the query OG
+void EggnogDatabase::set_og_data(EggnogIndexEntry &annotations, std::string &sql_desc, std::string &sql_protein) {
+    if (!sql_desc.empty() && sql_desc.find("[]") != 0) annotations.description = sql_desc;
+    if (!sql_protein.empty() && sql_protein.find("{}") != 0){
+        annotations.protein_domains = format_sql_data(sql_protein);
+    }
+}
+
 
 /**
  * ======================================================================
@@ -517,8 +1259,8 @@ void EggnogDatabase::get_og_query(QuerySequence::EggnogResults *eggnogResults) {
             og_map[temp.substr(p+1)] = temp.substr(0,p);
         }
         eggnogResults->og_key = "";
-        if (og_map.find(eggnogResults->tax_scope) != og_map.end()) {
-            eggnogResults->og_key = og_map[eggnogResults->tax_scope];
+        if (og_map.find(StringInterner::get(eggnogResults->tax_scope)) != og_map.end()) {
+            eggnogResults->og_key = og_map[StringInterner::get(eggnogResults->tax_scope)];
         }
     }
 }
@@ -583,58 +1325,40 @@ std::string EggnogDatabase::format_sql_data(std::string &input) {
 }
 
 void EggnogDatabase::get_member_ogs(QuerySequence::EggnogResults *eggnog_results) {
-    std::vector<std::vector<std::string>>results;
-    char *query;
+    std::string query;
 
     if (eggnog_results->seed_ortholog.empty()) return;
 
     if (mSQLVersion == EGGNOG_VERSION_4_5_1) {
         // emapper.db-4.5.1
-        query = sqlite3_mprintf(
-                "SELECT %q FROM %q WHERE %q=%Q",
-                SQL_MEMBER_GROUP.c_str(),
-                SQL_EGGNOG_TABLE.c_str(),
-                SQL_MEMBER_NAME.c_str(),
-                eggnog_results->seed_ortholog.c_str()
-        );
+        query = "SELECT " + SQL_MEMBER_GROUP + " FROM " + SQL_EGGNOG_TABLE + " WHERE " + SQL_MEMBER_NAME + "=?";
     } else {
         // Older versions
-        query = sqlite3_mprintf(
-                "SELECT %q FROM %q WHERE %q=%Q",
-                SQL_MEMBER_GROUP.c_str(),
-                mSQLMemberTable.c_str(),
-                SQL_MEMBER_NAME.c_str(),
-                eggnog_results->seed_ortholog.c_str());
+        query = "SELECT " + SQL_MEMBER_GROUP + " FROM " + mSQLMemberTable + " WHERE " + SQL_MEMBER_NAME + "=?";
     }
 
-    results = mpSQLDatabase->query(query);
-    if (!results.empty()) {
-        eggnog_results->member_ogs = results[0][0];
+    SQLDatabaseHelper::Statement statement(mpSQLDatabase, query);
+    statement.bind(1, eggnog_results->seed_ortholog);
+    if (statement.step()) {
+        eggnog_results->member_ogs = statement.get_text(0);
     }
 }
 
 EggnogDatabase::member_orthologs_t EggnogDatabase::get_member_orthologs(EggnogDatabase::member_orthologs_t &member_orthologs,
                                           std::string &best_hit,
-                                          std::set<std::string> &target_lvls) {
-    std::string                     query_taxon;  // Tax number from match
+                                          const std::set<std::string> &target_lvls) {
     std::string                     event_indexes;
-    std::set<std::string>           target_members;
     char*                           sql_query;
     SQLDatabaseHelper::query_struct sql_results;
 
-    query_taxon = best_hit.substr(0, best_hit.find_first_of('.'));    // "34740"
-    target_members.insert(best_hit);                                  // 34740.HMEL017225-PA
-
-    sql_query = sqlite3_mprintf(
-            "SELECT %q FROM %q WHERE %q=%Q",
-            SQL_MEMBER_ORTHOINDEX.c_str(),
-            mSQLMemberTable.c_str(),
-            SQL_MEMBER_NAME.c_str(),
-            best_hit.c_str());
-    sql_results = mpSQLDatabase->query(sql_query);
-    if (!sql_results.empty()) {
-        event_indexes = sql_results[0][0];
-    } else return member_orthologs_t();
+    {
+        SQLDatabaseHelper::Statement statement(mpSQLDatabase, "SELECT " + SQL_MEMBER_ORTHOINDEX + " FROM " +
+                                               mSQLMemberTable + " WHERE " + SQL_MEMBER_NAME + "=?");
+        statement.bind(1, best_hit);
+        if (statement.step()) {
+            event_indexes = statement.get_text(0);
+        } else return member_orthologs_t();
+    }
 
     if (event_indexes.empty()) return member_orthologs_t();
     // Can specify levels as well here
@@ -649,166 +1373,189 @@ EggnogDatabase::member_orthologs_t EggnogDatabase::get_member_orthologs(EggnogDa
             SQL_EVENT_LEVEL.c_str(),
             mpSQLDatabase->format_container(target_lvls).c_str()
     );
-    sql_results = mpSQLDatabase->query(sql_query);
-
-    std::map<std::pair<std::string,set_str_t>,
-            std::set<std::pair<std::string,set_str_t>>> ortholog_map;
-
-    for (std::vector<std::string> &hit : sql_results) {
-//        std::string* level = &hit[0];
-        std::string* side1 = &hit[1];
-        std::string* side2 = &hit[2];
-
-        // Vector of tax, id pairs
-        std::vector<pair_str_t> side1_pairs;     // '6238' , 'CBG18195']
-        std::vector<pair_str_t> side2_pairs;
-
-        // Convert string of hits to tax, id pair for side1
-        for (std::string &temp : split_string(*side1, ',')) {
-            uint16 index = (uint16)temp.find_first_of('.');
-            side1_pairs.push_back(std::make_pair(
-                    temp.substr(0, index),
-                    temp.substr(index+1)
-            ));
-        }
-        // Convert string of hits to tax, id pair for side2
-        for (std::string &temp : split_string(*side2, ',')) {
-            uint16 index = (uint16)temp.find_first_of('.');
-            side1_pairs.push_back(std::make_pair(
-                    temp.substr(0, index),
-                    temp.substr(index+1)
-            ));
-        }
-
-        // Can add check for target taxonomy here
-        vect_str_t target_taxa;
-        vect_str_t targets;
-        std::string mid;
-        std::unordered_map<std::string,set_str_t> by_sp1;
-        std::unordered_map<std::string,set_str_t> by_sp2;
-
-        std::map<std::pair<std::string,set_str_t>,
-                std::set<std::pair<std::string,set_str_t>>>::iterator iter;
-
-        for (auto &pair : side1_pairs) {
-            if ( (target_taxa.empty()) ||
-                 (std::find(target_taxa.begin(),target_taxa.end(), pair.first) != target_taxa.end()) ||
-                 (query_taxon.compare(pair.first) == 0)) {
-                mid = pair.first + "." + pair.second;
-                by_sp1[pair.first].insert(mid);// Default of empty set here
-            }
+    try {
+        sql_results = mpSQLDatabase->query(sql_query);
+    } catch (...) {
+        sqlite3_free(sql_query);
+        throw;
+    }
+    sqlite3_free(sql_query);
+
+    std::vector<const vect_str_t*> events;
+    events.reserve(sql_results.size());
+    for (const vect_str_t &row : sql_results) events.push_back(&row);
+    return compute_member_orthologs(events);
+}
+
+// Hash of interned ids, keys the species groups of compute_member_orthologs
+struct ids_hash {
+    size_t operator()(const std::vector<uint32> &ids) const {
+        size_t hash = ids.size();
+        for (uint32 id : ids) hash = hash * 1000003 ^ id;
+        return hash;
+    }
+};
+
+/**
+ * ======================================================================
+ * Function member_orthologs_t EggnogDatabase::compute_member_orthologs(
+ *                              const std::vector<const vect_str_t*> &events)
+ *
+ * Description          - Groups the members of each duplication/speciation
+ *                        event by species and classifies orthologs of the
+ *                        best hit (one2one, one2many...)
+ *
+ * Notes                - Shared by the single and batched lookups
+ *                      - Members, taxa and species groups are interned to
+ *                        integer ids, names are only used for the result
+ *                      - No target taxonomy is set, every species is kept
+ *
+ * @param events        - Event rows (level, side1, side2) at the target levels
+ *
+ * @return              - Orthologs by type, "all" holds every ortholog
+ * ======================================================================
+ */
+EggnogDatabase::member_orthologs_t EggnogDatabase::compute_member_orthologs(const std::vector<const vect_str_t*> &events) {
+    const uint32 EMPTY_GROUP = 0;                           // Co-orthologs of a side without species
+
+    std::unordered_map<std::string, uint32> member_ids;     // 34740.HMEL017225-PA to member id
+    std::vector<const std::string*>         members;        // Member id to name
+    std::vector<uint32>                     member_taxa;    // Member id to taxon id
+    std::unordered_map<std::string, uint32> taxon_ids;      // 34740 to taxon id
+    std::unordered_map<std::vector<uint32>, uint32, ids_hash> group_ids;   // (taxon, members...) to group id
+    std::vector<const std::vector<uint32>*> groups;         // Group id to (taxon, members...)
+    std::unordered_map<uint32, std::vector<uint32>> ortholog_map;   // Group id to co-ortholog group ids
+    std::map<std::string, std::vector<uint32>> otype_members {     // Member ids by ortholog type
+            {"one2one", {}},
+            {"one2many", {}},
+            {"many2many", {}},
+            {"many2one", {}},
+            {"all", {}}
+    };
+    std::string token;
+    std::string otype_prefix;
+    std::string otype;
+
+    groups.push_back(&group_ids.emplace(std::vector<uint32>(), EMPTY_GROUP).first->first);
+
+    // Adds (taxon id, member id) of each member of an event side ("6238.CBG18195,6239.C17E4.6")
+    auto add_members = [&](const std::string &side_text, std::vector<std::pair<uint32,uint32>> &side_members) {
+        const std::string *side = &side_text;
+        std::string        stripped;   // Newlines removed as with split_string
+
+        if (side_text.find('\n') != std::string::npos) {
+            stripped = side_text;
+            stripped.erase(std::remove(stripped.begin(), stripped.end(), '\n'), stripped.end());
+            side = &stripped;
         }
-        for (auto &pair : side2_pairs) {
-            if ( (target_taxa.empty()) ||
-                 (std::find(target_taxa.begin(),target_taxa.end(), pair.first) != target_taxa.end()) ||
-                 (query_taxon.compare(pair.first) == 0)) {
-                mid = pair.first + "." + pair.second;
-                by_sp2[pair.first].insert(mid); // Default of empty set here
+        for (size_t pos = 0; pos < side->size(); ) {
+            size_t end = std::min(side->find(',', pos), side->size());
+            token.assign(*side, pos, end - pos);
+            pos = end + 1;
+
+            // Offsets are 16 bit as in the string port, members without a taxon throw std::out_of_range
+            size_t dot = token.find_first_of('.');
+            if (dot > UINT16_MAX) {
+                uint16 index = (uint16) dot;
+                token = token.substr(0, index) + "." + token.substr(index + 1);
+                dot = index;
+            }
+            std::unordered_map<std::string, uint32>::iterator it = member_ids.find(token);
+            if (it == member_ids.end()) {
+                it = member_ids.emplace(token, (uint32) members.size()).first;
+                members.push_back(&it->first);
+                member_taxa.push_back(taxon_ids.emplace(token.substr(0, dot), (uint32) taxon_ids.size()).first->second);
             }
+            side_members.emplace_back(member_taxa[it->second], it->second);
         }
+    };
 
-        // merge side1 coorthologs
-        if (!target_taxa.empty()) {
-            targets = target_taxa;
-        } else if (!by_sp2.empty()) {
-            for (std::unordered_map<std::string,set_str_t>::iterator it = by_sp2.begin();
-                    it != by_sp2.end(); it++) {
-                targets.push_back(it->first);
+    // Group ids of the species of an event side, ordered by taxon id
+    auto species_groups = [&](std::vector<std::pair<uint32,uint32>> &side_members) {
+        std::vector<uint32> by_sp;
+        std::vector<uint32> key;
+
+        std::sort(side_members.begin(), side_members.end());
+        side_members.erase(std::unique(side_members.begin(), side_members.end()), side_members.end());
+        for (size_t i = 0; i < side_members.size(); ) {
+            key.assign(1, side_members[i].first);
+            for (; i < side_members.size() && side_members[i].first == key[0]; i++) {
+                key.push_back(side_members[i].second);
             }
-        }
-        for (auto &pair : by_sp1) {
-            if (!target_members.empty() && !pair.second.empty()) {
-                std::pair<std::string,set_str_t> key1 = std::make_pair(
-                        pair.first, pair.second
-                ); // sort pair.second
-                std::pair<std::string,set_str_t> key2;
-                for (std::string &sp2 : targets) {
-                    if (by_sp2.find(sp2) == by_sp2.end()) continue;
-                    set_str_t co2 = by_sp2[sp2];
-                    key2 = std::make_pair(sp2, co2);
-                }
-                iter = ortholog_map.find(key1);
-                if (iter != ortholog_map.end()) {
-                    iter->second.insert(key2);       // default empty set
-                } else {
-                    ortholog_map.emplace(key1, std::set<std::pair<std::string,set_str_t>>());
-                    ortholog_map.at(key1).insert(key2);
-                }
+            auto it = group_ids.find(key);
+            if (it == group_ids.end()) {
+                it = group_ids.emplace(key, (uint32) groups.size()).first;
+                groups.push_back(&it->first);
             }
+            by_sp.push_back(it->second);
         }
+        return by_sp;
+    };
 
-        // merge side2 coorthologs
-        if (!target_taxa.empty()) {
-            targets = target_taxa;
-        } else if (!by_sp1.empty()) {
-            for (std::unordered_map<std::string,set_str_t>::iterator it = by_sp1.begin();
-                 it != by_sp1.end(); it++) {
-                targets.push_back(it->first);
-            }
+    auto add_group = [&](std::vector<uint32> &ids, uint32 group) {
+        if (group != EMPTY_GROUP) ids.insert(ids.end(), groups[group]->begin() + 1, groups[group]->end());
+    };
+
+    for (const vect_str_t *hit : events) {
+        std::vector<std::pair<uint32,uint32>> side1_members;
+        std::vector<std::pair<uint32,uint32>> side2_members;
+
+        // Side2 members are added to side1 as in the original port, side2 has no species
+        add_members((*hit)[1], side1_members);
+        add_members((*hit)[2], side1_members);
+
+        std::vector<uint32> by_sp1 = species_groups(side1_members);
+        std::vector<uint32> by_sp2 = species_groups(side2_members);
+
+        // Species of a side are co-orthologs of the last species of the other side
+        for (uint32 group : by_sp1) {
+            ortholog_map[group].push_back(by_sp2.empty() ? EMPTY_GROUP : by_sp2.back());
         }
-        for (auto &pair : by_sp2) {
-            if (!target_members.empty() && !pair.second.empty()) {
-                std::pair<std::string,set_str_t> key1 = std::make_pair(
-                        pair.first, pair.second
-                ); // sort pair.second
-                std::pair<std::string,set_str_t> key2;
-                for (std::string &sp2 : targets) {
-                    if (by_sp1.find(sp2) == by_sp1.end()) continue;
-                    set_str_t co2 = by_sp1[sp2];
-                    key2 = std::make_pair(sp2, co2);
-                }
-                iter = ortholog_map.find(key1);
-                if (iter != ortholog_map.end()) {
-                    iter->second.insert(key2);       // default empty set
-                } else {
-                    ortholog_map.emplace(key1, std::set<std::pair<std::string,set_str_t>>());
-                    ortholog_map.at(key1).insert(key2);
-                }
-            }
+        for (uint32 group : by_sp2) {
+            ortholog_map[group].push_back(by_sp1.empty() ? EMPTY_GROUP : by_sp1.back());
         }
     }
 
-    member_orthologs_t all_orthologs {
-            {"one2one", set_str_t()},
-            {"one2many", set_str_t()},
-            {"many2many", set_str_t()},
-            {"many2one", set_str_t()},
-            {"all", set_str_t()}
-    };
-
-    std::string otype_prefix;
-    std::string otype;
     for (auto &pair : ortholog_map) {
-        if (pair.second.size() == 1) {
+        std::vector<uint32> &co_groups = pair.second;
+
+        std::sort(co_groups.begin(), co_groups.end());
+        co_groups.erase(std::unique(co_groups.begin(), co_groups.end()), co_groups.end());
+        if (co_groups.size() == 1) {
             otype_prefix = "one2";
         } else {
             otype_prefix = "many2";
         }
-        all_orthologs["all"].insert(pair.first.second.begin(), pair.first.second.end());
+        add_group(otype_members["all"], pair.first);
 
-        for (auto &pair2 : pair.second) {
-            if (pair2.second.size() == 1) {
+        for (uint32 co_group : co_groups) {
+            // Groups hold the taxon before their members
+            if (co_group != EMPTY_GROUP && groups[co_group]->size() == 2) {
                 otype = otype_prefix + "one";
             } else {
                 otype = otype_prefix + "many";
             }
-            all_orthologs[otype].insert(pair.first.second.begin(), pair.first.second.end());
-            all_orthologs[otype].insert(pair2.second.begin(), pair2.second.end());
-            all_orthologs["all"].insert(pair2.second.begin(), pair2.second.end());
+            add_group(otype_members[otype], pair.first);
+            add_group(otype_members[otype], co_group);
+            add_group(otype_members["all"], co_group);
         }
     }
+
+    member_orthologs_t all_orthologs;
+    for (auto &pair : otype_members) {
+        std::vector<uint32> &ids = pair.second;
+        set_str_t &orthologs = all_orthologs[pair.first];
+
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        for (uint32 id : ids) orthologs.insert(*members[id]);
+    }
     return all_orthologs;
 }
 
 void EggnogDatabase::get_annotations(set_str_t& orthologs, QuerySequence::EggnogResults* eggnog_results) {
 
     char*               sql_query;
-    set_str_t           all_gos;
-    set_str_t           all_kegg;
-    set_str_t           all_pnames;
-    Compair<std::string>             pname_counter;
-    set_str_t           all_bigg;
-    std::string         delim_list;
     SQLDatabaseHelper::query_struct sql_results;
 
     // This is different depending on version on eggnog using
@@ -845,9 +1592,55 @@ void EggnogDatabase::get_annotations(set_str_t& orthologs, QuerySequence::Eggnog
         );
     }
 
-    sql_results = mpSQLDatabase->query(sql_query);
+    try {
+        sql_results = mpSQLDatabase->query(sql_query);
+    } catch (...) {
+        sqlite3_free(sql_query);
+        throw;
+    }
+    sqlite3_free(sql_query);
+    set_annotations(sql_results, eggnog_results);
+}
+
+/**
+ * ======================================================================
+ * Function void EggnogDatabase::set_annotations(const SQLDatabaseHelper::query_struct &sql_results,
+ *                                               QuerySequence::EggnogResults* eggnog_results)
+ *
+ * Description          - Merges annotation rows of the orthologs into
+ *                        protein names, predicted gene, GO, KEGG and BiGG
+ *
+ * Notes                - Rows are (name, pname, gos, kegg[, bigg])
+ *
+ * @param sql_results   - Annotation rows of every ortholog
+ * @param eggnog_results- Current query sequence Eggnog struc
+ *
+ * @return              - None
+ * ======================================================================
+ */
+void EggnogDatabase::set_annotations(const SQLDatabaseHelper::query_struct &sql_results,
+                                     QuerySequence::EggnogResults* eggnog_results) {
+    EggnogIndexEntry annotations;
+
+    merge_annotations(sql_results, annotations);
+    eggnog_results->pname = annotations.pname;
+    if (!annotations.predicted_gene.empty()) eggnog_results->predicted_gene = annotations.predicted_gene;
+    eggnog_results->parsed_go = mpEntapDatabase->intern_go_terms(annotations.go, ',', false);
+    eggnog_results->kegg = annotations.kegg;
+    eggnog_results->bigg = annotations.bigg;
+}
+
+// Merges annotation rows of the orthologs, as set_annotations but GO terms are left as IDs
+void EggnogDatabase::merge_annotations(const SQLDatabaseHelper::query_struct &sql_results,
+                                       EggnogIndexEntry &annotations) {
+    set_str_t           all_gos;
+    set_str_t           all_kegg;
+    set_str_t           all_pnames;
+    Compair<std::string>             pname_counter;
+    set_str_t           all_bigg;
+
     if (!sql_results.empty()) {
-        for (vect_str_t &data : sql_results) {
+        for (const vect_str_t &data : sql_results) {
             update_dataset(all_pnames, EGGNOG_DATA_PNAME, data[1]);
             pname_counter.add_value(data[1]);
             update_dataset(all_gos, EGGNOG_DATA_GO, data[2]);
@@ -855,24 +1648,23 @@ void EggnogDatabase::get_annotations(set_str_t& orthologs, QuerySequence::Eggnog
             if (mSQLVersion == EGGNOG_VERSION_4_5_1)
                 update_dataset(all_bigg, EGGNOG_DATA_BIGG, data[4]);
         }
-        eggnog_results->pname  = container_to_string<std::string>(all_pnames,",");
+        annotations.pname  = container_to_string<std::string>(all_pnames,",");
         if (!pname_counter.empty()) {
             pname_counter.sort(true);
             if (pname_counter._sorted[0].second >= 2) {
-                eggnog_results->predicted_gene = pname_counter._sorted[0].first;
+                annotations.predicted_gene = pname_counter._sorted[0].first;
             }
         }
 
-        delim_list = container_to_string<std::string>(all_gos, ",");
-        eggnog_results->parsed_go = mpEntapDatabase->format_go_delim(delim_list,',');
-        eggnog_results->kegg = container_to_string<std::string>(all_kegg, ",");
+        annotations.go   = container_to_string<std::string>(all_gos, ",");
+        annotations.kegg = container_to_string<std::string>(all_kegg, ",");
         if (mSQLVersion == EGGNOG_VERSION_4_5_1)
-            eggnog_results->bigg = container_to_string<std::string>(all_bigg, ",");
+            annotations.bigg = container_to_string<std::string>(all_bigg, ",");
     } else {
-        eggnog_results->pname = "";
-        eggnog_results->parsed_go = go_format_t();
-        eggnog_results->kegg = "";
-        eggnog_results->bigg = "";
+        annotations.pname = "";
+        annotations.go    = "";
+        annotations.kegg  = "";
+        annotations.bigg  = "";
     }
 }
 
@@ -931,6 +1723,7 @@ void EggnogDatabase::set_database_version() {
         if (mpQueryData != nullptr)
             mpQueryData->header_set(ENTAP_HEADER_ONT_EGG_BIGG, false);       // Not supported for older version
     }
+    sqlite3_free(query);
 
     if (mSQLVersion == EGGNOG_VERSION_4_5_1) {
         mSQLMemberTable = SQL_MEMBER_TABLE_1;
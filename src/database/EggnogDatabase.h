@@ -28,8 +28,12 @@
 #ifndef ENTAP_EGGNOGDATABASE_H
 #define ENTAP_EGGNOGDATABASE_H
 
+#include <atomic>
+#include <bitset>
+#include <mutex>
 #include "../common.h"
 #include "SQLDatabaseHelper.h"
+#include "MappedDatabase.h"
 #include "../FileSystem.h"
 #include "../EntapGlobals.h"
 #include "../QuerySequence.h"
@@ -58,6 +62,7 @@ public:
         ERR_EGG_DMND_DECOMP,
         ERR_EGG_FASTA_FTP,
         ERR_EGG_FASTA_DECOMP,
+        ERR_EGG_INDEX,
 
     } ERR_EGGNOG_DB;
 
@@ -79,9 +84,18 @@ public:
     ~EggnogDatabase();
 
     ERR_EGGNOG_DB download(EGGNOG_DB_TYPES type, std::string out_path);
+    ERR_EGGNOG_DB download(const std::vector<EGGNOG_DB_TYPES> &types, const vect_str_t &out_paths);
     ERR_EGGNOG_DB open_sql(std::string& sql_path);
     std::string print_err();
+    std::string get_temp_directory();
     void get_eggnog_entry(QuerySequence::EggnogResults *eg);
+    void get_eggnog_entries(std::vector<QuerySequence::EggnogResults*> &eggnog_results, uint16 threads=1);
+    uint64 get_memo_lookups() const;
+    uint64 get_memo_hits() const;
+    ERR_EGGNOG_DB build_index(uint16 threads);
+
+    static std::string get_index_path(const std::string &sql_path);
+    static bool index_current(const std::string &sql_path);
 
 
 private:
@@ -90,6 +104,7 @@ private:
     const std::string FTP_EGGNOG_DMND = "http://eggnog5.embl.de/download/eggnog_4.1/eggnog-mapper-data/eggnog_proteins.dmnd.gz";
     const std::string FTP_EGGNOG_FASTA= "http://eggnog5.embl.de/download/eggnog_4.1/eggnog-mapper-data/eggnog4.clustered_proteins.fa.gz";
 
+    const std::string TEMP_DIRECTORY = "eggnog/";  // Within EnTAP temp directory, only EggNOG writes here
     const std::string TEMP_SQL_GZ = "temp_egg_sql.gz";
     const std::string TEMP_DMND_GZ = "temp_egg_dmnd.gz";
     const std::string TEMP_FAST_GZ = "temp_egg_fasta.gz";
@@ -165,13 +180,52 @@ private:
     const std::string SQL_EVENT_SIDE2       = "side2";
     const std::string SQL_EVENT_I           = "i";
 
-    typename std::unordered_map<std::string, vect_str_t>::const_iterator _it_vect_str;
+    const uint16      SQL_BULK_KEYS         = 500;      // Keys bound per query (below SQLITE_MAX_VARIABLE_NUMBER)
+    const uint64      EGGNOG_BATCH_SEQUENCES= 5000;     // Best hits resolved together by get_eggnog_entries
+
+    static const uint16 EGGNOG_LEVEL_BITS   = 128;      // Above the number of EggNOG levels (107)
+    static const uint16 EGGNOG_LEVEL_NONE   = UINT16_MAX;
+
+    // Target levels of a TAXONOMIC_RESOLUTION level, precomputed from LEVEL_CONTENT
+    struct TaxLevels {
+        std::string                     lvl_max;    // Level with the number of target levels (virNOG[6])
+        std::set<std::string>           names;      // Target level names, for SQL IN lists
+        std::bitset<EGGNOG_LEVEL_BITS>  levels;     // Target levels by level_id
+
+        bool contains(uint16 level) const {return level < EGGNOG_LEVEL_BITS && levels.test(level);}
+    };
+
+    // Data of a seed ortholog shared by the hits of a batch
+    struct SeedData {
+        std::string           member_ogs;
+        std::string           event_indexes;
+        const TaxLevels      *target_lvls = nullptr;
+        std::set<int64>       events;
+        set_str_t             orthologs;        // "all" member orthologs
+        bool                  found_ogs   = false;
+        bool                  found_index = false;
+        bool                  indexed     = false;  // Annotations found in the index
+        bool                  resolve     = false;  // Annotations are resolved through SQL
+        EggnogIndexEntry      annotations;
+        std::string           memo_key;
+        QuerySequence::EggnogResults *first_hit = nullptr;   // Hit resolved for the seed, others copy it
+    };
+
+    typedef std::function<void(SQLDatabaseHelper *database, uint16 worker, uint16 workers)> worker_t;
+
     SQLDatabaseHelper *mpSQLDatabase;
+    std::string        mSQLPath;            // Workers open their own connections to it
+    MappedDatabase    *mpIndex;             // Precompiled annotations, nullptr if not generated
+    std::unordered_map<std::string, QuerySequence::EggnogResults> mAnnotationMemo; // Resolved annotations by memo_key
+    std::mutex         mMemoMutex;
+    std::atomic<uint64> mMemoLookups;
+    std::atomic<uint64> mMemoHits;
     FileSystem        *mpFileSystem;
     EntapDatabase     *mpEntapDatabase;
     QueryData         *mpQueryData;         // Used to control header information
     std::string        mErrMsg;
     ERR_EGGNOG_DB      mErrCode;
+    std::string        mTempDirectory;      // Downloads, not shared with other databases
     std::string        mSQLMemberTable;
     EGGNOG_SQL_VERSION mSQLVersion;
     uint16              mVersionMajor;
@@ -181,6 +235,7 @@ private:
     static const std::unordered_map<std::string,std::string> EGGNOG_LEVELS;   // Mappings from tax lvl to full name
     static const std::unordered_map<std::string, vect_str_t> LEVEL_CONTENT;
     static const vect_str_t                                  TAXONOMIC_RESOLUTION;
+    static const std::string                                 EGGNOG_INDEX_EXT;
 
     void get_tax_scope(QuerySequence::EggnogResults*);
     void get_additional_sql_data(QuerySequence::EggnogResults* eggnogResults);
@@ -189,8 +244,30 @@ private:
     void get_member_ogs(QuerySequence::EggnogResults* eggnog_results);
     member_orthologs_t get_member_orthologs(member_orthologs_t &member_orthologs,
                               std::string &best_hit,
-                              std::set<std::string> &target_lvls);
+                              const std::set<std::string> &target_lvls);
+    member_orthologs_t compute_member_orthologs(const std::vector<const vect_str_t*> &events);
     void get_annotations(set_str_t& orthologs, QuerySequence::EggnogResults* eggnog_results);
+    void set_annotations(const SQLDatabaseHelper::query_struct &sql_results,
+                         QuerySequence::EggnogResults* eggnog_results);
+    void merge_annotations(const SQLDatabaseHelper::query_struct &sql_results, EggnogIndexEntry &annotations);
+    void apply_annotations(const EggnogIndexEntry &annotations, QuerySequence::EggnogResults *eggnog_data);
+    void set_og_data(EggnogIndexEntry &annotations, std::string &sql_desc, std::string &sql_protein);
+    const TaxLevels *set_tax_levels(QuerySequence::EggnogResults *eggnog_data);
+    const TaxLevels *select_tax_levels(const std::string &member_ogs);
+    static const std::vector<TaxLevels> &resolution_levels();
+    static const std::unordered_map<std::string, uint16> &level_ids();
+    static uint16 level_id(const std::string &level);
+    std::string select_og_key(const EggnogIndexEntry &annotations);
+    std::string memo_key(const std::string &seed_ortholog, const TaxLevels &target_lvls);
+    bool memo_find(const std::string &key, QuerySequence::EggnogResults *eggnog_data);
+    void memo_store(const std::string &key, const QuerySequence::EggnogResults *eggnog_data);
+    static void copy_annotations(const QuerySequence::EggnogResults &from, QuerySequence::EggnogResults *to);
+    void run_workers(uint16 threads, const worker_t &work);
+    void get_eggnog_batch(SQLDatabaseHelper *database, std::vector<QuerySequence::EggnogResults*> &batch);
+    void query_member_ogs(SQLDatabaseHelper *database, std::unordered_map<std::string, SeedData> &seeds);
+    void resolve_seeds(SQLDatabaseHelper *database, std::unordered_map<std::string, SeedData> &seeds);
+    void sql_bulk_query(SQLDatabaseHelper *database, const std::string &sql_prefix, const vect_str_t &keys,
+                        const std::function<void(SQLDatabaseHelper::Statement&)> &on_row);
     void set_error(std::string msg, ERR_EGGNOG_DB code);
     void set_database_version();
     void update_dataset(set_str_t &set, EGGNOG_DATA_TYPES datatype, std::string data);
@@ -24,8 +24,13 @@
  * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <array>
 #include <csv.h>
 #include "EntapDatabase.h"
+#include "MappedDatabase.h"
+#include "BlockCompressor.h"
+#include "../ThreadPool.h"
+#include "../DownloadManager.h"
 
 /**
  * ======================================================================
@@ -50,10 +55,16 @@ EntapDatabase::EntapDatabase(FileSystem* filesystem, UserInput* userInput) {
     // Initialize
     mpFileSystem     = filesystem;
     mpUserInput      = userInput;
-    mTempDirectory  = filesystem->get_temp_outdir();    // created previously
+    // Own directory, EggNOG databases may be downloading to the temp directory concurrently
+    mTempDirectory  = PATHS(filesystem->get_temp_outdir(), TEMP_DIRECTORY);
+    mpFileSystem->create_dir(mTempDirectory);
     mpSerializedDatabase = nullptr;
+    mpMappedDatabase     = nullptr;
     mpDatabaseHelper     = nullptr;
     mUseSerial          = true;                         // default
+    mSqlBatchInserts    = 0;
+    mpGoGraph           = nullptr;
+    mGoPropagate        = userInput != nullptr && userInput->has_input(INPUT_FLAG_GO_PROPAGATE);
     mErrMsg             = "";
     mErrCode            = ERR_DATA_OK;
 }
@@ -82,6 +93,9 @@ bool EntapDatabase::set_database(DATABASE_TYPE type) {
             // Filepath checked in routine
             mUseSerial = true;
             database_path = mpUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_ENTAP_DB_BIN);
+            if (mpUserInput->has_input(INPUT_FLAG_ENTAP_DB_SHARED)) {
+                return set_shared_database(database_path);
+            }
             return serialize_database_read(SERIALIZE_DEFAULT, database_path) == ERR_DATA_OK;
         case ENTAP_SQL:
             mUseSerial = false;
@@ -92,7 +106,18 @@ bool EntapDatabase::set_database(DATABASE_TYPE type) {
             }
             if (mpDatabaseHelper != nullptr) return true;   // already generated
             mpDatabaseHelper = new SQLDatabaseHelper();
-            return mpDatabaseHelper->open(database_path);
+            return mpDatabaseHelper->open_read_only(database_path);
+        case ENTAP_MAPPED:
+            mUseSerial = false;
+            database_path = mpUserInput->get_user_input<ent_input_str_t>(INPUT_FLAG_ENTAP_DB_MAPPED);
+            if (mpMappedDatabase != nullptr) return true;   // already mapped
+            mpMappedDatabase = new MappedDatabase();
+            if (!mpMappedDatabase->open(database_path)) {
+                set_err_msg(mpMappedDatabase->get_error(), ERR_DATA_SET);
+                SAFE_DELETE(mpMappedDatabase);
+                return false;
+            }
+            return true;
         default:
             return false;
     }
@@ -123,6 +148,10 @@ EntapDatabase::DATABASE_ERR EntapDatabase::download_database(EntapDatabase::DATA
             break;
         case ENTAP_SERIALIZED:
             err = download_entap_serial(path);
+            if (err == ERR_DATA_OK && !is_plain_serial()) err = compress_entap_serial(path);
+            break;
+        case ENTAP_MAPPED:
+            err = download_entap_mapped(path);
             break;
         default:
             return ERR_DATA_OK;
@@ -166,6 +195,8 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_database(
 
 EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE type, std::string &outpath) {
     DATABASE_ERR err_code;
+    DATABASE_TYPE build_type = type;    // Type entries are added as
+    std::string  err_msg;
 
     FS_dprint("Database type: " + ENTAP_DATABASE_TYPES_STR[type] + ", Outpath: " + outpath);
     switch (type) {
@@ -189,6 +220,9 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE
                 set_err_msg("Unable to create the EnTAP SQL database", ERR_DATA_SQL_CREATE_DATABASE);
                 return ERR_DATA_SQL_CREATE_DATABASE;
             }
+            // Entries are inserted in batched transactions, see sql_batch_commit
+            mSqlBatchInserts = 0;
+            mpDatabaseHelper->begin_transaction();
             FS_dprint("Success!");
             break;
 
@@ -210,27 +244,49 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE
             FS_dprint("Success!");
             break;
 
+        case ENTAP_MAPPED:
+            FS_dprint("Generating EnTAP Memory Mapped Database...");
+            if (mpSerializedDatabase != nullptr) {
+                set_err_msg("Serialized database already set!", ERR_DATA_SERIAL_DUPLICATE);
+                return ERR_DATA_SERIAL_DUPLICATE;
+            } else if (mpFileSystem->file_exists(outpath)) {
+                set_err_msg("Mapped EnTAP database already exists at: " + outpath, ERR_DATA_FILE_EXISTS);
+                return ERR_DATA_OK;
+            }
+
+            // Entries are built as a serialized database then written in mapped format
+            mUseSerial = true;
+            build_type = ENTAP_SERIALIZED;
+            mpSerializedDatabase = new EntapDatabaseStruct();
+            FS_dprint("Success!");
+            break;
+
         default:
             set_err_msg("ERROR: Unknown database type", ERR_DATA_UNHANDLED_TYPE);
             return ERR_DATA_UNHANDLED_TYPE;
     }
 
     // ---------------------- Add Database Entries ---------------------- //
+    err_code = download_generation_files();
+    if (err_code != ERR_DATA_OK) {
+        return err_code;
+    }
+
     FS_dprint("Adding entries to database...");
     // Generate tax entries, don't need a path - using SQL member
-    err_code = generate_entap_tax(type);
+    err_code = generate_entap_tax(build_type);
     if (err_code != ERR_DATA_OK) {
         return err_code;
     }
 
     // Generate go entries
-    err_code = generate_entap_go(type);
+    err_code = generate_entap_go(build_type);
     if (err_code != ERR_DATA_OK) {
         return err_code;
     }
 
     // Generate UniProt entries (this references GO database, must be done after)
-    err_code = generate_entap_uniprot(type);
+    err_code = generate_entap_uniprot(build_type);
     if (err_code != ERR_DATA_OK) {
         return err_code;
     }
@@ -239,9 +295,14 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE
     // Write database to file if necessary and set version number
     FS_dprint("All entries have been added, finalizing...");
 
-    set_database_versions(type);
+    set_database_versions(build_type);
     switch (type) {
         case ENTAP_SQL:
+            // Lookup indexes are built once all entries have been added
+            if (!sql_batch_commit(true) || !create_sql_indexes()) {
+                set_err_msg("Unable to finalize EnTAP SQL database", ERR_DATA_SQL_CREATE_ENTRY);
+                return ERR_DATA_SQL_CREATE_ENTRY;
+            }
             break;
 
         case ENTAP_SERIALIZED:
@@ -253,6 +314,14 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE
             }
             break;
 
+        case ENTAP_MAPPED:
+            FS_dprint("All entries added to database, writing mapped database...");
+            if (!MappedDatabase::write(outpath, *mpSerializedDatabase, err_msg)) {
+                set_err_msg(err_msg, ERR_DATA_SERIALIZE_SAVE);
+                return ERR_DATA_SERIALIZE_SAVE;
+            }
+            break;
+
         default:
             return ERR_DATA_MEM_ALLOC;
     }
@@ -260,6 +329,56 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_database(DATABASE_TYPE
     return ERR_DATA_OK;
 }
 
+/**
+ * ======================================================================
+ * Function DATABASE_ERR EntapDatabase::download_generation_files()
+ *
+ * Description          - Downloads NCBI Taxonomy and Gene Ontology data
+ *                        concurrently, archives are extracted to the temp
+ *                        directory as they download
+ *
+ * Notes                - UniProt data is streamed straight into its parser
+ *                        later, as it needs the GO entries
+ *
+ * @return              - Database error code
+ *
+ * =====================================================================
+ */
+EntapDatabase::DATABASE_ERR EntapDatabase::download_generation_files() {
+    DownloadManager::DownloadJob tax_job;
+    DownloadManager::DownloadJob go_job;
+    uint64 tax_index;
+    uint64 go_index;
+
+    FS_dprint("Downloading NCBI Taxonomy and Gene Ontology data...");
+    tax_job.url             = mpFileSystem->get_download_url(FTP_NCBI_TAX_DUMP_TARGZ);
+    tax_job.out_path        = PATHS(mTempDirectory, NCBI_TAX_DUMP_FILENAME);
+    tax_job.decompress      = FileSystem::ENT_FILE_TAR_GZ;
+    tax_job.decompress_path = mTempDirectory;
+
+    go_job.url              = mpFileSystem->get_download_url(FTP_GO_DATABASE);
+    go_job.out_path         = PATHS(mTempDirectory, GO_TERMDB_FILE);
+    go_job.decompress       = FileSystem::ENT_FILE_TAR_GZ;
+    go_job.decompress_path  = mTempDirectory;
+
+    DownloadManager downloadManager(2);
+    tax_index = downloadManager.add_job(tax_job);
+    go_index  = downloadManager.add_job(go_job);
+    downloadManager.run();
+
+    if (!downloadManager.get_job(tax_index).success) {
+        set_err_msg("Unable to download NCBI Taxonomy FTP files: " +
+                    downloadManager.get_job(tax_index).err_msg, ERR_DATA_TAX_DOWNLOAD);
+        return ERR_DATA_TAX_DOWNLOAD;
+    }
+    if (!downloadManager.get_job(go_index).success) {
+        set_err_msg("Unable to download GO data from FTP address " + go_job.url + ": " +
+                    downloadManager.get_job(go_index).err_msg, ERR_DATA_GO_DOWNLOAD);
+        return ERR_DATA_GO_DOWNLOAD;
+    }
+    return ERR_DATA_OK;
+}
+
 EntapDatabase::~EntapDatabase() {
     FS_dprint("Killing Object - EntapDatabase");
     if (mpDatabaseHelper != nullptr) {
@@ -267,10 +386,10 @@ EntapDatabase::~EntapDatabase() {
         SAFE_DELETE(mpDatabaseHelper);
     }
     SAFE_DELETE(mpSerializedDatabase);
+    SAFE_DELETE(mpMappedDatabase);
 }
 
 EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_tax(EntapDatabase::DATABASE_TYPE type) {
-    std::string temp_outpath;   // Path to unzipped files
     std::string sql_cmd;
     std::stringstream ss_temp;  // just for now
     std::string line;
@@ -302,25 +421,16 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_tax(EntapDatabase::DAT
         }
     }
 
-    temp_outpath = PATHS(mTempDirectory, NCBI_TAX_DUMP_FILENAME);
-
-    // download files from NCBI tax
-    if (!mpFileSystem->download_ftp_file(FTP_NCBI_TAX_DUMP_TARGZ, temp_outpath)) {
-        set_err_msg("Unable to download NCBI Taxonomy FTP files" + mpFileSystem->get_error(), ERR_DATA_TAX_DOWNLOAD);
-        return ERR_DATA_TAX_DOWNLOAD;
-    }
-    // decompress TAR.GZ file
-    if (!mpFileSystem->decompress_file(temp_outpath, mTempDirectory, FileSystem::ENT_FILE_TAR_GZ)) {
-        set_err_msg("Unable to decompress NCBI Taxonomy data" + mpFileSystem->get_error(), ERR_DATA_FILE_DECOMPRESS);
-        return ERR_DATA_FILE_DECOMPRESS;
-    }
-    // remove tar file
-    mpFileSystem->delete_file(temp_outpath);
-    // set paths to uncompressed files
+    // Files were extracted while downloading, see download_generation_files
     ncbi_names_path = PATHS(mTempDirectory, NCBI_TAX_DUMP_FTP_NAMES);
     ncbi_nodes_path = PATHS(mTempDirectory, NCBI_TAX_DUMP_FTP_NODES);
+    if (!mpFileSystem->file_exists(ncbi_names_path) || !mpFileSystem->file_exists(ncbi_nodes_path)) {
+        set_err_msg("Necessary NCBI Taxonomy files do not exist at:\n" + ncbi_names_path +
+                    "\n" + ncbi_nodes_path, ERR_DATA_TAX_DOWNLOAD);
+        return ERR_DATA_TAX_DOWNLOAD;
+    }
 
-    FS_dprint("Files downloaded and compressed, parsing...");
+    FS_dprint("Files downloaded and decompressed, parsing...");
 
 
     FS_dprint("Parsing NCBI Names file at: " + ncbi_names_path);
@@ -336,12 +446,9 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_tax(EntapDatabase::DAT
             tax_id = split_line[NCBI_TAX_DUMP_COL_ID];
             tax_name   = split_line[NCBI_TAX_DUMP_COL_NAME];
 
-            // Check if map already has this entry, if not - generate
-            if (taxonomy_nodes.find(tax_id) == taxonomy_nodes.end()) {
-                taxonomy_nodes.emplace(tax_id, TaxonomyNode(tax_id));
-            }
-
-            std::unordered_map<std::string, TaxonomyNode>::iterator it = taxonomy_nodes.find(tax_id);
+            // Generate entry if map does not already have it
+            std::unordered_map<std::string, TaxonomyNode>::iterator it =
+                    taxonomy_nodes.emplace(tax_id, TaxonomyNode(tax_id)).first;
 
             // We'll want to use scientific names when displaying lineage
             if (split_line[NCBI_TAX_DUMP_COL_NAME_CLASS].compare(NCBI_TAX_DUMP_SCIENTIFIC) ==0) {
@@ -377,13 +484,14 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_tax(EntapDatabase::DAT
         // parse through entire map and generate NCBI taxonomy entries
         TaxEntry taxEntry;
         for (auto &pair : taxonomy_nodes) {
+            // Lineage is computed once per node (memoized), shared by each of its names
+            const std::string &lineage = entap_tax_get_lineage(pair.second, taxonomy_nodes);
             // want a separate entry for each name (doing this for now, may change)
             for (std::string name : pair.second.names) {
                 LOWERCASE(name);
                 current_entries++;
                 taxEntry = {};
-                taxEntry.lineage = entap_tax_get_lineage(pair.second, taxonomy_nodes);
-                LOWERCASE(taxEntry.lineage);
+                taxEntry.lineage = lineage;
                 taxEntry.tax_id  = pair.second.ncbi_id;
                 taxEntry.tax_name= name;
 
@@ -407,6 +515,14 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_tax(EntapDatabase::DAT
             }
             // ********************************************************** //
         }
+        if (type != ENTAP_SQL) {
+            vect_str_t tax_names;
+            tax_names.reserve(mpSerializedDatabase->taxonomic_data.size());
+            for (auto &pair : mpSerializedDatabase->taxonomic_data) {
+                tax_names.push_back(pair.first);
+            }
+            mpSerializedDatabase->tax_trie.build(tax_names);
+        }
     } catch (const std::exception &e) {
         set_err_msg("Unable to parse taxonomy data: " + std::string(e.what()), ERR_DATA_TAXONOMY_PARSE);
         return ERR_DATA_TAXONOMY_PARSE;
@@ -422,28 +538,10 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
     std::string go_db_path;
     std::string go_term_path;
     std::string go_graph_path;
-    std::string go_database_targz;  // Outpath to downloaded tar.gz file
     std::string go_database_dir;    // Directory that will contain go files
 
-    go_database_targz = PATHS(mTempDirectory, GO_TERMDB_FILE);
-
-
-    // download Gene Ontology database file
-    if (!mpFileSystem->download_ftp_file(FTP_GO_DATABASE, go_database_targz)) {
-        // failed to download from ftp
-        set_err_msg("Unable to download GO data from FTP address " + FTP_GO_DATABASE, ERR_DATA_GO_DOWNLOAD);
-        return ERR_DATA_GO_DOWNLOAD;
-    }
-
-    // decompress database file
-    if (!mpFileSystem->decompress_file(go_database_targz, mTempDirectory, FileSystem::ENT_FILE_TAR_GZ)) {
-        // failed to decompress
-        set_err_msg("Unable to decompress GO database file " + mpFileSystem->get_error(), ERR_DATA_GO_DECOMPRESS);
-        return ERR_DATA_GO_DECOMPRESS;
-    }
-    mpFileSystem->delete_file(go_database_targz);
-
-    // Files are packaged within a directory. Set paths
+    // Files were extracted while downloading (see download_generation_files) and
+    // are packaged within a directory. Set paths
     go_database_dir = PATHS(mTempDirectory, GO_TERMDB_DIR);
     go_term_path    = PATHS(go_database_dir, GO_TERM_FILE);
     go_graph_path   = PATHS(go_database_dir, GO_GRAPH_FILE);
@@ -456,7 +554,7 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
 
     // If we are creating SQL database, add GO table
     if (type == ENTAP_SQL) {
-        if (!create_sql_table(ENTAP_GENE_ONTOLOGY)) {
+        if (!create_sql_table(ENTAP_GENE_ONTOLOGY) || !create_sql_table(ENTAP_GO_GRAPH)) {
             // error creating table
             return ERR_DATA_SQL_GO_CREATE_TABLE;
         }
@@ -467,7 +565,11 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
         io::CSVReader<6, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in(go_graph_path);
         std::string index,root,branch, temp, distance, temp2;
         std::map<std::string,std::string> distance_map;
+        std::vector<std::array<std::string, 3>> direct_edges;   // Parent, child, relation (term table ids)
         while (in.read_row(index,root,branch, temp, distance, temp2)) {
+            if (distance == GO_GRAPH_DIRECT && root != branch) {
+                direct_edges.push_back({{root, branch, temp}});
+            }
             if (root.compare(GO_BIOLOGICAL_LVL) == 0     ||
                 root.compare(GO_MOLECULAR_LVL) == 0  ||
                 root.compare(GO_CELLULAR_LVL) ==0) {
@@ -483,8 +585,10 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
         }
         GoEntry goEntry;
         std::string num,term,cat,go,ex,ex1,ex2;
+        std::unordered_map<std::string, std::string> term_accessions;   // Term table id to GO ID/relation name
         io::CSVReader<7, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in2(go_term_path);
         while (in2.read_row(num,term,cat,go,ex,ex1,ex2)) {
+            term_accessions[num] = go;
             goEntry = {};
             goEntry.category = cat;
             goEntry.level = distance_map[num];
@@ -501,6 +605,27 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
                 mpSerializedDatabase->gene_ontology_data[go] = goEntry;
             }
         }
+
+        // Gene Ontology DAG, only relations annotations are propagated through
+        GoGraph::parent_map_t go_parents;
+        for (const std::array<std::string, 3> &edge : direct_edges) {
+            const std::string &relation = term_accessions[edge[2]];
+            if (relation != GO_RELATION_IS_A && relation != GO_RELATION_PART_OF) continue;
+            const std::string &parent = term_accessions[edge[0]];
+            const std::string &child  = term_accessions[edge[1]];
+            if (parent.empty() || child.empty()) continue;
+            go_parents[child].push_back(parent);
+        }
+        FS_dprint("Gene Ontology terms with parents: " + std::to_string(go_parents.size()));
+        if (type == ENTAP_SQL) {
+            if (!sql_add_go_graph(go_parents)) {
+                set_err_msg("Unable to add Gene Ontology graph to SQL database", ERR_DATA_GO_ENTRY);
+                return ERR_DATA_GO_ENTRY;
+            }
+        } else if (!mpSerializedDatabase->go_graph.build(go_parents)) {
+            set_err_msg("Unable to build Gene Ontology graph", ERR_DATA_GO_PARSE);
+            return ERR_DATA_GO_PARSE;
+        }
     } catch (const std::exception &e) {
         set_err_msg("Unable to parse Gene Ontology data: " + std::string(e.what()), ERR_DATA_GO_PARSE);
         return ERR_DATA_GO_PARSE;
@@ -514,206 +639,408 @@ EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_go(EntapDatabase::DATA
 
 
 EntapDatabase::DATABASE_ERR EntapDatabase::generate_entap_uniprot(EntapDatabase::DATABASE_TYPE type) {
+    DATABASE_ERR parse_err = ERR_DATA_OK;
+    DownloadManager::DownloadJob job;
 
-    std::string uniprot_flat_gz;
-    std::string uniprot_flat;       // Decompressed path (this is parsed)
-    std::string line;
-    std::string dat_tag;
-    std::string database;
-    std::string go_list;            // Will be turned into go_format when indexed (comma delim)
-    std::string kegg_list;
-    uint16      file_status;
-    uint16      index_go;
-    uint16      index_term;
-    std::string data;
-    bool        same_entry = false;
+    // If we are creating SQL database, add UniProt table
+    if (type == ENTAP_SQL) {
+        if (!create_sql_table(ENTAP_UNIPROT)) {
+            // error creating table
+            set_err_msg("Unable to create UniProt SQL Table", ERR_DATA_SQL_UNIPROT_CREATE_TABLE);
+            return ERR_DATA_SQL_UNIPROT_CREATE_TABLE;
+        }
+    }
 
-    const uint8       UNIPROT_DAT_TAG_LEN            = 2;   // Length of tags
-    const uint8       UNIPROT_DAT_TAG_DATA_POS       = 5;   // Position data starts
-    // ID   001R_FRG3G              Reviewed;         256 AA.
-    const std::string UNIPROT_DAT_TAG_ID             = "ID";
-    // DR   SwissPalm; Q6GZX4; -.
-    const std::string UNIPROT_DAT_TAG_DATABASE_X_REF = "DR";
-    // Tag used to separate database names
-    const char UNIPROT_DAT_TAG_DATABASE_DELIM    = ';';
-    // Tag used for the Gene Ontology database
-    const std::string UNIPROT_DAT_TAG_DATABASE_GO = "GO";
-    // Tag used for the KEGG database
-    const std::string UNIPROT_DAT_TAG_DATABASE_KEGG = "KEGG";
+    // UniProt flat file is decompressed and parsed as it downloads, never written to disk
+    job.url        = mpFileSystem->get_download_url(FTP_UNIPROT_FLAT_FILE);
+    job.out_path   = PATHS(mTempDirectory, UNIPROT_DAT_FILE_GZ);
+    job.decompress = FileSystem::ENT_FILE_GZ;
+    job.consumer   = [this, type, &parse_err](std::istream &in) {
+        parse_err = parse_uniprot_stream(type, in);
+        return parse_err == ERR_DATA_OK;
+    };
+
+    DownloadManager downloadManager(1);
+    downloadManager.add_job(job);
+    if (!downloadManager.run()) {
+        // Parser sees an early end of data if the download failed, report that instead
+        if (downloadManager.get_job(0).transferred && parse_err != ERR_DATA_OK) return parse_err;
+        set_err_msg("Unable to download UniProt data from " + job.url +
+                    downloadManager.get_error(), ERR_DATA_UNIPROT_DOWNLOAD);
+        return ERR_DATA_UNIPROT_DOWNLOAD;
+    }
+    if (parse_err != ERR_DATA_OK) return parse_err;
+
+    FS_dprint("Success! UniProt entries added");
+    return ERR_DATA_OK;
+}
+
+/**
+ * ======================================================================
+ * Function DATABASE_ERR EntapDatabase::parse_uniprot_stream(DATABASE_TYPE type, std::istream &in)
+ *
+ * Description          - Parses decompressed UniProt flat file data and adds
+ *                        entries to the database
+ *                      - Chunks of whole entries are parsed by the pool, then
+ *                        added to the database in file order
+ *
+ * Notes                - Called by the download manager as data arrives
+ *
+ * @param type          - Database type entries are added as
+ * @param in            - Decompressed UniProt flat file data
+ *
+ * @return              - Database error code
+ *
+ * =====================================================================
+ */
+EntapDatabase::DATABASE_ERR EntapDatabase::parse_uniprot_stream(DATABASE_TYPE type, std::istream &in) {
+    std::string carry;              // Partial entry carried to next chunk
+    uint16      threads;
+    uint64      chunk_count;
+    uint64      data_start;
+    uint64      entry_end;
+    uint64      total_entries=0;
+    bool        end_of_file=false;
+    std::vector<UniprotParseChunk> chunks;  // Chunks parsed together, added in file order
 
-    // CC   -!- FUNCTION: Transcription activation. {ECO:0000305}.
-    const std::string UNIPROT_DAT_TAG_COMMENT        = "CC";
     // Entries are split by this (this is on the last line of file)
-    const std::string UNIPROT_DAT_TAG_NEXT_ENTRY     = "//";
+    const std::string UNIPROT_DAT_ENTRY_END = "\n//\n";
 
-    // Set output path for FTP file
-    uniprot_flat_gz = PATHS(mTempDirectory, UNIPROT_DAT_FILE_GZ);
-    uniprot_flat    = PATHS(mTempDirectory, UNIPROT_DAT_FILE);
+    threads = get_thread_count();
+    chunks.resize((uint64) threads * UNIPROT_CHUNKS_PER_THREAD);
+    FS_dprint("Parsing UniProt data with " + std::to_string(threads) + " threads...");
 
+    try {
+        ThreadPool threadPool(threads);
+        while (!end_of_file) {
+            chunk_count = 0;
+            while (chunk_count < chunks.size() && !end_of_file) {
+                UniprotParseChunk &chunk = chunks[chunk_count];
+                chunk.data = std::move(carry);
+                carry.clear();
+                chunk.entries.clear();
+                chunk.err_msg.clear();
+
+                data_start = chunk.data.size();
+                chunk.data.resize(data_start + UNIPROT_CHUNK_BYTES);
+                in.read(&chunk.data[data_start], UNIPROT_CHUNK_BYTES);
+                chunk.data.resize(data_start + (uint64) in.gcount());
+                if ((uint64) in.gcount() < UNIPROT_CHUNK_BYTES) {
+                    end_of_file = true;
+                } else {
+                    // Split after last complete entry, remainder starts next chunk
+                    entry_end = chunk.data.rfind(UNIPROT_DAT_ENTRY_END);
+                    if (entry_end == std::string::npos) {
+                        carry = std::move(chunk.data);     // Entry larger than chunk, keep reading
+                        continue;
+                    }
+                    entry_end += UNIPROT_DAT_ENTRY_END.length();
+                    carry.assign(chunk.data, entry_end, std::string::npos);
+                    chunk.data.resize(entry_end);
+                }
+                chunk_count++;
+            }
 
-    // download UniProt flat file
-    if (!mpFileSystem->download_ftp_file(FTP_UNIPROT_FLAT_FILE, uniprot_flat_gz)) {
-        // failed to download from ftp
-        set_err_msg("Unable to download UniProt data from " + FTP_UNIPROT_FLAT_FILE + mpFileSystem->get_error(), ERR_DATA_UNIPROT_DOWNLOAD);
-        return ERR_DATA_UNIPROT_DOWNLOAD;
-    }
+            for (uint64 i = 0; i < chunk_count; i++) {
+                UniprotParseChunk *pChunk = &chunks[i];
+                threadPool.enqueue([this, pChunk] {
+                    parse_uniprot_chunk(*pChunk);
+                });
+            }
+            threadPool.wait_all();
 
-    // decompress database file
-    if (!mpFileSystem->decompress_file(uniprot_flat_gz, uniprot_flat, FileSystem::ENT_FILE_GZ)) {
-        // failed to decompress
-        set_err_msg("Unable to decompress UniProt data" + mpFileSystem->get_error(), ERR_DATA_UNIPROT_DECOMPRESS);
-        return ERR_DATA_UNIPROT_DECOMPRESS;
+            for (uint64 i = 0; i < chunk_count; i++) {
+                if (!chunks[i].err_msg.empty()) {
+                    set_err_msg("Unable to parse UniProt data: " + chunks[i].err_msg, ERR_DATA_UNIPROT_PARSE);
+                    return ERR_DATA_UNIPROT_PARSE;
+                }
+                for (UniprotEntry &uniprotEntry : chunks[i].entries) {
+                    if (!add_uniprot_entry(type, uniprotEntry)) {
+                        // Unable to add entry
+                        set_err_msg("ERROR: Unable to add entry:\n" + uniprotEntry.print(), ERR_DATA_UNIPROT_ENTRY);
+                        return ERR_DATA_UNIPROT_ENTRY;
+                    }
+                }
+                total_entries += chunks[i].entries.size();
+                chunks[i] = UniprotParseChunk();    // Release chunk memory
+            }
+            FS_dprint("UniProt entries added: " + std::to_string(total_entries));
+        }
+    } catch (const std::exception &e) {
+        set_err_msg("Unable to parse UniProt data: " + std::string(e.what()), ERR_DATA_UNIPROT_PARSE);
+        return ERR_DATA_UNIPROT_PARSE;
     }
-    mpFileSystem->delete_file(uniprot_flat_gz); // Ensure gz file is deleted
 
-    FS_dprint("UniProt file downloaded/decompressed, verifying...");
-    // Ensure file is valid (should be)
-    file_status = mpFileSystem->get_file_status(uniprot_flat);
-    if (file_status != 0) {
-        // File invalid
-        set_err_msg(mpFileSystem->print_file_status(file_status, uniprot_flat), ERR_DATA_UNIPROT_FILE);
+    if (total_entries == 0) {
+        set_err_msg("No UniProt entries found in downloaded data", ERR_DATA_UNIPROT_FILE);
         return ERR_DATA_UNIPROT_FILE;
     }
+    return ERR_DATA_OK;
+}
+
+/**
+ * ======================================================================
+ * Function void EntapDatabase::parse_uniprot_chunk(UniprotParseChunk &chunk)
+ *
+ * Description          - Parses UniProt flat file entries of a chunk
+ *                      - Lines are read in place, only the data kept for
+ *                        each entry is copied
+ *
+ * Notes                - Run by generation thread pool, errors are set in
+ *                        chunk rather than thrown
+ *                      - GO terms are formatted against the GO entries
+ *                        already in the database
+ *
+ * @param chunk         - Chunk of whole entries, parsed entries are added to it
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void EntapDatabase::parse_uniprot_chunk(UniprotParseChunk &chunk) {
+    const char *data_end = chunk.data.data() + chunk.data.size();
+    const char *line = chunk.data.data();   // Start of current line
+    const char *line_end = line;            // End of current line (newline or end of chunk)
+    const char *data;               // Start of line data (after tag)
+    const char *id_end;             // End of UniProt ID on ID line
+    uint64      data_len;
+    std::string database;
+    std::string go_list;            // Will be turned into go_format when indexed (comma delim)
+    std::string kegg_list;
+    uint64      index_go;
+    uint64      index_term;
+    bool        same_entry = false;
+    UniprotEntry uniprotEntry;
+
+    const uint8 UNIPROT_DAT_TAG_LEN            = 2;   // Length of tags
+    const uint8 UNIPROT_DAT_TAG_DATA_POS       = 5;   // Position data starts
+    // Tag used to separate database names
+    const char UNIPROT_DAT_TAG_DATABASE_DELIM  = ';';
+    // Tag used for the Gene Ontology database
+    const std::string UNIPROT_DAT_TAG_DATABASE_GO = "GO";
+    // Tag used for the KEGG database
+    const std::string UNIPROT_DAT_TAG_DATABASE_KEGG = "KEGG";
 
-    // If we are creating SQL database, add UniProt table
-    if (type == ENTAP_SQL) {
-        if (!create_sql_table(ENTAP_UNIPROT)) {
-            // error creating table
-            set_err_msg("Unable to create UniProt SQL Table", ERR_DATA_SQL_UNIPROT_CREATE_TABLE);
-            return ERR_DATA_SQL_UNIPROT_CREATE_TABLE;
-        }
-    }
-    FS_dprint("UniProt file successfully downloaded/decompressed. Parsing...");
-    // File valid, continue to parse
     try {
-        UniprotEntry uniprotEntry;
-        std::ifstream infile(uniprot_flat);
-        while (std::getline(infile, line)) {
-            if (line.empty() || line.length() < UNIPROT_DAT_TAG_LEN) continue;
-            STR_ERASE(line, '\n');
-            dat_tag = line.substr(0, UNIPROT_DAT_TAG_LEN);
-            if (line.length() > UNIPROT_DAT_TAG_DATA_POS) {
-                data = line.substr(UNIPROT_DAT_TAG_DATA_POS); // All data from the line
+        for (; line < data_end; line = line_end + 1) {
+            line_end = (const char*) memchr(line, '\n', (size_t)(data_end - line));
+            if (line_end == nullptr) line_end = data_end;
+            if (line_end - line < UNIPROT_DAT_TAG_LEN) continue;
+
+            if (line_end - line > UNIPROT_DAT_TAG_DATA_POS) {
+                data = line + UNIPROT_DAT_TAG_DATA_POS;     // All data from the line
+                data_len = (uint64) (line_end - data);
+            } else {
+                data = line_end;
+                data_len = 0;
             }
 
-            // Check if this is sequence ID
-            if (dat_tag == UNIPROT_DAT_TAG_ID) {
+            if (line[0] == 'I' && line[1] == 'D') {
+                // ID   001R_FRG3G              Reviewed;         256 AA.
                 if (same_entry) {
-                    FS_dprint("ERROR: Same entry is true");
-                    return ERR_DATA_UNIPROT_PARSE;
+                    chunk.err_msg = "Same entry is true at: " + uniprotEntry.uniprot_id;
+                    return;
                 }
                 same_entry = true;
-                uniprotEntry.uniprot_id = line.substr(UNIPROT_DAT_TAG_DATA_POS,
-                                                      line.find_first_of(' ',UNIPROT_DAT_TAG_DATA_POS)-UNIPROT_DAT_TAG_DATA_POS);
-            } else if (dat_tag == UNIPROT_DAT_TAG_DATABASE_X_REF) {
-                // ID matches the database cross reference ID
+                id_end = (const char*) memchr(data, ' ', data_len);
+                uniprotEntry.uniprot_id.assign(data, id_end != nullptr ? id_end : data + data_len);
 
+            } else if (line[0] == 'D' && line[1] == 'R') {
+                // DR   SwissPalm; Q6GZX4; -.
                 // Check which database we have
-                database = data.substr(0, data.find(UNIPROT_DAT_TAG_DATABASE_DELIM));
+                std::string line_data(data, data_len);
+                database = line_data.substr(0, line_data.find(UNIPROT_DAT_TAG_DATABASE_DELIM));
                 if (database == UNIPROT_DAT_TAG_DATABASE_GO) {
-                    index_go = (uint16) data.find("GO:");
-                    index_term = (uint16) data.find(';', index_go);
-                    go_list += data.substr(index_go, index_term - index_go) + ',';
+                    index_go = line_data.find("GO:");
+                    index_term = line_data.find(';', index_go);
+                    go_list.append(line_data, index_go, index_term - index_go);
+                    go_list += ',';
 
                 } else if (database == UNIPROT_DAT_TAG_DATABASE_KEGG) {
-                    index_go = (uint16) (data.find(':') + 1);
-                    index_term = (uint16) data.find(';', index_go);
-                    kegg_list += data.substr(index_go, index_term - index_go) + ',';
+                    index_go = line_data.find(':') + 1;
+                    index_term = line_data.find(';', index_go);
+                    kegg_list.append(line_data, index_go, index_term - index_go);
+                    kegg_list += ',';
                 } else {
                     // Neither GO nor KEGG, add to x refs
-                    uniprotEntry.database_x_refs += "|" + data;
+                    uniprotEntry.database_x_refs += '|';
+                    uniprotEntry.database_x_refs.append(data, data_len);
                 }
 
-            } else if (dat_tag == UNIPROT_DAT_TAG_COMMENT) {
-                // ID matches the comments (sometimes useful info? maybe)
-                uniprotEntry.comments += "|" + data;
-            } else if (dat_tag == UNIPROT_DAT_TAG_NEXT_ENTRY){
-                // We've hit the next entry, add previous to the database
+            } else if (line[0] == 'C' && line[1] == 'C') {
+                // CC   -!- FUNCTION: Transcription activation. {ECO:0000305}.
+                uniprotEntry.comments += '|';
+                uniprotEntry.comments.append(data, data_len);
+
+            } else if (line[0] == '/' && line[1] == '/') {
+                // We've hit the next entry, add previous
                 if (go_list.length() > 0) go_list.pop_back();   // remove trailing ','
                 uniprotEntry.go_terms = format_go_delim(go_list, ',');
                 uniprotEntry.kegg_terms = kegg_list;
+                chunk.entries.push_back(std::move(uniprotEntry));
 
-                if (!add_uniprot_entry(type, uniprotEntry)) {
-                    // Unable to add entry
-                    set_err_msg("ERROR: Unable to add entry:\n" + uniprotEntry.print(), ERR_DATA_UNIPROT_ENTRY);
-                    return ERR_DATA_UNIPROT_ENTRY;
-                }
                 uniprotEntry = {};
                 same_entry = false;
-                go_list = "";
-                kegg_list = "";
+                go_list.clear();
+                kegg_list.clear();
 
             } else {
                 // Unhandled information from UniProt mapping, discard
             }
         }
     } catch (const std::exception &e) {
-        set_err_msg("Unable to parse UniProt data: " + std::string(e.what()) + "\nLine: " + line,
-                    ERR_DATA_UNIPROT_PARSE);
-        return ERR_DATA_UNIPROT_PARSE;
+        chunk.err_msg = std::string(e.what()) + "\nLine: " + std::string(line, line_end);
     }
-
-    FS_dprint("Success! UniProt entries added");
-    mpFileSystem->delete_file(uniprot_flat);
-    return ERR_DATA_OK;
 }
 
 
-// WARNING: recursive
-std::string EntapDatabase::entap_tax_get_lineage(EntapDatabase::TaxonomyNode &node,
-                                                 std::unordered_map<std::string,TaxonomyNode>& map) {
-    if (node.ncbi_id == "1" || node.ncbi_id == "") {
-        return "root";
-    } else {
-        return node.sci_name + ";" + entap_tax_get_lineage(map.at(node.parent_id), map);
+/**
+ * ======================================================================
+ * Function const std::string &EntapDatabase::entap_tax_get_lineage(TaxonomyNode &node,
+ *                                  std::unordered_map<std::string,TaxonomyNode>& map)
+ *
+ * Description          - Returns lowercase lineage of node (node;parent;...;root)
+ *                      - Walks up to the first ancestor with a known lineage,
+ *                        then fills in lineages on the way back down so each
+ *                        node is only computed once
+ *
+ * Notes                - Throws std::out_of_range if a parent is missing from
+ *                        the map, std::runtime_error if ancestry has a cycle
+ *
+ * @param node          - Node to get lineage of
+ * @param map           - All taxonomy nodes keyed by NCBI ID
+ *
+ * @return              - Lineage, stored in node
+ *
+ * =====================================================================
+ */
+const std::string &EntapDatabase::entap_tax_get_lineage(EntapDatabase::TaxonomyNode &node,
+                                                        std::unordered_map<std::string,TaxonomyNode>& map) {
+    std::vector<TaxonomyNode*> unresolved;  // Node first, ancestors without a lineage yet
+    TaxonomyNode *current = &node;
+    std::string   sci_name;
+
+    while (current->lineage.empty()) {
+        if (current->ncbi_id == "1" || current->ncbi_id == "") {
+            current->lineage = "root";
+            break;
+        }
+        unresolved.push_back(current);
+        if (unresolved.size() > map.size()) {
+            throw std::runtime_error("Cycle in taxonomy ancestry of NCBI ID: " + node.ncbi_id);
+        }
+        current = &map.at(current->parent_id);
+    }
+
+    // current has a lineage, resolve descendants from oldest to node
+    for (auto it = unresolved.rbegin(); it != unresolved.rend(); ++it) {
+        sci_name = (*it)->sci_name;
+        LOWERCASE(sci_name);
+        (*it)->lineage = sci_name + ";" + current->lineage;
+        current = *it;
     }
+    return node.lineage;
 }
 
 bool EntapDatabase::sql_add_tax_entry(TaxEntry &taxEntry) {
-    char *sql_cmd;
-
     if (mpDatabaseHelper == nullptr) return false;
 
-    sql_cmd = sqlite3_mprintf(
-            "INSERT INTO %Q (%Q,%Q,%Q) "\
-            "VALUES (%Q, %Q, %Q);",
-
-            SQL_TABLE_NCBI_TAX_TITLE.c_str(),
-            SQL_COL_NCBI_TAX_TAXID.c_str(),
-            SQL_COL_NCBI_TAX_LINEAGE.c_str(),
-            SQL_COL_NCBI_TAX_NAME.c_str(),
-            taxEntry.tax_id.c_str(),
-            taxEntry.lineage.c_str(),
-            taxEntry.tax_name.c_str()
-    );
-    return mpDatabaseHelper->execute_cmd(sql_cmd);
+    try {
+        SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_INSERT_TAX);
+        statement.bind(1, taxEntry.tax_id);
+        statement.bind(2, taxEntry.lineage);
+        statement.bind(3, taxEntry.tax_name);
+        statement.step();
+    } catch (const std::exception &e) {
+        FS_dprint("SQL Error: " + std::string(e.what()));
+        return false;
+    }
+    return sql_batch_commit(false);
 }
 
 bool EntapDatabase::sql_add_go_entry(GoEntry &goEntry) {
-    char *sql_cmd;
+    if (mpDatabaseHelper == nullptr) return false;
+
+    try {
+        SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_INSERT_GO);
+        statement.bind(1, goEntry.go_id);
+        statement.bind(2, goEntry.term);
+        statement.bind(3, goEntry.category);
+        statement.bind(4, goEntry.level);
+        statement.step();
+    } catch (const std::exception &e) {
+        FS_dprint("SQL Error: " + std::string(e.what()));
+        return false;
+    }
+    return sql_batch_commit(false);
+}
+
+/**
+ * ======================================================================
+ * Function bool EntapDatabase::sql_add_go_graph(const GoGraph::parent_map_t &parents)
+ *
+ * Description          - Adds direct parents of each GO term to the SQL
+ *                        Gene Ontology graph table
+ *
+ * Notes                - Ancestor closure is rebuilt when loaded (get_go_graph)
+ *
+ * @param parents       - GO ID to direct parent GO IDs
+ *
+ * @return              - True/false if successful
+ *
+ * =====================================================================
+ */
+bool EntapDatabase::sql_add_go_graph(const GoGraph::parent_map_t &parents) {
+    std::string parent_list;
 
     if (mpDatabaseHelper == nullptr) return false;
 
-    sql_cmd = sqlite3_mprintf(
-            "INSERT INTO %Q (%Q,%Q,%Q,%Q) "\
-            "VALUES (%Q, %Q, %Q, %Q);",
-
-            SQL_TABLE_GO_TITLE.c_str(),
-            SQL_TABLE_GO_COL_ID.c_str(),
-            SQL_TABLE_GO_COL_DESC.c_str(),
-            SQL_TABLE_GO_COL_CATEGORY.c_str(),
-            SQL_TABLE_GO_COL_LEVEL.c_str(),
-            goEntry.go_id.c_str(),
-            goEntry.term.c_str(),
-            goEntry.category.c_str(),
-            goEntry.level.c_str()
-    );
-    return mpDatabaseHelper->execute_cmd(sql_cmd);
+    for (const auto &pair : parents) {
+        parent_list.clear();
+        for (const std::string &parent : pair.second) {
+            if (!parent_list.empty()) parent_list += GO_GRAPH_DELIM;
+            parent_list += parent;
+        }
+        try {
+            SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_INSERT_GO_GRAPH);
+            statement.bind(1, pair.first);
+            statement.bind(2, parent_list);
+            statement.step();
+        } catch (const std::exception &e) {
+            FS_dprint("SQL Error: " + std::string(e.what()));
+            return false;
+        }
+        if (!sql_batch_commit(false)) return false;
+    }
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool EntapDatabase::sql_batch_commit(bool finish)
+ *
+ * Description          - Commits the generation transaction every
+ *                        SQL_INSERT_BATCH inserts and begins the next one
+ *
+ * Notes                - No-op if no transaction is open
+ *
+ * @param finish        - Commit now and do not begin another transaction
+ *
+ * @return              - True/false if successful
+ *
+ * =====================================================================
+ */
+bool EntapDatabase::sql_batch_commit(bool finish) {
+    if (mpDatabaseHelper == nullptr || !mpDatabaseHelper->in_transaction()) return true;
+
+    if (!finish && ++mSqlBatchInserts < SQL_INSERT_BATCH) return true;
+    mSqlBatchInserts = 0;
+    if (!mpDatabaseHelper->commit_transaction()) return false;
+    return finish || mpDatabaseHelper->begin_transaction();
 }
 
 bool EntapDatabase::add_uniprot_entry(EntapDatabase::DATABASE_TYPE type, UniprotEntry &entry) {
     bool ret = true;
-    char *sql_cmd;
 
     switch (type) {
         case ENTAP_SERIALIZED:
@@ -732,19 +1059,18 @@ bool EntapDatabase::add_uniprot_entry(EntapDatabase::DATABASE_TYPE type, Uniprot
                 break;
             }
 
-            sql_cmd = sqlite3_mprintf(
-                    "INSERT INTO %Q (%Q,%Q,%Q) " \
-                    "VALUES (%Q,%Q,%Q);",
-
-                    SQL_TABLE_UNIPROT_TITLE.c_str(),
-                    SQL_TABLE_UNIPROT_COL_ID.c_str(),
-                    SQL_TABLE_UNIPROT_COL_XREF.c_str(),
-                    SQL_TABLE_UNIPROT_COL_COMM.c_str(),
-                    entry.uniprot_id.c_str(),
-                    entry.database_x_refs.c_str(),
-                    entry.comments.c_str()
-            );
-            ret = mpDatabaseHelper->execute_cmd(sql_cmd);
+            try {
+                SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_INSERT_UNIPROT);
+                statement.bind(1, entry.uniprot_id);
+                statement.bind(2, entry.database_x_refs);
+                statement.bind(3, entry.comments);
+                statement.step();
+            } catch (const std::exception &e) {
+                FS_dprint("SQL Error: " + std::string(e.what()));
+                ret = false;
+                break;
+            }
+            ret = sql_batch_commit(false);
             break;
 
         default:
@@ -810,6 +1136,20 @@ bool EntapDatabase::create_sql_table(DATABASE_TYPE type) {
             );
             break;
 
+        case ENTAP_GO_GRAPH:
+            FS_dprint("Creating SQL Gene Ontology graph table...");
+            sql_cmd = sqlite3_mprintf(
+                    "CREATE TABLE %Q ("                     \
+                    "ID        INTEGER PRIMARY KEY       NOT NULL," \
+                    "%Q        TEXT                      NOT NULL," \
+                    "%Q        TEXT                      NOT NULL);",
+
+                    SQL_TABLE_GO_GRAPH_TITLE.c_str(),
+                    SQL_TABLE_GO_COL_ID.c_str(),
+                    SQL_TABLE_GO_GRAPH_COL_PARENTS.c_str()
+            );
+            break;
+
         case ENTAP_VERSION:
             FS_dprint("Creating version table...");
             sql_cmd = sqlite3_mprintf(
@@ -833,9 +1173,44 @@ bool EntapDatabase::create_sql_table(DATABASE_TYPE type) {
         std::string temp = sql_cmd;
         FS_dprint("ERROR: Unable to create table with command: \n" + temp);
     }
+    sqlite3_free(sql_cmd);
     return success;
 }
 
+/**
+ * ======================================================================
+ * Function bool EntapDatabase::create_sql_indexes()
+ *
+ * Description          - Indexes the lookup column of each SQL table
+ *
+ * Notes                - Called after the bulk load, building an index once
+ *                        is far cheaper than maintaining it per insert
+ *
+ * @return              - True/false if successful
+ *
+ * =====================================================================
+ */
+bool EntapDatabase::create_sql_indexes() {
+    std::string sql_cmd;
+
+    if (mpDatabaseHelper == nullptr) return false;
+
+    FS_dprint("Creating SQL lookup indexes...");
+    sql_cmd =
+        "CREATE INDEX IF NOT EXISTS IDX_" + SQL_TABLE_NCBI_TAX_TITLE + " ON " +
+            SQL_TABLE_NCBI_TAX_TITLE + " (" + SQL_COL_NCBI_TAX_NAME + ");" +
+        "CREATE INDEX IF NOT EXISTS IDX_" + SQL_TABLE_GO_TITLE + " ON " +
+            SQL_TABLE_GO_TITLE + " (" + SQL_TABLE_GO_COL_ID + ");" +
+        "CREATE INDEX IF NOT EXISTS IDX_" + SQL_TABLE_UNIPROT_TITLE + " ON " +
+            SQL_TABLE_UNIPROT_TITLE + " (" + SQL_TABLE_UNIPROT_COL_ID + ");";
+    if (!mpDatabaseHelper->execute_cmd((char*)sql_cmd.c_str())) {
+        FS_dprint("ERROR: Unable to create SQL indexes");
+        return false;
+    }
+    FS_dprint("Success!");
+    return true;
+}
+
 EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_serial(std::string &out_path) {
     std::string temp_gz_path;
 
@@ -847,7 +1222,7 @@ EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_serial(std::string &ou
     // download file (will be compressed as gz)
     if (!mpFileSystem->download_ftp_file(FTP_ENTAP_DATABASE_SERIAL, temp_gz_path)) {
         // File download failed!
-        set_err_msg("Unable to download EnTAP Serial Database from " + FTP_ENTAP_DATABASE_SERIAL +
+        set_err_msg("Unable to download EnTAP Serial Database from " + mpFileSystem->get_download_url(FTP_ENTAP_DATABASE_SERIAL) +
             mpFileSystem->get_error(), ERR_DATA_SERIAL_FTP);
         return ERR_DATA_SERIAL_FTP;
     }
@@ -866,18 +1241,101 @@ EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_serial(std::string &ou
     return ERR_DATA_OK;
 }
 
-EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_sql(std::string &path) {
-    std::string temp_gz_path;
-
-    FS_dprint("Downloading EnTAP sql database...");
+/**
+ * ======================================================================
+ * Function EntapDatabase::DATABASE_ERR EntapDatabase::compress_entap_serial(std::string &path)
+ *
+ * Description          - Converts a plain serialized EnTAP database (as
+ *                        hosted on the FTP) to the block compressed format
+ *
+ * Notes                - Contents are not deserialized, the archive is
+ *                        compressed as is
+ *
+ * @param path          - Path to serialized database, replaced in place
+ *
+ * @return              - DATABASE_ERR type
+ *
+ * =====================================================================
+ */
+EntapDatabase::DATABASE_ERR EntapDatabase::compress_entap_serial(std::string &path) {
+    std::string temp_path;
+    std::string contents;
+    std::string err_msg;
+
+    if (BlockCompressor::is_compressed(path)) return ERR_DATA_OK;
+    FS_dprint("Compressing EnTAP serialized database at: " + path);
+
+    std::ifstream in_file(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+    if (in_file.bad()) {
+        set_err_msg("Unable to read EnTAP serialized database at: " + path, ERR_DATA_SERIALIZE_SAVE);
+        return ERR_DATA_SERIALIZE_SAVE;
+    }
+    in_file.close();
 
-    // set temp path (will be downloaded to this then decompressed)
-    temp_gz_path = PATHS(mTempDirectory, ENTAP_DATABASE_SQL_GZ);
+    temp_path = path + ".tmp";
+    if (!BlockCompressor::write(temp_path, contents, get_thread_count(), err_msg) ||
+        !mpFileSystem->rename_file(temp_path, path)) {
+        mpFileSystem->delete_file(temp_path);
+        set_err_msg("Unable to compress EnTAP serialized database at: " + path + "\n" + err_msg,
+                    ERR_DATA_SERIALIZE_SAVE);
+        return ERR_DATA_SERIALIZE_SAVE;
+    }
+    return ERR_DATA_OK;
+}
+
+/**
+ * ======================================================================
+ * Function EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_mapped(std::string &out_path)
+ *
+ * Description          - Downloads the serialized EnTAP database and writes
+ *                        its contents as a memory mapped database
+ *
+ * Notes                - No mapped database is hosted, the serialized one is
+ *                        only kept in the temporary directory
+ *
+ * @param out_path      - Path to output mapped database
+ *
+ * @return              - DATABASE_ERR type
+ *
+ * =====================================================================
+ */
+EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_mapped(std::string &out_path) {
+    std::string  temp_serial_path;
+    std::string  err_msg;
+    DATABASE_ERR err_code;
+
+    FS_dprint("Downloading EnTAP serialized database for mapping...");
+
+    temp_serial_path = PATHS(mTempDirectory, ENTAP_DATABASE_SERIAL);
+    err_code = download_entap_serial(temp_serial_path);
+    if (err_code != ERR_DATA_OK) return err_code;
+
+    mUseSerial = true;
+    err_code = serialize_database_read(SERIALIZE_DEFAULT, temp_serial_path);
+    mpFileSystem->delete_file(temp_serial_path);
+    if (err_code != ERR_DATA_OK) return err_code;
+
+    if (!MappedDatabase::write(out_path, *mpSerializedDatabase, err_msg)) {
+        set_err_msg(err_msg, ERR_DATA_SERIALIZE_SAVE);
+        return ERR_DATA_SERIALIZE_SAVE;
+    }
+    SAFE_DELETE(mpSerializedDatabase);
+    return ERR_DATA_OK;
+}
+
+EntapDatabase::DATABASE_ERR EntapDatabase::download_entap_sql(std::string &path) {
+    std::string temp_gz_path;
+
+    FS_dprint("Downloading EnTAP sql database...");
+
+    // set temp path (will be downloaded to this then decompressed)
+    temp_gz_path = PATHS(mTempDirectory, ENTAP_DATABASE_SQL_GZ);
 
     // download file (will be compressed as gz)
     if (!mpFileSystem->download_ftp_file(FTP_ENTAP_DATABASE_SQL, temp_gz_path)) {
         // File download failed!
-        set_err_msg("Unable to download EnTAP Serial Database from " + FTP_ENTAP_DATABASE_SQL +
+        set_err_msg("Unable to download EnTAP Serial Database from " + mpFileSystem->get_download_url(FTP_ENTAP_DATABASE_SQL) +
                     mpFileSystem->get_error(), ERR_DATA_SQL_FTP);
         return ERR_DATA_SQL_FTP;
     }
@@ -909,30 +1367,30 @@ GoEntry EntapDatabase::get_go_entry(std::string &go_id) {
             return GoEntry();
         } else return it->second;
 
+    } else if (mpMappedDatabase != nullptr) {
+        // Using mapped database
+        mpMappedDatabase->find_go_entry(go_id, goEntry);
+        return goEntry;
+
     } else {
         // Using SQL database
-        std::vector<std::vector<std::string>> results;
         // Check temp if previously found (increase speeds)
-        go_serial_map_t::iterator it = mSqlGoHelper.find(go_id);
-        if (it != mSqlGoHelper.end()) return it->second;
-        // Generate SQL query
-        char *query = sqlite3_mprintf(
-                "SELECT %q, %q, %q, %q FROM %q WHERE %q=%Q",
-                SQL_TABLE_GO_COL_ID.c_str(),
-                SQL_TABLE_GO_COL_DESC.c_str(),
-                SQL_TABLE_GO_COL_CATEGORY.c_str(),
-                SQL_TABLE_GO_COL_LEVEL.c_str(),
-                SQL_TABLE_GO_TITLE.c_str(),
-                SQL_TABLE_GO_COL_ID.c_str(),
-                go_id.c_str()
-        );
+        {
+            std::lock_guard<std::mutex> lock(mSqlGoMutex);
+            go_serial_map_t::iterator it = mSqlGoHelper.find(go_id);
+            if (it != mSqlGoHelper.end()) return it->second;
+        }
         try {
-            if (results.empty()) return GoEntry();
-            results = mpDatabaseHelper->query(query);
-            goEntry.go_id    = results[0][0];
-            goEntry.term     = results[0][1];
-            goEntry.category = results[0][2];
-            goEntry.level    = results[0][3];
+            {
+                SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_QUERY_GO);
+                statement.bind(1, go_id);
+                if (!statement.step()) return GoEntry();
+                goEntry.go_id    = statement.get_text(0);
+                goEntry.term     = statement.get_text(1);
+                goEntry.category = statement.get_text(2);
+                goEntry.level    = statement.get_text(3);
+            }
+            std::lock_guard<std::mutex> lock(mSqlGoMutex);
             mSqlGoHelper[go_id] = goEntry;
             return goEntry;
         } catch (std::exception &e) {
@@ -943,18 +1401,373 @@ GoEntry EntapDatabase::get_go_entry(std::string &go_id) {
     }
 }
 
-TaxEntry EntapDatabase::get_tax_entry(std::string &species) {
+/**
+ * ======================================================================
+ * Function EntapDatabase::go_serial_map_t EntapDatabase::get_go_entries(
+ *                                          const std::set<std::string> &go_ids)
+ *
+ * Description          - Returns GO entries of a set of unique GO IDs
+ *                      - SQL: IDs not yet cached are resolved with bulk
+ *                        queries and added to the cache
+ *
+ * Notes                - Thread safe. IDs not found are not in returned map
+ *
+ * @param go_ids        - Unique GO IDs (ex: GO:0000166)
+ *
+ * @return              - Map of GO ID to entry
+ *
+ * =====================================================================
+ */
+EntapDatabase::go_serial_map_t EntapDatabase::get_go_entries(const std::set<std::string> &go_ids) {
+    go_serial_map_t entries;
+    vect_str_t      missing_ids;
+    GoEntry         goEntry;
+    std::string     temp;
+
+    entries.reserve(go_ids.size());
+    if (mUseSerial || mpMappedDatabase != nullptr) {
+        for (const std::string &go_id : go_ids) {
+            temp = go_id;
+            goEntry = get_go_entry(temp);
+            if (!goEntry.is_empty()) entries.emplace(go_id, std::move(goEntry));
+        }
+        return entries;
+    }
+
+    // Using SQL database
+    {
+        std::lock_guard<std::mutex> lock(mSqlGoMutex);
+        for (const std::string &go_id : go_ids) {
+            go_serial_map_t::iterator it = mSqlGoHelper.find(go_id);
+            if (it != mSqlGoHelper.end()) {
+                entries.emplace(go_id, it->second);
+            } else if (!go_id.empty()) {
+                missing_ids.push_back(go_id);
+            }
+        }
+    }
+    if (missing_ids.empty()) return entries;
+
+    try {
+        sql_bulk_query(SQL_BULK_QUERY_GO, missing_ids, [&entries](SQLDatabaseHelper::Statement &statement) {
+            GoEntry entry;
+            entry.go_id    = statement.get_text(0);
+            entry.term     = statement.get_text(1);
+            entry.category = statement.get_text(2);
+            entry.level    = statement.get_text(3);
+            entries.emplace(entry.go_id, std::move(entry));
+        });
+    } catch (std::exception &e) {
+        // Do not fatal error
+        FS_dprint(e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(mSqlGoMutex);
+    for (const std::string &go_id : missing_ids) {
+        go_serial_map_t::iterator it = entries.find(go_id);
+        if (it != entries.end()) mSqlGoHelper.emplace(go_id, it->second);
+    }
+    return entries;
+}
+
+/**
+ * ======================================================================
+ * Function const TaxEntry *EntapDatabase::get_tax_entry(std::string &species)
+ *
+ * Description          - Returns taxonomic entry of species, broadening the
+ *                        species (dropping last word) until a match is found
+ *                      - Results (including misses) are memoized by raw
+ *                        species string
+ *
+ * Notes                - Thread safe. Species is lowercased in place
+ *
+ * @param species       - Species to find
+ *
+ * @return              - Taxonomic entry (never nullptr), empty if not found
+ *
+ * =====================================================================
+ */
+const TaxEntry *EntapDatabase::get_tax_entry(std::string &species) {
     TaxEntry taxEntry;
-    std::string temp_species;
-    uint64 index;
+    std::string raw_species;
 
-    if (species.empty()) return TaxEntry();
+    if (species.empty()) return &mEmptyTaxEntry;
 
+    {
+        std::lock_guard<std::mutex> lock(mTaxCacheMutex);
+        tax_entry_map_t::iterator it = mTaxCache.find(species);
+        if (it != mTaxCache.end()) {
+            LOWERCASE(species);
+            return &it->second;
+        }
+    }
+
+    raw_species = species;
     LOWERCASE(species); // ensure lowercase (database is based on this for direct matching)
+    taxEntry = find_tax_entry(species);
+    get_lineage_path(taxEntry.lineage, taxEntry.lineage_path);
+
+    // Another thread may have added the species, keep the first entry
+    std::lock_guard<std::mutex> lock(mTaxCacheMutex);
+    return &mTaxCache.emplace(raw_species, std::move(taxEntry)).first->second;
+}
+
+/**
+ * ======================================================================
+ * Function EntapDatabase::tax_entry_ptr_map_t EntapDatabase::get_tax_entries(
+ *                                              const std::set<std::string> &species)
+ *
+ * Description          - Resolves a set of unique species with a single pass
+ *                        over the memo cache, only looking up misses
+ *                      - Misses are looked up together (bulk SQL queries)
+ *
+ * Notes                - Thread safe. Returned map is keyed by input (raw)
+ *                        species, empty entries for species not found
+ *
+ * @param species       - Unique species to find
+ *
+ * @return              - Map of species to taxonomic entry (never nullptr)
+ *
+ * =====================================================================
+ */
+EntapDatabase::tax_entry_ptr_map_t EntapDatabase::get_tax_entries(const std::set<std::string> &species) {
+    tax_entry_ptr_map_t entries;
+    vect_str_t          missing_species;
+    vect_str_t          lower_species;
+    std::vector<TaxEntry> missing_entries;
+    std::string         temp_species;
+
+    entries.reserve(species.size());
+    {
+        std::lock_guard<std::mutex> lock(mTaxCacheMutex);
+        for (const std::string &val : species) {
+            if (val.empty()) {
+                entries.emplace(val, &mEmptyTaxEntry);
+                continue;
+            }
+            tax_entry_map_t::iterator it = mTaxCache.find(val);
+            if (it != mTaxCache.end()) {
+                entries.emplace(val, &it->second);
+            } else {
+                missing_species.push_back(val);
+            }
+        }
+    }
+    if (missing_species.empty()) return entries;
+
+    lower_species.reserve(missing_species.size());
+    for (std::string &val : missing_species) {
+        temp_species = val;
+        LOWERCASE(temp_species);
+        lower_species.push_back(temp_species);
+    }
+    find_tax_entries(lower_species, missing_entries);
+    for (TaxEntry &entry : missing_entries) {
+        get_lineage_path(entry.lineage, entry.lineage_path);
+    }
+
+    std::lock_guard<std::mutex> lock(mTaxCacheMutex);
+    for (uint64 i = 0; i < missing_species.size(); i++) {
+        entries.emplace(missing_species[i],
+                        &mTaxCache.emplace(missing_species[i], std::move(missing_entries[i])).first->second);
+    }
+    return entries;
+}
+
+/**
+ * ======================================================================
+ * Function void EntapDatabase::get_lineage_path(const std::string &lineage, tax_path_t &path)
+ *
+ * Description          - Converts lineage text (taxon;parent;...;root) into
+ *                        a root first path of interned ancestor lineages
+ *                      - Each ancestor is identified by its own full lineage,
+ *                        so equal handles at a depth mean the same clade
+ *
+ * Notes                - Ancestor test: path.size() > depth(Y) && path[depth(Y)] == Y
+ *                      - Shared ancestry with another taxon is the length
+ *                        of the common path prefix
+ *
+ * @param lineage       - Lineage text
+ * @param path          - Output path (cleared), empty for empty lineage
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void EntapDatabase::get_lineage_path(const std::string &lineage, tax_path_t &path) {
+    std::vector<uint64> starts;     // Start of each ancestor lineage, taxon first
+
+    path.clear();
+    if (lineage.empty()) return;
+
+    starts.push_back(0);
+    for (uint64 i = 0; i < lineage.size(); i++) {
+        if (lineage[i] == ';') starts.push_back(i + 1);
+    }
+    path.reserve(starts.size());
+    for (auto it = starts.rbegin(); it != starts.rend(); ++it) {
+        path.push_back(StringInterner::intern(lineage.substr(*it)));
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void EntapDatabase::find_tax_entries(const vect_str_t &species,
+ *                                               std::vector<TaxEntry> &entries)
+ *
+ * Description          - Database lookup of many species, broadening each
+ *                        species until a match is found (same as find_tax_entry)
+ *                      - SQL: every broadened form of every species is
+ *                        resolved with bulk queries rather than one query
+ *                        per species per broadening
+ *
+ * Notes                - Species must be lowercase, not memoized
+ *                      - The taxonomy trie is only built for the serialized
+ *                        database, mapped and SQL databases broaden the
+ *                        species one word at a time
+ *
+ * @param species       - Lowercase species to find
+ * @param entries       - Output entries (cleared), same order as species
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void EntapDatabase::find_tax_entries(const vect_str_t &species, std::vector<TaxEntry> &entries) {
+    std::unordered_map<std::string, TaxEntry> found;    // Broadened species found in database
+    std::set<std::string> candidates;
+    vect_str_t  candidate_keys;
+    std::string temp_species;
+    uint64      index;
+
+    entries.clear();
+    entries.reserve(species.size());
+    if (mUseSerial || mpMappedDatabase != nullptr || mpDatabaseHelper == nullptr) {
+        for (const std::string &val : species) {
+            temp_species = val;
+            entries.push_back(find_tax_entry(temp_species));
+        }
+        return;
+    }
+
+    // Using SQL database, gather every broadened form of each species
+    for (const std::string &val : species) {
+        temp_species = val;
+        while (!temp_species.empty()) {
+            candidates.insert(temp_species);
+            index = temp_species.find_last_of(' ');
+            if (index == std::string::npos) break;
+            temp_species = temp_species.substr(0, index);
+        }
+    }
+    candidate_keys.assign(candidates.begin(), candidates.end());
+    try {
+        sql_bulk_query(SQL_BULK_QUERY_TAX, candidate_keys, [&found](SQLDatabaseHelper::Statement &statement) {
+            TaxEntry taxEntry;
+            taxEntry.tax_name = statement.get_text(0);
+            taxEntry.tax_id   = statement.get_text(1);
+            taxEntry.lineage  = statement.get_text(2);
+            found.emplace(taxEntry.tax_name, std::move(taxEntry));  // first row kept, as in single lookups
+        });
+    } catch (std::exception &e) {
+        // Do not fatal error
+        FS_dprint(e.what());
+    }
+
+    // Most specific match of each species
+    for (const std::string &val : species) {
+        temp_species = val;
+        entries.push_back(TaxEntry());
+        while (!temp_species.empty()) {
+            auto it = found.find(temp_species);
+            if (it != found.end()) {
+                entries.back() = it->second;
+                break;
+            }
+            index = temp_species.find_last_of(' ');
+            if (index == std::string::npos) break;
+            temp_species = temp_species.substr(0, index);
+        }
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void EntapDatabase::sql_bulk_query(const std::string &sql_prefix, const vect_str_t &keys,
+ *                          const std::function<void(SQLDatabaseHelper::Statement&)> &on_row)
+ *
+ * Description          - Looks up many keys against the SQL database, binding
+ *                        SQL_BULK_KEYS keys per query as "key IN (?,...)"
+ *                      - The same prepared statement is reused for every
+ *                        chunk, unused parameters of the last chunk are left
+ *                        NULL (never match)
+ *
+ * Notes                - Database is read only, so keys are bound rather than
+ *                        loaded into a temporary table
+ *                      - on_row must not query the database itself
+ *
+ * @param sql_prefix    - SELECT ending in the key column
+ * @param keys          - Keys to look up
+ * @param on_row        - Called for every row found
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void EntapDatabase::sql_bulk_query(const std::string &sql_prefix, const vect_str_t &keys,
+                                   const std::function<void(SQLDatabaseHelper::Statement&)> &on_row) {
+    std::string sql;
+    uint64      end;
+
+    if (keys.empty() || mpDatabaseHelper == nullptr) return;
+
+    sql = sql_prefix + " IN (?";
+    for (uint16 i = 1; i < SQL_BULK_KEYS; i++) sql += ",?";
+    sql += ")";
+
+    for (uint64 start = 0; start < keys.size(); start += SQL_BULK_KEYS) {
+        SQLDatabaseHelper::Statement statement(mpDatabaseHelper, sql);
+        end = std::min(start + SQL_BULK_KEYS, (uint64)keys.size());
+        for (uint64 i = start; i < end; i++) {
+            statement.bind((int)(i - start + 1), keys[i]);
+        }
+        while (statement.step()) {
+            on_row(statement);
+        }
+    }
+}
+
+/**
+ * ======================================================================
+ * Function TaxEntry EntapDatabase::find_tax_entry(std::string &species)
+ *
+ * Description          - Database lookup of species (serialized or SQL),
+ *                        broadening the species until a match is found
+ *
+ * Notes                - Species must be lowercase, not memoized
+ *
+ * @param species       - Lowercase species to find
+ *
+ * @return              - Taxonomic entry, empty if not found
+ *
+ * =====================================================================
+ */
+TaxEntry EntapDatabase::find_tax_entry(std::string &species) {
+    TaxEntry taxEntry;
+    std::string temp_species;
+    uint64 index;
 
     if (mUseSerial) {
         // Using serialized database
-        tax_serial_map_t::iterator it = mpSerializedDatabase->taxonomic_data.find(species);
+        tax_serial_map_t::iterator it;
+        if (!mpSerializedDatabase->tax_trie.empty()) {
+            // Single trie walk finds the most specific (longest) match, one map lookup for the entry
+            index = mpSerializedDatabase->tax_trie.longest_prefix(species);
+            if (index == TaxonomyTrie::PREFIX_NOT_FOUND) return TaxEntry();
+            it = mpSerializedDatabase->taxonomic_data.find(species.substr(0, index));
+            return it != mpSerializedDatabase->taxonomic_data.end() ? it->second : TaxEntry();
+        }
+        it = mpSerializedDatabase->taxonomic_data.find(species);
         if (it == mpSerializedDatabase->taxonomic_data.end()) {
             // If we can't find species, keep trying by making it more broad
             temp_species = species;
@@ -970,32 +1783,35 @@ TaxEntry EntapDatabase::get_tax_entry(std::string &species) {
             return TaxEntry();
         } else return it->second;
 
+    } else if (mpMappedDatabase != nullptr) {
+        // Using mapped database, broaden species until found
+        temp_species = species;
+        while (!mpMappedDatabase->find_tax_entry(temp_species, taxEntry)) {
+            index = temp_species.find_last_of(' ');
+            if (index == std::string::npos) return TaxEntry();
+            temp_species = temp_species.substr(0, index);
+        }
+        return taxEntry;
+
     } else {
         // Using SQL database
-        std::vector<std::vector<std::string>> results;
         temp_species = species;
         try {
             // If we can't find species, keep trying by making it more broad
             while (true) {
-                // Generate SQL query
-                char *query = sqlite3_mprintf(
-                        "SELECT %q, %q FROM %q WHERE %q=%Q",
-                        SQL_COL_NCBI_TAX_TAXID.c_str(),
-                        SQL_COL_NCBI_TAX_LINEAGE.c_str(),
-                        SQL_TABLE_NCBI_TAX_TITLE.c_str(),
-                        SQL_COL_NCBI_TAX_NAME.c_str(),
-                        temp_species.c_str()
-                );
-                results = mpDatabaseHelper->query(query);
-                if (results.empty()) {
-                    index = temp_species.find_last_of(' ');
-                    if (index == std::string::npos) return TaxEntry(); // couldn't find
-                    temp_species = temp_species.substr(0, index);
-                } else break; // Found species
+                SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_QUERY_TAX);
+                statement.bind(1, temp_species);
+                if (statement.step()) {
+                    // Found species
+                    taxEntry.tax_id  = statement.get_text(0);
+                    taxEntry.lineage = statement.get_text(1);
+                    break;
+                }
+                index = temp_species.find_last_of(' ');
+                if (index == std::string::npos) return TaxEntry(); // couldn't find
+                temp_species = temp_species.substr(0, index);
             }
 
-            taxEntry.tax_id  = results[0][0];
-            taxEntry.lineage = results[0][1];
             taxEntry.tax_name= temp_species;
             return taxEntry;
 
@@ -1007,10 +1823,28 @@ TaxEntry EntapDatabase::get_tax_entry(std::string &species) {
     }
 }
 
-UniprotEntry EntapDatabase::get_uniprot_entry(std::string& accession) {
+/**
+ * ======================================================================
+ * Function const UniprotEntry *EntapDatabase::get_uniprot_entry(std::string& accession)
+ *
+ * Description          - Returns UniProt entry of accession without copying it
+ *
+ * Notes                - Serialized entries point into the database, SQL
+ *                        and mapped entries are memoized (including misses)
+ *                        so hits can hold the pointer
+ *                      - Thread safe
+ *
+ * @param accession     - UniProt accession (ex: Q9FJZ9)
+ *
+ * @return              - UniProt entry, nullptr if not found
+ *
+ * =====================================================================
+ */
+const UniprotEntry *EntapDatabase::get_uniprot_entry(std::string& accession) {
     UniprotEntry uniprotEntry;
+    const UniprotEntry *ret;
 
-    if (accession.empty()) return UniprotEntry();
+    if (accession.empty()) return nullptr;
 
     try {
         if (mUseSerial) {
@@ -1019,34 +1853,162 @@ UniprotEntry EntapDatabase::get_uniprot_entry(std::string& accession) {
                     mpSerializedDatabase->uniprot_data.find(accession);
             if (it == mpSerializedDatabase->uniprot_data.end()) {
                 // FS_dprint("Unable to find Uniprot Entry: " + accession);
-                return UniprotEntry();
-            } else return it->second;
+                return nullptr;
+            } else return &it->second;
         } else {
+            {
+                std::lock_guard<std::mutex> lock(mUniprotCacheMutex);
+                uniprot_serial_map_t::iterator it = mUniprotCache.find(accession);
+                if (it != mUniprotCache.end()) {
+                    return it->second.is_empty() ? nullptr : &it->second;
+                }
+            }
+            if (mpMappedDatabase != nullptr) {
+                // Using mapped database, entries are decoded once
+                mpMappedDatabase->find_uniprot_entry(accession, uniprotEntry);
+                std::lock_guard<std::mutex> lock(mUniprotCacheMutex);
+                ret = &mUniprotCache.emplace(accession, std::move(uniprotEntry)).first->second;
+                return ret->is_empty() ? nullptr : ret;
+            }
             // Using SQL database
-            std::vector<std::vector<std::string>> results;
-            char *query = sqlite3_mprintf(
-                    "SELECT %q, %q, %q FROM %q WHERE %q=%Q",
-                    SQL_TABLE_UNIPROT_COL_ID.c_str(),
-                    SQL_TABLE_UNIPROT_COL_XREF.c_str(),
-                    SQL_TABLE_UNIPROT_COL_COMM.c_str(),
-                    SQL_TABLE_UNIPROT_TITLE.c_str(),
-                    SQL_TABLE_UNIPROT_COL_ID.c_str(),
-                    accession.c_str()
-            );
-            if (results.empty()) return UniprotEntry();
-            results = mpDatabaseHelper->query(query);
-            uniprotEntry.uniprot_id      = results[0][0];
-            uniprotEntry.database_x_refs = results[0][1];
-            uniprotEntry.comments        = results[0][2];
-            return uniprotEntry;
+            {
+                SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_QUERY_UNIPROT);
+                statement.bind(1, accession);
+                if (statement.step()) {
+                    uniprotEntry.uniprot_id      = statement.get_text(0);
+                    uniprotEntry.database_x_refs = statement.get_text(1);
+                    uniprotEntry.comments        = statement.get_text(2);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mUniprotCacheMutex);
+            ret = &mUniprotCache.emplace(accession, std::move(uniprotEntry)).first->second;
+            return ret->is_empty() ? nullptr : ret;
         }
     } catch (const std::exception &e) {
         FS_dprint("ERROR: Unhandled finding Uniprot Entry: "+ std::string(e.what()));
-        return UniprotEntry();
+        return nullptr;
+    }
+}
+
+/**
+ * ======================================================================
+ * Function bool EntapDatabase::set_shared_database(std::string &database_path)
+ *
+ * Description          - Attaches to the node wide shared memory copy of the
+ *                        serialized EnTAP database, so concurrent runs on one
+ *                        node only deserialize and hold it in memory once
+ *                      - The first run to need it deserializes and publishes it
+ *
+ * Notes                - On failure, falls back to the private serialized copy
+ *
+ * @param database_path - Path to serialized EnTAP database
+ *
+ * @return              - TRUE if database is ready to use
+ *
+ * =====================================================================
+ */
+bool EntapDatabase::set_shared_database(std::string &database_path) {
+    bool         loaded = false;
+    DATABASE_ERR load_err = ERR_DATA_OK;
+
+    if (mpMappedDatabase != nullptr) return true;   // already attached
+
+    mpMappedDatabase = new MappedDatabase();
+    if (mpMappedDatabase->open_shared(database_path, [this, &database_path, &loaded, &load_err]() -> const EntapDatabaseStruct* {
+        loaded   = true;
+        load_err = serialize_database_read(SERIALIZE_DEFAULT, database_path);
+        return load_err == ERR_DATA_OK ? mpSerializedDatabase : nullptr;
+    })) {
+        // Shared copy is used from now on, drop private copy if we published it
+        SAFE_DELETE(mpSerializedDatabase);
+        mUseSerial = false;
+        return true;
+    }
+
+    FS_dprint("WARNING: unable to use shared EnTAP database, reading privately: " + mpMappedDatabase->get_error());
+    SAFE_DELETE(mpMappedDatabase);
+    mUseSerial = true;
+    if (loaded) return load_err == ERR_DATA_OK;
+    return serialize_database_read(SERIALIZE_DEFAULT, database_path) == ERR_DATA_OK;
+}
+
+/**
+ * ======================================================================
+ * Function EntapDatabase::uniprot_entry_ptr_map_t EntapDatabase::get_uniprot_entries(
+ *                                                  const std::set<std::string> &accessions)
+ *
+ * Description          - Returns UniProt entries of a set of unique accessions
+ *                        without copying them (see get_uniprot_entry)
+ *                      - SQL: accessions not yet cached are resolved with bulk
+ *                        queries and memoized (including misses)
+ *
+ * Notes                - Thread safe
+ *
+ * @param accessions    - Unique UniProt accessions (ex: Q9FJZ9)
+ *
+ * @return              - Map of accession to entry, nullptr if not found
+ *
+ * =====================================================================
+ */
+EntapDatabase::uniprot_entry_ptr_map_t EntapDatabase::get_uniprot_entries(const std::set<std::string> &accessions) {
+    uniprot_entry_ptr_map_t entries;
+    uniprot_serial_map_t    found;
+    vect_str_t              missing_accessions;
+    std::string             temp;
+    const UniprotEntry     *entry;
+
+    entries.reserve(accessions.size());
+    if (mUseSerial || mpMappedDatabase != nullptr || mpDatabaseHelper == nullptr) {
+        for (const std::string &accession : accessions) {
+            temp = accession;
+            entries.emplace(accession, get_uniprot_entry(temp));
+        }
+        return entries;
+    }
+
+    // Using SQL database
+    {
+        std::lock_guard<std::mutex> lock(mUniprotCacheMutex);
+        for (const std::string &accession : accessions) {
+            uniprot_serial_map_t::iterator it = mUniprotCache.find(accession);
+            if (it != mUniprotCache.end()) {
+                entries.emplace(accession, it->second.is_empty() ? nullptr : &it->second);
+            } else if (accession.empty()) {
+                entries.emplace(accession, nullptr);
+            } else {
+                missing_accessions.push_back(accession);
+            }
+        }
+    }
+    if (missing_accessions.empty()) return entries;
+
+    try {
+        sql_bulk_query(SQL_BULK_QUERY_UNIPROT, missing_accessions, [&found](SQLDatabaseHelper::Statement &statement) {
+            UniprotEntry uniprotEntry;
+            uniprotEntry.uniprot_id      = statement.get_text(0);
+            uniprotEntry.database_x_refs = statement.get_text(1);
+            uniprotEntry.comments        = statement.get_text(2);
+            found.emplace(uniprotEntry.uniprot_id, std::move(uniprotEntry));
+        });
+    } catch (const std::exception &e) {
+        FS_dprint("ERROR: Unhandled finding Uniprot Entries: "+ std::string(e.what()));
+    }
+
+    std::lock_guard<std::mutex> lock(mUniprotCacheMutex);
+    for (const std::string &accession : missing_accessions) {
+        uniprot_serial_map_t::iterator it = found.find(accession);
+        entry = &mUniprotCache.emplace(accession, it != found.end() ? std::move(it->second) : UniprotEntry())
+                .first->second;
+        entries.emplace(accession, entry->is_empty() ? nullptr : entry);
     }
+    return entries;
 }
 
 EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_save(SERIALIZATION_TYPE type, std::string &out_path) {
+    std::stringstream ss;
+    std::string       err_msg;
+
     FS_dprint("Serializing EnTAP database to:" + out_path);
 
     if (mpSerializedDatabase == nullptr) {
@@ -1057,30 +2019,34 @@ EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_save(SERIALIZATION
 
     try {
         FS_dprint("Serializing type: " + std::to_string(type));
-        std::ofstream file(out_path);
         switch (type) {
 
 #ifdef USE_BOOST
             case BOOST_TEXT_ARCHIVE: {
-                boostAR::text_oarchive oa(file);
+                boostAR::text_oarchive oa(ss);
                 oa << *mpSerializedDatabase;
+                oa << mpSerializedDatabase->go_graph;
+                oa << mpSerializedDatabase->tax_trie;
+                oa << mpSerializedDatabase->manifest;
                 break;
             }
 
             case BOOST_BIN_ARCHIVE: {
-                boostAR::binary_oarchive oa_bin(file);
+                boostAR::binary_oarchive oa_bin(ss);
                 oa_bin << *mpSerializedDatabase;
+                oa_bin << mpSerializedDatabase->go_graph;
+                oa_bin << mpSerializedDatabase->tax_trie;
+                oa_bin << mpSerializedDatabase->manifest;
                 break;
             }
 #else // Use CEREAL for serilization
 
             case CEREAL_BIN_ARCHIVE: {
-                std::stringstream ss;
                 cereal::BinaryOutputArchive oarchive(ss); // Create an output archive
                 oarchive(*mpSerializedDatabase); // Write the data to the archive
-
-                // Write string stream to file
-                file << ss.str();
+                oarchive(mpSerializedDatabase->go_graph);   // Trailing so older EnTAP versions can still read it
+                oarchive(mpSerializedDatabase->tax_trie);
+                oarchive(mpSerializedDatabase->manifest);
                 break;
             }   // archive out of scope, flush
 #endif
@@ -1088,16 +2054,59 @@ EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_save(SERIALIZATION
             default:
                 return ERR_DATA_SERIALIZE_SAVE;
         }
-        file.close();
     } catch (std::exception &e) {
         set_err_msg("Unable to serialize EnTAP database\n" + std::string(e.what()),
                     ERR_DATA_SERIALIZE_SAVE);
         return ERR_DATA_SERIALIZE_SAVE;
     }
+
+    if (is_plain_serial()) {
+        // Plain archive, readable by older EnTAP versions
+        std::ofstream out_file(out_path, std::ios::binary | std::ios::trunc);
+        out_file << ss.rdbuf();
+        if (!out_file) {
+            set_err_msg("Unable to write serialized EnTAP database to: " + out_path, ERR_DATA_SERIALIZE_SAVE);
+            return ERR_DATA_SERIALIZE_SAVE;
+        }
+        return ERR_DATA_OK;
+    }
+
+    // Archive is written as independently compressed blocks
+    FS_dprint("Compressing serialized EnTAP database...");
+    if (!BlockCompressor::write(out_path, ss.str(), get_thread_count(), err_msg)) {
+        set_err_msg(err_msg, ERR_DATA_SERIALIZE_SAVE);
+        return ERR_DATA_SERIALIZE_SAVE;
+    }
     return ERR_DATA_OK;
 }
 
+/**
+ * ======================================================================
+ * Function EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_read(
+ *                                           SERIALIZATION_TYPE type, std::string &in_path)
+ *
+ * Description          - Deserializes EnTAP database from file
+ *                      - Block compressed databases are decompressed in
+ *                        parallel to memory and deserialized from there
+ *
+ * Notes                - Plain archives (older EnTAP versions, or before
+ *                        download conversion) are read directly
+ *
+ * @param type          - Serialization type
+ * @param in_path       - Path to serialized database
+ *
+ * @return              - DATABASE_ERR type
+ *
+ * =====================================================================
+ */
 EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_read(SERIALIZATION_TYPE type, std::string &in_path) {
+    std::string     decompressed;
+    std::string     err_msg;
+    std::ifstream   in_file;
+    std::unique_ptr<BlockCompressor::MemoryBuffer> in_buffer;
+    std::unique_ptr<std::istream>                  in_memory;
+    std::istream   *in_stream;
+
     FS_dprint("Reading serialized database from: " + in_path + "\n Of type: " + std::to_string(type));
 
     if (!mpFileSystem->file_exists(in_path)) {
@@ -1107,6 +2116,19 @@ EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_read(SERIALIZATION
 
     // Already generated? If no, generate
     if (mpSerializedDatabase != nullptr) return ERR_DATA_OK;
+
+    if (BlockCompressor::is_compressed(in_path)) {
+        if (!BlockCompressor::read(in_path, decompressed, get_thread_count(), err_msg)) {
+            set_err_msg(err_msg, ERR_DATA_SERIALIZE_READ);
+            return ERR_DATA_SERIALIZE_READ;
+        }
+        in_buffer.reset(new BlockCompressor::MemoryBuffer(decompressed.data(), decompressed.size()));
+        in_memory.reset(new std::istream(in_buffer.get()));
+        in_stream = in_memory.get();
+    } else {
+        in_file.open(in_path, std::ios::binary);
+        in_stream = &in_file;
+    }
     mpSerializedDatabase = new EntapDatabaseStruct();
 
     try {
@@ -1114,29 +2136,66 @@ EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_read(SERIALIZATION
 #ifdef USE_BOOST
             case BOOST_TEXT_ARCHIVE:
             {
-                std::ifstream ifs(in_path);
-                boost::archive::text_iarchive ia(ifs);
+                boost::archive::text_iarchive ia(*in_stream);
                 ia >> *mpSerializedDatabase;
-                ifs.close();
+                try {
+                    ia >> mpSerializedDatabase->go_graph;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->go_graph = GoGraph();     // Database generated without GO graph
+                }
+                try {
+                    ia >> mpSerializedDatabase->tax_trie;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->tax_trie = TaxonomyTrie();    // Database generated without taxonomy trie
+                }
+                try {
+                    ia >> mpSerializedDatabase->manifest;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->manifest = DatabaseManifest();    // Database without delta manifest
+                }
                 break;
             }
 
             case BOOST_BIN_ARCHIVE:
             {
-                std::ifstream ifs(in_path);
-                boost::archive::binary_iarchive ia(ifs);
+                boost::archive::binary_iarchive ia(*in_stream);
                 ia >> *mpSerializedDatabase;
-                ifs.close();
+                try {
+                    ia >> mpSerializedDatabase->go_graph;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->go_graph = GoGraph();     // Database generated without GO graph
+                }
+                try {
+                    ia >> mpSerializedDatabase->tax_trie;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->tax_trie = TaxonomyTrie();    // Database generated without taxonomy trie
+                }
+                try {
+                    ia >> mpSerializedDatabase->manifest;
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->manifest = DatabaseManifest();    // Database without delta manifest
+                }
                 break;
             }
 #else
             case CEREAL_BIN_ARCHIVE: {
-                std::stringstream ss;
-                std::ifstream in_file(in_path);
-                ss << in_file.rdbuf();
-                in_file.close();
-                cereal::BinaryInputArchive iarchive(ss); // Create an input archive
+                cereal::BinaryInputArchive iarchive(*in_stream); // Create an input archive
                 iarchive(*mpSerializedDatabase); // Read the data from the archive
+                try {
+                    iarchive(mpSerializedDatabase->go_graph);
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->go_graph = GoGraph();     // Database generated without GO graph
+                }
+                try {
+                    iarchive(mpSerializedDatabase->tax_trie);
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->tax_trie = TaxonomyTrie();    // Database generated without taxonomy trie
+                }
+                try {
+                    iarchive(mpSerializedDatabase->manifest);
+                } catch (const std::exception &e) {
+                    mpSerializedDatabase->manifest = DatabaseManifest();    // Database without delta manifest
+                }
                 break;
             }
 #endif
@@ -1149,6 +2208,7 @@ EntapDatabase::DATABASE_ERR EntapDatabase::serialize_database_read(SERIALIZATION
         set_err_msg("Unable to read Serialized EnTAP database: " + std::string(e.what()), ERR_DATA_SERIALIZE_READ);
         return ERR_DATA_SERIALIZE_READ;
     }
+    mpSerializedDatabase->go_graph.index();
     if (!is_valid_version()) {
         set_err_msg("EnTAP database version is not compatible with this version of EnTAP.\n" \
                     "Current Version: " + get_current_version_str() + "\nRequired version: " +
@@ -1181,20 +2241,183 @@ EntapDatabase::TaxonomyNode::TaxonomyNode(std::string id) {
 go_format_t EntapDatabase::format_go_delim(std::string terms, char delim) {
     go_format_t output;
     std::string temp;
-    std::vector<std::vector<std::string>>results;
+    vect_str_t  term_list;
+    go_serial_map_t entries;
 
     if (terms.empty()) return output;
     std::istringstream ss(terms);
     while (std::getline(ss,temp,delim)) {
-        GoEntry term_info = get_go_entry(temp);
-        if (!term_info.is_empty()) {
-            output[term_info.category].push_back(temp + "-" + term_info.term +
-                                                 "(L=" + term_info.level + ")");
+        term_list.push_back(temp);
+    }
+    // Resolve all terms together, output keeps list order
+    entries = get_go_entries(std::set<std::string>(term_list.begin(), term_list.end()));
+    for (const std::string &term : term_list) {
+        go_serial_map_t::iterator it = entries.find(term);
+        if (it != entries.end() && !it->second.is_empty()) {
+            output[it->second.category].push_back(term + "-" + it->second.term +
+                                                  "(L=" + it->second.level + ")");
         }
     }
     return output;
 }
 
+/**
+ * ======================================================================
+ * Function GoTermTable::GoTermSet EntapDatabase::intern_go_terms(const std::string &terms,
+ *                                                               char delim, bool keep_missing)
+ *
+ * Description          - Resolves a delimited list of GO IDs against the
+ *                        database and interns them in the GoTermTable
+ *                      - Result holds term IDs by category in list order,
+ *                        labels are only rendered for output
+ *
+ * Notes                - With --go-propagate, ancestors of the terms are
+ *                        added after them (propagate_go_terms)
+ *                      - Terms already interned are not looked up again,
+ *                        missing terms are interned too so they are only
+ *                        looked up once
+ *
+ * @param terms         - Delimited GO IDs (GO:4321431,GO:807890)
+ * @param delim         - Delimiter
+ * @param keep_missing  - TRUE to keep terms not found in the database as
+ *                        GO_CATEGORY_UNKNOWN
+ *
+ * @return              - Interned GO terms
+ *
+ * =====================================================================
+ */
+GoTermTable::GoTermSet EntapDatabase::intern_go_terms(const std::string &terms, char delim, bool keep_missing) {
+    GoTermTable::GoTermSet    output;
+    GoTermTable::term_id_t    term_id;
+    GoTermTable::GO_CATEGORY  category;
+    std::string               temp;
+    vect_str_t                term_list;
+    std::set<std::string>     lookup;
+    go_serial_map_t           entries;
+    go_serial_map_t::iterator it;
+
+    if (terms.empty()) return output;
+    std::istringstream ss(terms);
+    while (std::getline(ss,temp,delim)) {
+        term_list.push_back(temp);
+    }
+    if (mGoPropagate) propagate_go_terms(term_list);
+    for (const std::string &term : term_list) {
+        if (GoTermTable::find(term) == GoTermTable::TERM_NOT_FOUND) lookup.insert(term);
+    }
+
+    if (!lookup.empty()) {
+        entries = get_go_entries(lookup);
+        for (const std::string &term : lookup) {
+            it = entries.find(term);
+            if (it != entries.end() && !it->second.is_empty()) {
+                GoTermTable::intern(term, it->second.term, it->second.category, it->second.level);
+            } else {
+                GoTermTable::intern(term, "", "", "");
+            }
+        }
+    }
+
+    for (const std::string &term : term_list) {
+        term_id  = GoTermTable::find(term);
+        category = GoTermTable::get_category(term_id);
+        if (category == GoTermTable::GO_CATEGORY_UNKNOWN && !keep_missing) continue;
+        output.terms[category].push_back(term_id);
+    }
+    return output;
+}
+
+/**
+ * ======================================================================
+ * Function const GoGraph *EntapDatabase::get_go_graph()
+ *
+ * Description          - Returns Gene Ontology graph of the database in use
+ *                      - Serialized databases hold the graph with its
+ *                        ancestor closure, SQL and memory mapped databases
+ *                        store direct parents and the graph is built from
+ *                        them on first use
+ *
+ * Notes                - Thread safe
+ *
+ * @return              - Graph, nullptr if the database does not have one
+ *
+ * =====================================================================
+ */
+const GoGraph *EntapDatabase::get_go_graph() {
+    std::lock_guard<std::mutex> lock(mGoGraphMutex);
+    GoGraph::parent_map_t parents;
+
+    if (mpGoGraph != nullptr) return mpGoGraph->empty() ? nullptr : mpGoGraph;
+
+    if (mUseSerial && mpSerializedDatabase != nullptr) {
+        mpGoGraph = &mpSerializedDatabase->go_graph;
+    } else {
+        if (mpMappedDatabase != nullptr) {
+            mpMappedDatabase->get_go_parents(parents);
+        } else if (mpDatabaseHelper != nullptr) {
+            try {
+                SQLDatabaseHelper::Statement statement(mpDatabaseHelper, SQL_QUERY_GO_GRAPH);
+                while (statement.step()) {
+                    parents[statement.get_text(0)] = split_string(statement.get_text(1), GO_GRAPH_DELIM);
+                }
+            } catch (const std::exception &e) {
+                // Database generated before the graph was added
+                FS_dprint("Unable to read Gene Ontology graph from SQL database: " + std::string(e.what()));
+                parents.clear();
+            }
+        }
+        if (!parents.empty() && !mGoGraph.build(parents)) mGoGraph = GoGraph();
+        mpGoGraph = &mGoGraph;
+    }
+
+    if (mpGoGraph->empty()) {
+        FS_dprint("WARNING: EnTAP database does not contain the Gene Ontology graph, "
+                  "reconfigure to propagate Gene Ontology terms");
+        return nullptr;
+    }
+    return mpGoGraph;
+}
+
+/**
+ * ======================================================================
+ * Function void EntapDatabase::propagate_go_terms(vect_str_t &term_list)
+ *
+ * Description          - Adds all ancestors (is_a/part_of) of the GO terms
+ *                        in a list through the precomputed closure
+ *
+ * Notes                - Ancestors are appended in topological order after
+ *                        the original terms, terms are not repeated
+ *
+ * @param term_list     - GO IDs, ancestors appended
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void EntapDatabase::propagate_go_terms(vect_str_t &term_list) {
+    const GoGraph                *go_graph = get_go_graph();
+    std::vector<GoGraph::node_t>  nodes;
+    std::vector<GoGraph::node_t>  expanded;
+    GoGraph::node_t               node;
+
+    if (go_graph == nullptr) return;
+
+    for (const std::string &term : term_list) {
+        node = go_graph->find_node(term);
+        if (node != GoGraph::NODE_NOT_FOUND) nodes.push_back(node);
+    }
+    if (nodes.empty()) return;
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    go_graph->expand_ancestors(nodes, expanded);
+    for (GoGraph::node_t ancestor : expanded) {
+        if (!std::binary_search(nodes.begin(), nodes.end(), ancestor)) {
+            term_list.push_back(go_graph->get_go_id(ancestor));
+        }
+    }
+}
+
 bool EntapDatabase::is_valid_version() {
     return (get_current_version_str() == get_required_version_str());
 }
@@ -1211,6 +2434,11 @@ std::string EntapDatabase::get_current_version_str() {
             version_str = "";
         }
 
+    } else if (mpMappedDatabase != nullptr) {
+        // Using mapped database, version of the serialized contents
+        version_str = std::to_string(mpMappedDatabase->get_major_version()) + "." +
+                      std::to_string(mpMappedDatabase->get_minor_version());
+
     } else {
         // Using SQL database
         char* query;
@@ -1231,6 +2459,7 @@ std::string EntapDatabase::get_current_version_str() {
                 set_err_msg("ERROR: couldn't get SQL version of EnTAP Database", ERR_DATA_GET_VERSION);
                 version_str = "";
             }
+            sqlite3_free(query);
 
         } else {
             version_str = "";
@@ -1240,7 +2469,7 @@ std::string EntapDatabase::get_current_version_str() {
 }
 
 std::string EntapDatabase::get_required_version_str() {
-    if (mUseSerial) {
+    if (mUseSerial || mpMappedDatabase != nullptr) {
         return std::to_string(SERIALIZE_MAJOR) + "." + std::to_string(SERIALIZE_MINOR);
     } else {
         return std::to_string(SQL_MAJOR) + "." + std::to_string(SQL_MINOR);
@@ -1281,6 +2510,7 @@ bool EntapDatabase::set_database_versions(EntapDatabase::DATABASE_TYPE type) {
 
                     FS_dprint("Executing SQL cmd: " + std::string(query));
                     ret = mpDatabaseHelper->execute_cmd(query);
+                    sqlite3_free(query);
 
                 } else {
                     // NO, return
@@ -1298,12 +2528,12 @@ bool EntapDatabase::set_database_versions(EntapDatabase::DATABASE_TYPE type) {
     return ret;
 }
 
-bool EntapDatabase::is_uniprot_entry(std::string &sseqid, UniprotEntry &entry) {
+bool EntapDatabase::is_uniprot_entry(std::string &sseqid, const UniprotEntry *&entry) {
     std::string accession;
 
     accession = get_uniprot_accession(sseqid);
     entry = get_uniprot_entry(accession);
-    return !entry.is_empty();
+    return entry != nullptr;
 }
 
 std::string EntapDatabase::get_uniprot_accession(std::string &sseqid) {
@@ -1311,4 +2541,297 @@ std::string EntapDatabase::get_uniprot_accession(std::string &sseqid) {
 
     accession = sseqid.substr(sseqid.rfind('|',sseqid.length())+1);     // Q9FJZ9
     return accession;
-}
\ No newline at end of file
+}
+
+/**
+ * ======================================================================
+ * Function EntapDatabase::DATABASE_ERR EntapDatabase::apply_delta(DATABASE_TYPE type,
+ *                                           std::string &database_path,
+ *                                           std::string &delta_path)
+ *
+ * Description          - Adds, changes, or removes database records by
+ *                        accession from a delta file and saves the database
+ *                      - Each applied delta increments the manifest revision,
+ *                        changed records are tagged with it so runs can
+ *                        tell which annotations are affected
+ *
+ * Notes                - Serialized database only
+ *                      - A delta already in the manifest (by filename) is
+ *                        skipped so refreshes can be re-run safely
+ *                      - Delta lines (tab delimited), '#' comments:
+ *                          RELEASE   source   release
+ *                          ADD|CHANGE TAXONOMY name tax_id lineage
+ *                          ADD|CHANGE GO go_id term category level parents
+ *                          ADD|CHANGE UNIPROT uniprot_id xrefs comments kegg go_ids
+ *                          REMOVE    TAXONOMY|GO|UNIPROT key
+ *                      - GO parents (comma separated is_a/part_of parent IDs)
+ *                        update the Gene Ontology graph, which is rebuilt
+ *                        once the delta is read. ADD requires them when the
+ *                        database has a graph, CHANGE without them keeps
+ *                        the current parents
+ *
+ * @param type          - Database type
+ * @param database_path - Path to database, replaced once delta is applied
+ * @param delta_path    - Path to delta file
+ *
+ * @return              - DATABASE_ERR type
+ *
+ * =====================================================================
+ */
+EntapDatabase::DATABASE_ERR EntapDatabase::apply_delta(DATABASE_TYPE type, std::string &database_path,
+                                                       std::string &delta_path) {
+    std::string  delta_name;
+    std::string  line;
+    std::string  temp_path;
+    vect_str_t   fields;
+    uint64       line_number=0;
+    uint64       changed=0;
+    uint64       missing=0;
+    uint32       revision;
+    bool         tax_changed=false;
+    bool         go_graph_changed=false;
+    bool         has_go_graph;
+    GoGraph::parent_map_t go_parents;     // Direct parents of current graph, updated by GO records
+    DATABASE_ERR err_code;
+
+    if (type != ENTAP_SERIALIZED) {
+        set_err_msg("Delta updates are only supported for the serialized EnTAP database", ERR_DATA_DELTA);
+        return ERR_DATA_DELTA;
+    }
+    mUseSerial = true;
+    err_code = serialize_database_read(SERIALIZE_DEFAULT, database_path);
+    if (err_code != ERR_DATA_OK) return err_code;
+
+    DatabaseManifest &manifest = mpSerializedDatabase->manifest;
+    delta_name = mpFileSystem->get_filename(delta_path, true);
+    if (std::find(manifest.deltas.begin(), manifest.deltas.end(), delta_name) != manifest.deltas.end()) {
+        FS_dprint("Delta " + delta_name + " already applied, skipping");
+        return ERR_DATA_OK;
+    }
+    revision = manifest.revision + 1;
+    FS_dprint("Applying delta " + delta_path + " as revision " + std::to_string(revision));
+
+    const GoGraph &go_graph = mpSerializedDatabase->go_graph;
+    has_go_graph = !go_graph.empty();
+    for (GoGraph::node_t node = 0; node < go_graph.size(); node++) {
+        vect_str_t &node_parents = go_parents[go_graph.get_go_id(node)];
+        for (const GoGraph::node_t *parent = go_graph.parents_begin(node); parent != go_graph.parents_end(node); parent++) {
+            node_parents.push_back(go_graph.get_go_id(*parent));
+        }
+    }
+
+    std::ifstream in_file(delta_path);
+    if (!in_file.is_open()) {
+        set_err_msg("Unable to open EnTAP database delta at: " + delta_path, ERR_DATA_DELTA);
+        return ERR_DATA_DELTA;
+    }
+    while (std::getline(in_file, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == DELTA_COMMENT) continue;
+
+        fields = split_string(line, '\t');
+        if (fields.size() < 3) {
+            set_err_msg("Invalid delta line " + std::to_string(line_number) + " in " + delta_path, ERR_DATA_DELTA);
+            return ERR_DATA_DELTA;
+        }
+        const std::string &operation = fields[0];
+
+        if (operation == DELTA_OP_RELEASE) {
+            manifest.releases[fields[1]] = fields[2];
+
+        } else if (operation == DELTA_OP_REMOVE) {
+            uint64 erased;
+            if (fields[1] == DELTA_TYPE_TAXONOMY) {
+                LOWERCASE(fields[2]);
+                erased = mpSerializedDatabase->taxonomic_data.erase(fields[2]);
+                manifest.tax_revisions[fields[2]] = revision;
+                tax_changed |= erased > 0;
+            } else if (fields[1] == DELTA_TYPE_GO) {
+                erased = mpSerializedDatabase->gene_ontology_data.erase(fields[2]);
+                manifest.go_revisions[fields[2]] = revision;
+                if (has_go_graph) {
+                    go_parents.erase(fields[2]);
+                    for (auto &pair : go_parents) {
+                        pair.second.erase(std::remove(pair.second.begin(), pair.second.end(), fields[2]),
+                                          pair.second.end());
+                    }
+                    go_graph_changed = true;
+                }
+            } else if (fields[1] == DELTA_TYPE_UNIPROT) {
+                erased = mpSerializedDatabase->uniprot_data.erase(fields[2]);
+                manifest.uniprot_revisions[fields[2]] = revision;
+            } else {
+                set_err_msg("Invalid delta record type on line " + std::to_string(line_number) + ": " + fields[1],
+                            ERR_DATA_DELTA);
+                return ERR_DATA_DELTA;
+            }
+            erased > 0 ? changed++ : missing++;
+
+        } else if (operation == DELTA_OP_ADD || operation == DELTA_OP_CHANGE) {
+            // Both insert or replace, CHANGE of a missing record is only reported
+            if (fields[1] == DELTA_TYPE_TAXONOMY) {
+                TaxEntry taxEntry;
+                fields.resize(std::max(fields.size(), (size_t) 5));
+                LOWERCASE(fields[2]);
+                taxEntry.tax_name = fields[2];
+                taxEntry.tax_id   = fields[3];
+                taxEntry.lineage  = fields[4];
+                if (operation == DELTA_OP_CHANGE && mpSerializedDatabase->taxonomic_data.count(fields[2]) == 0) missing++;
+                mpSerializedDatabase->taxonomic_data[fields[2]] = taxEntry;
+                manifest.tax_revisions[fields[2]] = revision;
+                tax_changed = true;
+            } else if (fields[1] == DELTA_TYPE_GO) {
+                GoEntry goEntry;
+                bool    has_parents = fields.size() > 6;
+                if (has_go_graph && operation == DELTA_OP_ADD && !has_parents) {
+                    // Term would be left out of the graph, never propagated
+                    set_err_msg("GO term added without parents on delta line " + std::to_string(line_number) +
+                                ", required as the database has a Gene Ontology graph", ERR_DATA_DELTA);
+                    return ERR_DATA_DELTA;
+                }
+                fields.resize(std::max(fields.size(), (size_t) 7));
+                goEntry.go_id    = fields[2];
+                goEntry.term     = fields[3];
+                goEntry.category = fields[4];
+                goEntry.level    = fields[5];
+                if (has_go_graph && has_parents) {
+                    go_parents[fields[2]] = split_string(fields[6], ',');
+                    go_parents[fields[2]].erase(std::remove(go_parents[fields[2]].begin(), go_parents[fields[2]].end(), ""),
+                                                go_parents[fields[2]].end());
+                    go_graph_changed = true;
+                }
+                if (operation == DELTA_OP_CHANGE && mpSerializedDatabase->gene_ontology_data.count(fields[2]) == 0) missing++;
+                mpSerializedDatabase->gene_ontology_data[fields[2]] = goEntry;
+                manifest.go_revisions[fields[2]] = revision;
+            } else if (fields[1] == DELTA_TYPE_UNIPROT) {
+                UniprotEntry uniprotEntry;
+                fields.resize(std::max(fields.size(), (size_t) 7));
+                uniprotEntry.uniprot_id      = fields[2];
+                uniprotEntry.database_x_refs = fields[3];
+                uniprotEntry.comments        = fields[4];
+                uniprotEntry.kegg_terms      = fields[5];
+                uniprotEntry.go_terms        = format_go_delim(fields[6], ',');
+                if (operation == DELTA_OP_CHANGE && mpSerializedDatabase->uniprot_data.count(fields[2]) == 0) missing++;
+                mpSerializedDatabase->uniprot_data[fields[2]] = uniprotEntry;
+                manifest.uniprot_revisions[fields[2]] = revision;
+            } else {
+                set_err_msg("Invalid delta record type on line " + std::to_string(line_number) + ": " + fields[1],
+                            ERR_DATA_DELTA);
+                return ERR_DATA_DELTA;
+            }
+            changed++;
+
+        } else {
+            set_err_msg("Invalid delta operation on line " + std::to_string(line_number) + ": " + operation,
+                        ERR_DATA_DELTA);
+            return ERR_DATA_DELTA;
+        }
+    }
+    in_file.close();
+
+    if (tax_changed) {
+        vect_str_t tax_names;
+        tax_names.reserve(mpSerializedDatabase->taxonomic_data.size());
+        for (auto &pair : mpSerializedDatabase->taxonomic_data) {
+            tax_names.push_back(pair.first);
+        }
+        mpSerializedDatabase->tax_trie.build(tax_names);
+    }
+    if (go_graph_changed) {
+        FS_dprint("Rebuilding Gene Ontology graph...");
+        if (!mpSerializedDatabase->go_graph.build(go_parents)) {
+            set_err_msg("Delta parents form a cycle in the Gene Ontology graph: " + delta_path, ERR_DATA_DELTA);
+            return ERR_DATA_DELTA;
+        }
+    }
+    manifest.revision = revision;
+    manifest.deltas.push_back(delta_name);
+    FS_dprint("Delta applied, records changed: " + std::to_string(changed) +
+              " not previously in database: " + std::to_string(missing));
+
+    // Saved beside database first so a failed write leaves it intact
+    temp_path = database_path + ".tmp";
+    err_code = serialize_database_save(SERIALIZE_DEFAULT, temp_path);
+    if (err_code != ERR_DATA_OK) {
+        mpFileSystem->delete_file(temp_path);
+        return err_code;
+    }
+    if (!mpFileSystem->rename_file(temp_path, database_path)) {
+        mpFileSystem->delete_file(temp_path);
+        set_err_msg("Unable to replace EnTAP database at: " + database_path, ERR_DATA_DELTA);
+        return ERR_DATA_DELTA;
+    }
+    return ERR_DATA_OK;
+}
+
+/**
+ * ======================================================================
+ * Function uint32 EntapDatabase::get_revision()
+ *
+ * Description          - Returns manifest revision of database in use
+ *
+ * Notes                - SQL and mapped databases are never updated by
+ *                        deltas and are always revision 0
+ *
+ * @return              - Revision, 0 if no deltas applied
+ *
+ * =====================================================================
+ */
+uint32 EntapDatabase::get_revision() {
+    if (!mUseSerial || mpSerializedDatabase == nullptr) return 0;
+    return mpSerializedDatabase->manifest.revision;
+}
+
+/**
+ * ======================================================================
+ * Function uint64 EntapDatabase::get_changed_count(DATABASE_TYPE type, uint32 revision)
+ *
+ * Description          - Counts records of a type changed by deltas applied
+ *                        after a revision
+ *
+ * Notes                - None
+ *
+ * @param type          - ENTAP_TAXONOMY, ENTAP_GENE_ONTOLOGY, or ENTAP_UNIPROT
+ * @param revision      - Revision records are compared against
+ *
+ * @return              - Number of records changed (or removed) since revision
+ *
+ * =====================================================================
+ */
+uint64 EntapDatabase::get_changed_count(DATABASE_TYPE type, uint32 revision) {
+    const record_revision_map_t *revisions;
+    uint64 count=0;
+
+    if (!mUseSerial || mpSerializedDatabase == nullptr) return 0;
+    switch (type) {
+        case ENTAP_TAXONOMY:
+            revisions = &mpSerializedDatabase->manifest.tax_revisions;
+            break;
+        case ENTAP_GENE_ONTOLOGY:
+            revisions = &mpSerializedDatabase->manifest.go_revisions;
+            break;
+        case ENTAP_UNIPROT:
+            revisions = &mpSerializedDatabase->manifest.uniprot_revisions;
+            break;
+        default:
+            return 0;
+    }
+    for (auto &pair : *revisions) {
+        if (pair.second > revision) count++;
+    }
+    return count;
+}
+
+// Serialized database is written as a plain archive (--data-plain) rather than compressed blocks
+bool EntapDatabase::is_plain_serial() const {
+    return mpUserInput != nullptr && mpUserInput->has_input(INPUT_FLAG_DATABASE_PLAIN);
+}
+
+// Threads used for database generation and (de)compression
+uint16 EntapDatabase::get_thread_count() const {
+    uint16 threads;
+
+    threads = (mpUserInput != nullptr) ? (uint16) mpUserInput->get_supported_threads() : (uint16) 1;
+    return threads == 0 ? (uint16) 1 : threads;
+}
@@ -31,10 +31,14 @@
 #include "../EntapGlobals.h"
 #include "../EntapConfig.h"
 #include "SQLDatabaseHelper.h"
+#include <mutex>
+#include <functional>
 
 #ifdef USE_BOOST    // Include boost serialization headers
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/vector.hpp>
@@ -46,6 +50,7 @@
 #include <cereal/archives/binary.hpp>
 #include <cereal/cereal.hpp>
 #include <cereal/types/map.hpp>
+#include <cereal/types/unordered_map.hpp>
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 
@@ -53,6 +58,15 @@
 #endif
 
 #include "../FileSystem.h"
+#include "../StringInterner.h"
+#include "GoTermTable.h"
+#include "GoGraph.h"
+#include "TaxonomyTrie.h"
+
+// Lineage as interned ancestor lineages, root first. path[d] is the ancestor at depth d
+typedef std::vector<StringInterner::handle_t> tax_path_t;
+
+class MappedDatabase;
 
 
 struct  GoEntry {
@@ -96,6 +110,7 @@ struct TaxEntry {
     std::string tax_id;
     std::string lineage;
     std::string tax_name;
+    tax_path_t  lineage_path;   // Set at lookup, not serialized (EntapDatabase::get_lineage_path)
 
 #ifdef USE_BOOST
     friend class boost::serialization::access;
@@ -114,7 +129,7 @@ struct TaxEntry {
     }
 #endif
 
-    bool is_empty() {
+    bool is_empty() const {
         return this->tax_id.empty() && this->lineage.empty();
     }
     TaxEntry() {
@@ -169,7 +184,7 @@ struct UniprotEntry {
         return out.str();
     }
 
-    bool is_empty() {
+    bool is_empty() const {
         return this->database_x_refs.empty() && this->comments.empty();
     }
 };
@@ -182,14 +197,19 @@ public:
     typedef std::unordered_map<std::string, TaxEntry> tax_serial_map_t;
     typedef std::unordered_map<std::string, GoEntry> go_serial_map_t;
     typedef std::unordered_map<std::string, UniprotEntry> uniprot_serial_map_t;
+    typedef std::unordered_map<std::string, TaxEntry> tax_entry_map_t;     // Raw species to entry
+    typedef std::unordered_map<std::string, const TaxEntry*> tax_entry_ptr_map_t;
+    typedef std::unordered_map<std::string, const UniprotEntry*> uniprot_entry_ptr_map_t;
 
     typedef enum {
 
         ENTAP_SERIALIZED=0, // Serialized database
         ENTAP_SQL,          // SQL database (uniprot mapping, tax data)
+        ENTAP_MAPPED,       // Memory mapped database (converted from serialized)
         ENTAP_TAXONOMY,     // NCBI tax database
         ENTAP_GENE_ONTOLOGY,// GO database
         ENTAP_UNIPROT,      // UniProt mapping database
+        ENTAP_GO_GRAPH,     // Gene Ontology DAG (parents of each term)
         ENTAP_VERSION,      // Version table used in SQL database only
 
         ENTAP_MAX_TYPES
@@ -236,6 +256,7 @@ public:
 
         ERR_DATA_MEM_ALLOC,
         ERR_DATA_UNHANDLED_TYPE,
+        ERR_DATA_DELTA,
         ERR_DATA_MAX=100
 
     } DATABASE_ERR;
@@ -248,12 +269,50 @@ public:
 
     } SERIALIZATION_TYPE;
 
+    typedef std::unordered_map<std::string, uint32> record_revision_map_t;    // Key - revision last changed
+
+    // Releases and deltas applied to a serialized database (apply_delta)
+    struct DatabaseManifest {
+        uint32 revision;                                // Incremented by each applied delta, 0 if none
+        std::map<std::string, std::string> releases;    // Source (ex: uniprot) - release
+        vect_str_t deltas;                              // Names of applied deltas, in order
+        record_revision_map_t tax_revisions;            // Only records changed (or removed) by a delta
+        record_revision_map_t go_revisions;
+        record_revision_map_t uniprot_revisions;
+
+        DatabaseManifest() {
+            revision = 0;
+        }
+
+#ifdef USE_BOOST
+        friend class boost::serialization::access;
+        template<typename Archive>
+        void serialize(Archive & ar, const uint32 v) {
+            ar&revision;
+            ar&releases;
+            ar&deltas;
+            ar&tax_revisions;
+            ar&go_revisions;
+            ar&uniprot_revisions;
+        }
+#else
+        // Use CEREAL for serialization
+        template<class Archive>
+        void serialize(Archive & archive) {
+            archive(revision, releases, deltas, tax_revisions, go_revisions, uniprot_revisions);
+        }
+#endif
+    };
+
     struct EntapDatabaseStruct {
         tax_serial_map_t taxonomic_data;
         go_serial_map_t  gene_ontology_data;    // Accession - "GO:453232143"
         uniprot_serial_map_t uniprot_data;
         uint8 MAJOR_VERSION;
         uint8 MINOR_VERSION;
+        GoGraph go_graph;                       // Archived after the struct, older databases do not have it
+        TaxonomyTrie tax_trie;                  // Archived after go_graph, older databases do not have it
+        DatabaseManifest manifest;              // Archived after tax_trie, older databases do not have it
 
         EntapDatabaseStruct () {
             MAJOR_VERSION = 0;
@@ -288,11 +347,19 @@ public:
         std::string parent_id;
         std::string ncbi_id;
         std::string sci_name;
+        std::string lineage;    // Lowercase lineage, empty until computed
         vect_str_t  names;
 
         TaxonomyNode(std::string id);
     };
 
+    // '//' terminated UniProt flat file entries parsed by a single thread
+    struct UniprotParseChunk {
+        std::string               data;
+        std::vector<UniprotEntry> entries;
+        std::string               err_msg;  // Non-empty if parsing failed
+    };
+
     EntapDatabase(FileSystem* fileSystem, UserInput* userInput);
     ~EntapDatabase();
     bool set_database(DATABASE_TYPE type);
@@ -300,14 +367,26 @@ public:
     DATABASE_ERR generate_database(DATABASE_TYPE, std::string&);
     std::string print_error_log();
     go_format_t format_go_delim(std::string terms, char delim);
+    GoTermTable::GoTermSet intern_go_terms(const std::string &terms, char delim, bool keep_missing);
+    const GoGraph *get_go_graph();
 
     // Database accession routines
-    // TODO change to const* return if SQL removed
-    TaxEntry get_tax_entry(std::string& species);
+    // Returned entries point into database storage and are valid for the life of EntapDatabase
+    const TaxEntry *get_tax_entry(std::string& species);
+    tax_entry_ptr_map_t get_tax_entries(const std::set<std::string> &species);
+    static void get_lineage_path(const std::string &lineage, tax_path_t &path);
     GoEntry get_go_entry(std::string& go_id);
-    UniprotEntry get_uniprot_entry(std::string& accession);
+    go_serial_map_t get_go_entries(const std::set<std::string> &go_ids);
+    const UniprotEntry *get_uniprot_entry(std::string& accession);
+    uniprot_entry_ptr_map_t get_uniprot_entries(const std::set<std::string> &accessions);
+
+    bool is_uniprot_entry(std::string &sseqid, const UniprotEntry *&entry);
+    std::string get_uniprot_accession(std::string& sseqid);
 
-    bool is_uniprot_entry(std::string &sseqid, UniprotEntry &entry);
+    // Incremental updates (serialized database only)
+    DATABASE_ERR apply_delta(DATABASE_TYPE type, std::string &database_path, std::string &delta_path);
+    uint32 get_revision();
+    uint64 get_changed_count(DATABASE_TYPE type, uint32 revision);
 
     // Database versioning
     bool is_valid_version();
@@ -320,22 +399,37 @@ private:
     // Generation/download database routines
     DATABASE_ERR download_entap_sql(std::string&);
     DATABASE_ERR download_entap_serial(std::string&);
+    DATABASE_ERR download_entap_mapped(std::string&);
+    DATABASE_ERR compress_entap_serial(std::string &path);
     DATABASE_ERR generate_entap_database(DATABASE_TYPE type, std::string& path);
+    DATABASE_ERR download_generation_files();
     DATABASE_ERR generate_entap_tax(DATABASE_TYPE);
     DATABASE_ERR generate_entap_go(DATABASE_TYPE);
     DATABASE_ERR generate_entap_uniprot(DATABASE_TYPE);
-    std::string  entap_tax_get_lineage(TaxonomyNode &,
-                                       std::unordered_map<std::string, TaxonomyNode>&);
+    const std::string &entap_tax_get_lineage(TaxonomyNode &,
+                                             std::unordered_map<std::string, TaxonomyNode>&);
+    DATABASE_ERR parse_uniprot_stream(DATABASE_TYPE type, std::istream &in);
+    void parse_uniprot_chunk(UniprotParseChunk &chunk);
     bool sql_add_tax_entry(TaxEntry&);
     bool sql_add_go_entry(GoEntry&);
+    bool sql_batch_commit(bool finish);
     bool create_sql_table(DATABASE_TYPE);
+    bool create_sql_indexes();
+    bool sql_add_go_graph(const GoGraph::parent_map_t &parents);
+    void propagate_go_terms(vect_str_t &term_list);
     bool add_uniprot_entry(DATABASE_TYPE type, UniprotEntry &entry);
     void set_err_msg(std::string msg, DATABASE_ERR code);
     bool set_database_versions(DATABASE_TYPE type);
-    std::string get_uniprot_accession(std::string& sseqid);
+    TaxEntry find_tax_entry(std::string& species);
+    void find_tax_entries(const vect_str_t &species, std::vector<TaxEntry> &entries);
+    void sql_bulk_query(const std::string &sql_prefix, const vect_str_t &keys,
+                        const std::function<void(SQLDatabaseHelper::Statement&)> &on_row);
 
     DATABASE_ERR serialize_database_save(SERIALIZATION_TYPE, std::string&);
     DATABASE_ERR serialize_database_read(SERIALIZATION_TYPE, std::string&);
+    bool set_shared_database(std::string &database_path);
+    uint16 get_thread_count() const;
+    bool is_plain_serial() const;
 
     // FTP Paths
     const std::string FTP_GO_DATABASE =
@@ -349,9 +443,21 @@ private:
     const std::string FTP_UNIPROT_FLAT_FILE     =
             "ftp://ftp.uniprot.org/pub/databases/uniprot/current_release/knowledgebase/complete/uniprot_sprot.dat.gz";
 
+    const std::string TEMP_DIRECTORY           = "entap_database/";   // Within EnTAP temp directory, wiped after each configuration
     const std::string ENTAP_DATABASE_SERIAL_GZ = "entap_database.bin.gz";
+    const std::string ENTAP_DATABASE_SERIAL    = "entap_database.bin";
     const std::string ENTAP_DATABASE_SQL_GZ            = "entap_database.db.gz";
 
+    // Delta files (apply_delta), tab delimited: OPERATION TYPE fields...
+    const std::string DELTA_OP_ADD           = "ADD";
+    const std::string DELTA_OP_CHANGE        = "CHANGE";
+    const std::string DELTA_OP_REMOVE        = "REMOVE";
+    const std::string DELTA_OP_RELEASE       = "RELEASE";   // RELEASE source release
+    const std::string DELTA_TYPE_TAXONOMY    = "TAXONOMY";  // name tax_id lineage
+    const std::string DELTA_TYPE_GO          = "GO";        // go_id term category level parents
+    const std::string DELTA_TYPE_UNIPROT     = "UNIPROT";   // uniprot_id xrefs comments kegg go_ids
+    const char        DELTA_COMMENT          = '#';
+
     // NCBI Taxonomy filenames
     const std::string NCBI_TAX_ROOT          = "root[Subtree]"; // Unused
     const std::string NCBI_TAX_DATABASE      = "taxonomy";      // Unused
@@ -381,21 +487,65 @@ private:
     const std::string SQL_TABLE_UNIPROT_COL_COMM = "COMMENTS";
     const std::string SQL_TABLE_UNIPROT_COL_XREF = "DATAXREFS";
     const std::string SQL_TABLE_UNIPROT_COL_ID   = "UNIPROTID";
+    const std::string SQL_TABLE_GO_GRAPH_TITLE   = "GOGRAPH";
+    const std::string SQL_TABLE_GO_GRAPH_COL_PARENTS = "PARENTS";   // Comma separated direct parent GO IDs
     const std::string SQL_TABLE_VERSION_TITLE    = "VERSION";
     const std::string SQL_TABLE_VERSION_COL_VER  = "VERSION";
 
+    // SQL lookups, prepared once and bound per query
+    const std::string SQL_QUERY_TAX     = "SELECT " + SQL_COL_NCBI_TAX_TAXID + ", " + SQL_COL_NCBI_TAX_LINEAGE +
+                                          " FROM " + SQL_TABLE_NCBI_TAX_TITLE + " WHERE " + SQL_COL_NCBI_TAX_NAME + "=?";
+    const std::string SQL_QUERY_GO      = "SELECT " + SQL_TABLE_GO_COL_ID + ", " + SQL_TABLE_GO_COL_DESC + ", " +
+                                          SQL_TABLE_GO_COL_CATEGORY + ", " + SQL_TABLE_GO_COL_LEVEL +
+                                          " FROM " + SQL_TABLE_GO_TITLE + " WHERE " + SQL_TABLE_GO_COL_ID + "=?";
+    const std::string SQL_QUERY_UNIPROT = "SELECT " + SQL_TABLE_UNIPROT_COL_ID + ", " + SQL_TABLE_UNIPROT_COL_XREF +
+                                          ", " + SQL_TABLE_UNIPROT_COL_COMM + " FROM " + SQL_TABLE_UNIPROT_TITLE +
+                                          " WHERE " + SQL_TABLE_UNIPROT_COL_ID + "=?";
+
+    // SQL inserts during generation, committed every SQL_INSERT_BATCH rows
+    const uint64      SQL_INSERT_BATCH   = 100000;
+    const std::string SQL_INSERT_TAX     = "INSERT INTO " + SQL_TABLE_NCBI_TAX_TITLE + " (" + SQL_COL_NCBI_TAX_TAXID +
+                                           "," + SQL_COL_NCBI_TAX_LINEAGE + "," + SQL_COL_NCBI_TAX_NAME +
+                                           ") VALUES (?,?,?);";
+    const std::string SQL_INSERT_GO      = "INSERT INTO " + SQL_TABLE_GO_TITLE + " (" + SQL_TABLE_GO_COL_ID + "," +
+                                           SQL_TABLE_GO_COL_DESC + "," + SQL_TABLE_GO_COL_CATEGORY + "," +
+                                           SQL_TABLE_GO_COL_LEVEL + ") VALUES (?,?,?,?);";
+    const std::string SQL_INSERT_UNIPROT = "INSERT INTO " + SQL_TABLE_UNIPROT_TITLE + " (" + SQL_TABLE_UNIPROT_COL_ID +
+                                           "," + SQL_TABLE_UNIPROT_COL_XREF + "," + SQL_TABLE_UNIPROT_COL_COMM +
+                                           ") VALUES (?,?,?);";
+
+    const std::string SQL_INSERT_GO_GRAPH = "INSERT INTO " + SQL_TABLE_GO_GRAPH_TITLE + " (" + SQL_TABLE_GO_COL_ID +
+                                            "," + SQL_TABLE_GO_GRAPH_COL_PARENTS + ") VALUES (?,?);";
+    const std::string SQL_QUERY_GO_GRAPH  = "SELECT " + SQL_TABLE_GO_COL_ID + ", " + SQL_TABLE_GO_GRAPH_COL_PARENTS +
+                                            " FROM " + SQL_TABLE_GO_GRAPH_TITLE;
+
+    // SQL bulk lookups, key column is returned first and " IN (?,...)" appended
+    const uint16      SQL_BULK_KEYS          = 500;     // Keys bound per query (below SQLITE_MAX_VARIABLE_NUMBER)
+    const std::string SQL_BULK_QUERY_TAX     = "SELECT " + SQL_COL_NCBI_TAX_NAME + ", " + SQL_COL_NCBI_TAX_TAXID + ", " +
+                                               SQL_COL_NCBI_TAX_LINEAGE + " FROM " + SQL_TABLE_NCBI_TAX_TITLE +
+                                               " WHERE " + SQL_COL_NCBI_TAX_NAME;
+    const std::string SQL_BULK_QUERY_GO      = "SELECT " + SQL_TABLE_GO_COL_ID + ", " + SQL_TABLE_GO_COL_DESC + ", " +
+                                               SQL_TABLE_GO_COL_CATEGORY + ", " + SQL_TABLE_GO_COL_LEVEL +
+                                               " FROM " + SQL_TABLE_GO_TITLE + " WHERE " + SQL_TABLE_GO_COL_ID;
+    const std::string SQL_BULK_QUERY_UNIPROT = "SELECT " + SQL_TABLE_UNIPROT_COL_ID + ", " + SQL_TABLE_UNIPROT_COL_XREF +
+                                               ", " + SQL_TABLE_UNIPROT_COL_COMM + " FROM " + SQL_TABLE_UNIPROT_TITLE +
+                                               " WHERE " + SQL_TABLE_UNIPROT_COL_ID;
+
     // Gene Ontology constants
     const std::string GO_BIOLOGICAL_LVL = "6679";
     const std::string GO_MOLECULAR_LVL  = "2892";
     const std::string GO_CELLULAR_LVL   = "311";
     const std::string GO_TERM_FILE      = "term.txt";
     const std::string GO_GRAPH_FILE     = "graph_path.txt";
+    const std::string GO_RELATION_IS_A  = "is_a";       // Relations propagated through the GO graph
+    const std::string GO_RELATION_PART_OF = "part_of";
+    const std::string GO_GRAPH_DIRECT   = "1";          // graph_path.txt distance of a direct parent
+    const char        GO_GRAPH_DELIM    = ',';
     const std::string GO_TERMDB_FILE    = "go_monthly-termdb-tables.tar.gz";
     const std::string GO_TERMDB_DIR     = "go_monthly-termdb-tables/";
 
     // UniProt mapping constants
     const std::string UNIPROT_DAT_FILE_GZ            = "uniprot_sprot.dat.gz";
-    const std::string UNIPROT_DAT_FILE               = "uniprot_sprot.dat";
 
     // EnTAP database consts
     const SERIALIZATION_TYPE SERIALIZE_DEFAULT    = CEREAL_BIN_ARCHIVE;
@@ -405,23 +555,39 @@ private:
     const uint8              SQL_MINOR            = 0;
 
     const uint8 STATUS_UPDATES = 5;     // Percentage of updates when downloading/configuring
+    const uint64 UNIPROT_CHUNK_BYTES      = 16777216;   // UniProt flat file bytes read per parse chunk (16MB)
+    const uint16 UNIPROT_CHUNKS_PER_THREAD= 2;          // Chunks in memory per thread during generation
 
     EntapDatabaseStruct *mpSerializedDatabase;
+    MappedDatabase      *mpMappedDatabase;
     FileSystem          *mpFileSystem;
     UserInput           *mpUserInput;
     SQLDatabaseHelper   *mpDatabaseHelper;
     std::string          mTempDirectory;
     go_serial_map_t      mSqlGoHelper;    // Using to increase speeds for now, change later
+    std::mutex           mSqlGoMutex;
+    tax_entry_map_t      mTaxCache;       // Memoized species lookups (raw species), including misses
+    std::mutex           mTaxCacheMutex;
+    uniprot_serial_map_t mUniprotCache;   // SQL UniProt lookups (accession), including misses
+    std::mutex           mUniprotCacheMutex;
+    GoGraph              mGoGraph;        // Loaded from SQL/mapped database, serialized database holds its own
+    const GoGraph       *mpGoGraph;       // Graph in use, nullptr until get_go_graph
+    std::mutex           mGoGraphMutex;
+    bool                 mGoPropagate;    // Propagate GO terms to ancestors (--go-propagate)
+    const TaxEntry       mEmptyTaxEntry;
     bool                 mUseSerial;
+    uint64               mSqlBatchInserts;  // Inserts in current generation transaction
     std::string          mErrMsg;
     DATABASE_ERR         mErrCode;
 
     const std::string ENTAP_DATABASE_TYPES_STR[ENTAP_MAX_TYPES-1] {
             "EnTAP Serialized Database",
             "EnTAP SQL Database",
+            "EnTAP Memory Mapped Database",
             "EnTAP NCBI Taxonomy Database",
             "EnTAP Gene Ontology Database",
-            "EnTAP UniProt Swiss-Prot Database"
+            "EnTAP UniProt Swiss-Prot Database",
+            "EnTAP Gene Ontology Graph"
     };
 };
 
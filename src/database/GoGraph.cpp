@@ -0,0 +1,238 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <functional>
+#include <queue>
+#include "GoGraph.h"
+#include "../FileSystem.h"
+
+constexpr GoGraph::node_t GoGraph::NODE_NOT_FOUND;
+
+/**
+ * ======================================================================
+ * Function bool GoGraph::build(const parent_map_t &parents)
+ *
+ * Description          - Builds graph from the direct parents of each term
+ *                      - Orders nodes topologically (Kahn, ties broken by
+ *                        GO ID so output is deterministic), then computes
+ *                        each node's ancestor closure from its parents,
+ *                        which are already complete
+ *
+ * Notes                - Terms only seen as parents become root nodes
+ *
+ * @param parents       - GO ID to direct parent GO IDs
+ *
+ * @return              - FALSE if graph contains a cycle
+ *
+ * =====================================================================
+ */
+bool GoGraph::build(const parent_map_t &parents) {
+    vect_str_t                              sorted_ids;
+    std::unordered_map<std::string, node_t> sorted_index;
+    std::vector<std::vector<node_t>>        children;
+    std::vector<std::vector<node_t>>        node_parents;
+    std::vector<uint32>                     in_degree;
+    std::vector<node_t>                     order;          // Topological position to sorted node
+    std::vector<node_t>                     position;       // Sorted node to topological position
+    std::priority_queue<node_t, std::vector<node_t>, std::greater<node_t>> ready;
+    std::vector<node_t>                     closure;
+
+    mGoIds.clear();
+    mParentOffsets.clear();
+    mParents.clear();
+    mAncestorOffsets.clear();
+    mAncestors.clear();
+    mNodeIndex.clear();
+
+    for (const auto &pair : parents) {
+        sorted_ids.push_back(pair.first);
+        sorted_ids.insert(sorted_ids.end(), pair.second.begin(), pair.second.end());
+    }
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    sorted_ids.erase(std::unique(sorted_ids.begin(), sorted_ids.end()), sorted_ids.end());
+    for (node_t i = 0; i < sorted_ids.size(); i++) {
+        sorted_index.emplace(sorted_ids[i], i);
+    }
+
+    children.resize(sorted_ids.size());
+    node_parents.resize(sorted_ids.size());
+    in_degree.assign(sorted_ids.size(), 0);
+    for (const auto &pair : parents) {
+        node_t child = sorted_index[pair.first];
+        for (const std::string &parent_id : pair.second) {
+            node_t parent = sorted_index[parent_id];
+            if (parent == child) continue;
+            node_parents[child].push_back(parent);
+        }
+        std::sort(node_parents[child].begin(), node_parents[child].end());
+        node_parents[child].erase(std::unique(node_parents[child].begin(), node_parents[child].end()),
+                                  node_parents[child].end());
+        for (node_t parent : node_parents[child]) {
+            children[parent].push_back(child);
+        }
+        in_degree[child] = (uint32) node_parents[child].size();
+    }
+
+    for (node_t i = 0; i < sorted_ids.size(); i++) {
+        if (in_degree[i] == 0) ready.push(i);
+    }
+    while (!ready.empty()) {
+        node_t node = ready.top();
+        ready.pop();
+        order.push_back(node);
+        for (node_t child : children[node]) {
+            if (--in_degree[child] == 0) ready.push(child);
+        }
+    }
+    if (order.size() != sorted_ids.size()) {
+        FS_dprint("ERROR Gene Ontology graph contains a cycle, unable to build");
+        return false;
+    }
+
+    position.resize(sorted_ids.size());
+    for (node_t i = 0; i < order.size(); i++) {
+        position[order[i]] = i;
+    }
+
+    // Parents always precede a node, so their closures are complete when it is reached
+    mGoIds.reserve(order.size());
+    mParentOffsets.push_back(0);
+    mAncestorOffsets.push_back(0);
+    for (node_t node = 0; node < order.size(); node++) {
+        const std::vector<node_t> &sorted_parents = node_parents[order[node]];
+        mGoIds.push_back(sorted_ids[order[node]]);
+
+        closure.clear();
+        for (node_t sorted_parent : sorted_parents) {
+            node_t parent = position[sorted_parent];
+            mParents.push_back(parent);
+            closure.push_back(parent);
+            closure.insert(closure.end(), ancestors_begin(parent), ancestors_end(parent));
+        }
+        std::sort(mParents.begin() + mParentOffsets.back(), mParents.end());
+        std::sort(closure.begin(), closure.end());
+        closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+        mAncestors.insert(mAncestors.end(), closure.begin(), closure.end());
+
+        mParentOffsets.push_back((uint32) mParents.size());
+        mAncestorOffsets.push_back((uint32) mAncestors.size());
+    }
+    index();
+    FS_dprint("Gene Ontology graph built with " + std::to_string(mGoIds.size()) + " terms, " +
+              std::to_string(mParents.size()) + " edges, " + std::to_string(mAncestors.size()) +
+              " ancestor links");
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function void GoGraph::index()
+ *
+ * Description          - Builds GO ID lookup, must be called after the
+ *                        graph is deserialized
+ *
+ * Notes                - None
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void GoGraph::index() {
+    mNodeIndex.clear();
+    mNodeIndex.reserve(mGoIds.size());
+    for (node_t i = 0; i < mGoIds.size(); i++) {
+        mNodeIndex.emplace(mGoIds[i], i);
+    }
+}
+
+bool GoGraph::empty() const {
+    return mGoIds.empty();
+}
+
+uint32 GoGraph::size() const {
+    return (uint32) mGoIds.size();
+}
+
+GoGraph::node_t GoGraph::find_node(const std::string &go_id) const {
+    std::unordered_map<std::string, node_t>::const_iterator it = mNodeIndex.find(go_id);
+    return it != mNodeIndex.end() ? it->second : NODE_NOT_FOUND;
+}
+
+const std::string &GoGraph::get_go_id(node_t node) const {
+    return mGoIds[node];
+}
+
+const GoGraph::node_t *GoGraph::parents_begin(node_t node) const {
+    return mParents.data() + mParentOffsets[node];
+}
+
+const GoGraph::node_t *GoGraph::parents_end(node_t node) const {
+    return mParents.data() + mParentOffsets[node + 1];
+}
+
+const GoGraph::node_t *GoGraph::ancestors_begin(node_t node) const {
+    return mAncestors.data() + mAncestorOffsets[node];
+}
+
+const GoGraph::node_t *GoGraph::ancestors_end(node_t node) const {
+    return mAncestors.data() + mAncestorOffsets[node + 1];
+}
+
+/**
+ * ======================================================================
+ * Function void GoGraph::expand_ancestors(const std::vector<node_t> &nodes,
+ *                                         std::vector<node_t> &out)
+ *
+ * Description          - Propagates a set of nodes to all of their ancestors
+ *
+ * Notes                - Output is sorted (topological order) and unique,
+ *                        includes the input nodes
+ *
+ * @param nodes         - Nodes to expand
+ * @param out           - Set to nodes and their ancestors
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void GoGraph::expand_ancestors(const std::vector<node_t> &nodes, std::vector<node_t> &out) const {
+    std::vector<node_t> merged;
+
+    out.clear();
+    for (node_t node : nodes) {
+        if (node >= mGoIds.size()) continue;
+        merged.clear();
+        merged.reserve(out.size() + (ancestors_end(node) - ancestors_begin(node)));
+        std::set_union(out.begin(), out.end(), ancestors_begin(node), ancestors_end(node),
+                       std::back_inserter(merged));
+        out.swap(merged);
+        std::vector<node_t>::iterator it = std::lower_bound(out.begin(), out.end(), node);
+        if (it == out.end() || *it != node) out.insert(it, node);
+    }
+}
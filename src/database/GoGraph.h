@@ -0,0 +1,116 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ENTAP_GOGRAPH_H
+#define ENTAP_GOGRAPH_H
+
+#include <unordered_map>
+#include "../common.h"
+#include "../config.h"
+
+#ifdef USE_BOOST
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+#else
+#include <cereal/cereal.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#endif
+
+/**
+ * ======================================================================
+ * @class GoGraph
+ *
+ * Description          - Compact Gene Ontology DAG (is_a / part_of) built
+ *                        when the EnTAP database is configured
+ *                      - Nodes are numbered in topological order (every
+ *                        ancestor before its descendants)
+ *                      - Direct parents and the full ancestor closure of
+ *                        each node are stored as CSR arrays (offsets into
+ *                        one flat array of sorted node indices), so
+ *                        propagating a term set to its ancestors is a
+ *                        merge of sorted ranges
+ *
+ * Notes                - Stored in the serialized EnTAP database. SQL and
+ *                        memory mapped databases store the direct parents
+ *                        and rebuild the closure when loaded
+ *                      - Const lookups are thread safe
+ *
+ * ======================================================================
+ */
+class GoGraph {
+
+public:
+    typedef uint32 node_t;
+    typedef std::unordered_map<std::string, vect_str_t> parent_map_t;  // GO ID to direct parent GO IDs
+
+    static constexpr node_t NODE_NOT_FOUND = UINT32_MAX;
+
+    bool build(const parent_map_t &parents);
+    void index();
+    bool empty() const;
+    uint32 size() const;
+    node_t find_node(const std::string &go_id) const;
+    const std::string &get_go_id(node_t node) const;
+    const node_t *parents_begin(node_t node) const;
+    const node_t *parents_end(node_t node) const;
+    const node_t *ancestors_begin(node_t node) const;
+    const node_t *ancestors_end(node_t node) const;
+    void expand_ancestors(const std::vector<node_t> &nodes, std::vector<node_t> &out) const;
+
+#ifdef USE_BOOST
+    friend class boost::serialization::access;
+    template<typename Archive>
+    void serialize(Archive & ar, const uint32 v) {
+        ar&mGoIds;
+        ar&mParentOffsets;
+        ar&mParents;
+        ar&mAncestorOffsets;
+        ar&mAncestors;
+    }
+#else
+    // Use CEREAL for serialization
+    template<class Archive>
+    void serialize(Archive & archive) {
+        archive(mGoIds, mParentOffsets, mParents, mAncestorOffsets, mAncestors);
+    }
+#endif
+
+private:
+    vect_str_t                               mGoIds;            // Node to GO ID, topological order
+    std::vector<uint32>                      mParentOffsets;    // CSR, node count + 1
+    std::vector<node_t>                      mParents;
+    std::vector<uint32>                      mAncestorOffsets;  // CSR, node count + 1
+    std::vector<node_t>                      mAncestors;        // Excludes node itself
+    std::unordered_map<std::string, node_t>  mNodeIndex;        // GO ID to node, not serialized (index)
+};
+
+
+#endif //ENTAP_GOGRAPH_H
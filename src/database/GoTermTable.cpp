@@ -0,0 +1,221 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "GoTermTable.h"
+#include "../EntapGlobals.h"
+#include "../ExceptionHandler.h"
+
+constexpr uint8  GoTermTable::LEVEL_MAX;
+constexpr GoTermTable::term_id_t GoTermTable::TERM_NOT_FOUND;
+constexpr uint32 GoTermTable::CHUNK_SIZE;
+
+GoTermTable::GoTermTable() {
+    mCount = 0;
+    std::fill(mChunks, mChunks + CHUNK_MAX, nullptr);
+}
+
+GoTermTable::~GoTermTable() {
+    for (TermChunk *chunk : mChunks) {
+        delete chunk;
+    }
+}
+
+GoTermTable &GoTermTable::instance() {
+    static GoTermTable table;
+    return table;
+}
+
+bool GoTermTable::GoTermSet::empty() const {
+    for (const term_list_t &list : terms) {
+        if (!list.empty()) return false;
+    }
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function term_id_t GoTermTable::intern(const std::string &go_id, const std::string &term,
+ *                                        const std::string &category, const std::string &level)
+ *
+ * Description          - Returns ID of a GO term, storing it and setting its
+ *                        level bit if it has not been interned yet
+ *
+ * Notes                - Thread safe
+ *                      - Terms are keyed by GO ID, the first description
+ *                        seen for an ID is kept
+ *
+ * @param go_id         - GO ID (GO:0000001)
+ * @param term          - Term description, empty if not found in database
+ * @param category      - Category flag (biological_process...), empty if unknown
+ * @param level         - Level of term, empty if unknown
+ *
+ * @return              - Stable ID of the term
+ *
+ * =====================================================================
+ */
+GoTermTable::term_id_t GoTermTable::intern(const std::string &go_id, const std::string &term,
+                                           const std::string &category, const std::string &level) {
+    GoTermTable &table = instance();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    uint64 level_val;
+
+    std::unordered_map<std::string, term_id_t>::iterator it = table.mTermIds.find(go_id);
+    if (it != table.mTermIds.end()) return it->second;
+
+    if (table.mCount == CHUNK_MAX * CHUNK_SIZE) {
+        throw ExceptionHandler("Maximum number of Gene Ontology terms reached", ERR_ENTAP_MEM_ALLOC);
+    }
+
+    term_id_t id = table.mCount++;
+    uint32 offset = id & (CHUNK_SIZE - 1);
+    TermChunk *&chunk = table.mChunks[id >> CHUNK_BITS];
+    if (chunk == nullptr) chunk = new TermChunk();  // Value initialized, bitmaps start cleared
+
+    // Unparsable or missing levels are stored as 0, only output when not filtering
+    level_val = level.empty() ? 0 : strtoul(level.c_str(), nullptr, 10);
+    if (level_val > UINT8_MAX) level_val = 0;
+
+    chunk->labels[offset]     = go_id + "-" + term + "(L=" + level + ")";
+    chunk->categories[offset] = category_from_flag(category);
+    chunk->levels[offset]     = (uint8) level_val;
+    if (level_val > 0 && level_val <= LEVEL_MAX) {
+        chunk->level_bits[level_val][offset >> 6].fetch_or((uint64) 1 << (offset & 63), std::memory_order_relaxed);
+    }
+    table.mTermIds.emplace(go_id, id);
+    return id;
+}
+
+/**
+ * ======================================================================
+ * Function term_id_t GoTermTable::find(const std::string &go_id)
+ *
+ * Description          - Returns ID of a GO term without interning it
+ *
+ * Notes                - Thread safe
+ *
+ * @param go_id         - GO ID (GO:0000001)
+ *
+ * @return              - ID of the term or TERM_NOT_FOUND
+ *
+ * =====================================================================
+ */
+GoTermTable::term_id_t GoTermTable::find(const std::string &go_id) {
+    GoTermTable &table = instance();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    std::unordered_map<std::string, term_id_t>::iterator it = table.mTermIds.find(go_id);
+    return it != table.mTermIds.end() ? it->second : TERM_NOT_FOUND;
+}
+
+GoTermTable::GO_CATEGORY GoTermTable::get_category(term_id_t id) {
+    return instance().mChunks[id >> CHUNK_BITS]->categories[id & (CHUNK_SIZE - 1)];
+}
+
+uint8 GoTermTable::get_level(term_id_t id) {
+    return instance().mChunks[id >> CHUNK_BITS]->levels[id & (CHUNK_SIZE - 1)];
+}
+
+const std::string &GoTermTable::get_label(term_id_t id) {
+    return instance().mChunks[id >> CHUNK_BITS]->labels[id & (CHUNK_SIZE - 1)];
+}
+
+/**
+ * ======================================================================
+ * Function bool GoTermTable::at_level(term_id_t id, uint16 lvl)
+ *
+ * Description          - Checks whether a term is at a GO level using the
+ *                        level bitmap
+ *
+ * Notes                - Level 0 matches every term
+ *
+ * @param id            - Term ID
+ * @param lvl           - GO level
+ *
+ * @return              - TRUE if term is at level
+ *
+ * =====================================================================
+ */
+bool GoTermTable::at_level(term_id_t id, uint16 lvl) {
+    uint32 offset;
+
+    if (lvl == 0) return true;
+    if (lvl > LEVEL_MAX) return false;
+    offset = id & (CHUNK_SIZE - 1);
+    return ((instance().mChunks[id >> CHUNK_BITS]->level_bits[lvl][offset >> 6].load(std::memory_order_relaxed)
+            >> (offset & 63)) & 1) != 0;
+}
+
+/**
+ * ======================================================================
+ * Function std::string GoTermTable::format_terms(const term_list_t &terms, uint16 lvl)
+ *
+ * Description          - Renders the labels of the terms at a GO level for
+ *                        output (comma separated)
+ *
+ * Notes                - None
+ *
+ * @param terms         - Term IDs to render
+ * @param lvl           - GO level, 0 for all terms
+ *
+ * @return              - Output string
+ *
+ * =====================================================================
+ */
+std::string GoTermTable::format_terms(const term_list_t &terms, uint16 lvl) {
+    std::string out;
+
+    for (term_id_t id : terms) {
+        if (at_level(id, lvl)) {
+            out += get_label(id);
+            out += ',';
+        }
+    }
+    return out;
+}
+
+GoTermTable::GO_CATEGORY GoTermTable::category_from_flag(const std::string &category) {
+    if (category == GO_BIOLOGICAL_FLAG) return GO_CATEGORY_BIOLOGICAL;
+    if (category == GO_CELLULAR_FLAG)   return GO_CATEGORY_CELLULAR;
+    if (category == GO_MOLECULAR_FLAG)  return GO_CATEGORY_MOLECULAR;
+    return GO_CATEGORY_UNKNOWN;
+}
+
+const std::string &GoTermTable::category_to_flag(GO_CATEGORY category) {
+    static const std::string UNKNOWN_FLAG;
+
+    switch (category) {
+        case GO_CATEGORY_BIOLOGICAL:
+            return GO_BIOLOGICAL_FLAG;
+        case GO_CATEGORY_CELLULAR:
+            return GO_CELLULAR_FLAG;
+        case GO_CATEGORY_MOLECULAR:
+            return GO_MOLECULAR_FLAG;
+        default:
+            return UNKNOWN_FLAG;
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ENTAP_GOTERMTABLE_H
+#define ENTAP_GOTERMTABLE_H
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "../common.h"
+
+/**
+ * ======================================================================
+ * @class GoTermTable
+ *
+ * Description          - Process wide table of Gene Ontology terms found
+ *                        while annotating
+ *                      - Each GO term is stored once and referenced by a
+ *                        32bit ID, along with its category (enum), level
+ *                        (uint8) and output label (GO:0000001-term(L=3))
+ *                      - Every level has a precomputed bitmap of the term
+ *                        IDs at that level, so level filtering of a term
+ *                        list is a bit test per term instead of a string
+ *                        search
+ *
+ * Notes                - intern is thread safe. Lookups do not lock, the ID
+ *                        must have been obtained by the calling thread or
+ *                        passed to it through a synchronized path
+ *
+ * ======================================================================
+ */
+class GoTermTable {
+
+public:
+    typedef uint32 term_id_t;
+    typedef std::vector<term_id_t> term_list_t;
+
+    enum GO_CATEGORY : uint8 {
+        GO_CATEGORY_BIOLOGICAL=0,
+        GO_CATEGORY_CELLULAR,
+        GO_CATEGORY_MOLECULAR,
+        GO_CATEGORY_UNKNOWN,        // Term not found in EnTAP database
+
+        GO_CATEGORY_COUNT
+    };
+
+    // GO terms of a single alignment, by category in the order they were found
+    struct GoTermSet {
+        term_list_t terms[GO_CATEGORY_COUNT];
+
+        bool empty() const;
+        const term_list_t &get(GO_CATEGORY category) const {return terms[category];}
+    };
+
+    static constexpr uint8     LEVEL_MAX      = 31;           // Deeper levels are only output with level 0 (all)
+    static constexpr term_id_t TERM_NOT_FOUND = UINT32_MAX;
+
+    static term_id_t intern(const std::string &go_id, const std::string &term,
+                            const std::string &category, const std::string &level);
+    static term_id_t find(const std::string &go_id);
+    static GO_CATEGORY get_category(term_id_t id);
+    static uint8 get_level(term_id_t id);
+    static const std::string &get_label(term_id_t id);
+    static bool at_level(term_id_t id, uint16 lvl);
+    static std::string format_terms(const term_list_t &terms, uint16 lvl);
+    static GO_CATEGORY category_from_flag(const std::string &category);
+    static const std::string &category_to_flag(GO_CATEGORY category);
+
+private:
+    static constexpr uint32 CHUNK_BITS  = 12;
+    static constexpr uint32 CHUNK_SIZE  = (1 << CHUNK_BITS);
+    static constexpr uint32 CHUNK_MAX   = (1 << 10);           // Up to 4M terms
+    static constexpr uint32 CHUNK_WORDS = CHUNK_SIZE / 64;
+
+    struct TermChunk {
+        std::string          labels[CHUNK_SIZE];
+        GO_CATEGORY          categories[CHUNK_SIZE];
+        uint8                levels[CHUNK_SIZE];
+        std::atomic<uint64>  level_bits[LEVEL_MAX + 1][CHUNK_WORDS];
+    };
+
+    GoTermTable();
+    ~GoTermTable();
+    static GoTermTable &instance();
+
+    std::mutex                                    mMutex;
+    std::unordered_map<std::string, term_id_t>    mTermIds;     // GO ID (GO:0000001) to term ID
+    uint32                                        mCount;
+    TermChunk                                    *mChunks[CHUNK_MAX];   // Fixed table of chunks, never reallocated
+};
+
+
+#endif //ENTAP_GOTERMTABLE_H
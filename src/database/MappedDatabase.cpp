@@ -0,0 +1,1028 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+//*********************** Includes *****************************
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedDatabase.h"
+//**************************************************************
+
+constexpr uint32 MappedDatabase::FORMAT_VERSION;
+constexpr uint64 MappedDatabase::BUCKET_KEYS;
+constexpr uint32 MappedDatabase::MAX_SEED_ATTEMPTS;
+constexpr uint64 MappedDatabase::FILE_ALIGNMENT;
+constexpr char   MappedDatabase::GO_CATEGORY_DELIM;
+constexpr char   MappedDatabase::GO_TERM_DELIM;
+constexpr char   MappedDatabase::GO_PARENT_DELIM;
+const char       MappedDatabase::FILE_MAGIC[8] = {'E','N','T','A','P','M','D','B'};
+const std::string MappedDatabase::SHARED_MEMORY_DIR     = "/dev/shm";
+const std::string MappedDatabase::SHARED_SEGMENT_PREFIX = "entap_db_";
+
+MappedDatabase::MappedDatabase() {
+    mpData    = nullptr;
+    mDataSize = 0;
+    mSharedFd = -1;
+    for (Section &section : mSections) {
+        section = {};
+    }
+}
+
+MappedDatabase::~MappedDatabase() {
+    close();
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::open(const std::string &path)
+ *
+ * Description          - Memory maps database read only and validates the
+ *                        header and section bounds
+ *
+ * Notes                - Section data is not read, pages are loaded on first
+ *                        lookup
+ *
+ * @param path          - Path to mapped EnTAP database
+ *
+ * @return              - TRUE if database was opened
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::open(const std::string &path) {
+    int          fd;
+    struct stat  file_stat;
+    void        *addr;
+    const FileHeader *header;
+
+    FS_dprint("Mapping EnTAP database: " + path);
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        mErrMsg = "Unable to open mapped EnTAP database at: " + path;
+        return false;
+    }
+    if (fstat(fd, &file_stat) != 0 || (uint64) file_stat.st_size < sizeof(FileHeader)) {
+        ::close(fd);
+        mErrMsg = "Mapped EnTAP database is empty or unreadable at: " + path;
+        return false;
+    }
+    addr = mmap(nullptr, (size_t) file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // Mapping holds its own reference
+    if (addr == MAP_FAILED) {
+        mErrMsg = "Unable to memory map EnTAP database at: " + path;
+        return false;
+    }
+    // Lookups hop between hash slots and pool strings
+    madvise(addr, (size_t) file_stat.st_size, MADV_RANDOM);
+
+    mpData    = (const char*) addr;
+    mDataSize = (uint64) file_stat.st_size;
+
+    header = (const FileHeader*) mpData;
+    if (memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        header->format_version != FORMAT_VERSION || header->section_count != SECTION_MAX) {
+        close();
+        mErrMsg = "Unrecognized mapped EnTAP database format at: " + path;
+        return false;
+    }
+
+    if (!set_section(SECTION_TAXONOMY, TAX_FIELD_COUNT) ||
+        !set_section(SECTION_GENE_ONTOLOGY, GO_FIELD_COUNT) ||
+        !set_section(SECTION_UNIPROT, UNIPROT_FIELD_COUNT) ||
+        !set_section(SECTION_GO_GRAPH, GO_GRAPH_FIELD_COUNT) ||
+        !set_section(SECTION_EGGNOG, EGGNOG_FIELD_COUNT) ||
+        !set_section(SECTION_SUBJECT, SUBJECT_FIELD_COUNT) ||
+        !set_section(SECTION_SUBJECT_INFO, SUBJECT_INFO_FIELD_COUNT)) {
+        close();
+        mErrMsg = "Mapped EnTAP database is corrupt at: " + path;
+        return false;
+    }
+    FS_dprint("Success! Mapped " + std::to_string(mDataSize) + " bytes");
+    return true;
+}
+
+void MappedDatabase::close() {
+    if (mpData != nullptr) {
+        munmap((void*) mpData, (size_t) mDataSize);
+    }
+    mpData    = nullptr;
+    mDataSize = 0;
+    for (Section &section : mSections) {
+        section = {};
+    }
+    release_shared();
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::open_shared(const std::string &source_path,
+ *                                           const database_loader_t &load_database)
+ *
+ * Description          - Attaches to the shared memory copy of a serialized
+ *                        EnTAP database, publishing it first if no other
+ *                        process on the node has
+ *                      - Publishing loads the database (load_database),
+ *                        writes it in mapped format to a temporary segment,
+ *                        and renames it into place so attaching processes
+ *                        never see a partial segment
+ *
+ * Notes                - Segment name is derived from the source file identity
+ *                        and FORMAT_VERSION, so a changed database or an
+ *                        incompatible build never attaches to an old segment
+ *                      - Each attached process holds a shared lock on the
+ *                        segment as its reference, the last one to close
+ *                        removes it
+ *
+ * @param source_path   - Path to serialized EnTAP database
+ * @param load_database - Loads the serialized database if it must be published
+ *
+ * @return              - TRUE if attached to shared database
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::open_shared(const std::string &source_path, const database_loader_t &load_database) {
+    std::string segment_path;
+    std::string lock_path;
+    std::string temp_path;
+    int         lock_fd;
+    bool        ret = false;
+    const EntapDatabase::EntapDatabaseStruct *database;
+
+    close();
+    segment_path = get_shared_path(source_path);
+    if (segment_path.empty()) {
+        mErrMsg = "Unable to access EnTAP database at: " + source_path;
+        return false;
+    }
+
+    // Only one process publishes at a time, the rest wait and attach to its segment
+    lock_path = segment_path + ".lock";
+    lock_fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (lock_fd < 0) {
+        mErrMsg = "Unable to open shared memory lock at: " + lock_path;
+        return false;
+    }
+    if (flock(lock_fd, LOCK_EX) != 0) {
+        ::close(lock_fd);
+        mErrMsg = "Unable to lock shared memory at: " + lock_path;
+        return false;
+    }
+
+    if (attach_shared(segment_path)) {
+        FS_dprint("Attached to shared EnTAP database: " + segment_path);
+        ret = true;
+    } else {
+        FS_dprint("Publishing EnTAP database to shared memory: " + segment_path);
+        temp_path = segment_path + ".tmp" + std::to_string(getpid());
+        database = load_database();
+        if (database == nullptr) {
+            mErrMsg = "Unable to load EnTAP database at: " + source_path;
+        } else if (!write(temp_path, *database, mErrMsg)) {
+            ::unlink(temp_path.c_str());
+        } else if (std::rename(temp_path.c_str(), segment_path.c_str()) != 0) {
+            ::unlink(temp_path.c_str());
+            mErrMsg = "Unable to publish shared EnTAP database to: " + segment_path;
+        } else {
+            ret = attach_shared(segment_path);
+        }
+    }
+
+    flock(lock_fd, LOCK_UN);
+    ::close(lock_fd);
+    return ret;
+}
+
+/**
+ * ======================================================================
+ * Function std::string MappedDatabase::get_shared_path(const std::string &source_path)
+ *
+ * Description          - Returns shared memory segment path of a database
+ *
+ * Notes                - Identity is device, inode, size, and modification
+ *                        time of the source file
+ *
+ * @param source_path   - Path to serialized EnTAP database
+ *
+ * @return              - Segment path, empty if source is not accessible
+ *
+ * =====================================================================
+ */
+std::string MappedDatabase::get_shared_path(const std::string &source_path) {
+    struct stat file_stat;
+    std::string identity;
+    char        hash_str[17];
+
+    if (stat(source_path.c_str(), &file_stat) != 0) return "";
+
+    identity = std::to_string((uint64) file_stat.st_dev) + ":" + std::to_string((uint64) file_stat.st_ino) + ":" +
+               std::to_string((uint64) file_stat.st_size) + ":" + std::to_string((uint64) file_stat.st_mtime);
+    snprintf(hash_str, sizeof(hash_str), "%016llx", (unsigned long long) hash_key(identity));
+    return PATHS(SHARED_MEMORY_DIR, SHARED_SEGMENT_PREFIX + std::string(hash_str) + "_v" +
+                                    std::to_string(FORMAT_VERSION));
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::attach_shared(const std::string &segment_path)
+ *
+ * Description          - Takes a reference (shared lock) on a published
+ *                        segment and maps it
+ *
+ * Notes                - Fails if the segment was removed by its last user
+ *                        while attaching
+ *
+ * @param segment_path  - Shared memory segment path
+ *
+ * @return              - TRUE if attached
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::attach_shared(const std::string &segment_path) {
+    int         fd;
+    struct stat fd_stat;
+    struct stat path_stat;
+
+    fd = ::open(segment_path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    if (flock(fd, LOCK_SH) != 0 || fstat(fd, &fd_stat) != 0 || stat(segment_path.c_str(), &path_stat) != 0 ||
+        fd_stat.st_ino != path_stat.st_ino || fd_stat.st_dev != path_stat.st_dev) {
+        ::close(fd);
+        return false;
+    }
+    if (!open(segment_path)) {
+        ::close(fd);
+        return false;
+    }
+    mSharedFd   = fd;
+    mSharedPath = segment_path;
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function void MappedDatabase::release_shared()
+ *
+ * Description          - Drops this process's reference on the shared
+ *                        segment, removing the segment if it was the last
+ *
+ * Notes                - Holds the publishing lock so a segment being
+ *                        republished is never removed
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void MappedDatabase::release_shared() {
+    int         lock_fd;
+    struct stat fd_stat;
+    struct stat path_stat;
+
+    if (mSharedFd < 0) return;
+
+    lock_fd = ::open((mSharedPath + ".lock").c_str(), O_RDWR | O_CREAT, 0666);
+    if (lock_fd >= 0) flock(lock_fd, LOCK_EX);
+
+    // Exclusive lock is only granted once no other process holds a reference
+    if (flock(mSharedFd, LOCK_EX | LOCK_NB) == 0 &&
+        fstat(mSharedFd, &fd_stat) == 0 && stat(mSharedPath.c_str(), &path_stat) == 0 &&
+        fd_stat.st_ino == path_stat.st_ino && fd_stat.st_dev == path_stat.st_dev) {
+        FS_dprint("Last user of shared EnTAP database, removing: " + mSharedPath);
+        ::unlink(mSharedPath.c_str());
+    }
+    ::close(mSharedFd);
+    mSharedFd = -1;
+    mSharedPath.clear();
+
+    if (lock_fd >= 0) {
+        flock(lock_fd, LOCK_UN);
+        ::close(lock_fd);
+    }
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::set_section(SECTION_TYPE type, uint32 field_count)
+ *
+ * Description          - Sets runtime pointers of a section after checking
+ *                        all of its tables lie within the file
+ *
+ * Notes                - Absent sections are valid, lookups will not find
+ *                        anything
+ *
+ * @param type          - Section to set
+ * @param field_count   - Expected strings per record
+ *
+ * @return              - FALSE if section is corrupt
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::set_section(SECTION_TYPE type, uint32 field_count) {
+    const SectionEntry  &entry = ((const FileHeader*) mpData)->sections[type];
+    const SectionHeader *header;
+    Section             &section = mSections[type];
+
+    section = {};
+    if (entry.offset == 0) return true;
+
+    if (entry.offset % FILE_ALIGNMENT != 0 || entry.offset > mDataSize ||
+        entry.size > mDataSize - entry.offset || entry.size < sizeof(SectionHeader)) {
+        return false;
+    }
+    header = (const SectionHeader*) (mpData + entry.offset);
+    if (header->field_count != field_count ||
+        (header->record_count > 0 && header->bucket_count == 0) ||
+        header->seeds_offset > entry.size ||
+        header->bucket_count > (entry.size - header->seeds_offset) / sizeof(uint32) ||
+        header->records_offset > entry.size ||
+        header->record_count > (entry.size - header->records_offset) / (sizeof(StringRef) * field_count) ||
+        header->pool_offset > entry.size ||
+        header->pool_size > entry.size - header->pool_offset) {
+        return false;
+    }
+
+    section.header  = header;
+    section.seeds   = (const uint32*) (mpData + entry.offset + header->seeds_offset);
+    section.records = (const StringRef*) (mpData + entry.offset + header->records_offset);
+    section.pool    = mpData + entry.offset + header->pool_offset;
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function const StringRef *MappedDatabase::find_record(SECTION_TYPE type,
+ *                                                       const std::string &key)
+ *
+ * Description          - Finds record of key through the section perfect hash
+ *
+ * Notes                - Every key hashes to some slot, the stored key is
+ *                        compared to reject keys not in the database
+ *
+ * @param type          - Section to search
+ * @param key           - Key to find
+ *
+ * @return              - Record fields, nullptr if not found
+ *
+ * =====================================================================
+ */
+const MappedDatabase::StringRef *MappedDatabase::find_record(SECTION_TYPE type, const std::string &key) const {
+    const Section   &section = mSections[type];
+    const StringRef *record;
+    uint64           hash;
+    uint64           bucket;
+    uint64           slot;
+
+    if (section.header == nullptr || section.header->record_count == 0) return nullptr;
+
+    hash   = hash_key(key);
+    bucket = hash_seed(hash, 0) % section.header->bucket_count;
+    slot   = hash_seed(hash, section.seeds[bucket]) % section.header->record_count;
+    record = section.records + slot * section.header->field_count;
+
+    const StringRef &key_ref = record[0];
+    if (key_ref.length != key.size() || key_ref.offset > section.header->pool_size ||
+        key_ref.length > section.header->pool_size - key_ref.offset) {
+        return nullptr;
+    }
+    if (memcmp(section.pool + key_ref.offset, key.data(), key.size()) != 0) return nullptr;
+    return record;
+}
+
+std::string MappedDatabase::get_string(SECTION_TYPE type, const StringRef &ref) const {
+    const Section &section = mSections[type];
+
+    if (ref.offset > section.header->pool_size || ref.length > section.header->pool_size - ref.offset) {
+        return "";
+    }
+    return std::string(section.pool + ref.offset, ref.length);
+}
+
+bool MappedDatabase::find_tax_entry(const std::string &species, TaxEntry &entry) const {
+    const StringRef *record = find_record(SECTION_TAXONOMY, species);
+
+    if (record == nullptr) return false;
+    entry.tax_id   = get_string(SECTION_TAXONOMY, record[TAX_FIELD_ID]);
+    entry.lineage  = get_string(SECTION_TAXONOMY, record[TAX_FIELD_LINEAGE]);
+    entry.tax_name = get_string(SECTION_TAXONOMY, record[TAX_FIELD_NAME]);
+    return true;
+}
+
+bool MappedDatabase::find_go_entry(const std::string &go_id, GoEntry &entry) const {
+    const StringRef *record = find_record(SECTION_GENE_ONTOLOGY, go_id);
+
+    if (record == nullptr) return false;
+    entry.go_id    = get_string(SECTION_GENE_ONTOLOGY, record[GO_FIELD_ID]);
+    entry.level    = get_string(SECTION_GENE_ONTOLOGY, record[GO_FIELD_LEVEL]);
+    entry.category = get_string(SECTION_GENE_ONTOLOGY, record[GO_FIELD_CATEGORY]);
+    entry.term     = get_string(SECTION_GENE_ONTOLOGY, record[GO_FIELD_TERM]);
+    return true;
+}
+
+bool MappedDatabase::find_uniprot_entry(const std::string &accession, UniprotEntry &entry) const {
+    const StringRef *record = find_record(SECTION_UNIPROT, accession);
+
+    if (record == nullptr) return false;
+    entry.uniprot_id      = get_string(SECTION_UNIPROT, record[UNIPROT_FIELD_ID]);
+    entry.database_x_refs = get_string(SECTION_UNIPROT, record[UNIPROT_FIELD_XREFS]);
+    entry.comments        = get_string(SECTION_UNIPROT, record[UNIPROT_FIELD_COMMENTS]);
+    entry.kegg_terms      = get_string(SECTION_UNIPROT, record[UNIPROT_FIELD_KEGG]);
+    parse_go_terms(get_string(SECTION_UNIPROT, record[UNIPROT_FIELD_GO]), entry.go_terms);
+    return true;
+}
+
+bool MappedDatabase::find_eggnog_entry(const std::string &seed_ortholog, EggnogIndexEntry &entry) const {
+    const StringRef *record = find_record(SECTION_EGGNOG, seed_ortholog);
+
+    if (record == nullptr) return false;
+    entry.member_ogs        = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_MEMBER_OGS]);
+    entry.tax_scope_lvl_max = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_TAX_LEVEL]);
+    entry.pname             = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_PNAME]);
+    entry.predicted_gene    = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_PREDICTED_GENE]);
+    entry.go                = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_GO]);
+    entry.kegg              = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_KEGG]);
+    entry.bigg              = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_BIGG]);
+    entry.og_key            = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_OG_KEY]);
+    entry.description       = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_DESCRIPTION]);
+    entry.protein_domains   = get_string(SECTION_EGGNOG, record[EGGNOG_FIELD_PROTEIN_DOMAINS]);
+    return true;
+}
+
+bool MappedDatabase::find_subject_entry(const std::string &sseqid, SubjectIndexEntry &entry) const {
+    const StringRef *record = find_record(SECTION_SUBJECT, sseqid);
+
+    if (record == nullptr) return false;
+    entry.title       = get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_TITLE]);
+    entry.accession   = get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_ACCESSION]);
+    entry.species     = get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_SPECIES]);
+    entry.lineage     = get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_LINEAGE]);
+    entry.contam_mask = std::strtoull(get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_CONTAM_MASK]).c_str(),
+                                      nullptr, 10);
+    entry.informative = get_string(SECTION_SUBJECT, record[SUBJECT_FIELD_INFORMATIVE]) == "1";
+    return true;
+}
+
+bool MappedDatabase::find_subject_info(const std::string &key, std::string &value) const {
+    const StringRef *record = find_record(SECTION_SUBJECT_INFO, key);
+
+    if (record == nullptr) return false;
+    value = get_string(SECTION_SUBJECT_INFO, record[SUBJECT_INFO_FIELD_VALUE]);
+    return true;
+}
+
+uint64 MappedDatabase::get_subject_count() const {
+    if (mSections[SECTION_SUBJECT].header == nullptr) return 0;
+    return mSections[SECTION_SUBJECT].header->record_count;
+}
+
+/**
+ * ======================================================================
+ * Function void MappedDatabase::get_go_parents(GoGraph::parent_map_t &parents)
+ *
+ * Description          - Reads direct parents of every GO term so the
+ *                        Gene Ontology graph can be built
+ *
+ * Notes                - Walks every record of the section, only needed
+ *                        once per run
+ *
+ * @param parents       - Set to GO ID to direct parent GO IDs
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void MappedDatabase::get_go_parents(GoGraph::parent_map_t &parents) const {
+    const Section &section = mSections[SECTION_GO_GRAPH];
+    const StringRef *record;
+
+    parents.clear();
+    if (section.header == nullptr) return;
+
+    parents.reserve(section.header->record_count);
+    for (uint64 slot = 0; slot < section.header->record_count; slot++) {
+        record = section.records + slot * section.header->field_count;
+        parents[get_string(SECTION_GO_GRAPH, record[GO_GRAPH_FIELD_KEY])] =
+                split_string(get_string(SECTION_GO_GRAPH, record[GO_GRAPH_FIELD_PARENTS]), GO_PARENT_DELIM);
+    }
+}
+
+uint8 MappedDatabase::get_major_version() const {
+    if (mpData == nullptr) return 0;
+    return ((const FileHeader*) mpData)->major_version;
+}
+
+uint8 MappedDatabase::get_minor_version() const {
+    if (mpData == nullptr) return 0;
+    return ((const FileHeader*) mpData)->minor_version;
+}
+
+std::string MappedDatabase::get_error() const {
+    return mErrMsg;
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::write(const std::string &path,
+ *                      const EntapDatabase::EntapDatabaseStruct &database,
+ *                      std::string &err_msg)
+ *
+ * Description          - Writes contents of a serialized EnTAP database in
+ *                        the mapped format
+ *
+ * Notes                - Output only depends on database contents, not on
+ *                        map iteration order
+ *
+ * @param path          - Output path
+ * @param database      - Database contents
+ * @param err_msg       - Set on failure
+ *
+ * @return              - TRUE if database was written
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::write(const std::string &path, const EntapDatabase::EntapDatabaseStruct &database,
+                           std::string &err_msg) {
+    FileHeader     header;
+    section_data_t data;
+    vect_str_t     go_strings;      // Formatted UniProt GO terms, reserved so pointers are stable
+    vect_str_t     parent_strings;  // Formatted GO graph parents, reserved so pointers are stable
+    const GoGraph &go_graph = database.go_graph;
+
+    FS_dprint("Writing mapped EnTAP database to: " + path);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        err_msg = "Unable to open mapped EnTAP database for writing at: " + path;
+        return false;
+    }
+
+    header = {};
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.major_version  = database.MAJOR_VERSION;
+    header.minor_version  = database.MINOR_VERSION;
+    header.section_count  = SECTION_MAX;
+    file.write((const char*) &header, sizeof(header));     // Rewritten once sections are placed
+    write_padding(file);
+
+    FS_dprint("Writing taxonomy section...");
+    data.reserve(database.taxonomic_data.size());
+    for (const auto &pair : database.taxonomic_data) {
+        data.push_back({&pair.first, &pair.second.tax_id, &pair.second.lineage, &pair.second.tax_name});
+    }
+    if (!write_section(file, data, TAX_FIELD_COUNT, header.sections[SECTION_TAXONOMY], err_msg)) {
+        err_msg = "Unable to write taxonomy section of mapped EnTAP database: " + err_msg;
+        return false;
+    }
+
+    FS_dprint("Writing Gene Ontology section...");
+    data.clear();
+    data.reserve(database.gene_ontology_data.size());
+    for (const auto &pair : database.gene_ontology_data) {
+        data.push_back({&pair.first, &pair.second.go_id, &pair.second.level, &pair.second.category,
+                        &pair.second.term});
+    }
+    if (!write_section(file, data, GO_FIELD_COUNT, header.sections[SECTION_GENE_ONTOLOGY], err_msg)) {
+        err_msg = "Unable to write Gene Ontology section of mapped EnTAP database: " + err_msg;
+        return false;
+    }
+
+    FS_dprint("Writing UniProt section...");
+    data.clear();
+    data.reserve(database.uniprot_data.size());
+    go_strings.reserve(database.uniprot_data.size());
+    for (const auto &pair : database.uniprot_data) {
+        go_strings.push_back(format_go_terms(pair.second.go_terms));
+        data.push_back({&pair.first, &pair.second.uniprot_id, &pair.second.database_x_refs,
+                        &pair.second.comments, &pair.second.kegg_terms, &go_strings.back()});
+    }
+    if (!write_section(file, data, UNIPROT_FIELD_COUNT, header.sections[SECTION_UNIPROT], err_msg)) {
+        err_msg = "Unable to write UniProt section of mapped EnTAP database: " + err_msg;
+        return false;
+    }
+
+    FS_dprint("Writing Gene Ontology graph section...");
+    data.clear();
+    data.reserve(go_graph.size());
+    parent_strings.reserve(go_graph.size());
+    for (GoGraph::node_t node = 0; node < go_graph.size(); node++) {
+        if (go_graph.parents_begin(node) == go_graph.parents_end(node)) continue;   // Roots
+        parent_strings.emplace_back();
+        for (const GoGraph::node_t *parent = go_graph.parents_begin(node); parent != go_graph.parents_end(node); parent++) {
+            if (!parent_strings.back().empty()) parent_strings.back() += GO_PARENT_DELIM;
+            parent_strings.back() += go_graph.get_go_id(*parent);
+        }
+        data.push_back({&go_graph.get_go_id(node), &parent_strings.back()});
+    }
+    if (!write_section(file, data, GO_GRAPH_FIELD_COUNT, header.sections[SECTION_GO_GRAPH], err_msg)) {
+        err_msg = "Unable to write Gene Ontology graph section of mapped EnTAP database: " + err_msg;
+        return false;
+    }
+
+    file.seekp(0);
+    file.write((const char*) &header, sizeof(header));
+    file.close();
+    if (file.fail()) {
+        err_msg = "Error writing mapped EnTAP database to: " + path;
+        return false;
+    }
+    FS_dprint("Success! Mapped EnTAP database written to: " + path);
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::write_eggnog_index(const std::string &path,
+ *                      const section_data_t &records, std::string &err_msg)
+ *
+ * Description          - Writes a precompiled EggNOG annotation index, a
+ *                        mapped database with only the EggNOG section
+ *
+ * Notes                - Records follow EGGNOG_FIELDS. Fields pointing to
+ *                        the same string are stored once, so builders
+ *                        should pass one pointer per distinct value
+ *
+ * @param path          - Output path
+ * @param records       - Resolved annotations of each seed ortholog
+ * @param err_msg       - Set on failure
+ *
+ * @return              - TRUE if index was written
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::write_eggnog_index(const std::string &path, const section_data_t &records,
+                                        std::string &err_msg) {
+    FileHeader header;
+
+    FS_dprint("Writing EggNOG index with " + std::to_string(records.size()) + " seed orthologs to: " + path);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        err_msg = "Unable to open EggNOG index for writing at: " + path;
+        return false;
+    }
+
+    header = {};
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.section_count  = SECTION_MAX;
+    file.write((const char*) &header, sizeof(header));     // Rewritten once section is placed
+    write_padding(file);
+
+    if (!write_section(file, records, EGGNOG_FIELD_COUNT, header.sections[SECTION_EGGNOG], err_msg, true)) {
+        err_msg = "Unable to write EggNOG section of index: " + err_msg;
+        return false;
+    }
+
+    file.seekp(0);
+    file.write((const char*) &header, sizeof(header));
+    file.close();
+    if (file.fail()) {
+        err_msg = "Error writing EggNOG index to: " + path;
+        return false;
+    }
+    FS_dprint("Success! EggNOG index written to: " + path);
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::write_subject_index(const std::string &path,
+ *                      const section_data_t &subjects, const section_data_t &info,
+ *                      std::string &err_msg)
+ *
+ * Description          - Writes a DIAMOND subject index, a mapped database
+ *                        with only the subject and subject info sections
+ *
+ * Notes                - Records follow SUBJECT_FIELDS and SUBJECT_INFO_FIELDS.
+ *                        Fields pointing to the same string are stored once,
+ *                        so species, lineages, and statuses should be passed
+ *                        as one pointer per distinct value
+ *
+ * @param path          - Output path
+ * @param subjects      - Resolved metadata of each subject
+ * @param info          - Index wide settings by name
+ * @param err_msg       - Set on failure
+ *
+ * @return              - TRUE if index was written
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::write_subject_index(const std::string &path, const section_data_t &subjects,
+                                         const section_data_t &info, std::string &err_msg) {
+    FileHeader header;
+
+    FS_dprint("Writing subject index with " + std::to_string(subjects.size()) + " subjects to: " + path);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        err_msg = "Unable to open subject index for writing at: " + path;
+        return false;
+    }
+
+    header = {};
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.section_count  = SECTION_MAX;
+    file.write((const char*) &header, sizeof(header));     // Rewritten once sections are placed
+    write_padding(file);
+
+    if (!write_section(file, subjects, SUBJECT_FIELD_COUNT, header.sections[SECTION_SUBJECT], err_msg, true)) {
+        err_msg = "Unable to write subject section of index: " + err_msg;
+        return false;
+    }
+    if (!write_section(file, info, SUBJECT_INFO_FIELD_COUNT, header.sections[SECTION_SUBJECT_INFO], err_msg)) {
+        err_msg = "Unable to write subject info section of index: " + err_msg;
+        return false;
+    }
+
+    file.seekp(0);
+    file.write((const char*) &header, sizeof(header));
+    file.close();
+    if (file.fail()) {
+        err_msg = "Error writing subject index to: " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::write_section(std::ofstream &file, const section_data_t &data,
+ *                                             uint32 field_count, SectionEntry &entry,
+ *                                             std::string &err_msg, bool share_strings)
+ *
+ * Description          - Writes section header, hash seeds, records (in hash
+ *                        slot order), and string pool at the end of file
+ *
+ * Notes                - Fields equal to the key reference the key string
+ *                      - With share_strings, fields pointing to the same
+ *                        string reference a single pool copy
+ *
+ * @param file          - Output file, positioned at an aligned offset
+ * @param data          - Records of section
+ * @param field_count   - Strings per record
+ * @param entry         - Set to section location in file
+ * @param err_msg       - Set on failure
+ * @param share_strings - Pool each distinct string pointer once
+ *
+ * @return              - TRUE if section was written
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::write_section(std::ofstream &file, const section_data_t &data, uint32 field_count,
+                                   SectionEntry &entry, std::string &err_msg, bool share_strings) {
+    SectionHeader          header;
+    std::vector<uint32>    seeds;
+    std::vector<uint64>    slots;          // Key index to hash slot
+    std::vector<uint64>    slot_keys;      // Hash slot to key index
+    std::vector<StringRef> records;
+    std::vector<const std::string*> pool;  // Strings in pool order
+    std::unordered_map<const std::string*, StringRef> pooled;  // Shared strings already in pool
+    uint64                 record_count = data.size();
+
+    header = {};
+    header.record_count = record_count;
+    header.bucket_count = std::max((uint64) 1, (record_count + BUCKET_KEYS - 1) / BUCKET_KEYS);
+    header.field_count  = field_count;
+
+    if (!build_hash(data, header.bucket_count, seeds, slots, err_msg)) {
+        FS_dprint("ERROR unable to build perfect hash for section: " + err_msg);
+        return false;
+    }
+    slot_keys.resize(record_count);
+    for (uint64 i = 0; i < record_count; i++) {
+        slot_keys[slots[i]] = i;
+    }
+
+    // Pool is laid out in slot order
+    records.resize(record_count * field_count);
+    for (uint64 slot = 0; slot < record_count; slot++) {
+        const std::vector<const std::string*> &fields = data[slot_keys[slot]];
+        StringRef *record = &records[slot * field_count];
+        for (uint32 f = 0; f < field_count; f++) {
+            if (f > 0 && *fields[f] == *fields[0]) {
+                record[f] = record[0];
+                continue;
+            }
+            if (share_strings) {
+                std::unordered_map<const std::string*, StringRef>::iterator it = pooled.find(fields[f]);
+                if (it != pooled.end()) {
+                    record[f] = it->second;
+                    continue;
+                }
+            }
+            record[f].offset = header.pool_size;
+            record[f].length = fields[f]->size();
+            header.pool_size += fields[f]->size();
+            pool.push_back(fields[f]);
+            if (share_strings) pooled.emplace(fields[f], record[f]);
+        }
+    }
+    pooled.clear();
+
+    header.seeds_offset   = sizeof(SectionHeader);
+    header.records_offset = header.seeds_offset + seeds.size() * sizeof(uint32);
+    header.records_offset = (header.records_offset + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+    header.pool_offset    = header.records_offset + records.size() * sizeof(StringRef);
+
+    entry.offset = (uint64) file.tellp();
+    file.write((const char*) &header, sizeof(header));
+    file.write((const char*) seeds.data(), seeds.size() * sizeof(uint32));
+    write_padding(file);
+    file.write((const char*) records.data(), records.size() * sizeof(StringRef));
+    for (const std::string *str : pool) {
+        file.write(str->data(), str->size());
+    }
+    write_padding(file);
+    entry.size = (uint64) file.tellp() - entry.offset;
+    if (file.fail()) {
+        err_msg = "Unable to write section data";
+        return false;
+    }
+    return true;
+}
+
+void MappedDatabase::write_padding(std::ofstream &file) {
+    static const char zeros[FILE_ALIGNMENT] = {};
+    uint64 pos = (uint64) file.tellp();
+
+    if (pos % FILE_ALIGNMENT != 0) {
+        file.write(zeros, FILE_ALIGNMENT - pos % FILE_ALIGNMENT);
+    }
+}
+
+/**
+ * ======================================================================
+ * Function bool MappedDatabase::build_hash(const section_data_t &data, uint64 bucket_count,
+ *                                          std::vector<uint32> &seeds,
+ *                                          std::vector<uint64> &slots, std::string &err_msg)
+ *
+ * Description          - Builds a minimal perfect hash of section keys
+ *                        (hash and displace)
+ *                      - Keys are split into buckets, then the largest
+ *                        buckets first search for a seed placing all of their
+ *                        keys in free slots
+ *
+ * Notes                - Lookup: slot = H(key, seeds[H(key, 0) % buckets]) % keys
+ *                      - Keys with the same 64 bit hash can never be split
+ *                        by a seed, they are rejected before seeding
+ *
+ * @param data          - Records of section, key first
+ * @param bucket_count  - Number of hash buckets
+ * @param seeds         - Seed of each bucket
+ * @param slots         - Slot of each key
+ * @param err_msg       - Set on failure
+ *
+ * @return              - FALSE if a bucket could not be placed or two keys
+ *                        share a hash
+ *
+ * =====================================================================
+ */
+bool MappedDatabase::build_hash(const section_data_t &data, uint64 bucket_count,
+                                std::vector<uint32> &seeds, std::vector<uint64> &slots, std::string &err_msg) {
+    uint64                           record_count = data.size();
+    std::vector<uint64>              hashes(record_count);
+    std::vector<std::vector<uint64>> buckets(bucket_count);
+    std::vector<uint64>              bucket_order(bucket_count);
+    std::vector<bool>                taken(record_count, false);
+    std::vector<uint64>              bucket_slots;
+    uint32                           seed;
+    bool                             placed;
+
+    seeds.assign(bucket_count, 0);
+    slots.assign(record_count, 0);
+
+    for (uint64 i = 0; i < record_count; i++) {
+        hashes[i] = hash_key(*data[i][0]);
+        buckets[hash_seed(hashes[i], 0) % bucket_count].push_back(i);
+    }
+    // Equal hashes land in the same bucket, check there before spending seed attempts
+    for (const std::vector<uint64> &keys : buckets) {
+        for (uint64 i = 0; i < keys.size(); i++) {
+            for (uint64 j = i + 1; j < keys.size(); j++) {
+                if (hashes[keys[i]] != hashes[keys[j]]) continue;
+                err_msg = "Keys share a hash and cannot be indexed: '" + *data[keys[i]][0] +
+                          "' and '" + *data[keys[j]][0] + "'";
+                return false;
+            }
+        }
+    }
+    for (uint64 b = 0; b < bucket_count; b++) bucket_order[b] = b;
+    std::stable_sort(bucket_order.begin(), bucket_order.end(), [&buckets](uint64 a, uint64 b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    for (uint64 b : bucket_order) {
+        const std::vector<uint64> &keys = buckets[b];
+        if (keys.empty()) break;        // Sorted, rest are empty
+
+        placed = false;
+        for (seed = 1; seed < MAX_SEED_ATTEMPTS && !placed; seed++) {
+            bucket_slots.clear();
+            placed = true;
+            for (uint64 key : keys) {
+                uint64 slot = hash_seed(hashes[key], seed) % record_count;
+                if (taken[slot] ||
+                    std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+                    placed = false;
+                    break;
+                }
+                bucket_slots.push_back(slot);
+            }
+        }
+        if (!placed) {
+            err_msg = "No seed places hash bucket of key: " + *data[keys[0]][0];
+            return false;
+        }
+
+        seeds[b] = seed - 1;
+        for (uint64 i = 0; i < keys.size(); i++) {
+            taken[bucket_slots[i]] = true;
+            slots[keys[i]] = bucket_slots[i];
+        }
+    }
+    return true;
+}
+
+// FNV-1a
+uint64 MappedDatabase::hash_key(const std::string &key) {
+    uint64 hash = 0xcbf29ce484222325ULL;
+
+    for (char c : key) {
+        hash ^= (uint8) c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// splitmix64 finalizer, mixes seed into the key hash
+uint64 MappedDatabase::hash_seed(uint64 hash, uint32 seed) {
+    uint64 z = hash + (uint64) seed * 0x9e3779b97f4a7c15ULL;
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::string MappedDatabase::format_go_terms(const go_format_t &go_terms) {
+    std::string out;
+
+    for (const auto &pair : go_terms) {
+        out += pair.first;
+        for (const std::string &term : pair.second) {
+            out += GO_TERM_DELIM;
+            out += term;
+        }
+        out += GO_CATEGORY_DELIM;
+    }
+    return out;
+}
+
+void MappedDatabase::parse_go_terms(const std::string &str, go_format_t &go_terms) {
+    std::string line;
+    std::string field;
+
+    go_terms.clear();
+    std::istringstream lines(str);
+    while (std::getline(lines, line, GO_CATEGORY_DELIM)) {
+        std::istringstream fields(line);
+        std::getline(fields, field, GO_TERM_DELIM);
+        std::vector<std::string> &terms = go_terms[field];
+        while (std::getline(fields, field, GO_TERM_DELIM)) {
+            terms.push_back(field);
+        }
+    }
+}
@@ -0,0 +1,282 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_MAPPEDDATABASE_H
+#define ENTAP_MAPPEDDATABASE_H
+
+#include <functional>
+#include "../common.h"
+#include "EntapDatabase.h"
+
+// Annotations resolved for an EggNOG seed ortholog, GO terms are not interned
+struct EggnogIndexEntry {
+    std::string member_ogs;         // 0A01R@biNOG,0V8CP@meNOG
+    std::string tax_scope_lvl_max;  // virNOG[6], empty if no level matched
+    std::string pname;
+    std::string predicted_gene;
+    std::string go;                 // Comma separated GO IDs
+    std::string kegg;
+    std::string bigg;
+    std::string og_key;
+    std::string description;
+    std::string protein_domains;
+};
+
+// Metadata of a DIAMOND database subject, resolved when the database was configured
+struct SubjectIndexEntry {
+    std::string title;
+    std::string accession;          // UniProt accession, empty if not UniProt
+    std::string species;
+    std::string lineage;
+    uint64      contam_mask;        // Bit per contaminant term the lineage falls under
+    bool        informative;
+};
+
+/**
+ * ======================================================================
+ * @class MappedDatabase
+ *
+ * Description          - Read only EnTAP database designed to be memory
+ *                        mapped rather than deserialized
+ *                      - Taxonomy, Gene Ontology, UniProt, and Gene Ontology
+ *                        graph (direct parents of each term) data are kept
+ *                        in independent sections, each with a minimal
+ *                        perfect hash index, fixed size records, and a
+ *                        string pool referenced by offset
+ *                      - Opening only maps the file, pages are read when a
+ *                        lookup touches them and are shared between runs
+ *                        through the page cache
+ *
+ * Notes                - Generated from the serialized database contents
+ *                        (EntapDatabaseStruct)
+ *                      - Can be published to shared memory so concurrent
+ *                        runs on a node attach to a single copy (open_shared)
+ *                      - Lookups are const and thread safe
+ *                      - Also used for the precompiled EggNOG annotation
+ *                        index, a file holding only the EggNOG section, and
+ *                        for DIAMOND subject indexes (subject and subject
+ *                        info sections)
+ *
+ * ======================================================================
+ */
+class MappedDatabase {
+
+public:
+    MappedDatabase();
+    ~MappedDatabase();
+
+    typedef std::function<const EntapDatabase::EntapDatabaseStruct*()> database_loader_t;
+    typedef std::vector<std::vector<const std::string*>> section_data_t;  // Record fields, key first
+
+    // Field order of EggNOG index records
+    typedef enum {
+        EGGNOG_FIELD_KEY=0,             // Seed ortholog
+        EGGNOG_FIELD_MEMBER_OGS,
+        EGGNOG_FIELD_TAX_LEVEL,
+        EGGNOG_FIELD_PNAME,
+        EGGNOG_FIELD_PREDICTED_GENE,
+        EGGNOG_FIELD_GO,
+        EGGNOG_FIELD_KEGG,
+        EGGNOG_FIELD_BIGG,
+        EGGNOG_FIELD_OG_KEY,
+        EGGNOG_FIELD_DESCRIPTION,
+        EGGNOG_FIELD_PROTEIN_DOMAINS,
+
+        EGGNOG_FIELD_COUNT
+    } EGGNOG_FIELDS;
+
+    // Field order of subject index records
+    typedef enum {
+        SUBJECT_FIELD_KEY=0,            // sseqid
+        SUBJECT_FIELD_TITLE,
+        SUBJECT_FIELD_ACCESSION,
+        SUBJECT_FIELD_SPECIES,
+        SUBJECT_FIELD_LINEAGE,
+        SUBJECT_FIELD_CONTAM_MASK,      // Decimal
+        SUBJECT_FIELD_INFORMATIVE,      // "1" or "0"
+
+        SUBJECT_FIELD_COUNT
+    } SUBJECT_FIELDS;
+
+    // Field order of subject index info records (index wide settings by name)
+    typedef enum {
+        SUBJECT_INFO_FIELD_KEY=0,
+        SUBJECT_INFO_FIELD_VALUE,
+
+        SUBJECT_INFO_FIELD_COUNT
+    } SUBJECT_INFO_FIELDS;
+
+    bool open(const std::string &path);
+    bool open_shared(const std::string &source_path, const database_loader_t &load_database);
+    void close();
+    bool find_tax_entry(const std::string &species, TaxEntry &entry) const;
+    bool find_go_entry(const std::string &go_id, GoEntry &entry) const;
+    bool find_uniprot_entry(const std::string &accession, UniprotEntry &entry) const;
+    bool find_eggnog_entry(const std::string &seed_ortholog, EggnogIndexEntry &entry) const;
+    bool find_subject_entry(const std::string &sseqid, SubjectIndexEntry &entry) const;
+    bool find_subject_info(const std::string &key, std::string &value) const;
+    uint64 get_subject_count() const;
+    void get_go_parents(GoGraph::parent_map_t &parents) const;
+    uint8 get_major_version() const;
+    uint8 get_minor_version() const;
+    std::string get_error() const;
+
+    static bool write(const std::string &path, const EntapDatabase::EntapDatabaseStruct &database,
+                      std::string &err_msg);
+    static bool write_eggnog_index(const std::string &path, const section_data_t &records, std::string &err_msg);
+    static bool write_subject_index(const std::string &path, const section_data_t &subjects,
+                                    const section_data_t &info, std::string &err_msg);
+
+private:
+    typedef enum {
+        SECTION_TAXONOMY=0,
+        SECTION_GENE_ONTOLOGY,
+        SECTION_UNIPROT,
+        SECTION_GO_GRAPH,
+        SECTION_EGGNOG,
+        SECTION_SUBJECT,
+        SECTION_SUBJECT_INFO,
+
+        SECTION_MAX
+    } SECTION_TYPE;
+
+    // Field order of each section record, key is always first
+    typedef enum {
+        TAX_FIELD_KEY=0,
+        TAX_FIELD_ID,
+        TAX_FIELD_LINEAGE,
+        TAX_FIELD_NAME,
+
+        TAX_FIELD_COUNT
+    } TAX_FIELDS;
+
+    typedef enum {
+        GO_FIELD_KEY=0,
+        GO_FIELD_ID,
+        GO_FIELD_LEVEL,
+        GO_FIELD_CATEGORY,
+        GO_FIELD_TERM,
+
+        GO_FIELD_COUNT
+    } GO_FIELDS;
+
+    typedef enum {
+        UNIPROT_FIELD_KEY=0,
+        UNIPROT_FIELD_ID,
+        UNIPROT_FIELD_XREFS,
+        UNIPROT_FIELD_COMMENTS,
+        UNIPROT_FIELD_KEGG,
+        UNIPROT_FIELD_GO,
+
+        UNIPROT_FIELD_COUNT
+    } UNIPROT_FIELDS;
+
+    typedef enum {
+        GO_GRAPH_FIELD_KEY=0,
+        GO_GRAPH_FIELD_PARENTS,
+
+        GO_GRAPH_FIELD_COUNT
+    } GO_GRAPH_FIELDS;
+
+    // On disk layout, all offsets 8 byte aligned
+    struct SectionEntry {
+        uint64 offset;          // From start of file, 0 if section is absent
+        uint64 size;
+    };
+
+    struct FileHeader {
+        char         magic[8];
+        uint32       format_version;
+        uint8        major_version;     // EnTAP database version of contents
+        uint8        minor_version;
+        uint16       section_count;
+        SectionEntry sections[SECTION_MAX];
+    };
+
+    struct SectionHeader {
+        uint64 record_count;
+        uint64 bucket_count;
+        uint32 field_count;
+        uint32 reserved;
+        uint64 seeds_offset;    // From section start, uint32 displacement seed per bucket
+        uint64 records_offset;  // From section start, StringRef[field_count] per hash slot
+        uint64 pool_offset;     // From section start
+        uint64 pool_size;
+    };
+
+    struct StringRef {
+        uint64 offset;          // Into section string pool
+        uint64 length;
+    };
+
+    // Runtime view of a mapped section
+    struct Section {
+        const SectionHeader *header;
+        const uint32        *seeds;
+        const StringRef     *records;
+        const char          *pool;
+    };
+
+    static uint64 hash_key(const std::string &key);
+    static uint64 hash_seed(uint64 hash, uint32 seed);
+    static bool build_hash(const section_data_t &data, uint64 bucket_count,
+                           std::vector<uint32> &seeds, std::vector<uint64> &slots, std::string &err_msg);
+    static bool write_section(std::ofstream &file, const section_data_t &data, uint32 field_count,
+                              SectionEntry &entry, std::string &err_msg, bool share_strings=false);
+    static void write_padding(std::ofstream &file);
+    static std::string format_go_terms(const go_format_t &go_terms);
+    static void parse_go_terms(const std::string &str, go_format_t &go_terms);
+
+    static std::string get_shared_path(const std::string &source_path);
+    bool attach_shared(const std::string &segment_path);
+    void release_shared();
+    bool set_section(SECTION_TYPE type, uint32 field_count);
+    const StringRef *find_record(SECTION_TYPE type, const std::string &key) const;
+    std::string get_string(SECTION_TYPE type, const StringRef &ref) const;
+
+    static constexpr uint32 FORMAT_VERSION    = 4;      // 2: Gene Ontology graph section, 3: EggNOG section, 4: Subject sections
+    static constexpr uint64 BUCKET_KEYS       = 4;      // Average keys per hash bucket
+    static constexpr uint32 MAX_SEED_ATTEMPTS = 1u << 30;
+    static constexpr uint64 FILE_ALIGNMENT    = 8;
+    static constexpr char   GO_CATEGORY_DELIM = '\n';
+    static constexpr char   GO_TERM_DELIM     = '\t';
+    static constexpr char   GO_PARENT_DELIM   = ',';
+    static const char       FILE_MAGIC[8];
+    static const std::string SHARED_MEMORY_DIR;     // tmpfs backed, pages live in shared memory
+    static const std::string SHARED_SEGMENT_PREFIX;
+
+    const char  *mpData;
+    uint64       mDataSize;
+    int          mSharedFd;         // Holds shared lock (reference) on segment, -1 if not shared
+    std::string  mSharedPath;
+    Section      mSections[SECTION_MAX];
+    std::string  mErrMsg;
+};
+
+
+#endif //ENTAP_MAPPEDDATABASE_H
@@ -32,6 +32,8 @@
 #include "../EntapGlobals.h"
 //**************************************************************
 
+constexpr int64 SQLDatabaseHelper::DEFAULT_MMAP_SIZE;
+constexpr int64 SQLDatabaseHelper::DEFAULT_CACHE_SIZE;
 
 /**
  * ======================================================================
@@ -61,6 +63,51 @@ bool SQLDatabaseHelper::open(std::string file) {
 }
 
 
+/**
+ * ======================================================================
+ * Function bool SQLDatabaseHelper::open_read_only(const std::string &file,
+ *                                                 int64 mmap_size, int64 cache_size,
+ *                                                 bool no_mutex)
+ *
+ * Description          - Opens an existing SQL database for lookups only
+ *                      - Database file is memory mapped (up to mmap_size bytes)
+ *                        and page cache sized to cache_size KB
+ *                      - query_only is set so any stray write fails rather than
+ *                        touching the database
+ *
+ * Notes                - Database will not be created if it does not exist
+ *
+ * @param file          - Path to database
+ * @param mmap_size     - Max bytes of database to memory map (0 disables)
+ * @param cache_size    - Page cache size in KB
+ * @param no_mutex      - TRUE if the connection is only used by one thread,
+ *                        sqlite then skips its connection mutex
+ *
+ * @return              - True/false if successful
+ *
+ * =====================================================================
+ */
+bool SQLDatabaseHelper::open_read_only(const std::string &file, int64 mmap_size, int64 cache_size, bool no_mutex) {
+    FS_dprint("Opening SQL database (read only) at: " + file);
+    int err_code;
+    int flags = SQLITE_OPEN_READONLY;
+    std::string pragma;
+
+    if (no_mutex) flags |= SQLITE_OPEN_NOMUTEX;
+    err_code = sqlite3_open_v2(file.c_str(), &mpDatabase, flags, NULL);
+    if (err_code == SQLITE_OK) {
+        pragma = "PRAGMA mmap_size = " + std::to_string(mmap_size);
+        sqlite3_exec(mpDatabase, pragma.c_str(), NULL, NULL, NULL);
+        // Negative cache size is interpreted by sqlite as KB rather than pages
+        pragma = "PRAGMA cache_size = -" + std::to_string(cache_size);
+        sqlite3_exec(mpDatabase, pragma.c_str(), NULL, NULL, NULL);
+        sqlite3_exec(mpDatabase, "PRAGMA query_only = ON", NULL, NULL, NULL);
+        FS_dprint("Success!");
+    }
+    return err_code == SQLITE_OK;
+}
+
+
 /**
  * ======================================================================
  * Function void DatabaseHelper::close()
@@ -75,7 +122,9 @@ bool SQLDatabaseHelper::open(std::string file) {
  * =====================================================================
  */
 void SQLDatabaseHelper::close() {
+    finalize_statements();
     sqlite3_close(mpDatabase);
+    mpDatabase = NULL;
 }
 
 
@@ -151,6 +200,104 @@ std::vector<std::vector<std::string>> SQLDatabaseHelper::query(char *query) {
 }
 
 
+/**
+ * ======================================================================
+ * Function sqlite3_stmt *SQLDatabaseHelper::get_statement(const std::string &sql)
+ *
+ * Description          - Returns prepared statement for sql, preparing and
+ *                        caching it on first use
+ *
+ * Notes                - Caller must hold mStatementMutex
+ *
+ * @param sql           - SQL with '?' parameters
+ *
+ * @return              - Prepared statement owned by the cache
+ *
+ * =====================================================================
+ */
+sqlite3_stmt *SQLDatabaseHelper::get_statement(const std::string &sql) {
+    sqlite3_stmt *stmt = nullptr;
+
+    auto it = mStatements.find(sql);
+    if (it != mStatements.end()) return it->second;
+
+    if (sqlite3_prepare_v2(mpDatabase, sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+        throw ExceptionHandler("Error preparing database statement: " + std::string(sqlite3_errmsg(mpDatabase)),
+                               ERR_ENTAP_DATABASE_QUERY);
+    }
+    mStatements.emplace(sql, stmt);
+    return stmt;
+}
+
+
+void SQLDatabaseHelper::finalize_statements() {
+    std::lock_guard<std::mutex> lock(mStatementMutex);
+    for (auto &pair : mStatements) {
+        sqlite3_finalize(pair.second);
+    }
+    mStatements.clear();
+}
+
+
+SQLDatabaseHelper::Statement::Statement(SQLDatabaseHelper *helper, const std::string &sql)
+    : mLock(helper->mStatementMutex), mpHelper(helper) {
+    mpStatement = helper->get_statement(sql);
+}
+
+
+SQLDatabaseHelper::Statement::~Statement() {
+    sqlite3_reset(mpStatement);
+    sqlite3_clear_bindings(mpStatement);
+}
+
+
+void SQLDatabaseHelper::Statement::bind(int index, const std::string &val) {
+    sqlite3_bind_text(mpStatement, index, val.c_str(), (int)val.size(), SQLITE_TRANSIENT);
+}
+
+
+void SQLDatabaseHelper::Statement::bind(int index, int64 val) {
+    sqlite3_bind_int64(mpStatement, index, val);
+}
+
+
+/**
+ * ======================================================================
+ * Function bool SQLDatabaseHelper::Statement::step()
+ *
+ * Description          - Steps statement to the next result row
+ *
+ * Notes                - Throws on any sqlite error
+ *
+ * @return              - True if a row is available, false when done
+ *
+ * =====================================================================
+ */
+bool SQLDatabaseHelper::Statement::step() {
+    int stat = sqlite3_step(mpStatement);
+    if (stat == SQLITE_ROW) return true;
+    if (stat == SQLITE_DONE) return false;
+    throw ExceptionHandler("Error querying database: " + std::string(sqlite3_errmsg(mpHelper->mpDatabase)),
+                           ERR_ENTAP_DATABASE_QUERY);
+}
+
+
+std::string SQLDatabaseHelper::Statement::get_text(int column) const {
+    const char *txt = (const char*)sqlite3_column_text(mpStatement, column);
+    return txt != nullptr ? std::string(txt) : "";
+}
+
+
+int64 SQLDatabaseHelper::Statement::get_int(int column) const {
+    return sqlite3_column_int64(mpStatement, column);
+}
+
+
+int SQLDatabaseHelper::Statement::get_column_count() const {
+    return sqlite3_column_count(mpStatement);
+}
+
+
 SQLDatabaseHelper::SQLDatabaseHelper() {
     mpDatabase = NULL;
 }
@@ -179,7 +326,34 @@ bool SQLDatabaseHelper::execute_cmd(char* cmd) {
     }
 }
 
-std::string SQLDatabaseHelper::format_container(std::set<std::string> &in_cont) {
+/**
+ * ======================================================================
+ * Function bool SQLDatabaseHelper::begin_transaction()
+ *
+ * Description          - Begins a transaction, commands are not written until
+ *                        commit_transaction is called
+ *
+ * Notes                - Used to batch bulk inserts
+ *
+ * @return              - True/false if successful
+ *
+ * =====================================================================
+ */
+bool SQLDatabaseHelper::begin_transaction() {
+    return execute_cmd((char*)"BEGIN TRANSACTION;");
+}
+
+
+bool SQLDatabaseHelper::commit_transaction() {
+    return execute_cmd((char*)"COMMIT TRANSACTION;");
+}
+
+
+bool SQLDatabaseHelper::in_transaction() {
+    return mpDatabase != NULL && sqlite3_get_autocommit(mpDatabase) == 0;
+}
+
+std::string SQLDatabaseHelper::format_container(const std::set<std::string> &in_cont) {
     std::string ret = "(";
 
     if (in_cont.empty()) return "";
@@ -30,6 +30,8 @@
 #define ENTAP_DATABASEHELPER_H
 
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 #include "../common.h"
 #include "sqlite3.h"
 
@@ -39,20 +41,61 @@ class SQLDatabaseHelper {
 public:
     typedef std::vector<std::vector<std::string>> query_struct;
 
+    /**
+     * @class Statement
+     * Description - Prepared statement pulled from the helper's statement cache.
+     *               Parameters are bound by position (starting at 1) and the
+     *               statement is reset for reuse once this object is destroyed.
+     *             - Holds the helper's statement lock for its lifetime, so a caller
+     *               must not hold two Statements on the same helper at once
+     */
+    class Statement {
+    public:
+        Statement(SQLDatabaseHelper *helper, const std::string &sql);
+        ~Statement();
+        Statement(const Statement&) = delete;
+        Statement &operator=(const Statement&) = delete;
+
+        void bind(int index, const std::string &val);
+        void bind(int index, int64 val);
+        bool step();
+        std::string get_text(int column) const;
+        int64 get_int(int column) const;
+        int get_column_count() const;
+
+    private:
+        std::unique_lock<std::mutex> mLock;
+        SQLDatabaseHelper           *mpHelper;
+        sqlite3_stmt                *mpStatement;
+    };
+
+    static constexpr int64  DEFAULT_MMAP_SIZE  = 268435456;   // 256MB of file mapped for reads
+    static constexpr int64  DEFAULT_CACHE_SIZE = 65536;       // Page cache in KB
+
     SQLDatabaseHelper();
     ~SQLDatabaseHelper();
     bool open(std::string file);
+    bool open_read_only(const std::string &file, int64 mmap_size=DEFAULT_MMAP_SIZE,
+                        int64 cache_size=DEFAULT_CACHE_SIZE, bool no_mutex=false);
     bool create(std::string file);
     bool execute_cmd(char*);
+    bool begin_transaction();
+    bool commit_transaction();
+    bool in_transaction();
     void close();
     query_struct query(char* query);
 
     // change to template
-    std::string format_container(std::set<std::string> &in_cont);
+    std::string format_container(const std::set<std::string> &in_cont);
     std::string format_string(std::string& str, char delim);
 
 private:
-    sqlite3 *mpDatabase;
+    sqlite3_stmt *get_statement(const std::string &sql);
+    void finalize_statements();
+
+    sqlite3                                        *mpDatabase;
+    std::unordered_map<std::string, sqlite3_stmt*>  mStatements;    // Cached prepared statements, keyed by SQL
+    std::mutex                                      mStatementMutex;
 };
 
 
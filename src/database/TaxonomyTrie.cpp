@@ -0,0 +1,183 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <cstring>
+#include <queue>
+#include "TaxonomyTrie.h"
+#include "../FileSystem.h"
+
+constexpr uint64 TaxonomyTrie::PREFIX_NOT_FOUND;
+constexpr TaxonomyTrie::node_t TaxonomyTrie::ROOT_NODE;
+
+/**
+ * ======================================================================
+ * Function void TaxonomyTrie::build(const vect_str_t &names)
+ *
+ * Description          - Builds trie from the taxonomy names
+ *                      - Names are converted to word ID sequences and
+ *                        sorted, every node is then a range of sequences
+ *                        sharing a prefix, split into children breadth first
+ *
+ * Notes                - Names must be lowercase, as in the database
+ *
+ * @param names         - Taxonomy names
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void TaxonomyTrie::build(const vect_str_t &names) {
+    struct NodeRange {
+        uint64 start;       // Into sorted sequences
+        uint64 end;
+        uint64 depth;       // Words matched
+    };
+    std::vector<std::vector<word_t>> sequences;
+    std::queue<NodeRange>            pending;
+    uint64                           start;
+    uint64                           pos;
+
+    mWords.clear();
+    mNodeWords.clear();
+    mFirstChild.clear();
+    mTerminal.clear();
+
+    for (const std::string &name : names) {
+        start = 0;
+        while ((pos = name.find(WORD_DELIM, start)) != std::string::npos) {
+            mWords.push_back(name.substr(start, pos - start));
+            start = pos + 1;
+        }
+        mWords.push_back(name.substr(start));
+    }
+    std::sort(mWords.begin(), mWords.end());
+    mWords.erase(std::unique(mWords.begin(), mWords.end()), mWords.end());
+
+    sequences.reserve(names.size());
+    for (const std::string &name : names) {
+        sequences.emplace_back();
+        start = 0;
+        while ((pos = name.find(WORD_DELIM, start)) != std::string::npos) {
+            sequences.back().push_back(find_word(name.data() + start, pos - start));
+            start = pos + 1;
+        }
+        sequences.back().push_back(find_word(name.data() + start, name.size() - start));
+    }
+    // Shorter sequences sort before their extensions, so a node's terminal names come first
+    std::sort(sequences.begin(), sequences.end());
+
+    mNodeWords.push_back(0);
+    mTerminal.push_back(0);
+    pending.push({0, sequences.size(), 0});
+    while (!pending.empty()) {
+        NodeRange range = pending.front();
+        pending.pop();
+        node_t node = (node_t) mFirstChild.size();
+        mFirstChild.push_back((node_t) mNodeWords.size());
+
+        while (range.start < range.end && sequences[range.start].size() == range.depth) {
+            mTerminal[node] = 1;
+            range.start++;
+        }
+        while (range.start < range.end) {
+            word_t word = sequences[range.start][range.depth];
+            uint64 child_end = range.start;
+            while (child_end < range.end && sequences[child_end][range.depth] == word) child_end++;
+            mNodeWords.push_back(word);
+            mTerminal.push_back(0);
+            pending.push({range.start, child_end, range.depth + 1});
+            range.start = child_end;
+        }
+    }
+    mFirstChild.push_back((node_t) mNodeWords.size());
+    FS_dprint("Taxonomy trie built with " + std::to_string(mWords.size()) + " words, " +
+              std::to_string(mNodeWords.size()) + " nodes");
+}
+
+bool TaxonomyTrie::empty() const {
+    return mFirstChild.empty();
+}
+
+/**
+ * ======================================================================
+ * Function uint64 TaxonomyTrie::longest_prefix(const std::string &species)
+ *
+ * Description          - Walks the trie word by word, remembering the last
+ *                        node that is a taxonomy name
+ *
+ * Notes                - Equivalent to dropping the last word of the species
+ *                        until it is found in the database
+ *
+ * @param species       - Lowercase species
+ *
+ * @return              - Length of longest prefix that is a taxonomy name,
+ *                        PREFIX_NOT_FOUND if none
+ *
+ * =====================================================================
+ */
+uint64 TaxonomyTrie::longest_prefix(const std::string &species) const {
+    uint64 longest = PREFIX_NOT_FOUND;
+    uint64 start = 0;
+    uint64 pos;
+    node_t node = ROOT_NODE;
+    word_t word;
+
+    if (empty()) return PREFIX_NOT_FOUND;
+
+    while (true) {
+        pos = species.find(WORD_DELIM, start);
+        if (pos == std::string::npos) pos = species.size();
+
+        word = find_word(species.data() + start, pos - start);
+        if (word == mWords.size()) break;
+        const word_t *begin = mNodeWords.data() + mFirstChild[node];
+        const word_t *end   = mNodeWords.data() + mFirstChild[node + 1];
+        const word_t *child = std::lower_bound(begin, end, word);
+        if (child == end || *child != word) break;
+        node = (node_t) (child - mNodeWords.data());
+        if (mTerminal[node]) longest = pos;
+
+        if (pos == species.size()) break;
+        start = pos + 1;
+    }
+    return longest;
+}
+
+// Returns word ID, mWords.size() if word is not in the trie
+TaxonomyTrie::word_t TaxonomyTrie::find_word(const char *word, uint64 length) const {
+    vect_str_t::const_iterator it = std::lower_bound(mWords.begin(), mWords.end(), word,
+        [length](const std::string &val, const char *key) {
+            int cmp = val.compare(0, std::string::npos, key, length);
+            return cmp < 0;
+        });
+    if (it != mWords.end() && it->size() == length && it->compare(0, length, word, length) == 0) {
+        return (word_t) (it - mWords.begin());
+    }
+    return (word_t) mWords.size();
+}
@@ -0,0 +1,107 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ENTAP_TAXONOMYTRIE_H
+#define ENTAP_TAXONOMYTRIE_H
+
+#include "../common.h"
+#include "../config.h"
+
+#ifdef USE_BOOST
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+#else
+#include <cereal/cereal.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#endif
+
+/**
+ * ======================================================================
+ * @class TaxonomyTrie
+ *
+ * Description          - Word level trie of the taxonomy names in the EnTAP
+ *                        database (words split on single spaces)
+ *                      - A single walk of a species returns its longest
+ *                        prefix (at a word boundary) that is a taxonomy
+ *                        name, replacing one failed lookup per dropped word
+ *                      - Nodes are numbered breadth first so the children
+ *                        of a node are contiguous and sorted by word ID,
+ *                        words are stored sorted so no index has to be
+ *                        rebuilt when the database is loaded
+ *
+ * Notes                - Stored in the serialized EnTAP database
+ *                      - Const lookups are thread safe
+ *
+ * ======================================================================
+ */
+class TaxonomyTrie {
+
+public:
+    typedef uint32 node_t;
+    typedef uint32 word_t;
+
+    static constexpr uint64 PREFIX_NOT_FOUND = UINT64_MAX;
+
+    void build(const vect_str_t &names);
+    bool empty() const;
+    uint64 longest_prefix(const std::string &species) const;
+
+#ifdef USE_BOOST
+    friend class boost::serialization::access;
+    template<typename Archive>
+    void serialize(Archive & ar, const uint32 v) {
+        ar&mWords;
+        ar&mNodeWords;
+        ar&mFirstChild;
+        ar&mTerminal;
+    }
+#else
+    // Use CEREAL for serialization
+    template<class Archive>
+    void serialize(Archive & archive) {
+        archive(mWords, mNodeWords, mFirstChild, mTerminal);
+    }
+#endif
+
+private:
+    static constexpr node_t ROOT_NODE = 0;
+    static constexpr char   WORD_DELIM = ' ';
+
+    word_t find_word(const char *word, uint64 length) const;
+
+    vect_str_t          mWords;         // Sorted unique words, index is word ID
+    std::vector<word_t> mNodeWords;     // Word of edge into each node (root unused)
+    std::vector<node_t> mFirstChild;    // Node count + 1, children of n are [mFirstChild[n], mFirstChild[n+1])
+    std::vector<uint8>  mTerminal;      // 1 if path to node is a taxonomy name
+};
+
+
+#endif //ENTAP_TAXONOMYTRIE_H
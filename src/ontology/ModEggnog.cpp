@@ -113,7 +113,7 @@ void ModEggnog::parse() {
 
     ss<<std::fixed<<std::setprecision(2);
 
-    if (!EGGNOG_DATABASE.open(mEggnogDbPath))
+    if (!EGGNOG_DATABASE.open_read_only(mEggnogDbPath))
         throw ExceptionHandler("Unable to open EggNOG database",ERR_ENTAP_PARSE_EGGNOG);
 
     path = mOutHIts;
@@ -493,19 +493,20 @@ void ModEggnog::get_tax_scope(std::string &raw_scope,
 void ModEggnog::get_sql_data(QuerySequence::EggnogResults &eggnogResults, SQLDatabaseHelper &database) {
     // Lookup description, KEGG, protein domain from SQL database
     if (!eggnogResults.og_key.empty()) {
-        std::vector<std::vector<std::string>>results;
         std::string sql_kegg;
         std::string sql_desc;
         std::string sql_protein;
 
-        char *query = sqlite3_mprintf(
-                "SELECT description, KEGG_freq, SMART_freq FROM og WHERE og=%Q",
-                eggnogResults.og_key.c_str());
         try {
-            results = database.query(query);
-            sql_desc = results[0][0];
-            sql_kegg = results[0][1];
-            sql_protein = results[0][2];
+            {
+                SQLDatabaseHelper::Statement statement(&database,
+                    "SELECT description, KEGG_freq, SMART_freq FROM og WHERE og=?");
+                statement.bind(1, eggnogResults.og_key);
+                if (!statement.step()) return;
+                sql_desc = statement.get_text(0);
+                sql_kegg = statement.get_text(1);
+                sql_protein = statement.get_text(2);
+            }
             if (!sql_desc.empty() && sql_desc.find("[]") != 0) eggnogResults.description = sql_desc;
             if (!sql_kegg.empty() && sql_kegg.find("[]") != 0) {
                 eggnogResults.sql_kegg = format_sql_data(sql_kegg);
@@ -190,6 +190,9 @@ void ModEggnogDMND::parse() {
 
         } // End WHILE in.read_row
 
+        // Select overall best hits now that every alignment has been parsed
+        mpQueryData->finalize_alignments(GENE_ONTOLOGY, mSoftwareFlag);
+
         if (sequence_ct > 0) {
             FS_dprint("Success!");
             calculate_stats(stats_stream);
@@ -215,16 +218,20 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
     QuerySequence::EggnogResults                          *eggnog_results;
     EggnogDmndAlignment                                  *best_hit;
     Compair<std::string>                                  tax_scope_counter;
-    std::unordered_map<std::string,Compair<std::string>>  go_combined_map;
+    Compair<GoTermTable::term_id_t>                       go_category_counts[GoTermTable::GO_CATEGORY_COUNT];
+    Compair<GoTermTable::term_id_t>                       go_overall_counts;
     EggnogDatabase                                       *eggnogDatabase;
     std::vector<ENTAP_HEADERS>                            output_headers;
     GraphingManager::GraphingData                         graphing_data_temp;
+    std::vector<QuerySequence::EggnogResults*>            batch_results;    // Results of every best hit, looked up together
 
     uint64         ct_alignments=0;
     uint64         ct_no_alignment=0;
     uint64         ct_total_go_hits=0;      // Sequences that had at least one go
     uint64         ct_total_kegg_hits=0;    // Sequences that had at least one kegg
     uint64         ct_total_kegg_terms=0;
+    uint64         ct_memo_lookups;         // Hits looked up in the seed ortholog annotation memo
+    uint64         ct_memo_hits;            // Hits copied from the memo
     uint32         ct = 0;
     fp32           percent;
 
@@ -248,6 +255,18 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
     mpQueryData->start_alignment_files(out_no_hits_base, output_headers, 0, mAlignmentFileTypes);
     mpQueryData->start_alignment_files(out_hits_base, output_headers, 0, mAlignmentFileTypes);
 
+    // Gather best hits of every sequence, database is then queried for all of them together
+    // across threads. Output below stays in sequence order
+    for (auto &pair : *mpQueryData->get_sequences_ptr()) {
+        // Check if each sequence is an eggnog alignment
+        if (pair.second->hit_database(GENE_ONTOLOGY, mSoftwareFlag, mEggnogDbDiamond)) {
+            best_hit = pair.second->get_best_hit_alignment<EggnogDmndAlignment>
+                    (GENE_ONTOLOGY, mSoftwareFlag, mEggnogDbDiamond);
+            if (best_hit != nullptr) batch_results.push_back(best_hit->get_results());
+        }
+    }
+    eggnogDatabase->get_eggnog_entries(batch_results, (uint16) std::max(mThreads, 1));
+
     // Parse through all query sequences
     for (auto &pair : *mpQueryData->get_sequences_ptr()) {
         // Check if each sequence is an eggnog alignment
@@ -263,7 +282,6 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
                 continue;
             }
             eggnog_results = best_hit->get_results();
-            eggnogDatabase->get_eggnog_entry(eggnog_results);
             best_hit->refresh_headers();
 
             mpQueryData->add_alignment_data(out_hits_base, pair.second, nullptr);
@@ -271,13 +289,12 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
             //  Analyze Gene Ontology Stats
             if (!eggnog_results->parsed_go.empty()) {
                 ct_total_go_hits++;
-                for (auto &pair2 : eggnog_results->parsed_go) {
-                    // pair - first: GO category, second; vector of terms
-                    for (std::string &term : pair2.second) {
+                for (uint8 category = 0; category < GoTermTable::GO_CATEGORY_COUNT; category++) {
+                    for (GoTermTable::term_id_t term : eggnog_results->parsed_go.terms[category]) {
                         // Count the terms we've found for individual category
-                        go_combined_map[pair2.first].add_value(term);
+                        go_category_counts[category].add_value(term);
                         // Count the terms we've found overall (not category specific)
-                        go_combined_map[GO_OVERALL_FLAG].add_value(term);
+                        go_overall_counts.add_value(term);
                     }
                 }
             }
@@ -289,9 +306,9 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
             }
 
             // Compile Taxonomic Orthogroup stats
-            if (!eggnog_results->tax_scope_readable.empty()) {
+            if (eggnog_results->tax_scope_readable != StringInterner::EMPTY_HANDLE) {
                 // Count number of unique taxonomic groups
-                tax_scope_counter.add_value(eggnog_results->tax_scope_readable);
+                tax_scope_counter.add_value(StringInterner::get(eggnog_results->tax_scope_readable));
             }
 
         } else {
@@ -304,6 +321,8 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
     // Close files
     mpQueryData->end_alignment_files(out_hits_base);
     mpQueryData->end_alignment_files(out_no_hits_base);
+    ct_memo_lookups = eggnogDatabase->get_memo_lookups();
+    ct_memo_hits    = eggnogDatabase->get_memo_hits();
     delete eggnogDatabase;
 
     FS_dprint("EggNOG database closed, printing stats...");
@@ -313,6 +332,12 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
        "Statistics for overall Eggnog results: "               <<
        "\nTotal unique sequences with family assignment: "     << ct_alignments <<
        "\nTotal unique sequences without family assignment: "  << ct_no_alignment;
+    if (ct_memo_lookups > 0) {
+        percent = ((fp32) ct_memo_hits / ct_memo_lookups) * 100;
+        stream <<
+           "\nSequences sharing a previously resolved seed ortholog: " << ct_memo_hits <<
+           "(" << percent << "% of " << ct_memo_lookups << ")";
+    }
 
     // Make sure we have hits before doing anything
 
@@ -355,51 +380,61 @@ void ModEggnogDMND::calculate_stats(std::stringstream &stream) {
         stream <<
                "\nTotal unique sequences with at least one GO term: " << ct_total_go_hits <<
                "\nTotal unique sequences without GO terms: " << ct_alignments - ct_total_go_hits <<
-               "\nTotal GO terms assigned: " << go_combined_map[GO_OVERALL_FLAG]._ct_total;;
+               "\nTotal GO terms assigned: " << go_overall_counts._ct_total;;
+
+        // Count maps (biological/molecular/cellular/overall), uncategorized terms only count overall
+        const std::vector<std::pair<const std::string*, Compair<GoTermTable::term_id_t>*>> go_count_maps = {
+                {&GO_BIOLOGICAL_FLAG, &go_category_counts[GoTermTable::GO_CATEGORY_BIOLOGICAL]},
+                {&GO_CELLULAR_FLAG,   &go_category_counts[GoTermTable::GO_CATEGORY_CELLULAR]},
+                {&GO_MOLECULAR_FLAG,  &go_category_counts[GoTermTable::GO_CATEGORY_MOLECULAR]},
+                {&GO_OVERALL_FLAG,    &go_overall_counts}
+        };
+        for (auto &pair : go_count_maps) {
+            // Sort count maps
+            pair.second->sort(true);
+        }
 
         for (uint16 lvl : mGoLevels) {
-            for (auto &pair : go_combined_map) {
-                if (pair.first.empty()) continue;
-                // Count maps (biological/molecular/cellular/overall)
+            for (auto &pair : go_count_maps) {
+                const std::string &go_flag = *pair.first;
+                if (pair.second->empty()) continue;
                 graphing_data_temp = GraphingManager::GraphingData();
                 graphing_data_temp.x_axis_label = "Gene Ontology Term";
                 graphing_data_temp.y_axis_label = "Count";
-                graphing_data_temp.text_file_path = PATHS(mFigureDir, pair.first) + std::to_string(lvl)+GRAPH_GO_END_TXT;
-                graphing_data_temp.fig_out_path   = PATHS(mFigureDir, pair.first) + std::to_string(lvl)+GRAPH_GO_END_PNG;
+                graphing_data_temp.text_file_path = PATHS(mFigureDir, go_flag) + std::to_string(lvl)+GRAPH_GO_END_TXT;
+                graphing_data_temp.fig_out_path   = PATHS(mFigureDir, go_flag) + std::to_string(lvl)+GRAPH_GO_END_PNG;
 
-                if (pair.first == GO_BIOLOGICAL_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_BIO_TITLE + "_Level:_"+std::to_string(lvl);
-                if (pair.first == GO_CELLULAR_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_CELL_TITLE+ "_Level:_"+std::to_string(lvl);
-                if (pair.first == GO_MOLECULAR_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_MOLE_TITLE+ "_Level:_"+std::to_string(lvl);
-                if (pair.first == GO_OVERALL_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_ALL_TITLE+ "_Level:_"+std::to_string(lvl);
+                if (go_flag == GO_BIOLOGICAL_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_BIO_TITLE + "_Level:_"+std::to_string(lvl);
+                if (go_flag == GO_CELLULAR_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_CELL_TITLE+ "_Level:_"+std::to_string(lvl);
+                if (go_flag == GO_MOLECULAR_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_MOLE_TITLE+ "_Level:_"+std::to_string(lvl);
+                if (go_flag == GO_OVERALL_FLAG) graphing_data_temp.graph_title = GRAPH_GO_BAR_ALL_TITLE+ "_Level:_"+std::to_string(lvl);
                 graphing_data_temp.graph_type = GraphingManager::ENT_GRAPH_BAR_HORIZONTAL;
 
                 mpGraphingManager->initialize_graph_data(graphing_data_temp);
 
-                // Sort count maps
-                pair.second.sort(true);
-
                 // get total count for each level...change, didn't feel like making another
                 uint32 lvl_ct = 0;   // Use for percentages, total terms for each lvl
                 ct = 0;              // Use for unique count
-                for (auto &pair2 : pair.second._sorted) {
-                    if (pair2.first.find("(L=" + std::to_string(lvl))!=std::string::npos || lvl == 0) {
+                for (auto &pair2 : pair.second->_sorted) {
+                    if (GoTermTable::at_level(pair2.first, lvl)) {
                         ct++;
                         lvl_ct += pair2.second;
                     }
                 }
-                stream << "\nTotal "        << pair.first <<" terms (lvl="          << lvl << "): " << lvl_ct;
-                stream << "\nTotal unique " << pair.first <<" terms (lvl="          << lvl << "): " << ct;
-                stream << "\nTop " << COUNT_TOP_GO << " " << pair.first <<" terms assigned (lvl=" << lvl << "): ";
+                stream << "\nTotal "        << go_flag <<" terms (lvl="          << lvl << "): " << lvl_ct;
+                stream << "\nTotal unique " << go_flag <<" terms (lvl="          << lvl << "): " << ct;
+                stream << "\nTop " << COUNT_TOP_GO << " " << go_flag <<" terms assigned (lvl=" << lvl << "): ";
 
                 ct = 1;
-                for (auto &pair2 : pair.second._sorted) {
+                for (auto &pair2 : pair.second->_sorted) {
                     if (ct > COUNT_TOP_GO) break;
-                    if (pair2.first.find("(L=" + std::to_string(lvl))!=std::string::npos || lvl == 0) {
+                    if (GoTermTable::at_level(pair2.first, lvl)) {
+                        const std::string &label = GoTermTable::get_label(pair2.first);
                         percent = ((fp32)pair2.second / lvl_ct) * 100;
                         stream <<
-                               "\n\t" << ct << ")" << pair2.first << ": " << pair2.second <<
+                               "\n\t" << ct << ")" << label << ": " << pair2.second <<
                                "(" << percent << "%)";
-                        mpGraphingManager->add_datapoint(graphing_data_temp.text_file_path, {pair2.first, std::to_string(pair2.second)});
+                        mpGraphingManager->add_datapoint(graphing_data_temp.text_file_path, {label, std::to_string(pair2.second)});
                         ct++;
                     }
                 }
@@ -174,7 +174,7 @@ void ModInterpro::parse() {
     std::string                           path_hits_faa;
     std::string                           path_hits_fnn;
     std::map<std::string,InterProData>    interpro_map;
-    go_format_t                           go_terms_parsed;
+    GoTermTable::GoTermSet                go_terms_parsed;
     uint32                                count_hits=0;
     uint32                                count_no_hits=0;
 
@@ -236,6 +236,8 @@ void ModInterpro::parse() {
                 if (!pair.second->get_sequence_p().empty()) file_no_hits_faa << pair.second->get_sequence_p() << std::endl;
             }
         }
+        // Select overall best hits now that every alignment has been parsed
+        mpQueryData->finalize_alignments(mExecutionState, mSoftwareFlag);
     } catch (std::exception &e) {
         throw ExceptionHandler(e.what(), ERR_ENTAP_PARSE_INTERPRO);
     }
@@ -65,12 +65,17 @@ AbstractSimilaritySearch::AbstractSimilaritySearch(std::string &execution_stage_
     mEVal            = mpUserInput->get_user_input<ent_input_fp_t>(INPUT_FLAG_E_VALUE);
     mContaminateTaxons     = mpUserInput->get_contaminants();
     mUninformativeTags= mpUserInput->get_uninformative_vect();
+    mUninformativeMatcher.set_keywords(mUninformativeTags);
 
     mDatabasePaths = databases;
 
     // Get input species lineage information
-    TaxEntry taxEntry = mpEntapDatabase->get_tax_entry(mInputSpecies);
-    mInputLineage    = taxEntry.lineage;
+    const TaxEntry *taxEntry = mpEntapDatabase->get_tax_entry(mInputSpecies);
+    mInputLineage    = taxEntry->lineage;
+    mInputLineagePath = taxEntry->lineage_path;
+
+    // Contaminants are compared as clades when found in the taxonomic database
+    mContaminantScreen.set_contaminants(mContaminateTaxons, mpEntapDatabase);
 
     // set blast string to use for file naming
     mBlastp ? mBlastType = BLASTP_STR : mBlastType = BLASTX_STR;
@@ -124,55 +129,52 @@ std::string AbstractSimilaritySearch::get_database_output_path(std::string &data
 /**
  * ======================================================================
  * Function std::pair<bool,std::string> AbstractSimilaritySearch::is_contaminant
- *                                      (std::string lineage, vect_str_t &contams)
+ *                                      (const std::string &lineage, const tax_path_t &lineage_path,
+ *                                       const ContaminantScreen &contams)
  *
  * Description           - Determine if specified lineage is a contaminant based
  *                         on input contaminant taxons
  *
- * Notes                 - None
+ * Notes                 - First contaminant (input order) the lineage falls
+ *                         under is returned
  *
  * @param lineage        - Target lineage to determine contaminant status
- * @param contams        - vector of contaminant taxons
+ * @param lineage_path   - Target lineage path (EntapDatabase::get_lineage_path)
+ * @param contams        - Resolved contaminant taxons
  *
  * @return               - BOOL (contaminate TRUE/FALSE) and STRING (matching taxon)
  *
  * =====================================================================
  */
-std::pair<bool,std::string> AbstractSimilaritySearch::is_contaminant(std::string lineage, vect_str_t &contams) {
-    // species and tax database both lowercase
-    if (contams.empty()) return std::pair<bool,std::string>(false,"");
-    LOWERCASE(lineage);
-    for (auto const &contaminant:contams) {
-        if (lineage.find(contaminant) != std::string::npos){
-            return std::pair<bool,std::string>(true,contaminant);
-        }
-    }
-    return std::pair<bool,std::string>(false,"");
+std::pair<bool,std::string> AbstractSimilaritySearch::is_contaminant(const std::string &lineage,
+                                                                    const tax_path_t &lineage_path,
+                                                                    const ContaminantScreen &contams) {
+    int32 contam_ind;
+
+    contam_ind = contams.find_first_contaminant(lineage, lineage_path);
+    if (contam_ind == KeywordMatcher::NO_MATCH) return std::pair<bool,std::string>(false,"");
+    return std::pair<bool,std::string>(true, contams.get_contaminant((uint32) contam_ind));
 }
 
 /**
  * ======================================================================
- * Function bool AbstractSimilaritySearch::is_informative(std::string title,
- *                                          vect_str_t &uninformative_vect)
+ * Function bool AbstractSimilaritySearch::is_informative(const std::string &title,
+ *                                          const KeywordMatcher &uninformative)
  *
  * Description           - Determine if specified subject title is 'informative'
  *                         based upon informative tags
  *
- * Notes                 - None
+ * Notes                 - Case insensitive
  *
- * @param title              - Target title to determine informative status
- * @param uninformative_vect - vector of 'informative' tags
+ * @param title          - Target title to determine informative status
+ * @param uninformative  - Compiled 'uninformative' tags
  *
  * @return               - TRUE/FALSE informative
  *
  * =====================================================================
  */
-bool AbstractSimilaritySearch::is_informative(std::string title, vect_str_t &uninformative_vect) {
-    LOWERCASE(title);
-    for (std::string &item : uninformative_vect) { // Already lowercase
-        if (title.find(item) != std::string::npos) return false;
-    }
-    return true;
+bool AbstractSimilaritySearch::is_informative(const std::string &title, const KeywordMatcher &uninformative) {
+    return !uninformative.contains_any(title);
 }
 
 /**
@@ -30,6 +30,8 @@
 
 
 #include "../EntapModule.h"
+#include "../KeywordMatcher.h"
+#include "ContaminantScreen.h"
 
 class AbstractSimilaritySearch : public EntapModule{
 
@@ -44,6 +46,7 @@ public:
 
         bool                blastp;
         bool                more_sensitive;
+        bool                subject_index;  // Subject metadata pulled from index, only output sseqid
 
         uint16              threads;
         fp64                eval;
@@ -73,9 +76,12 @@ protected:
     vect_str_t                      mDatabasePaths;
     vect_str_t                      mUninformativeTags;
     vect_str_t                      mContaminateTaxons;
+    KeywordMatcher                  mUninformativeMatcher;  // Compiled mUninformativeTags
+    ContaminantScreen               mContaminantScreen;     // Resolved mContaminateTaxons
     vect_str_t                      mOutputPaths;
     std::map<std::string, std::string> mPathToDatabase;      // mapping of full database file path to shortened name
     std::string                     mInputLineage;
+    tax_path_t                      mInputLineagePath;
     std::string                     mInputSpecies;
     std::string                     mBlastType;            // string to signify blast type
     fp64                            mEVal;
@@ -97,9 +103,13 @@ protected:
 
     std::string get_database_shortname(std::string &full_path);
     std::string get_database_output_path(std::string &database_name);
-    std::pair<bool, std::string> is_contaminant(std::string lineage, vect_str_t &contams);
-    bool is_informative(std::string title, vect_str_t &uninformative_vect);
-    std::string get_species(std::string &title);
+
+public:
+    // Subject screening, also used when building the subject side index at configuration
+    static std::pair<bool, std::string> is_contaminant(const std::string &lineage, const tax_path_t &lineage_path,
+                                                       const ContaminantScreen &contams);
+    static bool is_informative(const std::string &title, const KeywordMatcher &uninformative);
+    static std::string get_species(std::string &title);
 };
 
 
@@ -0,0 +1,161 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ContaminantScreen.h"
+
+ContaminantScreen::ContaminantScreen() = default;
+
+/**
+ * ======================================================================
+ * Function void ContaminantScreen::set_contaminants(const vect_str_t &contaminants,
+ *                                                   EntapDatabase *entapDatabase)
+ *
+ * Description          - Resolves each contaminant to a clade in the EnTAP
+ *                        taxonomic database
+ *
+ * Notes                - Only exact taxon name matches become clades (the
+ *                        database broadens unknown species), others are
+ *                        matched as text
+ *
+ * @param contaminants  - Contaminant taxons (lowercase)
+ * @param entapDatabase - EnTAP database, nullptr to only match as text
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ContaminantScreen::set_contaminants(const vect_str_t &contaminants, EntapDatabase *entapDatabase) {
+    vect_str_t  text_contaminants;
+    std::string taxon;
+    const TaxEntry *taxEntry;
+
+    mContaminants = contaminants;
+    mClades.clear();
+    mTextIndices.clear();
+
+    for (uint32 i = 0; i < mContaminants.size(); i++) {
+        taxon = mContaminants[i];
+        taxEntry = nullptr;
+        if (entapDatabase != nullptr) {
+            taxEntry = entapDatabase->get_tax_entry(taxon);     // lowercases taxon
+        }
+
+        if (taxEntry != nullptr && !taxEntry->lineage_path.empty() && taxEntry->tax_name == taxon) {
+            ContaminantClade clade;
+            clade.contam_index = i;
+            clade.depth        = (uint16) (taxEntry->lineage_path.size() - 1);
+            clade.node         = taxEntry->lineage_path.back();
+            mClades.push_back(clade);
+        } else {
+            FS_dprint("Contaminant not found in taxonomic database, matching as text: " + mContaminants[i]);
+            text_contaminants.push_back(mContaminants[i]);
+            mTextIndices.push_back(i);
+        }
+    }
+    mTextMatcher.set_keywords(text_contaminants);
+}
+
+/**
+ * ======================================================================
+ * Function int32 ContaminantScreen::find_first_contaminant(const std::string &lineage,
+ *                                                          const tax_path_t &lineage_path)
+ *
+ * Description          - Returns first contaminant (input order) the taxon
+ *                        falls under
+ *
+ * Notes                - Clade checks are a single path comparison each
+ *
+ * @param lineage       - Lineage text of taxon
+ * @param lineage_path  - Lineage path of taxon
+ *
+ * @return              - Contaminant index, KeywordMatcher::NO_MATCH if none
+ *
+ * =====================================================================
+ */
+int32 ContaminantScreen::find_first_contaminant(const std::string &lineage, const tax_path_t &lineage_path) const {
+    int32 first = KeywordMatcher::NO_MATCH;
+    int32 text_ind;
+
+    for (const ContaminantClade &clade : mClades) {
+        if (lineage_path.size() > clade.depth && lineage_path[clade.depth] == clade.node) {
+            first = (int32) clade.contam_index;
+            break;
+        }
+    }
+
+    if (!mTextIndices.empty()) {
+        text_ind = mTextMatcher.find_first_keyword(lineage);
+        if (text_ind != KeywordMatcher::NO_MATCH &&
+            (first == KeywordMatcher::NO_MATCH || (int32) mTextIndices[text_ind] < first)) {
+            first = (int32) mTextIndices[text_ind];
+        }
+    }
+    return first;
+}
+
+/**
+ * ======================================================================
+ * Function void ContaminantScreen::find_contaminants(const std::string &lineage,
+ *                              const tax_path_t &lineage_path, std::vector<uint32> &contam_indices)
+ *
+ * Description          - Returns every contaminant the taxon falls under
+ *
+ * Notes                - Indices are unique and sorted
+ *
+ * @param lineage        - Lineage text of taxon
+ * @param lineage_path   - Lineage path of taxon
+ * @param contam_indices - Found contaminant indices (cleared first)
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ContaminantScreen::find_contaminants(const std::string &lineage, const tax_path_t &lineage_path,
+                                          std::vector<uint32> &contam_indices) const {
+    std::vector<uint32> text_indices;
+
+    contam_indices.clear();
+    for (const ContaminantClade &clade : mClades) {
+        if (lineage_path.size() > clade.depth && lineage_path[clade.depth] == clade.node) {
+            contam_indices.push_back(clade.contam_index);
+        }
+    }
+    if (!mTextIndices.empty()) {
+        mTextMatcher.find_keywords(lineage, text_indices);
+        for (uint32 ind : text_indices) contam_indices.push_back(mTextIndices[ind]);
+        std::sort(contam_indices.begin(), contam_indices.end());
+    }
+}
+
+const std::string &ContaminantScreen::get_contaminant(uint32 index) const {
+    return mContaminants.at(index);
+}
+
+const vect_str_t &ContaminantScreen::get_contaminants() const {
+    return mContaminants;
+}
@@ -0,0 +1,80 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_CONTAMINANTSCREEN_H
+#define ENTAP_CONTAMINANTSCREEN_H
+
+#include "../common.h"
+#include "../KeywordMatcher.h"
+#include "../database/EntapDatabase.h"
+
+/**
+ * ======================================================================
+ * @class ContaminantScreen
+ *
+ * Description          - Determines whether a taxon falls under any of the
+ *                        user contaminant taxons
+ *                      - Contaminants found in the EnTAP taxonomic database
+ *                        are compared as clades, a taxon is a contaminant if
+ *                        the clade is one of its lineage path ancestors
+ *                      - Contaminants not found in the database are matched
+ *                        as text against the lineage
+ *
+ * Notes                - Contaminant indices follow the input order, the first
+ *                        matching contaminant is reported as the type
+ *
+ * ======================================================================
+ */
+class ContaminantScreen {
+
+public:
+    ContaminantScreen();
+    ~ContaminantScreen() = default;
+
+    void set_contaminants(const vect_str_t &contaminants, EntapDatabase *entapDatabase);
+    int32 find_first_contaminant(const std::string &lineage, const tax_path_t &lineage_path) const;
+    void find_contaminants(const std::string &lineage, const tax_path_t &lineage_path,
+                           std::vector<uint32> &contam_indices) const;
+    const std::string &get_contaminant(uint32 index) const;
+    const vect_str_t &get_contaminants() const;
+
+private:
+    struct ContaminantClade {
+        uint32                   contam_index;   // Index in mContaminants
+        uint16                   depth;          // Depth of clade in lineage paths
+        StringInterner::handle_t node;           // Interned lineage of clade
+    };
+
+    vect_str_t                    mContaminants;
+    std::vector<ContaminantClade> mClades;          // Contaminants found in database, input order
+    KeywordMatcher                mTextMatcher;     // Contaminants not found in database
+    std::vector<uint32>           mTextIndices;     // Text matcher keyword to mContaminants index
+};
+
+
+#endif //ENTAP_CONTAMINANTSCREEN_H
@@ -31,6 +31,7 @@
 #include "../QueryAlignment.h"
 #include "../QueryData.h"
 #include "../GraphingManager.h"
+#include "../ThreadPool.h"
 
 #ifdef USE_BOOST
 #include <boost/regex.hpp>
@@ -38,6 +39,10 @@
 #include <regex>
 #endif
 
+constexpr uint64 ModDiamond::PARSE_CHUNK_MIN_BYTES;
+constexpr uint64 ModDiamond::PARSE_CHUNK_MAX_BYTES;
+constexpr uint64 ModDiamond::PARSE_CHUNKS_PER_THREAD;
+
 std::vector<ENTAP_HEADERS> ModDiamond::DEFAULT_HEADERS = {
         ENTAP_HEADER_SIM_SUBJECT,
         ENTAP_HEADER_SIM_PERCENT,
@@ -217,6 +222,8 @@ void ModDiamond::execute() {
             simSearchCmd.qcoverage     = mQCoverage;
             simSearchCmd.exe_path      = mExePath;
             simSearchCmd.blastp        = mBlastp;
+            // Subject metadata already indexed at configuration, DIAMOND does not need to output titles
+            simSearchCmd.subject_index = mpFileSystem->file_exists(SubjectIndex::get_index_path(database_path));
 
             try {
                 run_blast(&simSearchCmd, true);
@@ -276,7 +283,11 @@ bool ModDiamond::run_blast(AbstractSimilaritySearch::SimSearchCmd *cmd, bool use
 
     tc_commands.emplace(CMD_OUTPUT_PATH, cmd->output_path);
     tc_commands.emplace(CMD_THREADS, std::to_string(cmd->threads));
-    tc_commands.emplace(CMD_OUTPUT_FORMAT, CMD_DEFAULT_OUTPUT_FORMAT);
+    if (cmd->subject_index) {
+        tc_commands.emplace(CMD_OUTPUT_FORMAT, CMD_INDEXED_OUTPUT_FORMAT);
+    } else {
+        tc_commands.emplace(CMD_OUTPUT_FORMAT, CMD_DEFAULT_OUTPUT_FORMAT);
+    }
 
     terminalData.command        = TC_generate_command(tc_commands, temp_exe);
     terminalData.base_std_path  = cmd->std_out_path;
@@ -302,7 +313,16 @@ bool ModDiamond::run_blast(AbstractSimilaritySearch::SimSearchCmd *cmd, bool use
  * Description          - Parses and compiles data from DIAMOND output
  *                      - Adds this to QueryData class which determines best hits
  *
- * Notes                - None
+ * Notes                - Output files are split into line aligned chunks that
+ *                        are parsed in parallel. Chunks are merged into QueryData
+ *                        by this thread in file order so alignment order (and
+ *                        output) does not depend on thread count
+ *                      - Database statistics are calculated as soon as every
+ *                        chunk of that database has been merged
+ *                      - Output without titles is resolved through the
+ *                        SubjectIndex generated during configuration. Each
+ *                        index is read when the first chunk of its file is
+ *                        queued and released once the file is merged
  *
  *
  * @return              - None
@@ -310,129 +330,534 @@ bool ModDiamond::run_blast(AbstractSimilaritySearch::SimSearchCmd *cmd, bool use
  * =====================================================================
  */
 void ModDiamond::parse() {
-    bool                is_uniprot;                     // BOOL is current database a UniProt database
-    uint32              uniprot_attempts=0;             // Number of attempts to determine if database is UniProt
     uint16              file_status=0;                  // File statuses (defined FileSystem.h)
-    std::string         species;                        // Species from subject sequence
-    QuerySequence::SimSearchResults simSearchResults;   // Compiled similarity search results
-    TaxEntry            taxEntry;                       // Entry from Tarxonomic database
-    std::pair<bool, std::string> contam_info;           // Contaminate information
-
-    // ------------------ Read from DIAMOND output ----------------------- //
-    std::string qseqid;             // Sequence ID of query sequence
-    std::string sseqid;             // Sequence ID of subject/target sequence (from database)
-    std::string stitle;             // Title of subject sequence pulled from database
-    std::string pident;             // Percent identical
-    std::string bitscore;           // Bit score
-    std::string length;             // Length (bp)
-    std::string mismatch;           // Mismatches
-    std::string gapopen;            // Gap open
-    std::string qstart;             // Query start bp
-    std::string qend;               // Query end bp
-    std::string sstart;             // Subject start bp
-    std::string send;               // SUbject end bp
-    fp64 evalue;                    // E-value
-    fp64 coverage;                  // Coverage
-    // ------------------------------------------------------------------ //
+    uint16              col_count;                      // Number of columns in DIAMOND output
+    std::vector<DiamondParseFile>  parse_files;         // Output files, same order as mOutputPaths
+    std::vector<DiamondParseChunk> chunks;              // Chunks of every output file, in file order
+    std::mutex                     chunk_mutex;         // Guards chunk completion
+    std::condition_variable        chunk_condition;     // Signaled when a chunk completes
+    bool                           abort_parse=false;   // Set if merging fails, remaining chunks skipped
 
     FS_dprint("Beginning to filter individual DIAMOND files...");
 
-    // disable UniProt headers until we know we have a hit
-    for (std::string &output_path : mOutputPaths) {
-        FS_dprint("DIAMOND file located at " + output_path + " being parsed");
-
-        // reset uniprot info for each database
-        is_uniprot = false;
-        uniprot_attempts = 0;
-        simSearchResults = {};
+    // Output paths were added in the same order as database paths
+    parse_files.resize(mOutputPaths.size());
+    for (uint16 i = 0; i < mOutputPaths.size(); i++) {
+        DiamondParseFile &parse_file = parse_files[i];
+        parse_file.output_path = &mOutputPaths[i];
+        parse_file.hit_store = mpQueryData->get_hit_store(mOutputPaths[i]);
+        parse_file.missing_subjects = 0;
+        parse_file.is_uniprot = false;
 
         // ensure file exists
-        file_status = mpFileSystem->get_file_status(output_path);
+        file_status = mpFileSystem->get_file_status(mOutputPaths[i]);
         if (file_status != 0) {
-            throw ExceptionHandler("File not found or empty: " + output_path, ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+            throw ExceptionHandler("File not found or empty: " + mOutputPaths[i], ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
         }
 
-        // Begin using CSVReader lib to parse data
-        io::CSVReader<DMND_COL_NUMBER, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in(output_path);
-        while (in.read_row(qseqid, sseqid, pident, length, mismatch, gapopen,
-                           qstart, qend, sstart, send, evalue, bitscore, coverage,stitle)) {
-            simSearchResults = {};
-
-            // Get pointer to sequence in overall map
-            QuerySequence *query = mpQueryData->get_sequence(qseqid);
-            if (query == nullptr) {
-                throw ExceptionHandler("Unable to find sequence in transcriptome: " + qseqid + " from file: " + output_path,
+        col_count = get_output_column_count(mOutputPaths[i]);
+        if (col_count == DMND_COL_NUMBER_INDEXED) {
+            // Read when its chunks are queued so only databases being parsed are held open
+            parse_file.index_path = SubjectIndex::get_index_path(mDatabasePaths[i]);
+            if (!mpFileSystem->file_exists(parse_file.index_path)) {
+                throw ExceptionHandler("Subject index not found at: " + parse_file.index_path +
+                                       "\nRequired to parse DIAMOND output: " + mOutputPaths[i],
                                        ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
             }
+        } else if (col_count == DMND_COL_NUMBER) {
+            // Decided once per file so hits do not depend on how the file is split into chunks
+            parse_file.is_uniprot = is_uniprot_output(mOutputPaths[i]);
+        } else {
+            throw ExceptionHandler("Unrecognized DIAMOND output format (" + std::to_string(col_count) +
+                                   " columns) in file: " + mOutputPaths[i], ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+        }
+        split_output_file(parse_file, i, chunks);
+    }
 
-            // get species from database alignment title
-            species = get_species(stitle);
-            // get taxonomic information with species
-            taxEntry = mpEntapDatabase->get_tax_entry(species);
-            // get contaminant information
-            contam_info = is_contaminant(taxEntry.lineage, mContaminateTaxons);
-
-            // If this is a UniProt match and pull back info if so
-            if (is_uniprot) {
-                // Yes, UniProt match - Get uniprot info
-                mpEntapDatabase->is_uniprot_entry(sseqid, simSearchResults.uniprot_info);
-            } else {
-                // No, not a UniProt database, check if it is
-                if (uniprot_attempts <= UNIPROT_ATTEMPTS) {
-                    // First UniProt match assumes the rest are UniProt as well in database
-                    is_uniprot = mpEntapDatabase->is_uniprot_entry(sseqid, simSearchResults.uniprot_info);
-                    if (!is_uniprot) {
-                        uniprot_attempts++;
-                    } else {
-                        FS_dprint("Database file at " + output_path + "\nDetermined to be UniProt");
-                        set_uniprot_headers();
-                    }
-                } // Else, database is NOT UniProt after # of attempts
+    FS_dprint("Parsing " + std::to_string(chunks.size()) + " DIAMOND output chunks with " +
+              std::to_string(mThreads) + " threads...");
+
+    // Pool is destroyed (and waits for workers) before the data its tasks reference
+    //  Only PARSE_CHUNKS_PER_THREAD chunks per thread are queued ahead of the merge, bounding
+    //  the chunk buffers and parsed batches held in memory regardless of output size
+    ThreadPool threadPool((uint16) mThreads);
+    uint64 max_in_flight = PARSE_CHUNKS_PER_THREAD * (uint64) std::max(mThreads, 1);
+    uint64 next_chunk = 0;      // Next chunk to queue
+    auto enqueue_chunks = [&](uint64 merged) {
+        for (; next_chunk < chunks.size() && next_chunk < merged + max_in_flight; next_chunk++) {
+            DiamondParseChunk *pChunk = &chunks[next_chunk];
+            DiamondParseFile  &parse_file = parse_files[pChunk->file_index];
+            if (!parse_file.index_path.empty() && parse_file.subject_index == nullptr) {
+                parse_file.subject_index = std::unique_ptr<SubjectIndex>(new SubjectIndex(mpFileSystem));
+                if (!parse_file.subject_index->read_index(parse_file.index_path, mContaminantScreen,
+                                                         mUninformativeMatcher, mpEntapDatabase)) {
+                    throw ExceptionHandler("Unable to read subject index at: " + parse_file.index_path +
+                                           "\nRequired to parse DIAMOND output: " + *parse_file.output_path,
+                                           ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+                }
+            }
+            threadPool.enqueue([this, pChunk, &parse_files, &chunk_mutex, &chunk_condition, &abort_parse] {
+                bool skip;
+                {
+                    std::lock_guard<std::mutex> lock(chunk_mutex);
+                    skip = abort_parse;
+                }
+                if (!skip) parse_chunk(parse_files[pChunk->file_index], *pChunk);
+                {
+                    std::lock_guard<std::mutex> lock(chunk_mutex);
+                    pChunk->complete = true;
+                }
+                chunk_condition.notify_all();
+            });
+        }
+    };
+
+    try {
+        for (uint64 merged = 0; merged < chunks.size(); merged++) {
+            DiamondParseChunk &chunk = chunks[merged];
+            enqueue_chunks(merged);
+            {
+                std::unique_lock<std::mutex> lock(chunk_mutex);
+                chunk_condition.wait(lock, [&chunk]{return chunk.complete;});
+            }
+            if (!chunk.err_msg.empty()) {
+                throw ExceptionHandler(chunk.err_msg, chunk.err_code);
             }
 
-            // Compile sim search data
-            simSearchResults.database_path = output_path;
-            simSearchResults.qseqid = qseqid;
-            simSearchResults.sseqid = sseqid;
-            simSearchResults.pident = pident;
-            simSearchResults.length = length;
-            simSearchResults.mismatch = mismatch;
-            simSearchResults.gapopen = gapopen;
-            simSearchResults.qstart = qstart;
-            simSearchResults.qend = qend;
-            simSearchResults.sstart = sstart;
-            simSearchResults.send = send;
-            simSearchResults.stitle = stitle;
-            simSearchResults.bit_score = bitscore;
-            simSearchResults.lineage = taxEntry.lineage;
-            simSearchResults.species = species;
-            simSearchResults.e_val_raw = evalue;
-            simSearchResults.e_val = float_to_sci(evalue,2);
-            simSearchResults.coverage_raw = coverage;
-            simSearchResults.coverage = float_to_string(coverage);
-            simSearchResults.contaminant = contam_info.first;
-            simSearchResults.contam_type = contam_info.second;
-            simSearchResults.contaminant ? simSearchResults.yes_no_contam = YES_FLAG :
-                    simSearchResults.yes_no_contam  = NO_FLAG;
-            simSearchResults.is_informative = is_informative(stitle, mUninformativeTags);
-            simSearchResults.is_informative ? simSearchResults.yes_no_inform = YES_FLAG :
-                    simSearchResults.yes_no_inform  = NO_FLAG;
-
-            query->add_alignment(mExecutionState, mSoftwareFlag,
-                    simSearchResults, output_path, mInputLineage);
-        } // END WHILE LOOP
-
-        // Finished parsing and adding to alignment data, being to calc stats
-        FS_dprint("File parsed, calculating statistics and writing output...");
-        calculate_best_stats(false,output_path);
-        FS_dprint("Success!");
-    } // END FOR LOOP
+            DiamondParseFile &parse_file = parse_files[chunk.file_index];
+            parse_file.missing_subjects += chunk.batch.missing_subjects;
+            merge_hit_batch(chunk.batch, parse_file.hit_store);
+
+            if (chunk.last_in_file) {
+                if (parse_file.missing_subjects > 0) {
+                    FS_dprint("WARNING " + std::to_string(parse_file.missing_subjects) +
+                              " hits had subjects missing from index");
+                }
+                parse_file.subject_index.reset();
+
+                // Finished parsing and adding to alignment data, being to calc stats
+                FS_dprint("File parsed, calculating statistics and writing output...\n" + *parse_file.output_path);
+                calculate_best_stats(false, *parse_file.output_path);
+                FS_dprint("Success!");
+            }
+        } // END FOR LOOP
+    } catch (const ExceptionHandler &e) {
+        {
+            std::lock_guard<std::mutex> lock(chunk_mutex);
+            abort_parse = true;
+        }
+        throw e;
+    }
+
+    // Select overall best hits across databases now that every file has been parsed
+    mpQueryData->finalize_alignments(mExecutionState, mSoftwareFlag);
 
     FS_dprint("Calculating overall Similarity Searching statistics...");
     calculate_best_stats(true);
     FS_dprint("Success!");
 }
 
+/**
+ * ======================================================================
+ * Function void ModDiamond::split_output_file(DiamondParseFile &parse_file, uint16 file_index,
+ *                                             std::vector<DiamondParseChunk> &chunks)
+ *
+ * Description          - Splits DIAMOND output into chunks ending on line
+ *                        boundaries, roughly one per thread
+ *
+ * Notes                - Chunks are never smaller than PARSE_CHUNK_MIN_BYTES
+ *                        (except the final one) or larger than
+ *                        PARSE_CHUNK_MAX_BYTES (plus the rest of a line),
+ *                        only offsets are stored here
+ *
+ * @param parse_file    - Output file to split
+ * @param file_index    - Index of file in parse files
+ * @param chunks        - Chunks appended to
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::split_output_file(DiamondParseFile &parse_file, uint16 file_index,
+                                   std::vector<DiamondParseChunk> &chunks) {
+    std::ifstream in_file(*parse_file.output_path, std::ios::binary);
+    std::string   line;
+    uint64        file_size;
+    uint64        chunk_size;
+    uint64        begin=0;
+    uint64        end;
+    uint16        threads = mThreads > 0 ? (uint16) mThreads : (uint16) 1;
+
+    in_file.seekg(0, std::ios::end);
+    file_size = (uint64) in_file.tellg();
+    chunk_size = std::min(PARSE_CHUNK_MAX_BYTES, std::max(PARSE_CHUNK_MIN_BYTES, file_size / threads + 1));
+
+    while (begin < file_size) {
+        end = begin + chunk_size;
+        if (end >= file_size) {
+            end = file_size;
+        } else {
+            // Move end to the start of the next line
+            in_file.seekg(end);
+            std::getline(in_file, line);
+            end = in_file.good() ? (uint64) in_file.tellg() : file_size;
+        }
+
+        DiamondParseChunk chunk;
+        chunk.file_index   = file_index;
+        chunk.begin        = begin;
+        chunk.end          = end;
+        chunk.last_in_file = false;
+        chunk.complete     = false;
+        chunk.err_code     = 0;
+        chunk.batch.missing_subjects = 0;
+        chunk.batch.is_uniprot       = false;
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+    chunks.back().last_in_file = true;
+}
+
+/**
+ * ======================================================================
+ * Function void ModDiamond::parse_chunk(DiamondParseFile &parse_file, DiamondParseChunk &chunk)
+ *
+ * Description          - Worker routine, reads chunk of DIAMOND output and
+ *                        parses it into the chunk hit batch
+ *
+ * Notes                - Errors are stored in the chunk and thrown when merged
+ *
+ * @param parse_file    - Output file chunk belongs to
+ * @param chunk         - Chunk to parse
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::parse_chunk(DiamondParseFile &parse_file, DiamondParseChunk &chunk) {
+    std::string buffer;     // Chunk contents
+
+    try {
+        std::ifstream in_file(*parse_file.output_path, std::ios::binary);
+        buffer.resize(chunk.end - chunk.begin);
+        in_file.seekg(chunk.begin);
+        if (!in_file.read(&buffer[0], buffer.size())) {
+            throw ExceptionHandler("Unable to read DIAMOND output: " + *parse_file.output_path,
+                                   ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+        }
+        in_file.close();
+
+        if (parse_file.index_path.empty()) {
+            parse_titled_chunk(*parse_file.output_path, buffer.data(), buffer.data() + buffer.size(),
+                               parse_file.is_uniprot, chunk.batch);
+        } else {
+            parse_indexed_chunk(*parse_file.output_path, buffer.data(), buffer.data() + buffer.size(),
+                                *parse_file.subject_index, chunk.batch);
+        }
+    } catch (ExceptionHandler &e) {
+        chunk.err_msg  = e.what();
+        chunk.err_code = e.getErr_code();
+    } catch (const std::exception &e) {
+        chunk.err_msg  = "Error parsing DIAMOND output: " + *parse_file.output_path + "\n" + e.what();
+        chunk.err_code = ERR_ENTAP_RUN_SIM_SEARCH_FILTER;
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void ModDiamond::parse_titled_chunk(std::string &output_path, const char *data_begin,
+ *                                              const char *data_end, bool is_uniprot,
+ *                                              DiamondHitBatch &batch)
+ *
+ * Description          - Parses DIAMOND output containing subject titles
+ *                      - Species, taxonomy, and UniProt information is
+ *                        resolved from each title/sseqid
+ *
+ * Notes                - Used when database has no SubjectIndex
+ *                      - Species and UniProt entries are resolved in bulk
+ *                        once the chunk is read
+ *
+ * @param output_path   - Absolute path to DIAMOND output
+ * @param data_begin    - Start of chunk data
+ * @param data_end      - End of chunk data
+ * @param is_uniprot    - Whether the database was determined to be UniProt
+ * @param batch         - Batch parsed hits are added to
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::parse_titled_chunk(std::string &output_path, const char *data_begin, const char *data_end,
+                                    bool is_uniprot, DiamondHitBatch &batch) {
+    std::string         qseqid;                         // Sequence ID of query sequence
+    QuerySequence::SimSearchResults simSearchResults;   // Compiled similarity search results
+    std::set<std::string> chunk_species;                // Unique species of chunk
+    std::set<std::string> chunk_accessions;             // Unique UniProt accessions of chunk
+    vect_str_t          row_accessions;                 // UniProt accession of each hit
+    EntapDatabase::tax_entry_ptr_map_t tax_entries;     // Entries from Taxonomic database for chunk species
+    EntapDatabase::uniprot_entry_ptr_map_t uniprot_entries; // Entries from UniProt database for chunk accessions
+    std::pair<bool, std::string> contam_info;           // Contaminate information
+
+    // Begin using CSVReader lib to parse data
+    io::CSVReader<DMND_COL_NUMBER, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in(output_path, data_begin, data_end);
+    while (in.read_row(qseqid, simSearchResults.sseqid, simSearchResults.pident_raw, simSearchResults.length,
+                       simSearchResults.mismatch, simSearchResults.gapopen, simSearchResults.qstart,
+                       simSearchResults.qend, simSearchResults.sstart, simSearchResults.send,
+                       simSearchResults.e_val_raw, simSearchResults.bit_score, simSearchResults.coverage_raw,
+                       simSearchResults.stitle)) {
+        simSearchResults.uniprot_info = nullptr;
+
+        // get species from database alignment title, resolved once per chunk below
+        simSearchResults.species = get_species(simSearchResults.stitle);
+        chunk_species.insert(simSearchResults.species);
+
+        // UniProt info is resolved once per chunk below
+        if (is_uniprot) {
+            row_accessions.push_back(mpEntapDatabase->get_uniprot_accession(simSearchResults.sseqid));
+            chunk_accessions.insert(row_accessions.back());
+        }
+
+        simSearchResults.is_informative = is_informative(simSearchResults.stitle, mUninformativeMatcher);
+
+        add_batch_hit(qseqid, output_path, batch, simSearchResults);
+    } // END WHILE LOOP
+
+    // get UniProt information for every unique accession of the chunk at once
+    if (is_uniprot) {
+        uniprot_entries = mpEntapDatabase->get_uniprot_entries(chunk_accessions);
+        for (uint64 i = 0; i < batch.results.size(); i++) {
+            batch.results[i].uniprot_info = uniprot_entries.at(row_accessions[i]);
+        }
+    }
+
+    // get taxonomic/contaminant information for every unique species of the chunk at once
+    tax_entries = mpEntapDatabase->get_tax_entries(chunk_species);
+    batch.tax_scores.reserve(batch.results.size());
+    for (QuerySequence::SimSearchResults &results : batch.results) {
+        const TaxEntry &taxEntry = *tax_entries.at(results.species);
+        contam_info = is_contaminant(taxEntry.lineage, taxEntry.lineage_path, mContaminantScreen);
+        results.lineage     = taxEntry.lineage;
+        results.contaminant = contam_info.first;
+        results.contam_type = contam_info.second;
+        LOWERCASE(results.species);     // Species are output lowercase, as matched to the database
+        batch.tax_scores.push_back(SimSearchAlignment::calculate_tax_score(taxEntry.lineage_path, mInputLineagePath,
+                                                                           results.is_informative));
+    }
+    batch.is_uniprot = is_uniprot;
+}
+
+/**
+ * ======================================================================
+ * Function bool ModDiamond::is_uniprot_output(std::string &output_path)
+ *
+ * Description          - Determines whether DIAMOND output (with titles)
+ *                        was run against a UniProt database
+ *
+ * Notes                - First UniProt match assumes the rest are UniProt as
+ *                        well, database is NOT UniProt after UNIPROT_ATTEMPTS
+ *
+ * @param output_path   - Absolute path to DIAMOND output
+ *
+ * @return              - True if database is UniProt
+ *
+ * =====================================================================
+ */
+bool ModDiamond::is_uniprot_output(std::string &output_path) {
+    uint32              uniprot_attempts=0;             // Number of attempts to determine if database is UniProt
+    std::string         qseqid;                         // Sequence ID of query sequence
+    QuerySequence::SimSearchResults simSearchResults;   // Compiled similarity search results
+
+    try {
+        io::CSVReader<DMND_COL_NUMBER, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in(output_path);
+        while (uniprot_attempts <= UNIPROT_ATTEMPTS &&
+               in.read_row(qseqid, simSearchResults.sseqid, simSearchResults.pident_raw, simSearchResults.length,
+                           simSearchResults.mismatch, simSearchResults.gapopen, simSearchResults.qstart,
+                           simSearchResults.qend, simSearchResults.sstart, simSearchResults.send,
+                           simSearchResults.e_val_raw, simSearchResults.bit_score, simSearchResults.coverage_raw,
+                           simSearchResults.stitle)) {
+            if (mpEntapDatabase->is_uniprot_entry(simSearchResults.sseqid, simSearchResults.uniprot_info)) {
+                FS_dprint("Database file at " + output_path + "\nDetermined to be UniProt");
+                return true;
+            }
+            uniprot_attempts++;
+        }
+    } catch (const std::exception &e) {
+        throw ExceptionHandler("Error parsing DIAMOND output: " + output_path + "\n" + e.what(),
+                               ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+    }
+    return false;
+}
+
+/**
+ * ======================================================================
+ * Function void ModDiamond::parse_indexed_chunk(std::string &output_path, const char *data_begin,
+ *                                               const char *data_end, SubjectIndex &subjectIndex,
+ *                                               DiamondHitBatch &batch)
+ *
+ * Description          - Parses DIAMOND output without subject titles
+ *                      - Subject title, species, taxonomy, contaminant/informative
+ *                        status, and UniProt accession are pulled from the index
+ *
+ * Notes                - Subjects missing from the index (database changed
+ *                        after configuration) are kept with sseqid as title
+ *
+ * @param output_path   - Absolute path to DIAMOND output
+ * @param data_begin    - Start of chunk data
+ * @param data_end      - End of chunk data
+ * @param subjectIndex  - Subject index of this database
+ * @param batch         - Batch parsed hits are added to
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::parse_indexed_chunk(std::string &output_path, const char *data_begin, const char *data_end,
+                                     SubjectIndex &subjectIndex, DiamondHitBatch &batch) {
+    std::string         qseqid;                         // Sequence ID of query sequence
+    std::set<std::string> chunk_accessions;             // Unique UniProt accessions of chunk
+    std::vector<const std::string*> row_accessions;     // UniProt accession of each hit, nullptr if none
+    EntapDatabase::uniprot_entry_ptr_map_t uniprot_entries; // Entries from UniProt database for chunk accessions
+    QuerySequence::SimSearchResults simSearchResults;   // Compiled similarity search results
+    const SubjectIndex::SubjectInfo *subject;           // Indexed subject information
+    const tax_path_t    empty_path;                     // Lineage path of subjects missing from index
+
+    batch.is_uniprot = subjectIndex.has_uniprot();
+
+    io::CSVReader<DMND_COL_NUMBER_INDEXED, io::trim_chars<' '>, io::no_quote_escape<'\t'>> in(output_path, data_begin, data_end);
+    while (in.read_row(qseqid, simSearchResults.sseqid, simSearchResults.pident_raw, simSearchResults.length,
+                       simSearchResults.mismatch, simSearchResults.gapopen, simSearchResults.qstart,
+                       simSearchResults.qend, simSearchResults.sstart, simSearchResults.send,
+                       simSearchResults.e_val_raw, simSearchResults.bit_score, simSearchResults.coverage_raw)) {
+        simSearchResults.uniprot_info = nullptr;
+
+        subject = subjectIndex.find_subject(simSearchResults.sseqid);
+        if (subject != nullptr) {
+            simSearchResults.stitle         = subject->title;
+            simSearchResults.species        = StringInterner::get(subject->species);
+            simSearchResults.lineage        = StringInterner::get(subject->lineage);
+            simSearchResults.contaminant    = subject->contaminant;
+            simSearchResults.contam_type    = StringInterner::get(subject->contam_type);
+            simSearchResults.is_informative = subject->informative;
+            if (!subject->accession.empty()) {
+                chunk_accessions.insert(subject->accession);
+                row_accessions.push_back(&subject->accession);
+            } else {
+                row_accessions.push_back(nullptr);
+            }
+        } else {
+            batch.missing_subjects++;
+            simSearchResults.stitle         = simSearchResults.sseqid;
+            simSearchResults.species        = "";
+            simSearchResults.lineage        = "";
+            simSearchResults.contaminant    = false;
+            simSearchResults.contam_type    = "";
+            simSearchResults.is_informative = is_informative(simSearchResults.stitle, mUninformativeMatcher);
+            row_accessions.push_back(nullptr);
+        }
+
+        add_batch_hit(qseqid, output_path, batch, simSearchResults);
+        batch.tax_scores.push_back(SimSearchAlignment::calculate_tax_score(
+                subject != nullptr ? *subject->lineage_path : empty_path, mInputLineagePath,
+                simSearchResults.is_informative));
+    } // END WHILE LOOP
+
+    // get UniProt information for every unique accession of the chunk at once
+    if (chunk_accessions.empty()) return;
+    uniprot_entries = mpEntapDatabase->get_uniprot_entries(chunk_accessions);
+    for (uint64 i = 0; i < batch.results.size(); i++) {
+        if (row_accessions[i] != nullptr) batch.results[i].uniprot_info = uniprot_entries.at(*row_accessions[i]);
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void ModDiamond::add_batch_hit(std::string &qseqid, std::string &output_path,
+ *                          DiamondHitBatch &batch,
+ *                          QuerySequence::SimSearchResults &simSearchResults)
+ *
+ * Description          - Adds parsed hit to worker batch with its query
+ *                        sequence
+ *
+ * Notes                - QueryData is only read here, never modified
+ *
+ * @param qseqid           - Query sequence ID
+ * @param output_path      - Absolute path to DIAMOND output (error reporting)
+ * @param batch            - Worker batch
+ * @param simSearchResults - Parsed hit
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::add_batch_hit(std::string &qseqid, std::string &output_path, DiamondHitBatch &batch,
+                               QuerySequence::SimSearchResults &simSearchResults) {
+    // Get pointer to sequence in overall map
+    QuerySequence *query = mpQueryData->get_sequence(qseqid);
+    if (query == nullptr) {
+        throw ExceptionHandler("Unable to find sequence in transcriptome: " + qseqid + " from file: " + output_path,
+                               ERR_ENTAP_RUN_SIM_SEARCH_FILTER);
+    }
+
+    batch.queries.push_back(query);
+    batch.results.push_back(simSearchResults);
+}
+
+/**
+ * ======================================================================
+ * Function void ModDiamond::merge_hit_batch(DiamondHitBatch &batch, SimSearchHitStore *hit_store)
+ *
+ * Description          - Stores batch hits in the database hit store and adds
+ *                        alignments to their query sequences
+ *                      - Batch memory is released once merged
+ *
+ * Notes                - Called from parsing thread only, in chunk order
+ *
+ * @param batch         - Parsed worker batch
+ * @param hit_store     - Hit store of this database
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void ModDiamond::merge_hit_batch(DiamondHitBatch &batch, SimSearchHitStore *hit_store) {
+    SimSearchHitStore::row_t hit_row;   // Row of hit in store
+
+    if (batch.is_uniprot) set_uniprot_headers();
+
+    for (uint64 i = 0; i < batch.results.size(); i++) {
+        // Typed data is stored once in the database hit store, alignment is a view of that row
+        hit_row = hit_store->add_hit(batch.results[i], batch.tax_scores[i]);
+        batch.queries[i]->add_alignment(mExecutionState, mSoftwareFlag, hit_store, hit_row);
+    }
+
+    std::vector<QuerySequence*>().swap(batch.queries);
+    std::vector<QuerySequence::SimSearchResults>().swap(batch.results);
+    std::vector<fp32>().swap(batch.tax_scores);
+}
+
+/**
+ * ======================================================================
+ * Function uint16 ModDiamond::get_output_column_count(std::string &output_path)
+ *
+ * Description          - Returns number of columns in first line of DIAMOND
+ *                        output (with or without subject titles)
+ *
+ * Notes                - None
+ *
+ * @param output_path   - Absolute path to DIAMOND output
+ *
+ * @return              - Column count, 0 if file could not be read
+ *
+ * =====================================================================
+ */
+uint16 ModDiamond::get_output_column_count(std::string &output_path) {
+    std::ifstream in_file(output_path);
+    std::string   line;
+
+    if (!std::getline(in_file, line)) return 0;
+    return (uint16) (std::count(line.begin(), line.end(), FileSystem::DELIM_TSV) + 1);
+}
+
 typedef std::map<std::string,std::map<std::string,uint32>> graph_sum_t;
 
 
@@ -548,20 +973,17 @@ void ModDiamond::calculate_best_stats (bool is_final, std::string database_path)
             } else {
                 // HIT a database during sim search
 
-                QuerySequence::SimSearchResults *sim_search_data;
                 SimSearchAlignment *best_hit;
                 // Process unselected hits for non-final analysis and set best hit pointer
                 if (is_final) {
                     best_hit =
                             pair.second->get_best_hit_alignment<SimSearchAlignment>(
                                     SIMILARITY_SEARCH, SIM_DIAMOND,"");
-                    sim_search_data = best_hit->get_results();
                 } else {
                     best_hit = pair.second->get_best_hit_alignment<SimSearchAlignment>(
                             SIMILARITY_SEARCH, SIM_DIAMOND,database_path);
                     QuerySequence::align_database_hits_t *alignment_data =
                             pair.second->get_database_hits(database_path,SIMILARITY_SEARCH, SIM_DIAMOND);
-                    sim_search_data = best_hit->get_results();
                     for (auto &hit : *alignment_data) {
                         count_TOTAL_alignments++;
                         if (hit != best_hit) {  // If this hit is not the best hit
@@ -578,15 +1000,15 @@ void ModDiamond::calculate_best_stats (bool is_final, std::string database_path)
                 mpQueryData->add_alignment_data(out_best_hits_filepath, pair.second, best_hit);
 
                 frame = pair.second->getFrame();     // Used for graphing
-                species = sim_search_data->species;
+                species = best_hit->get_species();
 
                 // Determine contaminant information and print to files
-                if (sim_search_data->contaminant) {
+                if (best_hit->is_contaminant()) {
                     // Species is considered a contaminant
                     count_contam++;
                     mpQueryData->add_alignment_data(out_best_contams_filepath, pair.second, best_hit);
 
-                    contam = sim_search_data->contam_type;
+                    contam = best_hit->get_contam_type();
                     contam_counter.add_value(contam);
                     contam_species_counter.add_value(species);
                 } else {
@@ -598,7 +1020,7 @@ void ModDiamond::calculate_best_stats (bool is_final, std::string database_path)
                 species_counter.add_value(species);
 
                 // Check if this is an informative alignment and respond accordingly
-                if (sim_search_data->is_informative) {
+                if (best_hit->is_informative()) {
                     count_informative++;
                     // Graphing
                     if (!frame.empty()) {
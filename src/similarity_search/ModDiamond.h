@@ -29,7 +29,10 @@
 #define ENTAP_MODDIAMOND_H
 
 
+#include <memory>
 #include "AbstractSimilaritySearch.h"
+#include "SubjectIndex.h"
+#include "../QuerySequence.h"
 
 /**
  * ======================================================================
@@ -73,8 +76,59 @@ private:
     void calculate_best_stats(bool is_final, std::string database_path="");
     //**********************************************************
 
+    //***************** Parallel Parse Structs *****************
+    // Hits parsed by a worker from one chunk of DIAMOND output, in file order
+    struct DiamondHitBatch {
+        std::vector<QuerySequence*>                  queries;
+        std::vector<QuerySequence::SimSearchResults> results;
+        std::vector<fp32>                            tax_scores;
+        uint64                                       missing_subjects;  // Subjects not found in index
+        bool                                         is_uniprot;
+    };
+
+    // DIAMOND output file being parsed
+    struct DiamondParseFile {
+        std::string                  *output_path;
+        SimSearchHitStore            *hit_store;
+        std::string                   index_path;       // Subject index, empty if output contains titles
+        std::unique_ptr<SubjectIndex> subject_index;    // Read once the first chunk of the file is queued
+        uint64                        missing_subjects;
+        bool                          is_uniprot;       // Titled output only, decided before chunks are parsed
+    };
+
+    // Line aligned byte range of a DIAMOND output file
+    struct DiamondParseChunk {
+        uint16          file_index;
+        uint64          begin;
+        uint64          end;
+        bool            last_in_file;
+        bool            complete;       // Set by worker once parsed (or failed)
+        std::string     err_msg;        // Non-empty if parsing failed
+        int             err_code;
+        DiamondHitBatch batch;
+    };
+    //**********************************************************
+
+    //****************** Parse Functions ***********************
+    void split_output_file(DiamondParseFile &parse_file, uint16 file_index, std::vector<DiamondParseChunk> &chunks);
+    void parse_chunk(DiamondParseFile &parse_file, DiamondParseChunk &chunk);
+    void parse_titled_chunk(std::string &output_path, const char *data_begin, const char *data_end,
+                            bool is_uniprot, DiamondHitBatch &batch);
+    bool is_uniprot_output(std::string &output_path);
+    void parse_indexed_chunk(std::string &output_path, const char *data_begin, const char *data_end,
+                             SubjectIndex &subjectIndex, DiamondHitBatch &batch);
+    void add_batch_hit(std::string &qseqid, std::string &output_path, DiamondHitBatch &batch,
+                       QuerySequence::SimSearchResults &simSearchResults);
+    void merge_hit_batch(DiamondHitBatch &batch, SimSearchHitStore *hit_store);
+    uint16 get_output_column_count(std::string &output_path);
+    //**********************************************************
+
     //**************** Private Const Variables *****************
     static constexpr int DMND_COL_NUMBER = 14;
+    static constexpr int DMND_COL_NUMBER_INDEXED = 13;    // No stitle, subject metadata from SubjectIndex
+    static constexpr uint64 PARSE_CHUNK_MIN_BYTES = 16 * 1024 * 1024; // Smallest chunk of output given to a worker
+    static constexpr uint64 PARSE_CHUNK_MAX_BYTES = 64 * 1024 * 1024; // Largest chunk of output read into memory
+    static constexpr uint64 PARSE_CHUNKS_PER_THREAD = 2;               // Chunks queued ahead of the merge per thread
     static std::vector<ENTAP_HEADERS> UNIPROT_HEADERS;
     static std::vector<ENTAP_HEADERS> DEFAULT_HEADERS;
 
@@ -96,6 +150,7 @@ private:
     // Terminal Command EntapDefaults
     const uint16 CMD_DEFAULT_TOP_ALIGN  = 3;
     const std::string CMD_DEFAULT_OUTPUT_FORMAT = "6 qseqid sseqid pident length mismatch gapopen qstart qend sstart send evalue bitscore qcovhsp stitle";
+    const std::string CMD_INDEXED_OUTPUT_FORMAT = "6 qseqid sseqid pident length mismatch gapopen qstart qend sstart send evalue bitscore qcovhsp";
 
     // Terminal Commands (as of DIAMOND v0.9.9)
     const std::string CMD_QUERY_COVERAGE   = "--query-cover";     // Specify minimum query coverage for alignment
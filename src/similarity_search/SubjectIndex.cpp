@@ -0,0 +1,633 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "SubjectIndex.h"
+#include "AbstractSimilaritySearch.h"
+
+constexpr uint16 SubjectIndex::SUBJECT_SHARDS;
+constexpr char   SubjectIndex::TERM_DELIM;
+const std::string SubjectIndex::INFO_VERSION       = "version";
+const std::string SubjectIndex::INFO_REVISION      = "revision";
+const std::string SubjectIndex::INFO_CONTAMINANTS  = "contaminants";
+const std::string SubjectIndex::INFO_UNINFORMATIVE = "uninformative";
+const std::string SubjectIndex::INFO_UNIPROT       = "uniprot";
+
+SubjectIndex::SubjectIndex(FileSystem *fileSystem) {
+    mpFileSystem    = fileSystem;
+    mpContaminants  = nullptr;
+    mpUninformative = nullptr;
+    mpEntapDatabase = nullptr;
+    clear();
+}
+
+/**
+ * ======================================================================
+ * Function std::string SubjectIndex::get_index_path(const std::string &database_path)
+ *
+ * Description          - Returns path to the subject index that belongs to a
+ *                        DIAMOND database (.dmnd extension replaced)
+ *
+ * Notes                - None
+ *
+ * @param database_path - Absolute path to DIAMOND database
+ *
+ * @return              - Absolute path to subject index
+ *
+ * =====================================================================
+ */
+std::string SubjectIndex::get_index_path(const std::string &database_path) {
+    std::string base_path = database_path;
+
+    if (base_path.size() > FileSystem::EXT_DMND.size() &&
+        base_path.compare(base_path.size() - FileSystem::EXT_DMND.size(),
+                          FileSystem::EXT_DMND.size(), FileSystem::EXT_DMND) == 0) {
+        base_path.erase(base_path.size() - FileSystem::EXT_DMND.size());
+    }
+    return base_path + FileSystem::EXT_SUBJ;
+}
+
+/**
+ * ======================================================================
+ * Function bool SubjectIndex::generate_index(std::string &fasta_path, std::string &out_path,
+ *                              EntapDatabase *entapDatabase, vect_str_t &contaminants,
+ *                              vect_str_t &uninformative)
+ *
+ * Description          - Reads every header of a FASTA database and resolves
+ *                        species, lineage, UniProt accession, and contaminant/
+ *                        informative status for the subject
+ *                      - Writes results to out_path as a mapped index
+ *
+ * Notes                - Subject ID is the first word of the header, same as
+ *                        DIAMOND sseqid. Title is the full header (stitle)
+ *
+ * @param fasta_path    - Absolute path to FASTA database (uncompressed)
+ * @param out_path      - Absolute path to output subject index
+ * @param entapDatabase - EnTAP database to pull taxonomic/UniProt info from
+ * @param contaminants  - Contaminant terms (lowercase)
+ * @param uninformative - Uninformative terms (lowercase)
+ *
+ * @return              - TRUE if index was generated
+ *
+ * =====================================================================
+ */
+bool SubjectIndex::generate_index(std::string &fasta_path, std::string &out_path, EntapDatabase *entapDatabase,
+                                  vect_str_t &contaminants, vect_str_t &uninformative) {
+    SubjectIndexData  index_data;           // Subjects and species/lineage string table
+    SubjectRecord     record;               // Current subject
+    const TaxEntry   *taxEntry;             // Taxonomic entry of subject species
+    const UniprotEntry *uniprotEntry;       // UniProt entry of subject (if UniProt)
+    std::string       line;
+    std::string       species;
+    std::string       err_msg;
+    uint64            ind;
+    uint64            ct=0;
+    bool              has_uniprot=false;
+    std::unordered_map<std::string, uint32> string_indices;   // Species/lineage to string table index
+    std::unordered_map<std::string, bool>   seen_subjects;    // Duplicate sseqid check
+    std::unordered_map<uint64, std::string> mask_strings;     // Contaminant mask to its stored value
+    MappedDatabase::section_data_t subject_data;
+    MappedDatabase::section_data_t info_data;
+    ContaminantScreen contam_screen;
+    KeywordMatcher    uninform_matcher(uninformative);
+    const std::string informative_values[2] = {"0", "1"};
+
+    FS_dprint("Generating subject index from: " + fasta_path);
+
+    std::ifstream in_file(fasta_path);
+    if (!in_file.is_open()) {
+        FS_dprint("ERROR unable to open FASTA database: " + fasta_path);
+        return false;
+    }
+
+    contam_screen.set_contaminants(contaminants, entapDatabase);
+
+    index_data.strings.push_back("");       // Index 0 is always empty
+    string_indices[""] = 0;
+
+    // Species and lineage repeat across subjects, only keep one copy
+    auto get_string_index = [&index_data, &string_indices](const std::string &val) -> uint32 {
+        auto it = string_indices.find(val);
+        if (it != string_indices.end()) return it->second;
+        uint32 ind = (uint32) index_data.strings.size();
+        index_data.strings.push_back(val);
+        string_indices.emplace(val, ind);
+        return ind;
+    };
+
+    while (std::getline(in_file, line)) {
+        if (line.empty() || line[0] != FileSystem::FASTA_FLAG) continue;
+        if (line.back() == '\r') line.pop_back();
+
+        record = {};
+        record.title = line.substr(1);
+        ind = record.title.find_first_of(" \t");
+        record.sseqid = record.title.substr(0, ind);
+        if (record.sseqid.empty() || !seen_subjects.emplace(record.sseqid, true).second) continue;
+
+        species = AbstractSimilaritySearch::get_species(record.title);
+        taxEntry = entapDatabase->get_tax_entry(species);   // species lowercased, same as during parsing
+        record.species = get_string_index(species);
+        record.lineage = get_string_index(taxEntry->lineage);
+        record.contam_mask = get_contam_mask(taxEntry->lineage, taxEntry->lineage_path, contam_screen);
+        record.informative = AbstractSimilaritySearch::is_informative(record.title, uninform_matcher);
+
+        if (entapDatabase->is_uniprot_entry(record.sseqid, uniprotEntry)) {
+            record.accession = record.sseqid.substr(record.sseqid.rfind('|') + 1);
+            has_uniprot = true;
+        }
+        index_data.subjects.push_back(record);
+
+        if (++ct % STATUS_UPDATE_SUBJECTS == 0) {
+            FS_dprint("Subjects indexed: " + std::to_string(ct));
+        }
+    }
+    in_file.close();
+    seen_subjects.clear();
+    string_indices.clear();
+
+    // Subjects and string table are complete, pointers into them stay valid
+    //  Shared values pass a single pointer so they are pooled once
+    subject_data.reserve(index_data.subjects.size());
+    for (const SubjectRecord &subject : index_data.subjects) {
+        const std::string &mask = mask_strings.emplace(subject.contam_mask,
+                                                       std::to_string(subject.contam_mask)).first->second;
+        subject_data.push_back({&subject.sseqid, &subject.title, &subject.accession,
+                                &index_data.strings[subject.species], &index_data.strings[subject.lineage],
+                                &mask, &informative_values[subject.informative ? 1 : 0]});
+    }
+
+    const std::string version       = std::to_string(INDEX_VERSION);
+    const std::string revision      = std::to_string(entapDatabase->get_revision());
+    const std::string contam_terms  = join_terms(contaminants);
+    const std::string uninform_terms = join_terms(uninformative);
+    info_data.push_back({&INFO_VERSION, &version});
+    info_data.push_back({&INFO_REVISION, &revision});
+    info_data.push_back({&INFO_CONTAMINANTS, &contam_terms});
+    info_data.push_back({&INFO_UNINFORMATIVE, &uninform_terms});
+    info_data.push_back({&INFO_UNIPROT, &informative_values[has_uniprot ? 1 : 0]});
+
+    if (!MappedDatabase::write_subject_index(out_path, subject_data, info_data, err_msg)) {
+        FS_dprint("ERROR unable to write subject index: " + err_msg);
+        mpFileSystem->delete_file(out_path);
+        return false;
+    }
+    FS_dprint("Subject index with " + std::to_string(ct) + " subjects written to: " + out_path);
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool SubjectIndex::read_index(std::string &index_path,
+ *                                        const ContaminantScreen &contaminants,
+ *                                        const KeywordMatcher &uninformative,
+ *                                        EntapDatabase *entapDatabase)
+ *
+ * Description          - Opens subject index generated at configuration
+ *                      - Checks whether contaminant/informative statuses
+ *                        must be recomputed (terms differ from those used at
+ *                        configuration) and whether species lineages must be
+ *                        resolved again (EnTAP database revision changed
+ *                        since configuration, --data-delta)
+ *
+ * Notes                - Mapped indexes are only mapped here, subjects are
+ *                        resolved by find_subject
+ *                      - Contaminants, uninformative terms, and the EnTAP
+ *                        database must outlive the index
+ *
+ * @param index_path    - Absolute path to subject index
+ * @param contaminants  - Contaminant taxons for this execution
+ * @param uninformative - Uninformative terms for this execution
+ * @param entapDatabase - EnTAP database in use for this execution
+ *
+ * @return              - TRUE if index was read
+ *
+ * =====================================================================
+ */
+bool SubjectIndex::read_index(std::string &index_path, const ContaminantScreen &contaminants,
+                              const KeywordMatcher &uninformative, EntapDatabase *entapDatabase) {
+
+    FS_dprint("Reading subject index from: " + index_path);
+
+    clear();
+    mpContaminants  = &contaminants;
+    mpUninformative = &uninformative;
+    mpEntapDatabase = entapDatabase;
+    for (const std::string &val : contaminants.get_contaminants()) {
+        mContamHandles.push_back(StringInterner::intern(val));
+    }
+
+    if (!mpFileSystem->file_exists(index_path)) return false;
+
+    if (mMappedIndex.open(index_path)) {
+        return read_mapped_index(index_path);
+    }
+    FS_dprint("Subject index is not mapped (" + mMappedIndex.get_error() + "), reading as an archive");
+    return read_archive_index(index_path);
+}
+
+/**
+ * ======================================================================
+ * Function bool SubjectIndex::read_mapped_index(const std::string &index_path)
+ *
+ * Description          - Reads index wide settings of a mapped index
+ *
+ * Notes                - Index must already be open (mMappedIndex)
+ *
+ * @param index_path    - Absolute path to subject index
+ *
+ * @return              - TRUE if index can be used
+ *
+ * =====================================================================
+ */
+bool SubjectIndex::read_mapped_index(const std::string &index_path) {
+    std::string version;
+    std::string revision;
+    std::string contam_terms;
+    std::string uninform_terms;
+    std::string uniprot;
+
+    if (!mMappedIndex.find_subject_info(INFO_VERSION, version) ||
+        !mMappedIndex.find_subject_info(INFO_REVISION, revision) ||
+        !mMappedIndex.find_subject_info(INFO_CONTAMINANTS, contam_terms) ||
+        !mMappedIndex.find_subject_info(INFO_UNINFORMATIVE, uninform_terms) ||
+        !mMappedIndex.find_subject_info(INFO_UNIPROT, uniprot)) {
+        FS_dprint("ERROR subject index is missing settings: " + index_path);
+        clear();
+        return false;
+    }
+    if (version != std::to_string(INDEX_VERSION)) {
+        FS_dprint("WARNING subject index version mismatch, not using: " + index_path);
+        clear();
+        return false;
+    }
+
+    set_statuses(split_terms(contam_terms), split_terms(uninform_terms),
+                 (uint32) std::strtoul(revision.c_str(), nullptr, 10));
+    mMapped       = true;
+    mHasUniprot   = uniprot == "1";
+    mSubjectCount = mMappedIndex.get_subject_count();
+    FS_dprint("Success! Subject index mapped with " + std::to_string(mSubjectCount) + " subjects");
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function bool SubjectIndex::read_archive_index(const std::string &index_path)
+ *
+ * Description          - Reads a version 1/2 index (serialized archive) and
+ *                        resolves every subject
+ *
+ * Notes                - Lineages are resolved again up front if the EnTAP
+ *                        database changed, once per species
+ *
+ * @param index_path    - Absolute path to subject index
+ *
+ * @return              - TRUE if index was read
+ *
+ * =====================================================================
+ */
+bool SubjectIndex::read_archive_index(const std::string &index_path) {
+    SubjectIndexData             index_data;
+    std::vector<StringInterner::handle_t> string_handles;   // String table index to handle
+
+    try {
+        std::ifstream in_file(index_path, std::ios::binary);
+#ifdef USE_BOOST
+        boost::archive::binary_iarchive ia(in_file);
+        ia >> index_data;
+#else
+        cereal::BinaryInputArchive iarchive(in_file);
+        iarchive(index_data);
+#endif
+        in_file.close();
+    } catch (const std::exception &e) {
+        FS_dprint("ERROR unable to read subject index: " + std::string(e.what()));
+        return false;
+    }
+
+    if (index_data.version < INDEX_VERSION_MIN || index_data.version > ARCHIVE_VERSION_MAX) {
+        FS_dprint("WARNING subject index version mismatch, not using: " + index_path);
+        return false;
+    }
+
+    set_statuses(index_data.contaminants, index_data.uninformative, index_data.database_revision);
+    if (mResolveLineages) {
+        resolve_lineages(index_data, mpEntapDatabase);
+        mResolveLineages = false;   // Records now hold current lineages
+    }
+
+    string_handles.reserve(index_data.strings.size());
+    for (std::string &val : index_data.strings) {
+        string_handles.push_back(StringInterner::intern(val));
+    }
+
+    for (SubjectRecord &record : index_data.subjects) {
+        SubjectInfo info;
+
+        if (record.species >= string_handles.size() || record.lineage >= string_handles.size()) {
+            FS_dprint("ERROR subject index corrupt at: " + record.sseqid);
+            clear();
+            return false;
+        }
+        info.title     = std::move(record.title);
+        info.accession = std::move(record.accession);
+        info.species   = string_handles[record.species];
+        info.lineage   = string_handles[record.lineage];
+        resolve_subject(info, index_data.strings[record.lineage], record.contam_mask, record.informative);
+
+        if (!info.accession.empty()) mHasUniprot = true;
+        if (get_shard(record.sseqid).subjects.emplace(std::move(record.sseqid), std::move(info)).second) {
+            mSubjectCount++;
+        }
+    }
+    FS_dprint("Success! Subjects read: " + std::to_string(mSubjectCount));
+    return true;
+}
+
+/**
+ * ======================================================================
+ * Function void SubjectIndex::set_statuses(const vect_str_t &contaminants,
+ *                                          const vect_str_t &uninformative,
+ *                                          uint32 database_revision)
+ *
+ * Description          - Compares settings the index was generated with to
+ *                        those of this execution
+ *
+ * Notes                - Contaminant masks are not reused once lineages must
+ *                        be resolved again, they were computed from the
+ *                        previous lineages
+ *
+ * @param contaminants      - Contaminant terms used for stored masks
+ * @param uninformative     - Uninformative terms used for stored flags
+ * @param database_revision - EnTAP database revision lineages were resolved from
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void SubjectIndex::set_statuses(const vect_str_t &contaminants, const vect_str_t &uninformative,
+                                uint32 database_revision) {
+    mReuseContam = contaminants == mpContaminants->get_contaminants() &&
+                   contaminants.size() <= CONTAM_MASK_BITS;
+    mResolveLineages = database_revision != mpEntapDatabase->get_revision();
+    if (mResolveLineages) {
+        FS_dprint("EnTAP database changed since configuration, resolving subject lineages");
+        mReuseContam = false;
+    }
+    mReuseInform = uninformative == mpUninformative->get_keywords();
+    if (!mReuseContam) {
+        FS_dprint("Contaminant terms changed since configuration, recomputing");
+    }
+    if (!mReuseInform) {
+        FS_dprint("Uninformative terms changed since configuration, recomputing");
+    }
+}
+
+/**
+ * ======================================================================
+ * Function void SubjectIndex::resolve_subject(SubjectInfo &info, const std::string &lineage,
+ *                                             uint64 contam_mask, bool informative)
+ *
+ * Description          - Sets lineage path and contaminant/informative
+ *                        status of a subject
+ *
+ * Notes                - Stored statuses are used unless terms changed
+ *                        since configuration
+ *
+ * @param info          - Subject, title and lineage already set
+ * @param lineage       - Lineage of subject
+ * @param contam_mask   - Stored contaminant mask
+ * @param informative   - Stored informative flag
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void SubjectIndex::resolve_subject(SubjectInfo &info, const std::string &lineage, uint64 contam_mask,
+                                   bool informative) {
+    std::pair<bool, std::string> contam_info;
+    uint16                       bit;
+
+    info.lineage_path = get_lineage_path(info.lineage, lineage);
+
+    if (mReuseContam) {
+        info.contaminant = contam_mask != 0;
+        info.contam_type = StringInterner::EMPTY_HANDLE;
+        for (bit = 0; bit < mContamHandles.size(); bit++) {
+            if (contam_mask & ((uint64)1 << bit)) {
+                // First matching term in list order, same as AbstractSimilaritySearch::is_contaminant
+                info.contam_type = mContamHandles[bit];
+                break;
+            }
+        }
+    } else {
+        contam_info = AbstractSimilaritySearch::is_contaminant(lineage, *info.lineage_path, *mpContaminants);
+        info.contaminant = contam_info.first;
+        info.contam_type = StringInterner::intern(contam_info.second);
+    }
+
+    if (mReuseInform) {
+        info.informative = informative;
+    } else {
+        info.informative = AbstractSimilaritySearch::is_informative(info.title, *mpUninformative);
+    }
+}
+
+// Lineage paths are built once per lineage, SubjectInfo points to them
+const tax_path_t *SubjectIndex::get_lineage_path(StringInterner::handle_t handle, const std::string &lineage) {
+    std::lock_guard<std::mutex> lock(mLineageMutex);
+    auto it = mLineagePaths.find(handle);
+
+    if (it == mLineagePaths.end()) {
+        it = mLineagePaths.emplace(handle, tax_path_t()).first;
+        EntapDatabase::get_lineage_path(lineage, it->second);
+    }
+    return &it->second;
+}
+
+SubjectIndex::SubjectShard &SubjectIndex::get_shard(const std::string &sseqid) {
+    return mShards[std::hash<std::string>()(sseqid) % SUBJECT_SHARDS];
+}
+
+void SubjectIndex::clear() {
+    mMappedIndex.close();
+    mMapped          = false;
+    mHasUniprot      = false;
+    mSubjectCount    = 0;
+    mReuseContam     = false;
+    mReuseInform     = false;
+    mResolveLineages = false;
+    mContamHandles.clear();
+    for (SubjectShard &shard : mShards) {
+        shard.subjects.clear();
+    }
+    mLineagePaths.clear();
+}
+
+/**
+ * ======================================================================
+ * Function void SubjectIndex::resolve_lineages(SubjectIndexData &index_data,
+ *                                              EntapDatabase *entapDatabase)
+ *
+ * Description          - Points every subject to the lineage of its species
+ *                        in the EnTAP database in use
+ *
+ * Notes                - New lineages are appended to the string table,
+ *                        each species is looked up once
+ *
+ * @param index_data    - Index read from file, lineages updated
+ * @param entapDatabase - EnTAP database in use for this execution
+ *
+ * @return              - None
+ *
+ * =====================================================================
+ */
+void SubjectIndex::resolve_lineages(SubjectIndexData &index_data, EntapDatabase *entapDatabase) {
+    std::unordered_map<uint32, uint32>      species_lineages;   // Species to lineage string index
+    std::unordered_map<std::string, uint32> lineage_indices;    // Lineage to appended string index
+    std::string                             species;
+    const TaxEntry                         *taxEntry;
+
+    for (SubjectRecord &record : index_data.subjects) {
+        if (record.species >= index_data.strings.size()) continue;     // Corrupt, rejected when read
+        auto it = species_lineages.find(record.species);
+        if (it == species_lineages.end()) {
+            species  = index_data.strings[record.species];
+            taxEntry = entapDatabase->get_tax_entry(species);
+            auto lineage_it = lineage_indices.emplace(taxEntry->lineage, (uint32) index_data.strings.size());
+            if (lineage_it.second) index_data.strings.push_back(taxEntry->lineage);
+            it = species_lineages.emplace(record.species, lineage_it.first->second).first;
+        }
+        record.lineage = it->second;
+    }
+}
+
+/**
+ * ======================================================================
+ * Function const SubjectInfo *SubjectIndex::find_subject(const std::string &sseqid)
+ *
+ * Description          - Returns subject information for sseqid
+ *                      - Mapped indexes resolve the subject the first time
+ *                        it is requested, later requests reuse it
+ *
+ * Notes                - Thread safe, returned subject is valid until the
+ *                        index is read again or destroyed
+ *
+ * @param sseqid        - Subject sequence ID from DIAMOND output
+ *
+ * @return              - Pointer to subject info, nullptr if not found
+ *
+ * =====================================================================
+ */
+const SubjectIndex::SubjectInfo *SubjectIndex::find_subject(const std::string &sseqid) {
+    SubjectShard     &shard = get_shard(sseqid);
+    SubjectIndexEntry entry;
+    SubjectInfo       info;
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.subjects.find(sseqid);
+        if (it != shard.subjects.end()) return &it->second;
+    }
+    if (!mMapped || !mMappedIndex.find_subject_entry(sseqid, entry)) return nullptr;
+
+    if (mResolveLineages) {
+        entry.lineage = mpEntapDatabase->get_tax_entry(entry.species)->lineage;
+    }
+    info.title     = std::move(entry.title);
+    info.accession = std::move(entry.accession);
+    info.species   = StringInterner::intern(entry.species);
+    info.lineage   = StringInterner::intern(entry.lineage);
+    resolve_subject(info, entry.lineage, entry.contam_mask, entry.informative);
+
+    // Another worker may have resolved it meanwhile, the first one is kept
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return &shard.subjects.emplace(sseqid, std::move(info)).first->second;
+}
+
+bool SubjectIndex::has_uniprot() const {
+    return mHasUniprot;
+}
+
+uint64 SubjectIndex::get_subject_count() const {
+    return mSubjectCount;
+}
+
+/**
+ * ======================================================================
+ * Function uint64 SubjectIndex::get_contam_mask(const std::string &lineage,
+ *                                               const tax_path_t &lineage_path,
+ *                                               const ContaminantScreen &contaminants)
+ *
+ * Description          - Sets a bit for every contaminant the lineage falls
+ *                        under
+ *
+ * Notes                - Only the first CONTAM_MASK_BITS terms are represented,
+ *                        masks are recomputed at read if more are used
+ *
+ * @param lineage       - Lineage of subject
+ * @param lineage_path  - Lineage path of subject
+ * @param contaminants  - Resolved contaminant taxons
+ *
+ * @return              - Contaminant bit mask
+ *
+ * =====================================================================
+ */
+uint64 SubjectIndex::get_contam_mask(const std::string &lineage, const tax_path_t &lineage_path,
+                                     const ContaminantScreen &contaminants) {
+    uint64 mask = 0;
+    std::vector<uint32> contam_indices;
+
+    contaminants.find_contaminants(lineage, lineage_path, contam_indices);
+    for (uint32 ind : contam_indices) {
+        if (ind >= CONTAM_MASK_BITS) break;
+        mask |= ((uint64)1 << ind);
+    }
+    return mask;
+}
+
+std::string SubjectIndex::join_terms(const vect_str_t &terms) {
+    std::string out;
+
+    for (const std::string &term : terms) {
+        if (&term != &terms.front()) out += TERM_DELIM;
+        out += term;
+    }
+    return out;
+}
+
+vect_str_t SubjectIndex::split_terms(const std::string &terms) {
+    vect_str_t  out;
+    std::string term;
+
+    std::istringstream stream(terms);
+    while (std::getline(stream, term, TERM_DELIM)) {
+        out.push_back(term);
+    }
+    return out;
+}
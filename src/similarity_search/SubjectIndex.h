@@ -0,0 +1,215 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ENTAP_SUBJECTINDEX_H
+#define ENTAP_SUBJECTINDEX_H
+
+#include <mutex>
+#include "../common.h"
+#include "../StringInterner.h"
+#include "../KeywordMatcher.h"
+#include "ContaminantScreen.h"
+#include "../database/EntapDatabase.h"
+#include "../database/MappedDatabase.h"
+
+/**
+ * ======================================================================
+ * @class SubjectIndex
+ *
+ * Description          - Side index of subject (database sequence) metadata
+ *                        generated once when a DIAMOND database is configured
+ *                      - Maps each sseqid to its title, species, lineage,
+ *                        UniProt accession, and contaminant/informative status
+ *                        so DIAMOND runs only need to output sseqid
+ *                      - Saved next to the .dmnd database with FileSystem::EXT_SUBJ
+ *                        as a MappedDatabase (subject sections), opening only
+ *                        maps the file and subjects are resolved the first
+ *                        time a hit references them
+ *
+ * Notes                - Contaminant and informative statuses are computed with
+ *                        the lists used at configuration. If the lists differ at
+ *                        execution, statuses are recomputed from the stored
+ *                        lineage/title when a subject is resolved
+ *                      - Species lineages are resolved again from the EnTAP
+ *                        database when its revision (deltas applied) differs
+ *                        from the one the index was generated with
+ *                      - Version 1 and 2 indexes (serialized archives) are
+ *                        still read, every subject is loaded up front
+ *                      - find_subject is thread safe
+ *
+ * ======================================================================
+ */
+class SubjectIndex {
+
+public:
+    // Runtime subject information, strings shared through StringInterner
+    struct SubjectInfo {
+        std::string              title;
+        std::string              accession;     // UniProt accession, empty if not UniProt
+        StringInterner::handle_t species;
+        StringInterner::handle_t lineage;
+        const tax_path_t        *lineage_path;  // Points into mLineagePaths
+        StringInterner::handle_t contam_type;
+        bool                     contaminant;
+        bool                     informative;
+    };
+
+    SubjectIndex(FileSystem *fileSystem);
+    ~SubjectIndex() = default;
+
+    static std::string get_index_path(const std::string &database_path);
+    bool generate_index(std::string &fasta_path, std::string &out_path, EntapDatabase *entapDatabase,
+                        vect_str_t &contaminants, vect_str_t &uninformative);
+    bool read_index(std::string &index_path, const ContaminantScreen &contaminants,
+                    const KeywordMatcher &uninformative, EntapDatabase *entapDatabase);
+    const SubjectInfo *find_subject(const std::string &sseqid);
+    bool has_uniprot() const;
+    uint64 get_subject_count() const;
+
+private:
+
+    // Serialized subject of version 1/2 indexes, species/lineage reference string table
+    struct SubjectRecord {
+        std::string sseqid;
+        std::string title;
+        std::string accession;
+        uint32      species;
+        uint32      lineage;
+        uint64      contam_mask;    // Bit per contaminant term (first CONTAM_MASK_BITS terms)
+        bool        informative;
+
+#ifdef USE_BOOST
+        friend class boost::serialization::access;
+        template<typename Archive>
+        void serialize(Archive & ar, const uint32 v) {
+            ar&sseqid;
+            ar&title;
+            ar&accession;
+            ar&species;
+            ar&lineage;
+            ar&contam_mask;
+            ar&informative;
+        }
+#else
+        template<class Archive>
+        void serialize(Archive & archive) {
+            archive(sseqid, title, accession, species, lineage, contam_mask, informative);
+        }
+#endif
+    };
+
+    // Version 1/2 index, also holds subjects while a mapped index is generated
+    struct SubjectIndexData {
+        uint16                     version;
+        vect_str_t                 contaminants;    // Contaminant terms used for masks
+        vect_str_t                 uninformative;   // Uninformative terms used for flags
+        vect_str_t                 strings;         // Species + lineage string table
+        std::vector<SubjectRecord> subjects;
+        uint32                     database_revision;   // EnTAP database revision lineages were resolved from
+
+        // Version 1 indexes have no revision, it is unknown
+#ifdef USE_BOOST
+        friend class boost::serialization::access;
+        template<typename Archive>
+        void serialize(Archive & ar, const uint32 v) {
+            ar&version;
+            ar&contaminants;
+            ar&uninformative;
+            ar&strings;
+            ar&subjects;
+            if (version >= 2) {
+                ar&database_revision;
+            } else {
+                database_revision = REVISION_UNKNOWN;
+            }
+        }
+#else
+        template<class Archive>
+        void serialize(Archive & archive) {
+            archive(version, contaminants, uninformative, strings, subjects);
+            if (version >= 2) {
+                archive(database_revision);
+            } else {
+                database_revision = REVISION_UNKNOWN;
+            }
+        }
+#endif
+    };
+
+    // Resolved subjects, split so workers rarely wait on each other
+    struct SubjectShard {
+        std::mutex                                   mutex;
+        std::unordered_map<std::string, SubjectInfo> subjects;     // sseqid to subject info
+    };
+
+    bool read_mapped_index(const std::string &index_path);
+    bool read_archive_index(const std::string &index_path);
+    void set_statuses(const vect_str_t &contaminants, const vect_str_t &uninformative, uint32 database_revision);
+    void resolve_subject(SubjectInfo &info, const std::string &lineage, uint64 contam_mask, bool informative);
+    const tax_path_t *get_lineage_path(StringInterner::handle_t handle, const std::string &lineage);
+    SubjectShard &get_shard(const std::string &sseqid);
+    void clear();
+    static void resolve_lineages(SubjectIndexData &index_data, EntapDatabase *entapDatabase);
+    static uint64 get_contam_mask(const std::string &lineage, const tax_path_t &lineage_path,
+                                  const ContaminantScreen &contaminants);
+    static std::string join_terms(const vect_str_t &terms);
+    static vect_str_t split_terms(const std::string &terms);
+
+    static constexpr uint16 INDEX_VERSION    = 3;           // 2: EnTAP database revision, 3: Mapped
+    static constexpr uint16 INDEX_VERSION_MIN = 1;          // Oldest version still read
+    static constexpr uint16 ARCHIVE_VERSION_MAX = 2;        // Newest version serialized as an archive
+    static constexpr uint16 CONTAM_MASK_BITS = 64;
+    static constexpr uint32 REVISION_UNKNOWN = UINT32_MAX;   // Index generated before revisions were stored
+    static constexpr uint16 SUBJECT_SHARDS   = 64;
+    static constexpr char   TERM_DELIM       = '\n';        // Separates terms of info values
+    static const std::string INFO_VERSION;                  // Subject info section keys
+    static const std::string INFO_REVISION;
+    static const std::string INFO_CONTAMINANTS;
+    static const std::string INFO_UNINFORMATIVE;
+    static const std::string INFO_UNIPROT;
+    const uint64 STATUS_UPDATE_SUBJECTS      = 500000;
+
+    FileSystem     *mpFileSystem;
+    MappedDatabase  mMappedIndex;       // Open if index is mapped (version 3+)
+    bool            mMapped;
+    bool            mHasUniprot;
+    uint64          mSubjectCount;
+    bool            mReuseContam;       // Stored contaminant masks match this execution
+    bool            mReuseInform;       // Stored informative flags match this execution
+    bool            mResolveLineages;   // EnTAP database changed since configuration
+    const ContaminantScreen *mpContaminants;
+    const KeywordMatcher    *mpUninformative;
+    EntapDatabase           *mpEntapDatabase;
+    std::vector<StringInterner::handle_t> mContamHandles;  // Contaminant term index to handle
+    SubjectShard    mShards[SUBJECT_SHARDS];
+    std::mutex      mLineageMutex;      // Guards mLineagePaths
+    std::unordered_map<StringInterner::handle_t, tax_path_t> mLineagePaths;  // Lineage to lineage path
+};
+
+
+#endif //ENTAP_SUBJECTINDEX_H
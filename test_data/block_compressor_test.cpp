@@ -0,0 +1,137 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * BlockCompressor (LZ4 block codec) round trip test driver
+ *
+ * Usage: block_compressor_test <work_dir>
+ *      work_dir    - Directory for the compressed file, removed once done
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include "../src/database/BlockCompressor.h"
+
+//******************** Global Variables ************************
+std::string DEBUG_FILE_PATH;        // Extern, main.cpp is not linked
+std::string LOG_FILE_PATH;          // Extern
+//**************************************************************
+
+namespace {
+
+    const uint64 BLOCK_SIZE = 4 * 1024 * 1024;      // BlockCompressor::BLOCK_SIZE
+    const uint16 THREADS[]  = {1, 4};
+
+    std::string  compressedPath;
+    uint16       failures = 0;
+
+    uint64 file_size(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file.is_open() ? (uint64) file.tellg() : 0;
+    }
+
+    // Writes then reads data back, max_size is the largest acceptable file (0 for no limit)
+    void check_round_trip(const std::string &test, const std::string &data, uint64 max_size=0) {
+        std::string read_data;
+        std::string err_msg;
+        bool        passed;
+
+        for (uint16 threads : THREADS) {
+            read_data = "stale";
+            passed = BlockCompressor::write(compressedPath, data, threads, err_msg) &&
+                     BlockCompressor::is_compressed(compressedPath) &&
+                     BlockCompressor::read(compressedPath, read_data, threads, err_msg);
+            if (passed && read_data != data) err_msg = "data differs after round trip";
+            if (passed && max_size > 0 && file_size(compressedPath) > max_size) {
+                err_msg = "compressed to " + std::to_string(file_size(compressedPath)) + " bytes";
+            }
+            passed = passed && read_data == data && (max_size == 0 || file_size(compressedPath) <= max_size);
+            std::cout << (passed ? "PASS " : "FAIL ") << test << " (" << data.size() << " bytes, " << threads
+                      << " threads)" << (passed ? "" : ": " + err_msg) << std::endl;
+            if (!passed) failures++;
+        }
+    }
+
+    std::string random_bytes(uint64 size, uint32 seed) {
+        std::mt19937 rng(seed);
+        std::string  out(size, '\0');
+
+        for (char &c : out) c = (char) (rng() & 0xFF);
+        return out;
+    }
+
+    // Record like text, matches at many offsets and lengths mixed with literals
+    std::string record_text(uint64 size, uint32 seed) {
+        const char  *words[] = {"cellular organisms;", "eukaryota;", "viridiplantae;", "GO:0005634", "\t", "\n"};
+        std::mt19937 rng(seed);
+        std::string  out;
+
+        while (out.size() < size) {
+            out += words[rng() % 6];
+            out += std::to_string(rng() % 100000);
+        }
+        out.resize(size);
+        return out;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: block_compressor_test <work_dir>" << std::endl;
+        return 2;
+    }
+    compressedPath = std::string(argv[1]) + "/block_compressor_test.bin";
+
+    check_round_trip("empty", "");
+
+    // Stored as is, file only grows by the header and block index
+    check_round_trip("incompressible", random_bytes(BLOCK_SIZE + 12345, 1), BLOCK_SIZE + 12345 + 1024);
+
+    // Matches longer than the 4 bit length field and overlapping their own offset
+    check_round_trip("long_run", std::string(3 * BLOCK_SIZE + 7, 'A'), BLOCK_SIZE / 10);
+    check_round_trip("long_run_pattern", std::string(BLOCK_SIZE / 2, 'A') + std::string(BLOCK_SIZE / 2, 'B') +
+                                         record_text(1000, 2) + std::string(70000, 'C'), BLOCK_SIZE / 10);
+
+    // Sequences close to the end of a block, where the format forbids matches
+    for (uint64 size = 1; size <= 32; size++) {
+        check_round_trip("short_run", std::string(size, 'Z'));
+    }
+
+    // Block boundaries, compressed blocks of text
+    for (uint64 size : {BLOCK_SIZE - 1, BLOCK_SIZE, BLOCK_SIZE + 1, 2 * BLOCK_SIZE}) {
+        check_round_trip("block_boundary", record_text(size, (uint32) size), size / 4 * 3);
+    }
+
+    // Mixed compressible and incompressible regions in one block
+    check_round_trip("mixed", record_text(100000, 3) + random_bytes(100000, 4) + record_text(100000, 5));
+
+    std::remove(compressedPath.c_str());
+    std::cout << (failures == 0 ? "All block compressor tests passed" :
+                  std::to_string(failures) + " block compressor tests failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
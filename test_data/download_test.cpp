@@ -0,0 +1,216 @@
+/*
+ *
+ * Developed by Alexander Hart
+ * Plant Computational Genomics Lab
+ * University of Connecticut
+ *
+ * For information, contact Alexander Hart at:
+ *     entap.dev@gmail.com
+ *
+ * Copyright 2017-2020, Alexander Hart, Dr. Jill Wegrzyn
+ *
+ * This file is part of EnTAP.
+ *
+ * EnTAP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EnTAP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EnTAP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Download (--data-mirror) test driver, run through test_data_mirror.sh which
+ * generates the fixtures and serves them with python3 -m http.server
+ *
+ * Usage: download_test <mirror_url> <fixture_dir> <work_dir>
+ *      mirror_url  - Local server standing in for the public sources
+ *      fixture_dir - Served fixtures (published as ftp://entap.test/fixtures/)
+ *      work_dir    - Empty directory for downloads
+ */
+
+#include <cstdio>
+#include <iostream>
+#include "../src/DownloadManager.h"
+#include "../src/FileSystem.h"
+
+//******************** Global Variables ************************
+std::string DEBUG_FILE_PATH;        // Extern, main.cpp is not linked
+std::string LOG_FILE_PATH;          // Extern
+//**************************************************************
+
+namespace {
+
+    const std::string PUBLISHED_DIR = "ftp://entap.test/fixtures/";
+    const std::string PAYLOAD_GZ    = "payload.txt.gz";
+    const std::string PAYLOAD_TXT   = "payload.txt";
+    const std::string ARCHIVE_TAR   = "archive.tar.gz";
+    const std::string ARCHIVE_DIR   = "archive";
+    const std::string MEMBERS[]     = {"member_a.txt", "member_b.txt"};
+
+    FileSystem  *pFileSystem;
+    std::string  fixtureDir;
+    std::string  workDir;
+    uint16       failures = 0;
+
+    std::string read_file(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream ss;
+
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    void check(bool passed, const std::string &test, const std::string &msg) {
+        std::cout << (passed ? "PASS " : "FAIL ") << test << ": " << msg << std::endl;
+        if (!passed) failures++;
+    }
+
+    DownloadManager::DownloadJob make_job(const std::string &file_name, const std::string &out_name) {
+        DownloadManager::DownloadJob job;
+
+        job.url      = pFileSystem->get_download_url(PUBLISHED_DIR + file_name);
+        job.out_path = PATHS(workDir, out_name);
+        return job;
+    }
+
+    DownloadManager::DownloadJob run_job(const DownloadManager::DownloadJob &job) {
+        DownloadManager downloadManager(1);
+
+        downloadManager.add_job(job);
+        downloadManager.run();
+        return downloadManager.get_job(0);
+    }
+
+    // Plain gzip download decompressed to a file
+    void test_full() {
+        DownloadManager::DownloadJob job = make_job(PAYLOAD_GZ, "full.gz");
+
+        job.decompress      = FileSystem::ENT_FILE_GZ;
+        job.decompress_path = PATHS(workDir, "full.txt");
+        job = run_job(job);
+        check(job.success && read_file(job.decompress_path) == read_file(PATHS(fixtureDir, PAYLOAD_TXT)),
+              "full", job.success ? "decompressed output matches" : job.err_msg);
+    }
+
+    // Partial file left by an interrupted run is replayed and the rest is requested from its end
+    void test_resume() {
+        DownloadManager::DownloadJob job = make_job(PAYLOAD_GZ, "resume.gz");
+        std::string compressed = read_file(PATHS(fixtureDir, PAYLOAD_GZ));
+        std::string debug_log;
+
+        {
+            std::ofstream part(job.out_path + ".part", std::ios::binary);
+            part.write(compressed.data(), compressed.size() / 2);
+        }
+        job.decompress      = FileSystem::ENT_FILE_GZ;
+        job.decompress_path = PATHS(workDir, "resume.txt");
+        job = run_job(job);
+        debug_log = read_file(DEBUG_FILE_PATH);
+        check(debug_log.find("Resuming " + job.url + " from byte " + std::to_string(compressed.size() / 2)) !=
+              std::string::npos, "resume", "partial download replayed");
+        check(job.success && job.bytes == compressed.size() &&
+              read_file(job.decompress_path) == read_file(PATHS(fixtureDir, PAYLOAD_TXT)),
+              "resume", job.success ? "decompressed output matches" : job.err_msg);
+        check(!pFileSystem->file_exists(job.out_path + ".part"), "resume", "partial file removed");
+    }
+
+    // Data beyond the published size is not the published file
+    void test_size_mismatch() {
+        DownloadManager::DownloadJob job = make_job(PAYLOAD_GZ, "mismatch.gz");
+        uint64 published = (uint64) read_file(PATHS(fixtureDir, PAYLOAD_GZ)).size() - 1;
+
+        job.size = published;
+        job = run_job(job);
+        check(!job.success && job.err_msg.find("published " + std::to_string(published)) != std::string::npos,
+              "size_mismatch", job.success ? "oversized download accepted" : job.err_msg);
+        check(!pFileSystem->file_exists(job.out_path + ".part"), "size_mismatch", "partial file removed");
+
+        // Partial file larger than the published size can not be resumed, download starts over
+        job = make_job(PAYLOAD_GZ, "oversized_part.gz");
+        {
+            std::ofstream part(job.out_path + ".part", std::ios::binary);
+            part << read_file(PATHS(fixtureDir, PAYLOAD_GZ)) << "trailing";
+        }
+        job = run_job(job);
+        check(job.success && read_file(job.out_path) == read_file(PATHS(fixtureDir, PAYLOAD_GZ)),
+              "size_mismatch", job.success ? "oversized partial file discarded" : job.err_msg);
+    }
+
+    // Decompressed data streamed to a consumer through a FIFO, nothing written to disk
+    void test_fifo() {
+        DownloadManager::DownloadJob job = make_job(PAYLOAD_GZ, "fifo.gz");
+        std::string received;
+        uint64      lines = 0;
+
+        job.decompress = FileSystem::ENT_FILE_GZ;
+        job.consumer   = [&received](std::istream &stream) {
+            std::string line;
+            while (std::getline(stream, line)) received += line + "\n";
+            return true;
+        };
+        job = run_job(job);
+        check(job.success && received == read_file(PATHS(fixtureDir, PAYLOAD_TXT)),
+              "fifo", job.success ? "streamed data matches" : job.err_msg);
+        check(!pFileSystem->file_exists(job.out_path + ".fifo"), "fifo", "FIFO removed");
+
+        // Consumer stopping early fails the job without blocking the decompressor
+        job = make_job(PAYLOAD_GZ, "fifo_stop.gz");
+        job.decompress = FileSystem::ENT_FILE_GZ;
+        job.consumer   = [&lines](std::istream &stream) {
+            std::string line;
+            while (std::getline(stream, line)) {
+                if (++lines == 10) return false;
+            }
+            return true;
+        };
+        job = run_job(job);
+        check(!job.success && lines == 10, "fifo", job.success ? "rejected data accepted" : job.err_msg);
+    }
+
+    // Archive members extracted to a directory as the archive downloads
+    void test_tar() {
+        DownloadManager::DownloadJob job = make_job(ARCHIVE_TAR, "archive.tar.gz");
+        std::string extract_dir = PATHS(workDir, "extracted");
+
+        pFileSystem->create_dir(extract_dir);
+        job.decompress      = FileSystem::ENT_FILE_TAR_GZ;
+        job.decompress_path = extract_dir;
+        job = run_job(job);
+        check(job.success, "tar", job.success ? "archive extracted" : job.err_msg);
+        for (const std::string &member : MEMBERS) {
+            check(read_file(PATHS(PATHS(extract_dir, ARCHIVE_DIR), member)) ==
+                  read_file(PATHS(PATHS(fixtureDir, ARCHIVE_DIR), member)), "tar", member + " matches");
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: download_test <mirror_url> <fixture_dir> <work_dir>" << std::endl;
+        return 2;
+    }
+    fixtureDir      = argv[2];
+    workDir         = argv[3];
+    DEBUG_FILE_PATH = PATHS(workDir, "debug.txt");
+
+    FileSystem fileSystem;
+    fileSystem.set_download_mirror(argv[1]);
+    pFileSystem = &fileSystem;
+
+    test_full();
+    test_resume();
+    test_size_mismatch();
+    test_fifo();
+    test_tar();
+
+    std::cout << (failures == 0 ? "All download tests passed" :
+                  std::to_string(failures) + " download tests failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+#
+# Exercises downloads through a data mirror (--data-mirror) against a local
+# python3 -m http.server: resume from a partial file, size mismatches, FIFO
+# streaming to a consumer, and tar member extraction
+#
+# Usage: test_data_mirror.sh <download_test executable>
+#   download_test is built with: cmake -DBUILD_TESTS=ON
+#   Requires python3, wget, gzip, and tar
+#
+
+if [ $# -ne 1 ] || [ ! -x "$1" ]; then
+    echo "Usage: $0 <download_test executable>"
+    exit 2
+fi
+download_test=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+
+work_dir=$(mktemp -d)
+mirror_dir="$work_dir/mirror"
+fixture_dir="$mirror_dir/entap.test/fixtures"   # Published as ftp://entap.test/fixtures/
+server_pid=""
+
+cleanup() {
+    [ -n "$server_pid" ] && kill "$server_pid" 2>/dev/null
+    rm -rf "$work_dir"
+}
+trap cleanup EXIT
+
+# Fixtures, payload spans many pipe buffers so streaming is exercised
+mkdir -p "$fixture_dir/archive" "$work_dir/downloads"
+for i in $(seq 1 200000); do
+    echo "sp|P$i|TEST_ENTAP Fixture protein $i OS=Arabidopsis thaliana OX=3702"
+done > "$fixture_dir/payload.txt"
+gzip -c "$fixture_dir/payload.txt" > "$fixture_dir/payload.txt.gz"
+echo "first member" > "$fixture_dir/archive/member_a.txt"
+head -n 1000 "$fixture_dir/payload.txt" > "$fixture_dir/archive/member_b.txt"
+tar -czf "$fixture_dir/archive.tar.gz" -C "$fixture_dir" archive
+
+# Any free port
+port=$(python3 -c 'import socket; s = socket.socket(); s.bind(("127.0.0.1", 0)); print(s.getsockname()[1])')
+python3 -m http.server "$port" --bind 127.0.0.1 --directory "$mirror_dir" >/dev/null 2>&1 &
+server_pid=$!
+
+for attempt in $(seq 1 50); do
+    wget -q --spider "http://127.0.0.1:$port/entap.test/fixtures/payload.txt.gz" && break
+    sleep 0.1
+done
+
+"$download_test" "http://127.0.0.1:$port/" "$fixture_dir" "$work_dir/downloads"